@@ -489,6 +489,10 @@ namespace HXSL
 			}
 
 			RecordId GetRecordId(const Layout* layout);
+
+			// returns the id the layout was written under, 0 if the layout is not part of the written module.
+			RecordId FindRecordId(const Layout* layout) const;
+
 			bool WriteRecordHeader(const Layout* layout);
 			void WriteRecordRef(const Layout* layout);
 			void WriteNamespace(const NamespaceLayout* ns);
@@ -565,6 +569,9 @@ namespace HXSL
 			ModuleReader(Stream* s) : stream(s) {}
 
 			uptr<Module> Read();
+
+			// hands out the record id to layout mapping of the last read, used to look up records referenced by sections after the module.
+			dense_map<RecordId, Layout*> TakeRecordMap() { return std::move(recordMap); }
 		};
 	}
 }
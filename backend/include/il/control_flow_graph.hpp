@@ -234,12 +234,15 @@ namespace HXSL
 		{
 			friend class LTDominatorTree;
 			ILContext* context;
+			// bumped by every edge or node change, cached analyses compare it against the version they were built from.
+			uint64_t version = 0;
+			uint64_t domTreeVersion = std::numeric_limits<uint64_t>::max();
 		public:
 			BumpAllocator& allocator;
 			ILMetadata& metadata;
 			std::vector<size_t> idom;
 			std::vector<std::vector<size_t>> domTreeChildren;
-			std::vector<std::unordered_set<size_t>> domFront;
+			std::vector<std::vector<size_t>> domFront;
 			std::vector<size_t> domIn;
 			std::vector<size_t> domOut;
 
@@ -249,6 +252,18 @@ namespace HXSL
 
 			void RebuildDomTree();
 
+			uint64_t GetVersion() const noexcept { return version; }
+
+			bool IsDomTreeValid() const noexcept { return domTreeVersion == version; }
+
+			void EnsureDomTree()
+			{
+				if (!IsDomTreeValid())
+				{
+					RebuildDomTree();
+				}
+			}
+
 			inline bool Dominates(size_t a, size_t b) const
 			{
 				return domIn[a] <= domIn[b] && domOut[b] <= domOut[a];
@@ -279,7 +294,7 @@ namespace HXSL
 				}
 
 				auto index = nodes.size();
-
+				version++;
 				nodes.emplace_back(make_uptr<BasicBlock>(allocator, index, context, type));
 				return index;
 			}
@@ -291,6 +306,7 @@ namespace HXSL
 				{
 					return;
 				}
+				version++;
 				fromNode->AddSuccessor(to);
 				auto& toNode = nodes[to];
 				toNode->AddPredecessor(from);
@@ -302,6 +318,9 @@ namespace HXSL
 
 			void MergeNodes(size_t from, size_t to);
 
+			// puts a new block ending in a jump to 'to' on the edge, it takes the place of both ends in the edge lists so phi slots still line up.
+			size_t SplitEdge(size_t from, size_t to);
+
 			void Print() const;
 		};
 
@@ -211,6 +211,15 @@ namespace HXSL
 				functions.erase(functions.begin() + idx);
 			}
 
+			void RemovePhi(const PhiInstr* phi)
+			{
+				auto it = std::find(phiNodes.begin(), phiNodes.end(), phi);
+				if (it != phiNodes.end())
+				{
+					phiNodes.erase(it);
+				}
+			}
+
 			void RemoveFunc(FunctionLayout* def)
 			{
 				auto it = funcMap.find(def);
@@ -54,6 +54,7 @@ namespace HXSL
 			std::vector<uptr<LoopNode>> nodes;
 			dense_map<BasicBlock*, LoopNode*> headerToNode;
 			dense_map<BasicBlock*, LoopNode*> blockToNode;
+			uint64_t cfgVersion = std::numeric_limits<uint64_t>::max();
 
 			LoopNode* CreateNode(BasicBlock* header)
 			{
@@ -84,7 +85,18 @@ namespace HXSL
 		public:
 			LoopTree(ControlFlowGraph& cfg) : cfg(cfg) {}
 			void Build();
-			void Clear() { nodes.clear(); headerToNode.clear(); blockToNode.clear(); }
+			void Clear() { nodes.clear(); headerToNode.clear(); blockToNode.clear(); cfgVersion = std::numeric_limits<uint64_t>::max(); }
+
+			bool IsValid() const noexcept { return cfgVersion == cfg.GetVersion(); }
+
+			// rebuilds only if the cfg changed since the last build.
+			void Ensure()
+			{
+				if (!IsValid())
+				{
+					Build();
+				}
+			}
 
 			const std::vector<uptr<LoopNode>>& GetNodes() const { return nodes; }
 
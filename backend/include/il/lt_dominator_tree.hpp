@@ -132,10 +132,11 @@ namespace HXSL
 				return idom;
 			}
 
-			std::vector<std::unordered_set<size_t>> ComputeDominanceFrontiers(const std::vector<size_t>& idom, const std::vector<std::vector<size_t>>& domTreeChildren)
+			// every frontier is a sorted vector without duplicates.
+			std::vector<std::vector<size_t>> ComputeDominanceFrontiers(const std::vector<size_t>& idom, const std::vector<std::vector<size_t>>& domTreeChildren)
 			{
 				const size_t n = cfg.nodes.size();
-				std::vector<std::unordered_set<size_t>> df(n);
+				std::vector<std::vector<size_t>> df(n);
 
 				std::stack<std::tuple<size_t, bool>> walkStack;
 
@@ -164,11 +165,12 @@ namespace HXSL
 						continue;
 					}
 
+					auto& frontier = df[node];
 					for (size_t succ : cfg.nodes[node]->GetSuccessors())
 					{
 						if (idom[succ] != node)
 						{
-							df[node].insert(succ);
+							frontier.push_back(succ);
 						}
 					}
 
@@ -178,10 +180,13 @@ namespace HXSL
 						{
 							if (idom[frontier_node] != node)
 							{
-								df[node].insert(frontier_node);
+								frontier.push_back(frontier_node);
 							}
 						}
 					}
+
+					std::sort(frontier.begin(), frontier.end());
+					frontier.erase(std::unique(frontier.begin(), frontier.end()), frontier.end());
 				}
 
 				return df;
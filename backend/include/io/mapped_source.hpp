@@ -0,0 +1,38 @@
+#ifndef MAPPED_SOURCE_HPP
+#define MAPPED_SOURCE_HPP
+
+#include "pch/std.hpp"
+
+namespace HXSL
+{
+	// Read-only view of a whole source file, memory mapped where the platform supports it so that
+	// lexing and StringSpans read straight from the page cache instead of a private copy.
+	class MappedSource
+	{
+		std::string path;
+		const char* data = nullptr;
+		size_t length = 0;
+		void* mapping = nullptr;
+		std::vector<char> fallback;
+
+		MappedSource() = default;
+
+	public:
+		~MappedSource();
+
+		MappedSource(const MappedSource&) = delete;
+		MappedSource& operator=(const MappedSource&) = delete;
+
+		static std::unique_ptr<MappedSource> Open(const char* path);
+
+		const std::string& GetPath() const noexcept { return path; }
+
+		const char* GetData() const noexcept { return data; }
+
+		size_t GetLength() const noexcept { return length; }
+
+		bool IsMapped() const noexcept { return mapping != nullptr; }
+	};
+}
+
+#endif
\ No newline at end of file
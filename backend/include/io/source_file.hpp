@@ -2,6 +2,7 @@
 #define SOURCE_FILE_HPP
 
 #include "stream.hpp"
+#include "mapped_source.hpp"
 #include "source_location.hpp"
 #include "text_stream.hpp"
 #include "utils/span.hpp"
@@ -13,17 +14,25 @@ namespace HXSL
 	class SourceManager;
 	class SourceFile
 	{
+		friend class SourceManager;
+
 		SourceManager* srcManager;
 		SourceFileID id;
 		Stream* stream;
 		bool closeStream;
+		std::shared_ptr<MappedSource> mappedSource; // shared, included files are mapped once and referenced by every includer.
 		std::unique_ptr<TextStream> inputStream;
+		std::string path;
 
 	public:
 		SourceFile(SourceManager* srcManager, SourceFileID id, Stream* stream, bool closeStream) : srcManager(srcManager), id(id), stream(stream), closeStream(closeStream), inputStream(std::make_unique<TextStream>())
 		{
 		}
 
+		SourceFile(SourceManager* srcManager, SourceFileID id, std::shared_ptr<MappedSource> mappedSource) : srcManager(srcManager), id(id), stream(nullptr), closeStream(false), mappedSource(std::move(mappedSource)), inputStream(std::make_unique<TextStream>(this->mappedSource->GetData(), this->mappedSource->GetLength())), path(this->mappedSource->GetPath())
+		{
+		}
+
 		~SourceFile()
 		{
 			if (stream)
@@ -38,6 +47,11 @@ namespace HXSL
 
 		SourceFileID GetID() const noexcept { return id; }
 
+		const MappedSource* GetMappedSource() const noexcept { return mappedSource.get(); }
+
+		// Path the source was opened from, empty for sources read from a stream. Kept when the preprocessor replaces the input.
+		const std::string& GetPath() const noexcept { return path; }
+
 		bool PrepareInputStream();
 
 		const std::unique_ptr<TextStream>& GetInputStream() const noexcept;
@@ -5,22 +5,79 @@
 #include "source_file.hpp"
 #include "text_stream.hpp"
 #include "lexical/text_span.hpp"
+#include <atomic>
 
 namespace HXSL
 {
+	// Sources may be added from several threads at once, e.g. includes found while preprocessing in parallel.
+	// Files are indexed through fixed size chunks that never move, so GetSource doesn't lock.
+	// A manager with a parent stages the sources of one worker under provisional ids and forwards lookups of lower ids to the
+	// parent, Adopt then registers them with the parent in a serial step so the final ids don't depend on thread scheduling.
 	class SourceManager
 	{
+		static constexpr size_t ChunkShift = 6;
+		static constexpr size_t ChunkSize = 1 << ChunkShift;
+		static constexpr size_t MaxChunks = 1024;
+		static constexpr SourceFileID ProvisionalBase = 0x80000000u;
+
+		std::atomic<SourceFile**> chunks[MaxChunks] = {};
+		std::vector<std::unique_ptr<SourceFile*[]>> chunkStorage;
 		std::vector<std::unique_ptr<SourceFile>> files;
+		std::mutex lock;
+		const SourceManager* parent = nullptr;
+		SourceFileID firstID = 0;
+
+		SourceFile* Insert(std::unique_ptr<SourceFile>&& file);
+
+		SourceFileID NextID() const noexcept { return firstID + static_cast<SourceFileID>(files.size()); }
 
 	public:
-		void AddSource(std::unique_ptr<SourceFile>&& file) { files.push_back(std::forward<std::unique_ptr<SourceFile>>(file)); };
+		SourceManager() = default;
+
+		explicit SourceManager(const SourceManager* parent) : parent(parent), firstID(ProvisionalBase)
+		{
+		}
+
+		SourceManager(const SourceManager&) = delete;
+		SourceManager& operator=(const SourceManager&) = delete;
+
+		void AddSource(std::unique_ptr<SourceFile>&& file)
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			Insert(std::move(file));
+		}
+
 		SourceFile* AddSource(Stream* stream, bool closeStream)
 		{
-			files.push_back(std::make_unique<SourceFile>(this, static_cast<SourceFileID>(files.size()), stream, closeStream));
-			return files.back().get();
+			std::lock_guard<std::mutex> guard(lock);
+			return Insert(std::make_unique<SourceFile>(this, NextID(), stream, closeStream));
+		}
+
+		SourceFile* AddSource(std::shared_ptr<MappedSource> source)
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			return Insert(std::make_unique<SourceFile>(this, NextID(), std::move(source)));
+		}
+
+		// Number of sources added to this manager, staged sources of children are not counted until they are adopted.
+		size_t Size()
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			return files.size();
 		}
 
-		const SourceFile* GetSource(SourceFileID id) const { return files[id].get(); }
+		// Moves the sources staged by child over to this manager in the order they were added and assigns their final ids.
+		void Adopt(SourceManager& child);
+
+		const SourceFile* GetSource(SourceFileID id) const
+		{
+			if (id < firstID)
+			{
+				return parent->GetSource(id);
+			}
+			id -= firstID;
+			return chunks[id >> ChunkShift].load(std::memory_order_acquire)[id & (ChunkSize - 1)];
+		}
 
 		std::string GetString(const TextSpan& span) const { return GetSource(span.source)->GetString(span.start, span.length); }
 
@@ -6,23 +6,40 @@
 
 namespace HXSL
 {
+	// A view stream reads from memory it doesn't own (e.g. a MappedSource), writes that don't change the
+	// viewed bytes only move the write position, anything else copies the view into a private buffer first.
 	class TextStream
 	{
 		std::vector<char> data;
+		const char* view;
 		static constexpr size_t growValue = 1024;
 		size_t writePosition;
 		size_t dataSize;
 
+		void Materialize()
+		{
+			if (!view) return;
+			data.resize(dataSize + growValue);
+			std::memcpy(data.data(), view, dataSize);
+			view = nullptr;
+		}
+
 	public:
-		TextStream() : writePosition(0), dataSize(0)
+		TextStream() : view(nullptr), writePosition(0), dataSize(0)
+		{
+		}
+
+		TextStream(const char* view, size_t length) : view(view), writePosition(0), dataSize(length)
 		{
 		}
 
 		const char* GetBuffer() const noexcept
 		{
-			return data.data();
+			return view ? view : data.data();
 		}
 
+		bool IsView() const noexcept { return view != nullptr; }
+
 		void SetLength(size_t size)  noexcept
 		{
 			dataSize = size;
@@ -36,12 +53,13 @@ namespace HXSL
 
 		size_t GetPosition() const noexcept { return writePosition; }
 
-		std::vector<char>& GetData() { return data; }
+		std::vector<char>& GetData() { Materialize(); return data; }
 
-		std::vector<char> DetachData() { return std::move(data); }
+		std::vector<char> DetachData() { Materialize(); return std::move(data); }
 
 		void Reserve(size_t wantedCapacity)
 		{
+			Materialize();
 			if (data.size() < wantedCapacity)
 			{
 				data.resize(wantedCapacity);
@@ -55,6 +73,7 @@ namespace HXSL
 			if (len == 0) return true;
 			size_t length = static_cast<size_t>(len);
 
+			Materialize();
 			size_t capacity = data.size();
 			size_t nextPosition = writePosition + length;
 			if (nextPosition > capacity)
@@ -75,12 +94,23 @@ namespace HXSL
 
 		void CopyTo(TextStream* stream)
 		{
-			stream->Write(data.data(), dataSize);
+			stream->Write(GetBuffer(), dataSize);
 		}
 
 		void Write(const char* src, size_t length)
 		{
 			if (length == 0) return;
+			if (view)
+			{
+				size_t nextPosition = writePosition + length;
+				if (nextPosition <= dataSize && (src == view + writePosition || std::memcmp(view + writePosition, src, length) == 0))
+				{
+					writePosition = nextPosition;
+					return;
+				}
+				Materialize();
+			}
+
 			size_t capacity = data.size();
 			size_t nextPosition = writePosition + length;
 			if (nextPosition > capacity)
@@ -101,7 +131,7 @@ namespace HXSL
 
 		void Print()
 		{
-			std::cout << std::string(data.data(), dataSize) << std::endl;
+			std::cout << std::string(GetBuffer(), dataSize) << std::endl;
 		}
 	};
 }
@@ -3,45 +3,85 @@
 
 #include "pch/std.hpp"
 #include "utils/span.hpp"
-#include "utils/dense_map.hpp"
 #include "utils/bump_allocator.hpp"
+#include <atomic>
 
 namespace HXSL
 {
 	struct IdentifierInfo
 	{
 		StringSpan name;
+		size_t hashCode; // hash of the name, computed once when interned.
 
-		size_t hash() const { return name.hash(); }
+		size_t hash() const { return hashCode; }
 
 		inline bool operator==(const IdentifierInfo& other) const { return name == other.name; }
 		inline bool operator!=(const IdentifierInfo& other) const { return !(*this == other); }
 	};
 
+	// Thread-safe interning table, names are split over shards by hash. Lookups of existing names never lock, inserts lock only their shard.
+	// IdentifierInfo pointers and their names stay valid for the lifetime of the table.
 	class IdentifierTable
 	{
-		BumpAllocator allocator;
-		dense_map<StringSpan, IdentifierInfo*> map;
+	public:
+		static constexpr size_t ShardCount = 1 << 4;
+
+	private:
+		static constexpr size_t ShardShift = sizeof(size_t) * 8 - 4; // The top bits pick the shard, the low bits the slot.
+		static constexpr size_t InitialCapacity = 64;
+
+		struct Slot
+		{
+			std::atomic<size_t> hash;
+			std::atomic<IdentifierInfo*> info;
+		};
+
+		// Open addressing, power of two capacity. Tables are never freed while the table lives, readers may still probe an old one after a grow.
+		struct SlotTable
+		{
+			size_t mask;
+			Slot* slots;
+		};
+
+		struct alignas(64) Shard
+		{
+			std::atomic<SlotTable*> table = nullptr;
+			size_t count = 0;
+			mutable std::mutex lock;
+			BumpAllocator allocator;
+
+			IdentifierInfo* Find(const StringSpan& name, size_t hash) const noexcept;
+			IdentifierInfo* Insert(const StringSpan& name, size_t hash);
+			SlotTable* CreateTable(size_t capacity);
+		};
+
+		Shard shards[ShardCount];
 
 	public:
+		IdentifierTable() = default;
+
+		IdentifierTable(const IdentifierTable&) = delete;
+		IdentifierTable& operator=(const IdentifierTable&) = delete;
+
 		IdentifierInfo* Get(const StringSpan& name)
 		{
-			auto it = map.find(name);
-			if (it != map.end())
+			size_t hash = name.hash();
+			auto& shard = shards[hash >> ShardShift];
+			if (auto info = shard.Find(name, hash))
 			{
-				return it->second;
+				return info;
 			}
+			return shard.Insert(name, hash);
+		}
 
-			auto info = allocator.Alloc<IdentifierInfo>();
-
-			auto p = reinterpret_cast<char*>(allocator.Alloc((name.size() + 1)* sizeof(char), alignof(char)));
-			std::memcpy(p, name.data(), name.size() * sizeof(char));
-			p[name.size()] = '\0';
-			info->name = StringSpan(p, name.size());
-
-			map.insert({ info->name, info });
-			return info;
+		// Returns nullptr if the name was never interned, never locks.
+		IdentifierInfo* Find(const StringSpan& name) const noexcept
+		{
+			size_t hash = name.hash();
+			return shards[hash >> ShardShift].Find(name, hash);
 		}
+
+		size_t Size() const noexcept;
 	};
 }
 
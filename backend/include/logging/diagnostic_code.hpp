@@ -5,6 +5,7 @@
 #include <string>
 
 #include "log_message.h"
+#include "utils/span.hpp"
 
 namespace HXSL
 {
@@ -31,7 +32,8 @@ namespace HXSL
 			value &= ~(0x3ull << 62ull);
 		}
 
-		std::string GetMessage() const;
+		// points into the decoded locale, copy it before looking up many other messages.
+		StringSpan GetMessage() const;
 
 		std::string GetCodeString() const;
 
@@ -47,7 +49,7 @@ namespace HXSL
 			return !(*this == other);
 		}
 
-		typedef std::string(*GetMessageForCode)(uint64_t code);
+		typedef StringSpan(*GetMessageForCode)(uint64_t code);
 		typedef std::string(*GetStringForCode)(uint64_t code);
 		typedef uint64_t(*EncodeDiagnosticCode)(LogLevel level, const std::string& code);
 
@@ -6,10 +6,13 @@
 #include "utils/interval_tree.hpp"
 
 #include "fmt/core.h"
+#include "fmt/args.h"
 #include "fmt/ostream.h"
 #include "pch/std.hpp"
 
 #include "utils/span.hpp"
+#include "utils/dense_map.hpp"
+#include "utils/hashing.hpp"
 
 template <> struct fmt::formatter<HXSL::StringSpan> : ostream_formatter {};
 
@@ -26,16 +29,116 @@ namespace HXSL
 		}
 	};
 
+	using DiagnosticArgs = fmt::dynamic_format_arg_store<fmt::format_context>;
+
+	// A logged message or diagnostic in its structured form, the text is only rendered when it is asked for.
+	struct DiagnosticRecord
+	{
+		LogLevel level = LogLevel_Info;
+		bool isDiagnostic = false;
+		DiagnosticCode code = 0;
+		size_t location = 0;
+		const char* format = nullptr; // appended to the localized message of code, has to outlive the logger.
+		std::shared_ptr<const DiagnosticArgs> args;
+		std::string text; // used instead of format and args for messages logged as text.
+		uint32_t count = 1; // occurrences folded into this record while deduplicating, rendered as " (xN)".
+
+		std::string Render() const;
+	};
+
 	class ILogger
 	{
 	private:
-		std::vector<LogMessage> messages;
-		std::vector<DiagnosticSuppressionRange> suppressionRanges;
+		// Calls into a deferred logger in their original order, Replay feeds them to another logger.
+		struct DeferredEvent
+		{
+			enum Type
+			{
+				Type_Record,
+				Type_Suppression,
+			};
+
+			Type type;
+			DiagnosticRecord record;
+			size_t end;
+		};
+
+		struct DiagnosticSite
+		{
+			uint64_t code;
+			size_t location;
+
+			bool operator==(const DiagnosticSite& other) const noexcept { return code == other.code && location == other.location; }
+		};
+
+		struct DiagnosticSiteHash
+		{
+			size_t operator()(const DiagnosticSite& site) const noexcept
+			{
+				XXHash3Chain chain;
+				chain.Combine(site.code);
+				chain.Combine(site.location);
+				return static_cast<size_t>(chain.hash);
+			}
+		};
+
+		std::vector<DiagnosticRecord> records;
+		mutable std::vector<LogMessage> messages; // rendered prefix of records.
+		mutable std::vector<uint32_t> renderedCounts; // count of each record when its message was rendered.
+		mutable std::vector<size_t> staleMessages; // messages whose record folded more duplicates since.
+		IntervalTree<DiagnosticCode> suppressionRanges;
+		dense_map<DiagnosticSite, size_t, DiagnosticSiteHash> sites;
+		std::vector<DeferredEvent> deferredEvents;
+		size_t maxRecords = 0;
+		size_t droppedCount = 0;
+		bool deduplicate = false;
 		bool hasCriticalErrors;
+		bool deferred;
 		int errorCount;
 
+		bool IsSuppressed(DiagnosticCode code, size_t location) const;
+
+		// records the call when deferred, a suppressed record is only kept for the replay.
+		void Submit(DiagnosticRecord&& record, bool suppressed);
+
+		void Emit(DiagnosticRecord&& record);
+
+		template <typename T>
+		static void StoreArg(DiagnosticArgs& store, T&& arg)
+		{
+			using Decayed = std::decay_t<T>;
+			// views only point into their source, which may be gone by the time the record is rendered.
+			if constexpr (std::is_same_v<Decayed, StringSpan>)
+			{
+				store.push_back(arg.str());
+			}
+			else if constexpr (std::is_same_v<Decayed, std::string_view> || std::is_same_v<Decayed, const char*> || std::is_same_v<Decayed, char*>)
+			{
+				store.push_back(std::string(arg));
+			}
+			else
+			{
+				store.push_back(std::forward<T>(arg));
+			}
+		}
+
+		template <typename... Args>
+		static std::shared_ptr<const DiagnosticArgs> StoreArgs(Args&&... args)
+		{
+			auto store = std::make_shared<DiagnosticArgs>();
+			store->reserve(sizeof...(Args), 0);
+			(StoreArg(*store, std::forward<Args>(args)), ...);
+			return store;
+		}
+
 	public:
-		ILogger() : hasCriticalErrors(false), errorCount(0)
+		ILogger() : hasCriticalErrors(false), deferred(false), errorCount(0)
+		{
+		}
+
+		// A deferred logger doesn't print anything, it keeps its own messages and error counts so the
+		// producer stops at the same limits, and records every call for a later Replay.
+		explicit ILogger(bool deferred) : hasCriticalErrors(false), deferred(deferred), errorCount(0)
 		{
 		}
 
@@ -45,10 +148,21 @@ namespace HXSL
 
 		int GetErrorCount()  const noexcept { return errorCount; };
 
-		const std::vector<LogMessage>& GetMessages() const noexcept
-		{
-			return messages;
-		}
+		// Doesn't render anything, speculative paths only need to know whether something was logged.
+		bool HasMessages() const noexcept { return !records.empty() || droppedCount > 0; }
+
+		const std::vector<DiagnosticRecord>& GetRecords() const noexcept { return records; }
+
+		// Renders the records logged since the last call and those whose count changed since.
+		const std::vector<LogMessage>& GetMessages() const;
+
+		// Records past max are counted but dropped, critical errors are always kept. Zero means no limit.
+		void SetMaxRecords(size_t max) noexcept { maxRecords = max; }
+
+		size_t GetDroppedCount() const noexcept { return droppedCount; }
+
+		// Folds repeated diagnostics with the same code and location into the first record and doesn't count them as errors again.
+		void SetDeduplicate(bool value) noexcept { deduplicate = value; }
 
 		void AddDiagnosticSuppressionRange(const DiagnosticSuppressionRange& range);
 
@@ -56,6 +170,15 @@ namespace HXSL
 
 		void Log(DiagnosticCode code, size_t location, const std::string& message);
 
+		size_t GetDeferredEventCount() const noexcept { return deferredEvents.size(); }
+
+		// Replays the calls recorded by a deferred logger, suppression and error limits are evaluated again by this logger.
+		// Stops once this logger has critical errors, a serial run would not have produced anything past that point either.
+		void Replay(const ILogger& deferredLogger);
+
+		// Replays the recorded calls in [begin, end), lets callers interleave several deferred loggers.
+		void Replay(const ILogger& deferredLogger, size_t begin, size_t end);
+
 		template <typename T>
 		auto convert_to_cstr(T&& arg) -> decltype(std::forward<T>(arg))
 		{
@@ -72,40 +195,35 @@ namespace HXSL
 			return arg.c_str();
 		}
 
+		// format is stored and rendered later, pass a literal.
 		template <typename... Args>
-		void LogFormattedInternal(LogLevel level, const std::string& format, Args&&... args)
+		void LogFormattedInternal(LogLevel level, const char* format, Args&&... args)
 		{
-			auto view = fmt::string_view(format);
-
-			auto storedArgs = std::make_tuple(std::forward<Args>(args)...);
-
-			std::string formatted = std::apply(
-				[&](const auto&... unpacked) {
-					return fmt::vformat(view, fmt::make_format_args(unpacked...));
-				},
-				storedArgs
-			);
-
-			Log(level, formatted);
+			DiagnosticRecord record;
+			record.level = level;
+			record.format = format;
+			record.args = StoreArgs(std::forward<Args>(args)...);
+			Submit(std::move(record), false);
 		}
 
+		// format is stored and rendered later, pass a literal.
 		template <typename... Args>
-		void LogFormattedEx(DiagnosticCode code, size_t location, const std::string& format, Args&&... args)
+		void LogFormattedEx(DiagnosticCode code, size_t location, const char* format, Args&&... args)
 		{
-			std::string formatFinal = code.GetMessage() + format;
-
-			auto view = fmt::string_view(formatFinal);
-
-			auto storedArgs = std::make_tuple(std::forward<Args>(args)...);
-
-			std::string formatted = std::apply(
-				[&](const auto&... unpacked) {
-					return fmt::vformat(view, fmt::make_format_args(unpacked...));
-				},
-				storedArgs
-			);
-
-			Log(code, location, formatted);
+			bool suppressed = IsSuppressed(code, location);
+			if (suppressed && !deferred)
+			{
+				return;
+			}
+
+			DiagnosticRecord record;
+			record.level = code.GetLogLevel();
+			record.isDiagnostic = true;
+			record.code = code;
+			record.location = location;
+			record.format = format;
+			record.args = StoreArgs(std::forward<Args>(args)...);
+			Submit(std::move(record), suppressed);
 		}
 
 		~ILogger()
@@ -114,4 +232,4 @@ namespace HXSL
 	};
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -18,6 +18,8 @@ namespace HXSL
 
 		std::string GetName() override { return "AlgebraicSimplifier"; }
 
+		bool IsBlockLocal() const override { return true; }
+
 		OptimizerPassResult Run() override
 		{
 			changed = false;
@@ -12,7 +12,7 @@ namespace HXSL
 			std::unordered_map<ILVarId, Number> constants;
 			std::unordered_map<ILVarId, ILVarId> varToVar;
 
-			void TryFoldOperand(Operand*& op);
+			void TryFoldOperand(BasicBlock& node, Operand*& op);
 
 			void Visit(size_t index, BasicBlock& node, EmptyCFGContext& context) override;
 
@@ -23,6 +23,8 @@ namespace HXSL
 
 			std::string GetName() override { return "ConstantFolder"; }
 
+			bool IsBlockLocal() const override { return true; }
+
 			OptimizerPassResult Run() override
 			{
 				changed = false;
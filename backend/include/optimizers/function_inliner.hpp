@@ -2,11 +2,14 @@
 #define FUNCTION_INLINER_HPP
 
 #include "pch/il.hpp"
+#include "utils/thread_pool.hpp"
 
 namespace HXSL
 {
 	namespace Backend
 	{
+		class FuncCallGraph;
+
 		class FunctionInliner
 		{
 			enum class ParamInfoType
@@ -47,6 +50,9 @@ namespace HXSL
 
 			float ComputeInlineCost(FunctionLayout* funcLayout);
 
+			// only touches the caller, the callees are read.
+			bool InlineCallees(const FuncCallGraph& callGraph, size_t callerNode);
+
 		public:
 			FunctionInliner()
 			{
@@ -60,7 +66,9 @@ namespace HXSL
 				}
 			}
 			
-			dense_set<FunctionLayout*> Inline(const Span<FunctionLayout*> functions);
+			// Inlines bottom-up over the SCCs of the call graph, one level of SCCs at a time on the pool. Returns the changed
+			// callers in call graph order, the result doesn't depend on the thread count.
+			std::vector<FunctionLayout*> Inline(const Span<FunctionLayout*> functions, ThreadPool& pool);
 		};
 	}
 }
@@ -13,7 +13,7 @@ namespace HXSL
 			std::unordered_set<ResultInstr*, InstructionPtrHash, InstructionPtrEquals> subExpressions;
 			dense_map<ILVarId, ILVarId> map;
 
-			void TryMapOperand(Operand*& op);
+			void TryMapOperand(BasicBlock& node, Operand*& op);
 
 			void Visit(size_t index, BasicBlock& node, EmptyCFGContext& context) override;
 
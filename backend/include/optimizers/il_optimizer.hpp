@@ -3,6 +3,9 @@
 
 #include "pch/il.hpp"
 #include "logging/logger.hpp"
+#include "pass_manager.hpp"
+#include "utils/dense_map.hpp"
+#include "utils/thread_pool.hpp"
 
 namespace HXSL
 {
@@ -11,12 +14,22 @@ namespace HXSL
 		class ILOptimizer
 		{
 			Module* module;
+			OptimizationLevel level;
+			size_t threadCount;
+			dense_map<ILContext*, uptr<ILPassManager>> passManagers;
+
+			ILPassManager& GetPassManager(ILContext* function);
 
 		public:
-			ILOptimizer(ILogger* logger, Module* compilation) : module(compilation)
+			// functions are optimized on up to threadCount threads, the output is the same for any count.
+			ILOptimizer(ILogger* logger, Module* compilation, OptimizationLevel level = OptimizationLevel_Full, size_t threadCount = 1) : module(compilation), level(level), threadCount(std::max<size_t>(threadCount, 1))
 			{
 			}
 
+			OptimizationLevel GetLevel() const noexcept { return level; }
+
+			size_t GetThreadCount() const noexcept { return threadCount; }
+
 			void Optimize();
 
 			void Optimize(ILContext* function);
@@ -16,18 +16,45 @@ namespace HXSL
 
 		class ILOptimizerPass : protected ILMutatorBase
 		{
+			friend class ILPassManager;
+			std::vector<size_t> changedBlocks;
+			const std::vector<bool>* dirtyBlocks = nullptr;
+
 		protected:
 			ILContext* context;
 			bool changed = false;
+
+			// records the block for the pass manager, a change without any marked block counts for the whole function.
+			void MarkChanged(const BasicBlock& block)
+			{
+				changed = true;
+				changedBlocks.push_back(block.GetId());
+			}
+
+			// false only for blocks nobody touched since this pass last ran, always true outside of a pass manager.
+			bool IsDirty(size_t block) const
+			{
+				return !dirtyBlocks || block >= dirtyBlocks->size() || (*dirtyBlocks)[block];
+			}
+
 			void DiscardInstr(Instruction& instr) override
 			{
 				ILMutatorBase::DiscardInstr(instr);
-				changed = true;
+				if (auto block = instr.GetParent())
+				{
+					MarkChanged(*block);
+				}
+				else
+				{
+					changed = true;
+				}
 			}
 
 		public:
 			ILOptimizerPass(ILContext* context) : ILMutatorBase(context->GetMetadata()), context(context) {}
 			virtual std::string GetName() = 0;
+			// block local passes look at each block on its own, so the pass manager only hands them blocks which changed.
+			virtual bool IsBlockLocal() const { return false; }
 			virtual OptimizerPassResult Run() = 0;
 			virtual ~ILOptimizerPass() = default;
 		};
@@ -2,15 +2,111 @@
 #define LIVENESS_ANALYZER_HPP
 
 #include "il_optimizer_pass.hpp"
+#include "utils/dense_map.hpp"
+#include "utils/bit_vector.hpp"
 
 namespace HXSL
 {
 	namespace Backend
 	{
+		// span of instruction positions a variable holds a value over, the instruction i reads at 2 * i and writes at 2 * i + 1.
+		struct LiveRange
+		{
+			size_t start = std::numeric_limits<size_t>::max();
+			size_t end = 0;
+
+			bool empty() const noexcept { return start > end; }
+
+			void Extend(size_t position) noexcept
+			{
+				start = std::min(start, position);
+				end = std::max(end, position);
+			}
+
+			bool Overlaps(const LiveRange& other) const noexcept
+			{
+				return !empty() && !other.empty() && start <= other.end && other.start <= end;
+			}
+		};
+
+		// Computes the variables live on entry and exit of every reachable block, one bit per variable. The blocks are visited
+		// in post-order until no set changes. Phi operands count as used at the end of the predecessor they come from and phi
+		// results as defined at the start of their block. Instructions are numbered in reverse post-order and every variable gets
+		// the hull of the positions it is live at, two variables whose ranges don't overlap are never live at the same time.
 		class LivenessAnalyzer : CFGVisitor<EmptyCFGContext>
 		{
+			bool trackTemps;
+			dense_map<ILVarId, size_t> slots;
+			std::vector<ILVarId> vars;
+			std::vector<size_t> postOrder;
+			std::vector<bool> reachable;
+			std::vector<size_t> blockStarts;
+			std::vector<bit_vector> uses;
+			std::vector<bit_vector> defs;
+			std::vector<bit_vector> phiUses;
+			std::vector<bit_vector> liveIn;
+			std::vector<bit_vector> liveOut;
+			std::vector<LiveRange> ranges;
+			size_t iterations = 0;
+
+			size_t AddSlot(const ILVarId& varId);
+
+			void Visit(size_t index, BasicBlock& node, EmptyCFGContext& context) override {}
+
+			void VisitClose(size_t index, BasicBlock& node, EmptyCFGContext& context) override;
+
+			void ComputeLocalSets();
+
+			void Solve();
+
+			void ComputeRanges();
+
+		public:
+			static constexpr size_t InvalidSlot = std::numeric_limits<size_t>::max();
+
+			// without temps only the named variables get a slot, the ssa builder needs nothing else and the sets stay small.
+			LivenessAnalyzer(ControlFlowGraph& cfg, bool trackTemps = true) : CFGVisitor(cfg), trackTemps(trackTemps)
+			{
+			}
+
+			void Analyze();
+
+			size_t GetVarCount() const noexcept { return vars.size(); }
+
+			size_t GetSlot(const ILVarId& varId) const
+			{
+				auto it = slots.find(varId);
+				return it != slots.end() ? it->second : InvalidSlot;
+			}
+
+			const ILVarId& GetVar(size_t slot) const { return vars[slot]; }
+
+			const std::vector<size_t>& GetPostOrder() const noexcept { return postOrder; }
+
+			bool IsReachable(size_t block) const { return reachable[block]; }
+
+			const bit_vector& GetLiveIn(size_t block) const { return liveIn[block]; }
+
+			const bit_vector& GetLiveOut(size_t block) const { return liveOut[block]; }
+
+			bool IsLiveIn(size_t block, const ILVarId& varId) const
+			{
+				auto slot = GetSlot(varId);
+				return slot != InvalidSlot && liveIn[block].test(slot);
+			}
+
+			bool IsLiveOut(size_t block, const ILVarId& varId) const
+			{
+				auto slot = GetSlot(varId);
+				return slot != InvalidSlot && liveOut[block].test(slot);
+			}
+
+			const LiveRange& GetRange(size_t slot) const { return ranges[slot]; }
+
+			// number of passes over the blocks the fixed point took, the last one changes nothing.
+			size_t GetIterationCount() const noexcept { return iterations; }
 		};
 	}
 }
 
-#endif
\ No newline at end of file
+#endif
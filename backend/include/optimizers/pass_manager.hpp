@@ -0,0 +1,53 @@
+#ifndef PASS_MANAGER_HPP
+#define PASS_MANAGER_HPP
+
+#include "il_optimizer_pass.hpp"
+
+namespace HXSL
+{
+	namespace Backend
+	{
+		enum OptimizationLevel
+		{
+			OptimizationLevel_None, // SSA round trip only.
+			OptimizationLevel_Basic, // folding, simplification and dead code elimination.
+			OptimizationLevel_Full, // the whole pipeline, inlining and loop unrolling.
+		};
+
+		OptimizerPassResult RunOptimizerPass(ILContext* function, ILOptimizerPass& pass);
+
+		// Runs the pipeline of one function to a fixed point. The passes are created once and reused by every Run, so a function
+		// optimized again after inlining or unrolling keeps its buffers. Every pass has a set of blocks changed since it last ran,
+		// block local passes only revisit those and any pass with an empty set is skipped. The dominator tree is only rebuilt
+		// when a pass changed the cfg.
+		class ILPassManager
+		{
+			struct PassState
+			{
+				uptr<ILOptimizerPass> pass;
+				std::vector<bool> dirty;
+				bool pending = false;
+			};
+
+			ILContext* function;
+			std::vector<PassState> passes;
+
+			void MarkAllDirty();
+
+			void MarkDirty(const std::vector<size_t>& blocks);
+
+		public:
+			// same budget the fixed loop had, a round ends early when a pass asks for a rerun.
+			static constexpr size_t MaxRounds = 10;
+
+			ILPassManager(ILContext* function, OptimizationLevel level);
+
+			// returns true if any pass changed the function.
+			bool Run();
+
+			size_t GetPassCount() const noexcept { return passes.size(); }
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef SPARSE_CONDITIONAL_CONSTANT_PROPAGATION_HPP
+#define SPARSE_CONDITIONAL_CONSTANT_PROPAGATION_HPP
+
+#include "il_optimizer_pass.hpp"
+#include "utils/dense_map.hpp"
+#include "utils/dense_set.hpp"
+
+namespace HXSL
+{
+	namespace Backend
+	{
+		// Propagates constants through the SSA form and only along cfg edges that can be taken, so a branch on a constant
+		// condition never merges the values of the dead side into a phi. Both the values and the edges only ever move down
+		// the lattice, the analysis reaches its fixed point in one run. Folded branches, the blocks they cut off and
+		// instructions with a known value are rewritten afterwards.
+		class SparseConditionalConstantPropagation : public ILOptimizerPass
+		{
+			enum LatticeState : char
+			{
+				LatticeState_Unknown, // no executable definition seen yet.
+				LatticeState_Constant,
+				LatticeState_Overdefined,
+			};
+
+			struct LatticeValue
+			{
+				LatticeState state = LatticeState_Unknown;
+				Number value;
+
+				static LatticeValue Constant(const Number& value) { return { LatticeState_Constant, value }; }
+
+				static LatticeValue Overdefined() { return { LatticeState_Overdefined, {} }; }
+
+				bool IsConstant() const noexcept { return state == LatticeState_Constant; }
+
+				bool operator==(const LatticeValue& other) const;
+
+				void Meet(const LatticeValue& other);
+			};
+
+			ControlFlowGraph& cfg;
+			dense_map<ILVarId, LatticeValue> values;
+			dense_map<ILVarId, std::vector<Instruction*>> uses;
+			dense_set<uint64_t> executableEdges;
+			std::vector<bool> executableBlocks;
+			std::vector<size_t> blockWorklist;
+			std::vector<ILVarId> varWorklist;
+
+			static uint64_t EdgeKey(size_t from, size_t to) { return static_cast<uint64_t>(from) << 32 | static_cast<uint64_t>(to); }
+
+			bool IsEdgeExecutable(size_t from, size_t to) const { return executableEdges.contains(EdgeKey(from, to)); }
+
+			LatticeValue GetValue(const Operand* op) const;
+
+			LatticeValue GetValue(const ILVarId& varId) const;
+
+			void SetValue(const ILVarId& varId, const LatticeValue& value);
+
+			void MarkEdge(size_t from, size_t to);
+
+			// the implicit condition of a conditional jump is the result of the instruction right before it.
+			static ResultInstr* GetCondition(JumpInstr& jump);
+
+			// the jump target if the branch is taken, the other successor if it falls through.
+			bool TryGetFallthrough(const BasicBlock& block, JumpInstr& jump, size_t& fallthrough) const;
+
+			void VisitBranch(BasicBlock& block, JumpInstr& jump);
+
+			void VisitInstr(Instruction& instr);
+
+			void VisitBlock(BasicBlock& block);
+
+			void Analyze();
+
+			void FoldBranch(BasicBlock& block);
+
+			void RewriteBlock(BasicBlock& block);
+
+			void RemoveDeadEdges();
+
+		public:
+			SparseConditionalConstantPropagation(ILContext* context) : ILOptimizerPass(context), cfg(context->GetCFG())
+			{
+			}
+
+			std::string GetName() override { return "SparseConditionalConstantPropagation"; }
+
+			OptimizerPassResult Run() override;
+		};
+	}
+}
+
+#endif
@@ -24,7 +24,7 @@ namespace HXSL
 		ControlFlowGraph& cfg;
 
 		std::vector<std::vector<size_t>>& domTreeChildren;
-		std::vector<std::unordered_set<size_t>>& domFront;
+		std::vector<std::vector<size_t>>& domFront;
 		std::unordered_map<uint64_t, std::unordered_set<size_t>> defSites;
 
 		MemorySSABuilder(ILMetadata& metadata, ControlFlowGraph& cfg) : metadata(metadata), CFGVisitor(cfg), cfg(cfg), domTreeChildren(cfg.domTreeChildren), domFront(cfg.domFront)
@@ -10,53 +10,56 @@ namespace HXSL
 	{
 		struct SSACFGContext
 		{
-			std::vector<ILVarId> variables;
+			// size of the rename log when the block was entered.
+			size_t marker = 0;
 		};
 
+		// Builds the SSA form with tables indexed by variable slot instead of hash maps. Named variables take the slots
+		// [0, variables.size()) and temps the ones after, so the slot comes straight from the id. The version stacks of all
+		// variables live in one flat rename log, every definition records the version it replaced and leaving a block in the
+		// dominator tree rolls the log back to the marker taken on entry. Phis are only placed where the variable is live.
 		class SSABuilder : CFGVisitor<SSACFGContext>
 		{
+			struct RenameEntry
+			{
+				uint32_t slot;
+				ILVarId previous;
+			};
+
 			ILContext* context;
 			ILMetadata& metadata;
 
 			std::vector<std::vector<size_t>>& domTreeChildren;
-			std::vector<std::unordered_set<size_t>>& domFront;
+			std::vector<std::vector<size_t>>& domFront;
 
-			std::unordered_map<ILVarId, std::stack<ILVarId>> versionStacks;
-			std::unordered_map<ILVarId, uint32_t> versionCounters;
+			size_t namedCount = 0;
+			std::vector<ILVarId> currentVersions;
+			std::vector<uint32_t> versionCounters;
+			std::vector<RenameEntry> renameLog;
 
-			ILVarId TopVersion(ILVarId varId)
+			uint32_t GetSlot(const ILVarId& varId) const
 			{
-				if (versionStacks[varId].empty())
-				{
-					return varId;
-				}
-
-				return versionStacks[varId].top();
+				return varId.temp() ? static_cast<uint32_t>(namedCount + varId.var.id) : static_cast<uint32_t>(varId.var.id);
 			}
 
-			ILVarId MakeNewVersion(ILVarId varId, bool push = true)
+			ILVarId TopVersion(const ILVarId& varId) const
 			{
-				ILVarId newVersion = varId;
-				newVersion.var.version = ++versionCounters[varId];
-				if (push)
-				{
-					versionStacks[varId].push(newVersion);
-				}
-				return newVersion;
+				return currentVersions[GetSlot(varId)];
 			}
 
-			void PushVersion(ILVarId varId, ILVarId newVersion)
+			ILVarId MakeNewVersion(const ILVarId& varId)
 			{
-				versionStacks[varId].push(newVersion);
-			}
-
-			void PopVersion(ILVarId varId)
-			{
-				versionStacks[varId].pop();
+				auto slot = GetSlot(varId);
+				ILVarId newVersion = varId.WithVersion(++versionCounters[slot]);
+				renameLog.push_back({ slot, currentVersions[slot] });
+				currentVersions[slot] = newVersion;
+				return newVersion;
 			}
 
 			void InsertPhiMeta(BasicBlock& node, ILVarId varId);
 
+			void PlacePhis();
+
 			void Visit(size_t index, BasicBlock& node, SSACFGContext& context) override;
 
 			void VisitClose(size_t index, BasicBlock& node, SSACFGContext& context) override;
@@ -76,4 +79,4 @@ namespace HXSL
 	}
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -2,130 +2,77 @@
 #define SSA_REDUCER_HPP
 
 #include "pch/il.hpp"
+#include "optimizers/liveness_analyzer.hpp"
+#include "utils/dense_set.hpp"
 
 namespace HXSL
 {
 	namespace Backend
 	{
-		class SSAReducer : CFGVisitor<EmptyCFGContext>, ILMutatorBase
+		// Lowers the SSA form back to plain variables. A phi result and its operands share one variable unless they are live at
+		// the same time, only the operands that interfere get a copy on their incoming edge. Afterwards the live ranges of the
+		// remaining variables are packed into as few variables per type as possible, so the final IL has fewer moves and temps.
+		class SSAReducer : ILMutatorBase
 		{
-			std::unordered_map<ILVarId, ILVarId> phiMap;
-			std::unordered_map<ILVarId, ILVarId> varMapping;
-			std::unordered_map<ILVarId, const Instruction*> lastUseIndex;
-			std::unordered_map<ILType, std::queue<ILVarId>> freeTemps;
-			std::unordered_set<ILVarId> seenVars;
+			struct PendingCopy
+			{
+				ILVarId dst;
+				Operand* src;
+			};
 
-			ILVarId nextVarId = SSA_VARIABLE_TEMP_FLAG;
+			ControlFlowGraph& cfg;
 
-			ILVarId GetFinalVarId(ILVarId varId, bool result)
-			{
-				auto type = metadata.GetTempVar(varId).typeId;
-				auto it = freeTemps.find(type);
-				if (it != freeTemps.end())
-				{
-					auto& freeTempsQ = it->second;
-					if (!freeTempsQ.empty())
-					{
-						ILVarId finalId = freeTempsQ.front();
-						freeTempsQ.pop();
-						varMapping[varId] = finalId;
-						return finalId;
-					}
-				}
+			// union-find over the liveness slots, a class ends up as one variable.
+			std::vector<size_t> parents;
+			std::vector<std::vector<size_t>> members;
 
-				ILVarId finalId = metadata.RegTempVar(type).id;
-				varMapping[varId] = finalId;
-				return finalId;
-			}
+			// only pairs where one side is a phi result or operand are tracked, nothing else is ever coalesced.
+			std::vector<bool> phiRelated;
+			dense_set<uint64_t> interferences;
 
-			void Prepare(const Instruction& instr)
-			{
-				for (auto& operand : instr.GetOperands())
-				{
-					if (auto var = dyn_cast<Variable>(operand))
-					{
-						lastUseIndex.insert_or_assign(var->varId, &instr);
-					}
-				}
+			std::unordered_map<ILType, std::vector<ILVarId>> freeTemps;
+			std::unordered_map<ILType, std::vector<ILVarId>> freeVars;
 
-				if (auto res = dyn_cast<ResultInstr>(&instr))
-				{
-					seenVars.insert(res->GetResult() & SSA_VERSION_STRIP_MASK);
-				}
+			static uint64_t PairKey(size_t a, size_t b)
+			{
+				if (a > b) std::swap(a, b);
+				return static_cast<uint64_t>(a) << 32 | static_cast<uint64_t>(b);
 			}
 
-			void RemapVar(ILVarId& varId, Instruction* instr, bool isResult)
+			size_t Find(size_t slot)
 			{
-				if (!IsTempVar(varId)) return;
-
-				ILVarId tmpVarId = varId;
-
-				if (isResult)
-				{
-					varId = GetFinalVarId(tmpVarId, isResult);
-				}
-				else
+				while (parents[slot] != slot)
 				{
-					auto it = varMapping.find(tmpVarId);
-					if (it != varMapping.end())
-					{
-						varId = it->second;
-					}
+					parents[slot] = parents[parents[slot]];
+					slot = parents[slot];
 				}
-
-				if (lastUseIndex[tmpVarId] != instr) return;
-
-				auto id = tmpVarId & SSA_VARIABLE_MASK;
-
-				auto type = metadata.GetTempVar(tmpVarId).typeId;
-
-				MarkAsFree(type, varId);
+				return slot;
 			}
 
-			void MarkAsFree(ILType type, ILVarId varId)
+			void AddInterference(size_t a, size_t b)
 			{
-				auto it = freeTemps.find(type);
-				if (it == freeTemps.end())
+				if (a != b)
 				{
-					std::queue<ILVarId> que;
-					que.push(varId & SSA_VERSION_STRIP_MASK);
-					freeTemps.insert({ type, que });
-				}
-				else
-				{
-					it->second.push(varId & SSA_VERSION_STRIP_MASK);
+					interferences.insert(PairKey(a, b));
 				}
 			}
 
-			void RemapOperand(Operand* op, Instruction* instr, bool isResult)
-			{
-				auto var = dyn_cast<Variable>(op);
-				if (!var) return;
+			void BuildInterference(const LivenessAnalyzer& liveness);
 
-				ILVarId varId = var->varId;
+			bool TryCoalesce(const LivenessAnalyzer& liveness, size_t a, size_t b);
 
-				RemapVar(var->varId, instr, isResult);
-			}
+			void Coalesce(const LivenessAnalyzer& liveness);
 
-			void RemapOperandsAndResult(Instruction& instr)
-			{
-				for (auto& operand : instr.GetOperands())
-				{
-					RemapOperand(operand, &instr, false);
-				}
+			ILVarId GetClassVar(const LivenessAnalyzer& liveness, const ILVarId& varId);
 
-				if (auto res = dyn_cast<ResultInstr>(&instr))
-				{
-					RemapVar(res->GetResult(), &instr, true);
-				}
-			}
+			void EmitCopies(BasicBlock& block, std::vector<PendingCopy>& copies);
+
+			void LowerPhis(const LivenessAnalyzer& liveness);
 
-			void TryClearVersion(ILVarId& op);
-			void TryClearVersion(Operand* op);
-			void Visit(size_t index, BasicBlock& node, EmptyCFGContext& context) override;
+			void AssignVariables();
 
 		public:
-			SSAReducer(ILMetadata& metadata, ControlFlowGraph& cfg) : ILMutatorBase(metadata), CFGVisitor(cfg)
+			SSAReducer(ILMetadata& metadata, ControlFlowGraph& cfg) : ILMutatorBase(metadata), cfg(cfg)
 			{
 			}
 
@@ -134,4 +81,4 @@ namespace HXSL
 	}
 }
 
-#endif
\ No newline at end of file
+#endif
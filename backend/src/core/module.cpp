@@ -42,6 +42,21 @@ namespace HXSL
             return id;
         }
 
+        ModuleWriter::RecordId ModuleWriter::FindRecordId(const Layout* layout) const
+        {
+            if (writtenRecords.find(layout) == writtenRecords.end())
+            {
+                return 0;
+            }
+
+            auto it = recordMap.find(layout);
+            if (it != recordMap.end())
+            {
+                return it->second;
+            }
+            return 0;
+        }
+
         bool ModuleWriter::WriteRecordHeader(const Layout* layout)
         {
             if (!writtenRecords.insert(layout).second)
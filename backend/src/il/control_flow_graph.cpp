@@ -13,6 +13,7 @@ namespace HXSL
 		void ControlFlowGraph::Build(ILContainer& container, JumpTable& jumpTable)
 		{
 			nodes.clear();
+			version++;
 
 			std::unordered_map<Instruction*, size_t> instrToNode;
 			std::unordered_set<Instruction*> blockStarts;
@@ -115,6 +116,7 @@ namespace HXSL
 			LTDominatorTree tree = LTDominatorTree(*this);
 			idom = tree.Compute(0);
 			const size_t n = nodes.size();
+			domTreeVersion = version;
 
 			domTreeChildren.clear();
 			domTreeChildren.resize(n);
@@ -157,33 +159,52 @@ namespace HXSL
 		{
 			auto& block = *nodes[targetBlock];
 
-			for (auto& instr : block)
+			// phi inputs are ordered like the predecessors, this has to run before the predecessor is removed.
+			size_t slot = block.GetPredecessorIndex(removedPred);
+			if (slot == static_cast<size_t>(-1))
 			{
-				auto phi = dyn_cast<PhiInstr>(&instr);
+				return;
+			}
+
+			for (auto it = block.begin(); it != block.end();)
+			{
+				auto phi = dyn_cast<PhiInstr>(&*it);
 				if (!phi) break;
+				++it;
 
 				auto& phiInputs = phi->GetOperands();
-
-				if (removedPred >= phiInputs.size())
+				if (slot >= phiInputs.size())
 					continue;
 
-				if (phiInputs.size() == 1)
+				std::move(phiInputs.begin() + slot + 1, phiInputs.end(), phiInputs.begin() + slot);
+				phiInputs.resize(phiInputs.size() - 1);
+
+				if (phiInputs.size() == 1 && phiInputs[0])
 				{
-					block.ReplaceInstrO<MoveInstr>(&instr, phi->GetResult(), phiInputs[0]);
+					metadata.RemovePhi(phi);
+					block.ReplaceInstrO<MoveInstr>(phi, phi->GetResult(), phiInputs[0]);
 				}
 			}
 		}
 
 		void ControlFlowGraph::Unlink(size_t from, size_t to)
 		{
+			version++;
+			UpdatePhiInputs(from, to);
 			nodes[from]->RemoveSuccessor(to);
 			nodes[to]->RemovePredecessor(from);
-			UpdatePhiInputs(from, to);
 		}
 
 		void ControlFlowGraph::RemoveNode(size_t index)
 		{
+			version++;
 			auto& node = *nodes[index];
+			for (auto& instr : node)
+			{
+				auto phi = dyn_cast<PhiInstr>(&instr);
+				if (!phi) break;
+				metadata.RemovePhi(phi);
+			}
 			for (auto& pred : node.predecessors)
 			{
 				nodes[pred]->RemoveSuccessor(index);
@@ -268,6 +289,39 @@ namespace HXSL
 			RemoveNode(from);
 		}
 
+		size_t ControlFlowGraph::SplitEdge(size_t from, size_t to)
+		{
+			version++;
+			auto index = nodes.size();
+			nodes.emplace_back(make_uptr<BasicBlock>(allocator, index, context, ControlFlowType_Unconditional));
+
+			auto& middle = *nodes[index];
+			auto& fromNode = *nodes[from];
+			auto& toNode = *nodes[to];
+
+			auto succIt = std::find(fromNode.successors.begin(), fromNode.successors.end(), to);
+			*succIt = index;
+			auto predIt = std::find(toNode.predecessors.begin(), toNode.predecessors.end(), from);
+			*predIt = index;
+			middle.predecessors.push_back(from);
+			middle.successors.push_back(to);
+
+			if (!fromNode.instructions.empty())
+			{
+				if (auto jump = dyn_cast<JumpInstr>(&fromNode.instructions.back()))
+				{
+					auto label = jump->GetLabel();
+					if (label->label.value == to)
+					{
+						label->label = ILLabel(index);
+					}
+				}
+			}
+
+			middle.AddInstr(allocator.Alloc<JumpInstr>(allocator, OpCode_Jump, allocator.Alloc<Label>(ILLabel(to))));
+			return index;
+		}
+
 		void ControlFlowGraph::Print() const
 		{
 			auto fn = context->GetFunction();
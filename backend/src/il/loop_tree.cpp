@@ -112,6 +112,7 @@ namespace HXSL
 		void LoopTree::Build()
 		{
 			Clear();
+			cfg.EnsureDomTree();
 
 			auto& cfgNodes = cfg.GetNodes();
 			for (size_t n = 0; n < cfgNodes.size(); n++)
@@ -167,6 +168,8 @@ namespace HXSL
 					}
 				}
 			}
+
+			cfgVersion = cfg.GetVersion();
 		}
 
 		void LoopTree::Print() const
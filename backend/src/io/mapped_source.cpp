@@ -0,0 +1,137 @@
+#include "io/mapped_source.hpp"
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#define HXSL_MAPPED_SOURCE_WIN32 1
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define HXSL_MAPPED_SOURCE_POSIX 1
+#endif
+
+namespace HXSL
+{
+	MappedSource::~MappedSource()
+	{
+		if (!mapping)
+		{
+			return;
+		}
+#if HXSL_MAPPED_SOURCE_WIN32
+		UnmapViewOfFile(mapping);
+#elif HXSL_MAPPED_SOURCE_POSIX
+		munmap(mapping, length);
+#endif
+		mapping = nullptr;
+	}
+
+	static bool ReadWholeFile(const char* path, std::vector<char>& buffer)
+	{
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file)
+		{
+			return false;
+		}
+
+		auto size = file.tellg();
+		if (size < 0)
+		{
+			return false;
+		}
+
+		buffer.resize(static_cast<size_t>(size));
+		file.seekg(0, std::ios::beg);
+		return static_cast<bool>(file.read(buffer.data(), size));
+	}
+
+	std::unique_ptr<MappedSource> MappedSource::Open(const char* path)
+	{
+		std::unique_ptr<MappedSource> source = std::unique_ptr<MappedSource>(new MappedSource());
+		source->path = path;
+
+#if HXSL_MAPPED_SOURCE_WIN32
+		HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return nullptr;
+		}
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size))
+		{
+			CloseHandle(file);
+			return nullptr;
+		}
+
+		if (size.QuadPart != 0)
+		{
+			HANDLE fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (fileMapping)
+			{
+				source->mapping = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+				CloseHandle(fileMapping);
+			}
+		}
+		CloseHandle(file);
+
+		if (source->mapping)
+		{
+			source->data = static_cast<const char*>(source->mapping);
+			source->length = static_cast<size_t>(size.QuadPart);
+			return source;
+		}
+#elif HXSL_MAPPED_SOURCE_POSIX
+		int fd = open(path, O_RDONLY);
+		if (fd < 0)
+		{
+			return nullptr;
+		}
+
+		struct stat info;
+		if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+		{
+			close(fd);
+			return nullptr;
+		}
+
+		size_t size = static_cast<size_t>(info.st_size);
+		if (size != 0)
+		{
+			void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (view != MAP_FAILED)
+			{
+#ifdef POSIX_MADV_SEQUENTIAL
+				posix_madvise(view, size, POSIX_MADV_SEQUENTIAL);
+#endif
+				source->mapping = view;
+			}
+		}
+		close(fd);
+
+		if (source->mapping)
+		{
+			source->data = static_cast<const char*>(source->mapping);
+			source->length = size;
+			return source;
+		}
+#endif
+
+		// empty files can't be mapped, other failures fall back to a plain read.
+		if (!ReadWholeFile(path, source->fallback))
+		{
+			return nullptr;
+		}
+
+		source->data = source->fallback.data();
+		source->length = source->fallback.size();
+		return source;
+	}
+}
\ No newline at end of file
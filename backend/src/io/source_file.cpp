@@ -4,6 +4,10 @@ namespace HXSL
 {
 	bool SourceFile::PrepareInputStream()
 	{
+		if (mappedSource)
+		{
+			return true;
+		}
 		return inputStream->CopyFrom(*stream);
 	}
 
@@ -15,6 +19,10 @@ namespace HXSL
 	void SourceFile::SetInputStream(std::unique_ptr<TextStream>&& value) noexcept
 	{
 		inputStream = std::move(value);
+		if (inputStream && !inputStream->IsView())
+		{
+			mappedSource.reset();
+		}
 	}
 
 	std::string SourceFile::GetString(size_t start, size_t length) const
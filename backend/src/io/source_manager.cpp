@@ -0,0 +1,45 @@
+#include "io/source_manager.hpp"
+
+namespace HXSL
+{
+	SourceFile* SourceManager::Insert(std::unique_ptr<SourceFile>&& file)
+	{
+		size_t id = files.size(); // local index, firstID is only added to the ids handed out.
+		HXSL_ASSERT(id < MaxChunks * ChunkSize, "Too many source files.");
+
+		auto& chunk = chunks[id >> ChunkShift];
+		auto slots = chunk.load(std::memory_order_relaxed);
+		if (!slots)
+		{
+			chunkStorage.push_back(std::make_unique<SourceFile*[]>(ChunkSize));
+			slots = chunkStorage.back().get();
+			chunk.store(slots, std::memory_order_release);
+		}
+
+		// readers only ask for ids they got back from AddSource, the slot itself needs no ordering.
+		auto result = file.get();
+		slots[id & (ChunkSize - 1)] = result;
+		files.push_back(std::move(file));
+		return result;
+	}
+
+	void SourceManager::Adopt(SourceManager& child)
+	{
+		HXSL_ASSERT(child.parent == this, "Only staged sources of a child manager can be adopted.");
+		std::lock_guard<std::mutex> childGuard(child.lock);
+		std::lock_guard<std::mutex> guard(lock);
+		for (auto& file : child.files)
+		{
+			file->srcManager = this;
+			file->id = NextID();
+			Insert(std::move(file));
+		}
+
+		child.files.clear();
+		for (auto& chunk : child.chunks)
+		{
+			chunk.store(nullptr, std::memory_order_relaxed);
+		}
+		child.chunkStorage.clear();
+	}
+}
\ No newline at end of file
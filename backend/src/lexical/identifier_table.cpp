@@ -0,0 +1,113 @@
+#include "lexical/identifier_table.hpp"
+
+namespace HXSL
+{
+	IdentifierInfo* IdentifierTable::Shard::Find(const StringSpan& name, size_t hash) const noexcept
+	{
+		auto current = table.load(std::memory_order_acquire);
+		if (!current)
+		{
+			return nullptr;
+		}
+
+		size_t index = hash & current->mask;
+		while (true)
+		{
+			auto& slot = current->slots[index];
+			auto info = slot.info.load(std::memory_order_acquire);
+			if (!info)
+			{
+				return nullptr;
+			}
+
+			if (slot.hash.load(std::memory_order_relaxed) == hash && info->name == name)
+			{
+				return info;
+			}
+
+			index = (index + 1) & current->mask;
+		}
+	}
+
+	IdentifierTable::SlotTable* IdentifierTable::Shard::CreateTable(size_t capacity)
+	{
+		auto newTable = allocator.Alloc<SlotTable>();
+		newTable->mask = capacity - 1;
+		newTable->slots = reinterpret_cast<Slot*>(allocator.Alloc(sizeof(Slot) * capacity, alignof(Slot)));
+		for (size_t i = 0; i < capacity; i++)
+		{
+			new (&newTable->slots[i]) Slot{};
+		}
+		return newTable;
+	}
+
+	static void InsertSlot(std::atomic<size_t>& slotHash, std::atomic<IdentifierInfo*>& slotInfo, size_t hash, IdentifierInfo* info)
+	{
+		// The hash has to be visible before the info pointer publishes the slot.
+		slotHash.store(hash, std::memory_order_relaxed);
+		slotInfo.store(info, std::memory_order_release);
+	}
+
+	IdentifierInfo* IdentifierTable::Shard::Insert(const StringSpan& name, size_t hash)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+
+		// Another thread might have inserted the name between the lock-free probe and taking the lock.
+		if (auto info = Find(name, hash))
+		{
+			return info;
+		}
+
+		auto current = table.load(std::memory_order_relaxed);
+		if (!current || (count + 1) * 2 > current->mask + 1)
+		{
+			auto grown = CreateTable(current ? (current->mask + 1) * 2 : InitialCapacity);
+			if (current)
+			{
+				for (size_t i = 0; i <= current->mask; i++)
+				{
+					auto& slot = current->slots[i];
+					auto info = slot.info.load(std::memory_order_relaxed);
+					if (!info) continue;
+					size_t slotHash = slot.hash.load(std::memory_order_relaxed);
+					size_t index = slotHash & grown->mask;
+					while (grown->slots[index].info.load(std::memory_order_relaxed))
+					{
+						index = (index + 1) & grown->mask;
+					}
+					InsertSlot(grown->slots[index].hash, grown->slots[index].info, slotHash, info);
+				}
+			}
+			table.store(grown, std::memory_order_release);
+			current = grown;
+		}
+
+		auto info = allocator.Alloc<IdentifierInfo>();
+		auto p = reinterpret_cast<char*>(allocator.Alloc((name.size() + 1) * sizeof(char), alignof(char)));
+		std::memcpy(p, name.data(), name.size() * sizeof(char));
+		p[name.size()] = '\0';
+		info->name = StringSpan(p, name.size());
+		info->hashCode = hash;
+
+		size_t index = hash & current->mask;
+		while (current->slots[index].info.load(std::memory_order_relaxed))
+		{
+			index = (index + 1) & current->mask;
+		}
+		InsertSlot(current->slots[index].hash, current->slots[index].info, hash, info);
+		count++;
+
+		return info;
+	}
+
+	size_t IdentifierTable::Size() const noexcept
+	{
+		size_t size = 0;
+		for (auto& shard : shards)
+		{
+			std::lock_guard<std::mutex> guard(shard.lock);
+			size += shard.count;
+		}
+		return size;
+	}
+}
@@ -6,7 +6,7 @@ namespace HXSL
 	DiagnosticCode::GetStringForCode DiagnosticCode::getStringForCode;
 	DiagnosticCode::EncodeDiagnosticCode DiagnosticCode::encodeDiagnosticCode;
 
-	std::string DiagnosticCode::GetMessage() const
+	StringSpan DiagnosticCode::GetMessage() const
 	{
 		return getMessageForCode(value);
 	}
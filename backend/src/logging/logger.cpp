@@ -3,99 +3,184 @@
 
 namespace HXSL
 {
-	static int64_t BinarySearch(const std::vector<DiagnosticSuppressionRange>& ranges, size_t idx)
+	std::string DiagnosticRecord::Render() const
 	{
-		int64_t low = 0;
-		int64_t high = (int64_t)ranges.size() - 1;
+		std::string message;
+		if (format)
+		{
+			std::string formatFinal = isDiagnostic ? code.GetMessage().str() + format : std::string(format);
+			message = fmt::vformat(fmt::string_view(formatFinal), *args);
+		}
+		else
+		{
+			message = text;
+		}
 
-		while (low <= high)
+		if (count > 1)
 		{
-			int64_t mid = low + (high - low) / 2;
-			const auto& m = ranges[mid];
+			message += " (x" + std::to_string(count) + ")";
+		}
 
-			if (idx >= m.start && idx < m.end)
-			{
-				return mid;
-			}
-			else if (idx < m.start)
-			{
-				high = mid - 1;
-			}
-			else
-			{
-				low = mid + 1;
-			}
+		if (isDiagnostic)
+		{
+			return code.GetCodeString() + ": " + message;
 		}
 
-		return ~low;
+		return message;
+	}
+
+	bool ILogger::IsSuppressed(DiagnosticCode code, size_t location) const
+	{
+		return suppressionRanges.AnyContaining(location, [&](const DiagnosticCode& suppressed) { return suppressed == code; });
 	}
 
 	void ILogger::AddDiagnosticSuppressionRange(const DiagnosticSuppressionRange& range)
 	{
-		auto idx = BinarySearch(suppressionRanges, range.start);
-		if (idx < 0)
+		if (deferred)
 		{
-			idx = ~idx;
+			DiagnosticRecord record;
+			record.code = range.code;
+			record.location = range.start;
+			deferredEvents.push_back({ DeferredEvent::Type_Suppression, std::move(record), range.end });
 		}
-		auto copy = range;
-		suppressionRanges.insert(suppressionRanges.begin() + idx, copy);
+
+		suppressionRanges.Insert(Interval<size_t>(range.start, range.end), range.code);
 	}
 
-	void ILogger::Log(LogLevel level, const std::string& message)
+	const std::vector<LogMessage>& ILogger::GetMessages() const
 	{
-		messages.push_back(std::move(LogMessage(level, message)));
+		for (auto i : staleMessages)
+		{
+			messages[i] = LogMessage(records[i].level, records[i].Render());
+			renderedCounts[i] = records[i].count;
+		}
+		staleMessages.clear();
 
-		if (EnableErrorOutput)
+		for (size_t i = messages.size(); i < records.size(); ++i)
 		{
-			std::cerr << "[" << ToString(level) << "]: " << message << std::endl;
+			messages.push_back(LogMessage(records[i].level, records[i].Render()));
+			renderedCounts.push_back(records[i].count);
 		}
+		return messages;
+	}
 
-		if (level == LogLevel_Critical)
+	void ILogger::Submit(DiagnosticRecord&& record, bool suppressed)
+	{
+		if (deferred)
 		{
-			hasCriticalErrors = true;
-			HXSL_ASSERT(false, message.c_str());
+			deferredEvents.push_back({ DeferredEvent::Type_Record, record, 0 });
 		}
-		else if (level == LogLevel_Error)
+
+		if (!suppressed)
 		{
-			errorCount++;
-			if (errorCount >= 100)
-			{
-				Log(LogLevel_Critical, "Too many errors encountered, stopping compilation!");
-			}
+			Emit(std::move(record));
 		}
 	}
 
-	void ILogger::Log(DiagnosticCode code, size_t location, const std::string& message)
+	void ILogger::Emit(DiagnosticRecord&& record)
 	{
-		auto idx = BinarySearch(suppressionRanges, location);
-		if (idx >= 0 && suppressionRanges[idx].code == code)
+		LogLevel level = record.level;
+		DiagnosticSite site = { record.code.value, record.location };
+		if (deduplicate && record.isDiagnostic)
 		{
-			return;
+			auto it = sites.find(site);
+			if (it != sites.end())
+			{
+				// an already rendered message is queued once, GetMessages renders it again with the final count.
+				auto index = it->second;
+				if (index < messages.size() && renderedCounts[index] == records[index].count)
+				{
+					staleMessages.push_back(index);
+				}
+				records[index].count++;
+				return;
+			}
 		}
 
-		auto level = code.GetLogLevel();
-
-		auto fullMessage = code.GetCodeString() + ": " + message;
-
-		messages.push_back(std::move(LogMessage(level, fullMessage)));
-
-		if (EnableErrorOutput)
+		if (maxRecords != 0 && records.size() >= maxRecords && level != LogLevel_Critical)
 		{
-			std::cerr << "[" << ToString(level) << "] " << fullMessage << std::endl;
+			droppedCount++;
+		}
+		else
+		{
+			if (EnableErrorOutput && !deferred)
+			{
+				std::cerr << "[" << ToString(level) << "]" << (record.isDiagnostic ? " " : ": ") << record.Render() << std::endl;
+			}
+
+			if (deduplicate && record.isDiagnostic)
+			{
+				sites.insert({ site, records.size() });
+			}
+			records.push_back(std::move(record));
 		}
 
 		if (level == LogLevel_Critical)
 		{
 			hasCriticalErrors = true;
-			HXSL_ASSERT(false, fullMessage.c_str());
+			std::string message = records.back().Render();
+			HXSL_ASSERT(false, message.c_str());
 		}
 		else if (level == LogLevel_Error)
 		{
 			errorCount++;
 			if (errorCount >= 100)
 			{
-				Log(LogLevel_Critical, "Too many errors encountered, stopping compilation!");
+				DiagnosticRecord limit;
+				limit.level = LogLevel_Critical;
+				limit.text = "Too many errors encountered, stopping compilation!";
+				Emit(std::move(limit));
+			}
+		}
+	}
+
+	void ILogger::Log(LogLevel level, const std::string& message)
+	{
+		DiagnosticRecord record;
+		record.level = level;
+		record.text = message;
+		Submit(std::move(record), false);
+	}
+
+	void ILogger::Log(DiagnosticCode code, size_t location, const std::string& message)
+	{
+		DiagnosticRecord record;
+		record.level = code.GetLogLevel();
+		record.isDiagnostic = true;
+		record.code = code;
+		record.location = location;
+		record.text = message;
+		Submit(std::move(record), IsSuppressed(code, location));
+	}
+
+	void ILogger::Replay(const ILogger& deferredLogger)
+	{
+		Replay(deferredLogger, 0, deferredLogger.deferredEvents.size());
+	}
+
+	void ILogger::Replay(const ILogger& deferredLogger, size_t begin, size_t end)
+	{
+		end = std::min(end, deferredLogger.deferredEvents.size());
+		for (size_t i = begin; i < end; ++i)
+		{
+			auto& event = deferredLogger.deferredEvents[i];
+			if (hasCriticalErrors)
+			{
+				break;
+			}
+
+			switch (event.type)
+			{
+			case DeferredEvent::Type_Record:
+			{
+				auto& record = event.record;
+				Submit(DiagnosticRecord(record), record.isDiagnostic && IsSuppressed(record.code, record.location));
+			}
+			break;
+			case DeferredEvent::Type_Suppression:
+				AddDiagnosticSuppressionRange(DiagnosticSuppressionRange(event.record.code, event.record.location, event.end));
+				break;
 			}
 		}
 	}
-}
\ No newline at end of file
+}
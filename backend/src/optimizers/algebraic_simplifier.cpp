@@ -38,6 +38,11 @@ namespace HXSL
 
     void AlgebraicSimplifier::Visit(size_t index, BasicBlock& node, EmptyCFGContext& ctx)
     {
+        if (!IsDirty(index))
+        {
+            return;
+        }
+
         for (auto& instr : node)
         {
             switch (instr.GetOpCode())
@@ -47,17 +52,17 @@ namespace HXSL
                 auto& in = *cast<BinaryInstr>(&instr);
                 if (IsZero(in.GetLHS()) || IsZero(in.GetRHS()))
                 {
-                    ConvertMoveZero(context, in); changed = true;
+                    ConvertMoveZero(context, in); MarkChanged(node);
                 }
 
                 if (IsOne(in.GetLHS()))
                 {
-                    ConvertMoveRight(in); changed = true;
+                    ConvertMoveRight(in); MarkChanged(node);
                 }
 
                 if (IsOne(in.GetRHS()))
                 {
-                    ConvertMoveLeft(in); changed = true;
+                    ConvertMoveLeft(in); MarkChanged(node);
                 }
             }
             break;
@@ -66,24 +71,24 @@ namespace HXSL
                 auto& in = *cast<BinaryInstr>(&instr);
                 if (IsZero(in.GetLHS()))
                 {
-                    ConvertMoveZero(context, in); changed = true;
+                    ConvertMoveZero(context, in); MarkChanged(node);
                 }
                 if (IsZero(in.GetRHS()))
                 {
                     // TODO: add warning or error.
                     //instr.opcode = OpCode_Move;
                     //instr.GetRHS() = {};
-                    changed = true;
+                    MarkChanged(node);
                 }
 
                 if (IsOne(in.GetRHS()))
                 {
-                    ConvertMoveLeft(in); changed = true;
+                    ConvertMoveLeft(in); MarkChanged(node);
                 }
 
                 if (in.GetLHS() == in.GetRHS())
                 {
-                    ConvertMoveImm(context, in, Number(1)); changed = true;
+                    ConvertMoveImm(context, in, Number(1)); MarkChanged(node);
                 }
             }
             break;
@@ -92,15 +97,15 @@ namespace HXSL
                 auto& in = *cast<BinaryInstr>(&instr);
                 if (IsZero(in.GetLHS()))
                 {
-                    ConvertMoveRight(in); changed = true;
+                    ConvertMoveRight(in); MarkChanged(node);
                 }
                 if (IsZero(in.GetRHS()))
                 {
-                    ConvertMoveLeft(in); changed = true;
+                    ConvertMoveLeft(in); MarkChanged(node);
                 }
                 if (in.GetLHS() == in.GetRHS())
                 {
-                    ConvertMoveZero(context, in); changed = true;
+                    ConvertMoveZero(context, in); MarkChanged(node);
                 }
             }
             break;
@@ -109,17 +114,17 @@ namespace HXSL
                 auto& in = *cast<BinaryInstr>(&instr);
                 if (IsZero(in.GetLHS()))
                 {
-                    ConvertMoveRight(in); changed = true;
+                    ConvertMoveRight(in); MarkChanged(node);
                 }
                 else if (IsZero(in.GetRHS()))
                 {
-                    ConvertMoveLeft(in); changed = true;
+                    ConvertMoveLeft(in); MarkChanged(node);
                 }
                 else if (equals(in.GetLHS(), in.GetRHS()))
                 {
 					in.OverwriteOpCode(OpCode_Multiply);
 					in.GetRHS() = context->MakeConstant(Cast(in, in.GetResult(), Number(2)));
-					changed = true;
+					MarkChanged(node);
                 }
             }
             break;
@@ -128,7 +133,7 @@ namespace HXSL
                     auto& in = *cast<BinaryInstr>(&instr);
                     if (IsZero(in.GetLHS()))
                     {
-                        ConvertMoveZero(context, in); changed = true;
+                        ConvertMoveZero(context, in); MarkChanged(node);
                     }
                 }
                 break;
@@ -137,7 +142,7 @@ namespace HXSL
                     auto& in = *cast<BinaryInstr>(&instr);
                     if (IsZero(in.GetRHS()))
                     {
-                        ConvertMoveZero(context, in); changed = true;
+                        ConvertMoveZero(context, in); MarkChanged(node);
                     }
                 }
                 break;
@@ -146,7 +151,7 @@ namespace HXSL
                     auto& in = *cast<BinaryInstr>(&instr);
                     if (IsZero(in.GetRHS()))
                     {
-                        ConvertMoveLeft(in); changed = true;
+                        ConvertMoveLeft(in); MarkChanged(node);
                     }
                 }
                 break;
@@ -155,12 +160,12 @@ namespace HXSL
                     auto& in = *cast<BinaryInstr>(&instr);
                     if (IsZero(in.GetRHS()))
                     {
-                        ConvertMoveLeft(in); changed = true;
+                        ConvertMoveLeft(in); MarkChanged(node);
                     }
 
                     if (in.GetLHS() == in.GetRHS())
                     {
-                        ConvertMoveZero(context, in); changed = true;
+                        ConvertMoveZero(context, in); MarkChanged(node);
                     }
                 }
                 break;
@@ -171,11 +176,11 @@ namespace HXSL
                     if (!immR) break;
                     if (immR->imm().ToBool())
                     {
-                        ConvertMoveLeft(in); changed = true;
+                        ConvertMoveLeft(in); MarkChanged(node);
                     }
                     else
                     {
-                        changed = true;
+                        MarkChanged(node);
 
                         bool condition = false;
                         if (instr.GetNext())
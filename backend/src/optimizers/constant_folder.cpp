@@ -10,30 +10,35 @@ namespace HXSL
 			return isa<JumpInstr>(instruction.GetNext());
 		}
 
-		void ConstantFolder::TryFoldOperand(Operand*& op)
+		void ConstantFolder::TryFoldOperand(BasicBlock& node, Operand*& op)
 		{
 			if (auto var = dyn_cast<Variable>(op))
 			{
 				auto it = constants.find(var->varId);
 				if (it != constants.end())
 				{
-					op = context->MakeConstant(it->second); changed = true;
+					op = context->MakeConstant(it->second); MarkChanged(node);
 				}
 				auto itr = varToVar.find(var->varId);
 				if (itr != varToVar.end())
 				{
-					op = context->MakeVariable(itr->second); changed = true;
+					op = context->MakeVariable(itr->second); MarkChanged(node);
 				}
 			}
 		}
 
 		void ConstantFolder::Visit(size_t index, BasicBlock& node, EmptyCFGContext& ctx)
 		{
+			if (!IsDirty(index))
+			{
+				return;
+			}
+
 			for (auto& instr : node)
 			{
 				for (Operand*& operand : instr.GetOperands())
 				{
-					TryFoldOperand(operand);
+					TryFoldOperand(node, operand);
 				}
 
 				switch (instr.GetOpCode())
@@ -66,6 +71,7 @@ namespace HXSL
 					{
 						node.ReplaceInstrO<MoveInstr>(&instr, in.GetResult(), Cast(instr, in.GetResult(), immL->imm()));
 						constants.insert({ in.GetResult(), immL->imm() });
+						MarkChanged(node);
 					}
 				}
 
@@ -110,6 +116,7 @@ namespace HXSL
 						}
 						constants.insert({ res->GetResult(), imm });
 						node.ReplaceInstrO<MoveInstr>(&instr, res->GetResult(), context->MakeConstant(imm));
+						MarkChanged(node);
 					}
 				}
 				break;
@@ -174,6 +181,7 @@ namespace HXSL
 								Number total = FoldImm(lhs, rhs, fuseMulDiv ? OpCode_Divide : binary.GetOpCode());
 								auto opcode = fuseMulDiv ? OpCode_Multiply : defInstr.GetOpCode();
 								node.ReplaceInstr<BinaryInstr>(&instr, opcode, binary.GetResult(), base, total);
+								MarkChanged(node);
 								continue;
 							}
 						}
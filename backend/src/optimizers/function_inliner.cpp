@@ -241,7 +241,47 @@ namespace HXSL
 			block->RemoveInstr(site);
 		}
 
-		dense_set<FunctionLayout*> FunctionInliner::Inline(const Span<FunctionLayout*> functions)
+		bool FunctionInliner::InlineCallees(const FuncCallGraph& callGraph, size_t callerNode)
+		{
+			static constexpr float MaxCost = 2.0f;
+			auto& nodes = callGraph.GetNodes();
+			auto* callerLayout = nodes[callerNode]->GetFunction();
+			auto* caller = callerLayout->GetContext();
+			auto& metadata = caller->metadata;
+			size_t callerScc = nodes[callerNode]->GetSCCIndex();
+
+			bool inlined = false;
+			for (auto& call : metadata.functions)
+			{
+				auto* calleeLayout = call->func;
+				size_t calleeNode = callGraph.GetIndex(calleeLayout);
+				size_t calleeScc = nodes[calleeNode]->GetSCCIndex();
+
+				if (callerScc == calleeScc)
+				{
+					continue;
+				}
+
+				float inlineCost = callGraph.GetNode(calleeLayout)->GetInlineCost();
+				if (inlineCost > MaxCost)
+				{
+					continue;
+				}
+
+				InlineAtAllSites(callerLayout, calleeLayout, call->callSites);
+				caller->metadata.RemoveFunc(call);
+
+#if HXSL_DEBUG
+				std::cout << "Inliner:" << std::endl;
+				caller->cfg.Print();
+#endif
+				inlined = true;
+			}
+
+			return inlined;
+		}
+
+		std::vector<FunctionLayout*> FunctionInliner::Inline(const Span<FunctionLayout*> functions, ThreadPool& pool)
 		{
 			FuncCallGraph callGraph = FuncCallGraph();
 
@@ -249,8 +289,7 @@ namespace HXSL
 			{
 				auto function = functionLayout->GetContext();
 				if (function->empty()) continue;
-				auto* node = callGraph.AddFunction(functionLayout);
-				node->SetInlineCost(ComputeInlineCost(functionLayout));
+				callGraph.AddFunction(functionLayout);
 			}
 
 			for (auto& functionLayout : functions)
@@ -264,9 +303,16 @@ namespace HXSL
 				}
 			}
 
+			auto& nodes = callGraph.GetNodes();
+
+			// every cost is taken before anything gets inlined, so it doesn't depend on the order callers finish in.
+			pool.ParallelFor(nodes.size(), [&](size_t i)
+				{
+					nodes[i]->SetInlineCost(ComputeInlineCost(nodes[i]->GetFunction()));
+				});
+
 			callGraph.UpdateSCCs();
 
-			auto& nodes = callGraph.GetNodes();
 			auto& sccs = callGraph.GetSCCs();
 
 			DAGGraph<size_t> sccGraph = DAGGraph<size_t>();
@@ -291,44 +337,48 @@ namespace HXSL
 
 			std::vector<size_t> sccOrder = sccGraph.TopologicalSort(true); // true == bottom-up order
 
-			dense_set<FunctionLayout*> dirtyFunctions;
-			static constexpr float MaxCost = 2.0f;
-			for (auto callerScc : sccOrder)
+			// an SCC sits one level above the highest SCC it calls into. Callers only read callees of lower levels, so the
+			// SCCs of one level can be inlined into at the same time and each level sees its callees fully inlined.
+			std::vector<size_t> sccLevels(sccs.size(), 0);
+			std::vector<std::vector<size_t>> levels;
+			for (auto scc : sccOrder)
 			{
-				for (size_t callerNode : sccs[callerScc])
+				size_t level = 0;
+				for (size_t u : sccs[scc])
 				{
-					auto* callerLayout = nodes[callerNode]->GetFunction();
-					auto* caller = callerLayout->GetContext();
-					auto& metadata = caller->metadata;
-					if (caller->empty()) continue;
-
-					for (auto& call : metadata.functions)
+					for (size_t v : nodes[u]->GetDependencies())
 					{
-						auto* calleeLayout = call->func;
-						size_t calleeNode = callGraph.GetIndex(calleeLayout);
-						size_t calleeScc = nodes[calleeNode]->GetSCCIndex();
-
-						if (callerScc == calleeScc)
+						size_t sv = nodes[v]->GetSCCIndex();
+						if (sv != scc)
 						{
-							continue;
+							level = std::max(level, sccLevels[sv] + 1);
 						}
+					}
+				}
 
-						auto* callee = calleeLayout->GetContext();
-						float inlineCost = callGraph.GetNode(calleeLayout)->GetInlineCost();
-						if (inlineCost > MaxCost)
-						{
-							continue;
-						}
+				sccLevels[scc] = level;
+				if (levels.size() <= level)
+				{
+					levels.resize(level + 1);
+				}
+				levels[level].insert(levels[level].end(), sccs[scc].begin(), sccs[scc].end());
+			}
 
-						InlineAtAllSites(callerLayout, calleeLayout, call->callSites);
-						caller->metadata.RemoveFunc(call);
+			std::vector<char> dirty(nodes.size(), false);
+			for (auto& level : levels)
+			{
+				pool.ParallelFor(level.size(), [&](size_t i)
+					{
+						dirty[level[i]] = InlineCallees(callGraph, level[i]);
+					});
+			}
 
-#if HXSL_DEBUG
-						std::cout << "Inliner:" << std::endl;
-						caller->cfg.Print();
-#endif
-						dirtyFunctions.insert(callerLayout);
-					}
+			std::vector<FunctionLayout*> dirtyFunctions;
+			for (size_t i = 0; i < nodes.size(); ++i)
+			{
+				if (dirty[i])
+				{
+					dirtyFunctions.push_back(nodes[i]->GetFunction());
 				}
 			}
 
@@ -4,14 +4,14 @@ namespace HXSL
 {
 	namespace Backend
 	{
-		void GlobalValueNumbering::TryMapOperand(Operand*& op)
+		void GlobalValueNumbering::TryMapOperand(BasicBlock& node, Operand*& op)
 		{
 			if (auto var = dyn_cast<Variable>(op))
 			{
 				auto it = map.find(var->varId);
 				if (it != map.end())
 				{
-					op = context->MakeVariable(it->second); changed = true;
+					op = context->MakeVariable(it->second); MarkChanged(node);
 				}
 			}
 		}
@@ -22,7 +22,7 @@ namespace HXSL
 			{
 				for (auto& operand : instr.GetOperands())
 				{
-					TryMapOperand(operand);
+					TryMapOperand(node, operand);
 				}
 
 				auto opcode = instr.GetOpCode();
@@ -2,14 +2,7 @@
 
 #include "ssa/ssa_builder.hpp"
 #include "ssa/ssa_reducer.hpp"
-#include "optimizers/il_optimizer_pass.hpp"
-
-#include "optimizers/constant_folder.hpp"
-#include "optimizers/algebraic_simplifier.hpp"
-#include "optimizers/reassociation_pass.hpp"
-#include "optimizers/strength_reduction.hpp"
-#include "optimizers/global_value_numbering.hpp"
-#include "optimizers/dead_code_eliminator.hpp"
+
 #include "optimizers/function_inliner.hpp"
 #include "optimizers/loop_unroller.hpp"
 #include "il/func_call_graph.hpp"
@@ -17,12 +10,26 @@
 #include "il/dag_graph.hpp"
 #include "il/rpo_merger.hpp"
 #include "il/il_code_blob.hpp"
-#include "utils/scoped_timer.hpp"
+#include "utils/profiler.hpp"
 
 namespace HXSL
 {
 	namespace Backend
 	{
+		ILPassManager& ILOptimizer::GetPassManager(ILContext* function)
+		{
+			auto it = passManagers.find(function);
+			if (it != passManagers.end())
+			{
+				return *it->second;
+			}
+
+			auto manager = make_uptr<ILPassManager>(function, level);
+			auto& result = *manager;
+			passManagers.insert({ function, std::move(manager) });
+			return result;
+		}
+
 		void ILOptimizer::OptimizeFunctions(const Span<FunctionLayout*>& functions)
 		{
 			for (auto& functionLayout : functions)
@@ -33,146 +40,139 @@ namespace HXSL
 
 		void ILOptimizer::Optimize()
 		{
-			auto& functions = module->GetAllFunctions();
+			auto& allFunctions = module->GetAllFunctions();
 
-			for (auto& functionLayout : functions)
+			std::vector<FunctionLayout*> functions;
+			for (auto& functionLayout : allFunctions)
 			{
 				auto function = functionLayout->GetContext();
-				auto& cfg = function->cfg;
-				auto& metadata = function->metadata;
-
 				if (function->empty() || function->IsExtern()) continue;
+				functions.push_back(functionLayout);
+			}
 
-				SSABuilder ssaBuilder = SSABuilder(function);
-				ssaBuilder.Build();
+			// the map and the module allocator aren't thread safe, everything shared is set up before the workers start.
+			std::vector<ILCodeBlob*> blobs;
+			auto& alloc = module->GetAllocator();
+			for (auto& functionLayout : functions)
+			{
+				GetPassManager(functionLayout->GetContext());
+				blobs.push_back(alloc.Alloc<ILCodeBlob>());
+			}
 
 #if HXSL_DEBUG
-				std::cout << "Converted IL to SSA:" << std::endl;
-				cfg.Print();
+			// keeps the dumps readable.
+			size_t threads = 1;
+#else
+			size_t threads = std::min(threadCount, std::max<size_t>(functions.size(), 1));
 #endif
+			ThreadPool pool = ThreadPool(threads);
 
-				Optimize(function);
-			}
+			pool.ParallelFor(functions.size(), [&](size_t i)
+				{
+					auto functionLayout = functions[i];
+					auto function = functionLayout->GetContext();
+					auto& cfg = function->cfg;
+
+					{
+						PROFILE_SCOPE_DETAIL("SSA Build", functionLayout->GetName().str());
+						cfg.EnsureDomTree();
+						SSABuilder ssaBuilder = SSABuilder(function);
+						ssaBuilder.Build();
+					}
+
+#if HXSL_DEBUG
+					std::cout << "Converted IL to SSA:" << std::endl;
+					cfg.Print();
+#endif
+
+					Optimize(function);
+				});
 
 			FunctionInliner inliner = FunctionInliner();
-			for (size_t i = 0; i < 10; ++i)
+			size_t inlineRounds = level == OptimizationLevel_Full ? 10 : 0;
+			for (size_t i = 0; i < inlineRounds; ++i)
 			{	
-				auto inlined = inliner.Inline(functions);
+				std::vector<FunctionLayout*> inlined;
+				{
+					PROFILE_SCOPE("Function Inliner");
+					inlined = inliner.Inline(allFunctions, pool);
+				}
 				if (inlined.empty())
 				{
 					break;
 				}
 				for (auto& funcLayout : inlined)
 				{
-					Optimize(funcLayout->GetContext());
+					GetPassManager(funcLayout->GetContext());
 				}
+				pool.ParallelFor(inlined.size(), [&](size_t j)
+					{
+						Optimize(inlined[j]->GetContext());
+					});
 			}
 
-			for (auto& functionLayout : functions)
+			if (level == OptimizationLevel_Full)
 			{
-				auto function = functionLayout->GetContext();
-				auto& cfg = function->cfg;
-				auto& metadata = function->metadata;
-				if (function->empty() || function->IsExtern()) continue;
-
-				auto& loopTree = function->loopTree;
-				loopTree.Build();
+				pool.ParallelFor(functions.size(), [&](size_t i)
+					{
+						auto function = functions[i]->GetContext();
+						auto& cfg = function->cfg;
+						auto& loopTree = function->loopTree;
+						loopTree.Ensure();
 #if HXSL_DEBUG
-				std::cout << "Loop Tree:" << std::endl;
-				loopTree.Print();
+						std::cout << "Loop Tree:" << std::endl;
+						loopTree.Print();
 #endif
-				LoopUnroller unroller = LoopUnroller(function);
-				auto result = unroller.Run();
-				if (result == OptimizerPassResult_Changed)
-				{
+						LoopUnroller unroller = LoopUnroller(function);
+						auto result = RunOptimizerPass(function, unroller);
+						if (result == OptimizerPassResult_Changed)
+						{
 #if HXSL_DEBUG
-					std::cout << "After Loop Unrolling:" << std::endl;
-					cfg.Print();
+							std::cout << "After Loop Unrolling:" << std::endl;
+							cfg.Print();
 #endif
-					Optimize(function);
-				}
+							Optimize(function);
+						}
+					});
 			}
 
-			for (auto& functionLayout : functions)
-			{
-				auto function = functionLayout->GetContext();
-				auto& cfg = function->cfg;
-				auto& metadata = function->metadata;
-				if (function->empty() || function->IsExtern()) continue;
+			pool.ParallelFor(functions.size(), [&](size_t i)
+				{
+					auto functionLayout = functions[i];
+					auto function = functionLayout->GetContext();
+					auto& cfg = function->cfg;
+					auto& metadata = function->metadata;
 
-				SSAReducer reducer = SSAReducer(metadata, cfg);
-				reducer.Reduce();
+					PROFILE_SCOPE_DETAIL("SSA Reduce", functionLayout->GetName().str());
+					cfg.EnsureDomTree();
+					SSAReducer reducer = SSAReducer(metadata, cfg);
+					reducer.Reduce();
 
 #if HXSL_DEBUG
-				std::cout << "Lowered SSA to IL:" << std::endl;
-				cfg.Print();
+					std::cout << "Lowered SSA to IL:" << std::endl;
+					cfg.Print();
 #endif
-				auto& alloc = module->GetAllocator();
-				ILCodeBlob* ilBlob = alloc.Alloc<ILCodeBlob>();
-		
-				ilBlob->FromContext(function);
+					ILCodeBlob* ilBlob = blobs[i];
+					ilBlob->FromContext(function);
 
 #if HXSL_DEBUG
-				std::cout << "Final IL:" << std::endl;
-				std::cout << functionLayout->ToString() << std::endl;
-				ilBlob->Print();
+					std::cout << "Final IL:" << std::endl;
+					std::cout << functionLayout->ToString() << std::endl;
+					ilBlob->Print();
 #endif
-				functionLayout->SetCodeBlob(ilBlob);
-			}
-		}
-
-		static std::vector<uptr<ILOptimizerPass>> MakeScope(ILContext* function)
-		{
-			std::vector<uptr<ILOptimizerPass>> passes;
-			passes.push_back(make_uptr<ConstantFolder>(function));
-			passes.push_back(make_uptr<AlgebraicSimplifier>(function));
-			passes.push_back(make_uptr<ReassociationPass>(function));
-			passes.push_back(make_uptr<GlobalValueNumbering>(function));
-			passes.push_back(make_uptr<DeadCodeEliminator>(function));
-			//passes.push_back(make_uptr<StrengthReduction>(function));
-			return passes;
+					functionLayout->SetCodeBlob(ilBlob);
+				});
 		}
 
 		void ILOptimizer::Optimize(ILContext* function)
 		{
-#if HXSL_DEBUG
-			auto& cfg = function->cfg;
-#endif
-			auto passes = MakeScope(function);
-
-			//PROFILE_SCOPE("Optimizer Main");
-			for (size_t i = 0; i < 10; i++)
+			if (level == OptimizationLevel_None)
 			{
-				//PROFILE_SCOPE("Optimizer Pass");
-				bool changed = false;
-				for (auto& pass : passes)
-				{
-					//PROFILE_SCOPE("Optimizer Sub Pass");
-					auto result = pass->Run();
-					if (result == OptimizerPassResult_Rerun)
-					{
-#if HXSL_DEBUG
-						std::cout << "Pass: " << pass->GetName() << std::endl;
-						cfg.Print();
-#endif
-						changed = true;
-						break;
-					}
-					else if (result == OptimizerPassResult_Changed)
-					{
-#if HXSL_DEBUG
-						std::cout << "Pass: " << pass->GetName() << std::endl;
-						cfg.Print();
-#endif
-						changed = true;
-					}
-				}
-
-				if (!changed)
-				{
-					break;
-				}
+				return;
 			}
+
+			PROFILE_SCOPE_DETAIL("Optimize", function->GetFunction()->GetName().str());
+			GetPassManager(function).Run();
 		}
 	}
 }
\ No newline at end of file
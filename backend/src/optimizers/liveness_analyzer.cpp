@@ -2,4 +2,203 @@
 
 namespace HXSL
 {
-}
\ No newline at end of file
+	namespace Backend
+	{
+		size_t LivenessAnalyzer::AddSlot(const ILVarId& varId)
+		{
+			auto it = slots.find(varId);
+			if (it != slots.end())
+			{
+				return it->second;
+			}
+
+			size_t slot = vars.size();
+			vars.push_back(varId);
+			slots.insert({ varId, slot });
+			return slot;
+		}
+
+		void LivenessAnalyzer::VisitClose(size_t index, BasicBlock& node, EmptyCFGContext& context)
+		{
+			postOrder.push_back(index);
+			reachable[index] = true;
+		}
+
+		void LivenessAnalyzer::ComputeLocalSets()
+		{
+			for (auto b : postOrder)
+			{
+				for (auto& instr : *cfg.GetNode(b))
+				{
+					for (auto& operand : instr.GetOperands())
+					{
+						auto var = dyn_cast<Variable>(operand);
+						if (var && (trackTemps || !var->varId.temp()))
+						{
+							AddSlot(var->varId);
+						}
+					}
+
+					// calls of void functions leave INVALID_VARIABLE as result, it never gets a slot.
+					auto res = dyn_cast<ResultInstr>(&instr);
+					if (res && res->GetResult() != INVALID_VARIABLE && (trackTemps || !res->GetResult().temp()))
+					{
+						AddSlot(res->GetResult());
+					}
+				}
+			}
+
+			const size_t n = cfg.size();
+			const size_t varCount = vars.size();
+			uses.assign(n, bit_vector(varCount));
+			defs.assign(n, bit_vector(varCount));
+			phiUses.assign(n, bit_vector(varCount));
+			liveIn.assign(n, bit_vector(varCount));
+			liveOut.assign(n, bit_vector(varCount));
+			ranges.assign(varCount, {});
+
+			for (auto b : postOrder)
+			{
+				auto& node = *cfg.GetNode(b);
+				auto& blockUses = uses[b];
+				auto& blockDefs = defs[b];
+				auto& predecessors = node.GetPredecessors();
+
+				for (auto& instr : node)
+				{
+					if (auto phi = dyn_cast<PhiInstr>(&instr))
+					{
+						auto result = GetSlot(phi->GetResult());
+						if (result == InvalidSlot) continue;
+						blockDefs.set(result);
+
+						// the operand in slot i is read on the edge from predecessor i.
+						auto& operands = phi->GetOperands();
+						for (size_t i = 0; i < operands.size() && i < predecessors.size(); ++i)
+						{
+							auto var = dyn_cast<Variable>(operands[i]);
+							if (!var || !reachable[predecessors[i]]) continue;
+							auto slot = GetSlot(var->varId);
+							if (slot != InvalidSlot)
+							{
+								phiUses[predecessors[i]].set(slot);
+							}
+						}
+						continue;
+					}
+
+					for (auto& operand : instr.GetOperands())
+					{
+						if (auto var = dyn_cast<Variable>(operand))
+						{
+							auto slot = GetSlot(var->varId);
+							if (slot != InvalidSlot && !blockDefs.test(slot))
+							{
+								blockUses.set(slot);
+							}
+						}
+					}
+
+					if (auto res = dyn_cast<ResultInstr>(&instr))
+					{
+						auto slot = GetSlot(res->GetResult());
+						if (slot != InvalidSlot)
+						{
+							blockDefs.set(slot);
+						}
+					}
+				}
+			}
+		}
+
+		void LivenessAnalyzer::Solve()
+		{
+			// post-order sees the successors first, without loops one pass is enough and every back edge costs about one more.
+			bit_vector in = bit_vector(vars.size());
+			bool changed = true;
+			while (changed)
+			{
+				changed = false;
+				iterations++;
+				for (auto b : postOrder)
+				{
+					auto& out = liveOut[b];
+					for (auto succ : cfg.GetNode(b)->GetSuccessors())
+					{
+						out.union_with(liveIn[succ]);
+					}
+					out.union_with(phiUses[b]);
+
+					in = out;
+					in.subtract(defs[b]);
+					in.union_with(uses[b]);
+					changed |= liveIn[b].union_with(in);
+				}
+			}
+		}
+
+		void LivenessAnalyzer::ComputeRanges()
+		{
+			blockStarts.assign(cfg.size(), 0);
+			size_t position = 0;
+			for (auto it = postOrder.rbegin(); it != postOrder.rend(); ++it)
+			{
+				blockStarts[*it] = position;
+				position += cfg.GetNode(*it)->GetInstructions().size();
+			}
+
+			for (auto b : postOrder)
+			{
+				auto& node = *cfg.GetNode(b);
+				size_t first = blockStarts[b];
+				size_t i = first + node.GetInstructions().size();
+
+				liveOut[b].for_each([&](size_t slot) { ranges[slot].Extend(2 * i); });
+
+				for (auto it = node.rbegin(); it != node.rend(); ++it)
+				{
+					--i;
+					auto& instr = *it;
+					if (auto res = dyn_cast<ResultInstr>(&instr))
+					{
+						auto slot = GetSlot(res->GetResult());
+						if (slot != InvalidSlot)
+						{
+							ranges[slot].Extend(2 * i + 1);
+						}
+					}
+
+					if (isa<PhiInstr>(&instr)) continue;
+
+					for (auto& operand : instr.GetOperands())
+					{
+						if (auto var = dyn_cast<Variable>(operand))
+						{
+							auto slot = GetSlot(var->varId);
+							if (slot != InvalidSlot)
+							{
+								ranges[slot].Extend(2 * i);
+							}
+						}
+					}
+				}
+
+				liveIn[b].for_each([&](size_t slot) { ranges[slot].Extend(2 * first); });
+			}
+		}
+
+		void LivenessAnalyzer::Analyze()
+		{
+			slots.clear();
+			vars.clear();
+			postOrder.clear();
+			iterations = 0;
+			reachable.assign(cfg.size(), false);
+
+			TraverseDFS();
+			ComputeLocalSets();
+			Solve();
+			ComputeRanges();
+		}
+	}
+}
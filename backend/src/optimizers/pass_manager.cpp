@@ -0,0 +1,159 @@
+#include "optimizers/pass_manager.hpp"
+
+#include "optimizers/sparse_conditional_constant_propagation.hpp"
+#include "optimizers/constant_folder.hpp"
+#include "optimizers/algebraic_simplifier.hpp"
+#include "optimizers/reassociation_pass.hpp"
+#include "optimizers/global_value_numbering.hpp"
+#include "optimizers/dead_code_eliminator.hpp"
+#include "utils/profiler.hpp"
+
+namespace HXSL
+{
+	namespace Backend
+	{
+		OptimizerPassResult RunOptimizerPass(ILContext* function, ILOptimizerPass& pass)
+		{
+			ProfileScope scope = ProfileScope("Pass", [&]() { return pass.GetName(); });
+			if (!scope.IsActive())
+			{
+				return pass.Run();
+			}
+
+			// counting walks every block, only pay for it while profiling.
+			int64_t before = static_cast<int64_t>(function->cfg.CountInstructions());
+			auto result = pass.Run();
+			int64_t removed = before - static_cast<int64_t>(function->cfg.CountInstructions());
+			scope.AddArg("instructionsRemoved", removed);
+			Profiler::Count("Instructions removed", removed);
+			return result;
+		}
+
+		ILPassManager::ILPassManager(ILContext* function, OptimizationLevel level) : function(function)
+		{
+			auto add = [&](uptr<ILOptimizerPass> pass) { passes.push_back({ std::move(pass) }); };
+			switch (level)
+			{
+			case OptimizationLevel_Basic:
+				add(make_uptr<SparseConditionalConstantPropagation>(function));
+				add(make_uptr<ConstantFolder>(function));
+				add(make_uptr<AlgebraicSimplifier>(function));
+				add(make_uptr<DeadCodeEliminator>(function));
+				break;
+			case OptimizationLevel_Full:
+				add(make_uptr<SparseConditionalConstantPropagation>(function));
+				add(make_uptr<ConstantFolder>(function));
+				add(make_uptr<AlgebraicSimplifier>(function));
+				add(make_uptr<ReassociationPass>(function));
+				add(make_uptr<GlobalValueNumbering>(function));
+				add(make_uptr<DeadCodeEliminator>(function));
+				//add(make_uptr<StrengthReduction>(function));
+				break;
+			default:
+				break;
+			}
+		}
+
+		void ILPassManager::MarkAllDirty()
+		{
+			auto size = function->cfg.size();
+			for (auto& state : passes)
+			{
+				state.dirty.assign(size, true);
+				state.pending = true;
+			}
+		}
+
+		void ILPassManager::MarkDirty(const std::vector<size_t>& blocks)
+		{
+			auto size = function->cfg.size();
+			for (auto& state : passes)
+			{
+				state.dirty.resize(size, false);
+				for (auto block : blocks)
+				{
+					state.dirty[block] = true;
+				}
+				state.pending = true;
+			}
+		}
+
+		bool ILPassManager::Run()
+		{
+			auto& cfg = function->cfg;
+#if HXSL_DEBUG
+			auto name = function->GetFunction()->GetName().str();
+#endif
+			// the function may have been changed by the inliner or unroller in between, nothing of the last run carries over.
+			MarkAllDirty();
+
+			bool changedAny = false;
+			size_t rounds = 0;
+			size_t runs = 0;
+			size_t skipped = 0;
+			bool pending = true;
+			while (pending && rounds < MaxRounds)
+			{
+				rounds++;
+				for (auto& state : passes)
+				{
+					if (!state.pending)
+					{
+						skipped++;
+						continue;
+					}
+
+					auto& pass = *state.pass;
+					cfg.EnsureDomTree();
+					uint64_t version = cfg.GetVersion();
+					pass.changedBlocks.clear();
+					pass.dirtyBlocks = pass.IsBlockLocal() ? &state.dirty : nullptr;
+
+					auto result = RunOptimizerPass(function, pass);
+					runs++;
+
+					pass.dirtyBlocks = nullptr;
+					state.dirty.assign(cfg.size(), false);
+					state.pending = false;
+
+					if (result == OptimizerPassResult_None)
+					{
+						continue;
+					}
+
+#if HXSL_DEBUG
+					std::cout << "Pass: " << pass.GetName() << " (" << name << ")" << std::endl;
+					cfg.Print();
+#endif
+					changedAny = true;
+
+					// block ids don't survive a cfg change, and a pass might not know which blocks it touched.
+					if (cfg.GetVersion() != version || pass.changedBlocks.empty())
+					{
+						MarkAllDirty();
+					}
+					else
+					{
+						MarkDirty(pass.changedBlocks);
+					}
+
+					if (result == OptimizerPassResult_Rerun)
+					{
+						break;
+					}
+				}
+
+				pending = false;
+				for (auto& state : passes)
+				{
+					pending |= state.pending;
+				}
+			}
+
+			Profiler::Count("Optimizer rounds", static_cast<int64_t>(rounds));
+			Profiler::Count("Passes run", static_cast<int64_t>(runs));
+			Profiler::Count("Passes skipped", static_cast<int64_t>(skipped));
+			return changedAny;
+		}
+	}
+}
@@ -228,7 +228,10 @@ namespace HXSL
                 {
                     if (binInstr->GetOpCode() == OpCode_Add || binInstr->GetOpCode() == OpCode_Subtract)
                     {
-                        changed |= TryReassociateMulAddSub(context, *binInstr, definitions);
+                        if (TryReassociateMulAddSub(context, *binInstr, definitions))
+                        {
+                            MarkChanged(node);
+                        }
                     }
 				}
 			}
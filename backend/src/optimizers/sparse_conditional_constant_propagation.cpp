@@ -0,0 +1,443 @@
+#include "optimizers/sparse_conditional_constant_propagation.hpp"
+#include "il/il_helper.hpp"
+
+namespace HXSL
+{
+	namespace Backend
+	{
+		static bool IsConditionalJump(const Instruction* instr)
+		{
+			return instr && (instr->IsOp(OpCode_JumpZero) || instr->IsOp(OpCode_JumpNotZero));
+		}
+
+		bool SparseConditionalConstantPropagation::LatticeValue::operator==(const LatticeValue& other) const
+		{
+			if (state != other.state) return false;
+			if (state != LatticeState_Constant) return true;
+			return value.Kind == other.value.Kind && (value == other.value) == 1;
+		}
+
+		void SparseConditionalConstantPropagation::LatticeValue::Meet(const LatticeValue& other)
+		{
+			if (other.state == LatticeState_Unknown || state == LatticeState_Overdefined) return;
+			if (state == LatticeState_Unknown)
+			{
+				*this = other;
+				return;
+			}
+			if (!(*this == other))
+			{
+				*this = Overdefined();
+			}
+		}
+
+		SparseConditionalConstantPropagation::LatticeValue SparseConditionalConstantPropagation::GetValue(const Operand* op) const
+		{
+			if (auto imm = dyn_cast<Constant>(op))
+			{
+				return LatticeValue::Constant(imm->imm());
+			}
+
+			if (auto var = dyn_cast<Variable>(op))
+			{
+				return GetValue(var->varId);
+			}
+
+			return LatticeValue::Overdefined();
+		}
+
+		SparseConditionalConstantPropagation::LatticeValue SparseConditionalConstantPropagation::GetValue(const ILVarId& varId) const
+		{
+			// no definition in this function at all, parameters and the like.
+			auto it = values.find(varId);
+			if (it != values.end())
+			{
+				return it->second;
+			}
+			return LatticeValue::Overdefined();
+		}
+
+		void SparseConditionalConstantPropagation::SetValue(const ILVarId& varId, const LatticeValue& value)
+		{
+			auto it = values.find(varId);
+			if (it == values.end()) return;
+
+			// values only move down, a second constant or a second definition outside of SSA ends up overdefined.
+			auto next = it->second;
+			next.Meet(value);
+			if (next == it->second) return;
+
+			it->second = next;
+			varWorklist.push_back(varId);
+		}
+
+		void SparseConditionalConstantPropagation::MarkEdge(size_t from, size_t to)
+		{
+			if (!executableEdges.insert(EdgeKey(from, to)).second) return;
+
+			if (!executableBlocks[to])
+			{
+				executableBlocks[to] = true;
+				blockWorklist.push_back(to);
+				return;
+			}
+
+			// the block was visited already, only its phis gain an input.
+			for (auto& instr : *cfg.GetNode(to))
+			{
+				if (!isa<PhiInstr>(&instr)) break;
+				VisitInstr(instr);
+			}
+		}
+
+		ResultInstr* SparseConditionalConstantPropagation::GetCondition(JumpInstr& jump)
+		{
+			auto prev = jump.GetPrev();
+			return prev ? dyn_cast<ResultInstr>(prev) : nullptr;
+		}
+
+		bool SparseConditionalConstantPropagation::TryGetFallthrough(const BasicBlock& block, JumpInstr& jump, size_t& fallthrough) const
+		{
+			auto& successors = block.GetSuccessors();
+			if (successors.size() != 2 || successors[0] == successors[1]) return false;
+
+			size_t target = jump.GetLabel()->label.value;
+			if (successors[0] == target)
+			{
+				fallthrough = successors[1];
+				return true;
+			}
+			if (successors[1] == target)
+			{
+				fallthrough = successors[0];
+				return true;
+			}
+			return false;
+		}
+
+		void SparseConditionalConstantPropagation::VisitBranch(BasicBlock& block, JumpInstr& jump)
+		{
+			auto condition = GetCondition(jump);
+			size_t fallthrough;
+			if (!condition || !TryGetFallthrough(block, jump, fallthrough))
+			{
+				for (auto succ : block.GetSuccessors())
+				{
+					MarkEdge(block.GetId(), succ);
+				}
+				return;
+			}
+
+			auto value = GetValue(condition->GetResult());
+			switch (value.state)
+			{
+			case LatticeState_Unknown:
+				break;
+			case LatticeState_Constant:
+			{
+				bool taken = jump.IsOp(OpCode_JumpZero) ? !value.value.ToBool() : value.value.ToBool();
+				MarkEdge(block.GetId(), taken ? jump.GetLabel()->label.value : fallthrough);
+			}
+			break;
+			case LatticeState_Overdefined:
+				for (auto succ : block.GetSuccessors())
+				{
+					MarkEdge(block.GetId(), succ);
+				}
+				break;
+			}
+		}
+
+		void SparseConditionalConstantPropagation::VisitInstr(Instruction& instr)
+		{
+			auto& block = *instr.GetParent();
+			auto index = block.GetId();
+			if (!executableBlocks[index]) return;
+
+			if (IsConditionalJump(&instr))
+			{
+				VisitBranch(block, *cast<JumpInstr>(&instr));
+				return;
+			}
+
+			if (auto phi = dyn_cast<PhiInstr>(&instr))
+			{
+				LatticeValue result;
+				auto& predecessors = block.GetPredecessors();
+				auto& operands = phi->GetOperands();
+				for (size_t i = 0; i < operands.size() && i < predecessors.size(); ++i)
+				{
+					if (!operands[i] || !IsEdgeExecutable(predecessors[i], index)) continue;
+					result.Meet(GetValue(operands[i]));
+				}
+				SetValue(phi->GetResult(), result);
+				return;
+			}
+
+			auto res = dyn_cast<ResultInstr>(&instr);
+			if (!res) return;
+
+			LatticeValue result = LatticeValue::Overdefined();
+			if (auto move = dyn_cast<MoveInstr>(&instr))
+			{
+				result = GetValue(move->GetSource());
+			}
+			else if (auto unary = dyn_cast<UnaryInstr>(&instr))
+			{
+				result = GetValue(unary->GetOperand());
+				if (result.IsConstant())
+				{
+					auto imm = unary->IsOp(OpCode_Cast) ? Cast(instr, res->GetResult(), result.value) : FoldImm(result.value, {}, unary->GetOpCode());
+					result = imm.Kind == NumberType_Unknown ? LatticeValue::Overdefined() : LatticeValue::Constant(imm);
+				}
+			}
+			else if (auto binary = dyn_cast<BinaryInstr>(&instr))
+			{
+				auto lhs = GetValue(binary->GetLHS());
+				auto rhs = GetValue(binary->GetRHS());
+				if (lhs.state == LatticeState_Overdefined || rhs.state == LatticeState_Overdefined)
+				{
+					result = LatticeValue::Overdefined();
+				}
+				else if (lhs.state == LatticeState_Unknown || rhs.state == LatticeState_Unknown)
+				{
+					result = {};
+				}
+				else if ((binary->IsOp(OpCode_Divide) || binary->IsOp(OpCode_Modulus)) && rhs.value.IsZero())
+				{
+					// left for the runtime, folding would trap in the compiler.
+					result = LatticeValue::Overdefined();
+				}
+				else
+				{
+					auto imm = FoldImm(lhs.value, rhs.value, binary->GetOpCode());
+					result = imm.Kind == NumberType_Unknown ? LatticeValue::Overdefined() : LatticeValue::Constant(imm);
+				}
+			}
+
+			SetValue(res->GetResult(), result);
+		}
+
+		void SparseConditionalConstantPropagation::VisitBlock(BasicBlock& block)
+		{
+			for (auto& instr : block)
+			{
+				VisitInstr(instr);
+			}
+
+			auto& instructions = block.GetInstructions();
+			if (!instructions.empty() && IsConditionalJump(&instructions.back()))
+			{
+				return;
+			}
+
+			for (auto succ : block.GetSuccessors())
+			{
+				MarkEdge(block.GetId(), succ);
+			}
+		}
+
+		void SparseConditionalConstantPropagation::Analyze()
+		{
+			values.clear();
+			uses.clear();
+			executableEdges.clear();
+			executableBlocks.assign(cfg.size(), false);
+			blockWorklist.clear();
+			varWorklist.clear();
+
+			for (auto& block : cfg.GetNodes())
+			{
+				for (auto& instr : *block)
+				{
+					for (auto& operand : instr.GetOperands())
+					{
+						if (auto var = dyn_cast<Variable>(operand))
+						{
+							uses[var->varId].push_back(&instr);
+						}
+					}
+
+					if (auto jump = dyn_cast<JumpInstr>(&instr))
+					{
+						auto condition = GetCondition(*jump);
+						if (IsConditionalJump(jump) && condition)
+						{
+							uses[condition->GetResult()].push_back(&instr);
+						}
+					}
+
+					auto res = dyn_cast<ResultInstr>(&instr);
+					if (res && res->GetResult() != INVALID_VARIABLE)
+					{
+						values.insert({ res->GetResult(), {} });
+					}
+				}
+			}
+
+			executableBlocks[0] = true;
+			blockWorklist.push_back(0);
+			while (!blockWorklist.empty() || !varWorklist.empty())
+			{
+				while (!varWorklist.empty())
+				{
+					auto varId = varWorklist.back();
+					varWorklist.pop_back();
+					auto it = uses.find(varId);
+					if (it == uses.end()) continue;
+					for (auto user : it->second)
+					{
+						VisitInstr(*user);
+					}
+				}
+
+				while (!blockWorklist.empty())
+				{
+					auto index = blockWorklist.back();
+					blockWorklist.pop_back();
+					VisitBlock(*cfg.GetNode(index));
+				}
+			}
+		}
+
+		void SparseConditionalConstantPropagation::FoldBranch(BasicBlock& block)
+		{
+			auto& instructions = block.GetInstructions();
+			if (instructions.empty() || !IsConditionalJump(&instructions.back())) return;
+
+			auto& jump = *cast<JumpInstr>(&instructions.back());
+			auto condition = GetCondition(jump);
+			size_t fallthrough;
+			if (!condition || !TryGetFallthrough(block, jump, fallthrough)) return;
+
+			auto value = GetValue(condition->GetResult());
+			if (!value.IsConstant()) return;
+
+			size_t target = jump.GetLabel()->label.value;
+			bool taken = jump.IsOp(OpCode_JumpZero) ? !value.value.ToBool() : value.value.ToBool();
+			if (taken)
+			{
+				block.ReplaceInstrNO<JumpInstr>(&jump, OpCode_Jump, ILLabel(target));
+				block.SetType(ControlFlowType_Unconditional);
+			}
+			else
+			{
+				block.RemoveInstr(&jump);
+				block.SetType(ControlFlowType_Normal);
+			}
+			MarkChanged(block);
+		}
+
+		void SparseConditionalConstantPropagation::RewriteBlock(BasicBlock& block)
+		{
+			std::vector<PhiInstr*> constantPhis;
+			auto it = block.begin();
+			for (; it != block.end(); ++it)
+			{
+				auto phi = dyn_cast<PhiInstr>(&*it);
+				if (!phi) break;
+				if (values[phi->GetResult()].IsConstant())
+				{
+					constantPhis.push_back(phi);
+				}
+			}
+
+			// the moves go behind the remaining phis, everything scanning phis stops at the first other instruction.
+			for (auto phi : constantPhis)
+			{
+				auto& result = phi->GetResult();
+				block.InsertInstrO<MoveInstr>(it, result, values[result].value);
+				metadata.RemovePhi(phi);
+				block.RemoveInstr(phi);
+				MarkChanged(block);
+			}
+
+			for (; it != block.end(); ++it)
+			{
+				auto& instr = *it;
+				for (auto& operand : instr.GetOperands())
+				{
+					auto var = dyn_cast<Variable>(operand);
+					if (!var) continue;
+					auto value = values.find(var->varId);
+					if (value != values.end() && value->second.IsConstant())
+					{
+						operand = context->MakeConstant(value->second.value);
+						MarkChanged(block);
+					}
+				}
+
+				auto res = dyn_cast<ResultInstr>(&instr);
+				if (!res || IsConditionalJump(instr.GetNext())) continue;
+				if (auto move = dyn_cast<MoveInstr>(&instr); move && isa<Constant>(move->GetSource())) continue;
+
+				auto value = values.find(res->GetResult());
+				if (value != values.end() && value->second.IsConstant())
+				{
+					block.ReplaceInstrO<MoveInstr>(&instr, res->GetResult(), value->second.value);
+					MarkChanged(block);
+				}
+			}
+		}
+
+		void SparseConditionalConstantPropagation::RemoveDeadEdges()
+		{
+			for (size_t i = 0; i < cfg.size(); ++i)
+			{
+				if (!executableBlocks[i]) continue;
+				auto successors = cfg.GetNode(i)->GetSuccessors();
+				for (auto succ : successors)
+				{
+					if (!IsEdgeExecutable(i, succ))
+					{
+						cfg.Unlink(i, succ);
+						changed = true;
+					}
+				}
+			}
+
+			// removing swaps the last block into the hole, going backwards only ever moves reachable blocks.
+			for (size_t i = cfg.size(); i-- > 1;)
+			{
+				if (!executableBlocks[i])
+				{
+					cfg.RemoveNode(i);
+					changed = true;
+				}
+			}
+		}
+
+		OptimizerPassResult SparseConditionalConstantPropagation::Run()
+		{
+			changed = false;
+			if (cfg.empty()) return OptimizerPassResult_None;
+
+			Analyze();
+
+			// a branch still waiting on its condition would lose both edges, only happens outside of proper SSA.
+			for (size_t i = 0; i < cfg.size(); ++i)
+			{
+				if (!executableBlocks[i]) continue;
+				auto& instructions = cfg.GetNode(i)->GetInstructions();
+				if (instructions.empty() || !IsConditionalJump(&instructions.back())) continue;
+				auto condition = GetCondition(*cast<JumpInstr>(&instructions.back()));
+				if (condition && GetValue(condition->GetResult()).state == LatticeState_Unknown)
+				{
+					return OptimizerPassResult_None;
+				}
+			}
+
+			for (size_t i = 0; i < cfg.size(); ++i)
+			{
+				if (!executableBlocks[i]) continue;
+				auto& block = *cfg.GetNode(i);
+				FoldBranch(block);
+				RewriteBlock(block);
+			}
+
+			RemoveDeadEdges();
+
+			return changed ? OptimizerPassResult_Changed : OptimizerPassResult_None;
+		}
+	}
+}
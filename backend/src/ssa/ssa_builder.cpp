@@ -1,4 +1,5 @@
 #include "ssa/ssa_builder.hpp"
+#include "optimizers/liveness_analyzer.hpp"
 #include "pch/std.hpp"
 
 namespace HXSL
@@ -7,14 +8,13 @@ namespace HXSL
 	{
 		void SSABuilder::Visit(size_t index, BasicBlock& node, SSACFGContext& context)
 		{
+			context.marker = renameLog.size();
+
 			for (auto& instr : node)
 			{
 				if (auto phi = dyn_cast<PhiInstr>(&instr))
 				{
-					auto& var = phi->GetResult();
-					auto newVersion = MakeNewVersion(var);
-					context.variables.push_back(var);
-					phi->SetResult(newVersion);
+					phi->SetResult(MakeNewVersion(phi->GetResult()));
 					continue;
 				}
 
@@ -26,12 +26,11 @@ namespace HXSL
 					}
 				}
 
-				if (auto res = dyn_cast<ResultInstr>(&instr))
+				// calls of void functions define nothing, INVALID_VARIABLE has no slot.
+				auto res = dyn_cast<ResultInstr>(&instr);
+				if (res && res->GetResult() != INVALID_VARIABLE)
 				{
-					auto& varId = res->GetResult();
-					ILVarId newVersion = MakeNewVersion(varId);
-					context.variables.push_back(varId);
-					res->SetResult(newVersion);
+					res->SetResult(MakeNewVersion(res->GetResult()));
 				}
 			}
 
@@ -44,18 +43,18 @@ namespace HXSL
 				{
 					auto phi = dyn_cast<PhiInstr>(&instr);
 					if (!phi) break;
-					ILVarId varId = phi->GetResult();
-					ILVarId version = TopVersion(varId.StripVersion());
-					phi->GetOperand(slot) = this->context->MakeVariable(version);
+					phi->GetOperand(slot) = this->context->MakeVariable(TopVersion(phi->GetResult()));
 				}
 			}
 		}
 
 		void SSABuilder::VisitClose(size_t index, BasicBlock& node, SSACFGContext& context)
 		{
-			for (auto& varId : context.variables)
+			while (renameLog.size() > context.marker)
 			{
-				PopVersion(varId);
+				auto& entry = renameLog.back();
+				currentVersions[entry.slot] = entry.previous;
+				renameLog.pop_back();
 			}
 		}
 
@@ -68,11 +67,12 @@ namespace HXSL
 			globalMetadata.phiNodes.push_back(instr);
 		}
 
-		void SSABuilder::Build()
+		void SSABuilder::PlacePhis()
 		{
 			const size_t n = cfg.size();
 
-			std::unordered_map<ILVarId, std::unordered_set<size_t>> defSites;
+			// temps are defined once and never need a phi, only the named variables are tracked.
+			std::vector<std::vector<size_t>> defBlocks(namedCount);
 			for (size_t i = 0; i < n; ++i)
 			{
 				for (auto& instr : *cfg.GetNode(i))
@@ -80,37 +80,83 @@ namespace HXSL
 					auto res = dyn_cast<ResultInstr>(&instr);
 					if (!res) continue;
 					auto& var = res->GetResult();
-					if (var.temp())
+					if (var.temp()) continue;
+					auto& blocks = defBlocks[var.var.id];
+					if (blocks.empty() || blocks.back() != i)
 					{
-						continue;
+						blocks.push_back(i);
 					}
-					defSites[var].insert(i);
 				}
 			}
 
-			std::unordered_map<uint64_t, std::unordered_set<size_t>> hasPhi;
-			for (auto& p : defSites)
+			LivenessAnalyzer liveness = LivenessAnalyzer(cfg, false);
+			liveness.Analyze();
+
+			// marked with slot + 1, the marks of one variable never have to be cleared for the next.
+			std::vector<uint32_t> hasPhi(n, 0);
+			std::vector<uint32_t> queued(n, 0);
+			std::vector<size_t> worklist;
+			for (size_t slot = 0; slot < namedCount; ++slot)
 			{
-				uint64_t varId = p.first;
-				std::queue<size_t> wl;
-				for (auto b : p.second) wl.push(b);
+				auto& blocks = defBlocks[slot];
+				if (blocks.empty()) continue;
+
+				ILVarId varId = ILVarId(static_cast<uint64_t>(slot));
+				size_t liveSlot = liveness.GetSlot(varId);
+				if (liveSlot == LivenessAnalyzer::InvalidSlot) continue;
+
+				uint32_t mark = static_cast<uint32_t>(slot + 1);
+				worklist.clear();
+				for (auto b : blocks)
+				{
+					queued[b] = mark;
+					worklist.push_back(b);
+				}
 
-				while (!wl.empty())
+				while (!worklist.empty())
 				{
-					size_t b = wl.front(); wl.pop();
+					size_t b = worklist.back();
+					worklist.pop_back();
 					for (auto df : domFront[b])
 					{
-						if (hasPhi[varId].insert(df).second)
+						if (hasPhi[df] == mark) continue;
+						hasPhi[df] = mark;
+
+						// a dead phi is left out but still counts as a definition, the iterated frontier stays the same.
+						if (liveness.GetLiveIn(df).test(liveSlot))
 						{
 							InsertPhiMeta(*cfg.GetNode(df), varId);
-							if (!p.second.count(df)) wl.push(df);
+						}
+
+						if (queued[df] != mark)
+						{
+							queued[df] = mark;
+							worklist.push_back(df);
 						}
 					}
 				}
 			}
+		}
+
+		void SSABuilder::Build()
+		{
+			namedCount = metadata.variables.size();
+			const size_t slotCount = namedCount + metadata.tempVariables.size();
+
+			currentVersions.resize(slotCount);
+			for (size_t i = 0; i < namedCount; ++i)
+			{
+				currentVersions[i] = ILVarId(static_cast<uint64_t>(i));
+			}
+			for (size_t i = namedCount; i < slotCount; ++i)
+			{
+				currentVersions[i] = ILVarId(static_cast<uint64_t>(i - namedCount) | SSA_VARIABLE_TEMP_FLAG);
+			}
+			versionCounters.assign(slotCount, 0);
+			renameLog.clear();
 
+			PlacePhis();
 			Traverse(0);
-			return;
 		}
 	}
-}
\ No newline at end of file
+}
@@ -4,75 +4,455 @@ namespace HXSL
 {
 	namespace Backend
 	{
-		void SSAReducer::TryClearVersion(ILVarId& op)
+		void SSAReducer::BuildInterference(const LivenessAnalyzer& liveness)
 		{
-			auto it = phiMap.find(op);
-			if (it != phiMap.end())
+			const size_t n = liveness.GetVarCount();
+			phiRelated.assign(n, false);
+			for (auto b : liveness.GetPostOrder())
 			{
-				op = it->second;
+				for (auto& instr : *cfg.GetNode(b))
+				{
+					auto phi = dyn_cast<PhiInstr>(&instr);
+					if (!phi) break;
+					phiRelated[liveness.GetSlot(phi->GetResult())] = true;
+					for (auto& operand : phi->GetOperands())
+					{
+						auto var = dyn_cast<Variable>(operand);
+						if (!var) continue;
+						auto slot = liveness.GetSlot(var->varId);
+						if (slot != LivenessAnalyzer::InvalidSlot)
+						{
+							phiRelated[slot] = true;
+						}
+					}
+				}
+			}
+
+			bit_vector live = bit_vector(n);
+			std::vector<size_t> phiResults;
+			for (auto b : liveness.GetPostOrder())
+			{
+				auto& node = *cfg.GetNode(b);
+				live = liveness.GetLiveOut(b);
+
+				for (auto it = node.rbegin(); it != node.rend(); ++it)
+				{
+					auto& instr = *it;
+					if (isa<PhiInstr>(&instr)) break;
+
+					auto res = dyn_cast<ResultInstr>(&instr);
+					if (res && res->GetResult() != INVALID_VARIABLE)
+					{
+						size_t def = liveness.GetSlot(res->GetResult());
+						live.reset(def);
+
+						// a move leaves both sides with the same value, they can share a variable even while both are live.
+						size_t source = LivenessAnalyzer::InvalidSlot;
+						if (auto move = dyn_cast<MoveInstr>(&instr))
+						{
+							if (auto var = dyn_cast<Variable>(move->GetSource()))
+							{
+								source = liveness.GetSlot(var->varId);
+							}
+						}
+
+						bool related = phiRelated[def];
+						live.for_each([&](size_t other)
+							{
+								if (other != source && (related || phiRelated[other]))
+								{
+									AddInterference(def, other);
+								}
+							});
+					}
+
+					for (auto& operand : instr.GetOperands())
+					{
+						if (auto var = dyn_cast<Variable>(operand))
+						{
+							live.set(liveness.GetSlot(var->varId));
+						}
+					}
+				}
+
+				// the phis of a block are written at once, they interfere with each other and everything live past them.
+				phiResults.clear();
+				for (auto& instr : node)
+				{
+					auto phi = dyn_cast<PhiInstr>(&instr);
+					if (!phi) break;
+					size_t slot = liveness.GetSlot(phi->GetResult());
+					phiResults.push_back(slot);
+					live.set(slot);
+				}
+
+				for (auto result : phiResults)
+				{
+					live.for_each([&](size_t other) { AddInterference(result, other); });
+				}
 			}
 		}
 
-		void SSAReducer::TryClearVersion(Operand* op)
+		bool SSAReducer::TryCoalesce(const LivenessAnalyzer& liveness, size_t a, size_t b)
 		{
-			auto var = dyn_cast<Variable>(op);
-			if (!var) return;
-			TryClearVersion(var->varId);
+			size_t rootA = Find(a);
+			size_t rootB = Find(b);
+			if (rootA == rootB) return true;
+
+			if (metadata.GetVar(liveness.GetVar(rootA)).typeId != metadata.GetVar(liveness.GetVar(rootB)).typeId)
+			{
+				return false;
+			}
+
+			for (auto memberA : members[rootA])
+			{
+				for (auto memberB : members[rootB])
+				{
+					if (interferences.contains(PairKey(memberA, memberB)))
+					{
+						return false;
+					}
+				}
+			}
+
+			if (members[rootA].size() < members[rootB].size())
+			{
+				std::swap(rootA, rootB);
+			}
+
+			parents[rootB] = rootA;
+			auto& target = members[rootA];
+			auto& source = members[rootB];
+			target.insert(target.end(), source.begin(), source.end());
+			source.clear();
+			source.shrink_to_fit();
+			return true;
 		}
 
-		void SSAReducer::Visit(size_t index, BasicBlock& node, EmptyCFGContext& context)
+		void SSAReducer::Coalesce(const LivenessAnalyzer& liveness)
 		{
-			lastUseIndex.clear();
+			const size_t n = liveness.GetVarCount();
+			parents.resize(n);
+			members.resize(n);
+			for (size_t i = 0; i < n; ++i)
+			{
+				parents[i] = i;
+				members[i] = { i };
+			}
 
-			for (auto& instr : node)
+			auto& postOrder = liveness.GetPostOrder();
+			for (auto it = postOrder.rbegin(); it != postOrder.rend(); ++it)
 			{
-				if (isa<PhiInstr>(&instr))
+				for (auto& instr : *cfg.GetNode(*it))
 				{
-					DiscardInstr(instr);
-					continue;
+					auto phi = dyn_cast<PhiInstr>(&instr);
+					if (!phi) break;
+					size_t result = liveness.GetSlot(phi->GetResult());
+					for (auto& operand : phi->GetOperands())
+					{
+						auto var = dyn_cast<Variable>(operand);
+						if (!var) continue;
+						auto slot = liveness.GetSlot(var->varId);
+						if (slot != LivenessAnalyzer::InvalidSlot)
+						{
+							TryCoalesce(liveness, result, slot);
+						}
+					}
 				}
+			}
+		}
+
+		ILVarId SSAReducer::GetClassVar(const LivenessAnalyzer& liveness, const ILVarId& varId)
+		{
+			auto slot = liveness.GetSlot(varId);
+			if (slot == LivenessAnalyzer::InvalidSlot)
+			{
+				return varId;
+			}
+			return liveness.GetVar(Find(slot));
+		}
+
+		void SSAReducer::EmitCopies(BasicBlock& block, std::vector<PendingCopy>& copies)
+		{
+			auto& allocator = cfg.allocator;
+			auto& instructions = block.GetInstructions();
+			auto pos = block.end();
+			if (!instructions.empty() && isa<JumpInstr>(&instructions.back()))
+			{
+				pos = BasicBlock::instr_iterator(&instructions.back());
+			}
+
+			auto reads = [&](const PendingCopy& copy, const ILVarId& varId)
+				{
+					auto var = dyn_cast<Variable>(copy.src);
+					return var && var->varId == varId;
+				};
 
-				for (auto& op : instr.GetOperands())
+			// the copies of one edge happen at once, a copy can only be emitted once no other pending copy reads its destination.
+			while (!copies.empty())
+			{
+				bool emitted = false;
+				for (size_t i = 0; i < copies.size(); ++i)
 				{
-					TryClearVersion(op);
+					auto& copy = copies[i];
+					bool blocked = false;
+					for (size_t j = 0; j < copies.size() && !blocked; ++j)
+					{
+						blocked = j != i && reads(copies[j], copy.dst);
+					}
+					if (blocked) continue;
+
+					Instruction* move = allocator.Alloc<MoveInstr>(allocator, copy.dst, copy.src);
+					block.InsertInstr(pos, move);
+					copies.erase(copies.begin() + i);
+					emitted = true;
+					break;
 				}
 
-				if (auto res = dyn_cast<ResultInstr>(&instr))
+				if (emitted) continue;
+
+				// only cycles are left, one destination is saved to a temp and its readers read the temp instead.
+				auto dst = copies.front().dst;
+				auto temp = metadata.RegTempVar(metadata.GetVar(dst).typeId).id;
+				Instruction* save = allocator.Alloc<MoveInstr>(allocator, temp, allocator.Alloc<Variable>(dst));
+				block.InsertInstr(pos, save);
+				for (auto& copy : copies)
 				{
-					TryClearVersion(res->GetResult());
+					if (reads(copy, dst))
+					{
+						copy.src = allocator.Alloc<Variable>(temp);
+					}
 				}
+			}
+		}
+
+		void SSAReducer::LowerPhis(const LivenessAnalyzer& liveness)
+		{
+			struct EdgeCopies
+			{
+				size_t block;
+				size_t slot;
+				std::vector<PendingCopy> copies;
+			};
+
+			auto& allocator = cfg.allocator;
+			std::vector<EdgeCopies> edges;
+			std::vector<std::vector<PendingCopy>> slotCopies;
+
+			for (auto b : liveness.GetPostOrder())
+			{
+				auto& node = *cfg.GetNode(b);
+				auto& predecessors = node.GetPredecessors();
+				slotCopies.clear();
+				slotCopies.resize(predecessors.size());
 
-				Prepare(instr);
+				for (auto& instr : node)
+				{
+					if (auto phi = dyn_cast<PhiInstr>(&instr))
+					{
+						auto dst = GetClassVar(liveness, phi->GetResult());
+						auto& operands = phi->GetOperands();
+						for (size_t i = 0; i < operands.size() && i < predecessors.size(); ++i)
+						{
+							if (!liveness.IsReachable(predecessors[i])) continue;
+
+							Operand* src = operands[i];
+							if (auto var = dyn_cast<Variable>(src))
+							{
+								auto srcVar = GetClassVar(liveness, var->varId);
+								if (srcVar == dst) continue;
+								src = allocator.Alloc<Variable>(srcVar);
+							}
+							slotCopies[i].push_back({ dst, src });
+						}
+
+						DiscardInstr(instr);
+						continue;
+					}
+
+					for (auto& operand : instr.GetOperands())
+					{
+						if (auto var = dyn_cast<Variable>(operand))
+						{
+							var->varId = GetClassVar(liveness, var->varId);
+						}
+					}
+
+					if (auto res = dyn_cast<ResultInstr>(&instr))
+					{
+						res->SetResult(GetClassVar(liveness, res->GetResult()));
+					}
+				}
+
+				DiscardMarkedInstructs(node);
+
+				for (size_t i = 0; i < slotCopies.size(); ++i)
+				{
+					if (!slotCopies[i].empty())
+					{
+						edges.push_back({ b, i, std::move(slotCopies[i]) });
+					}
+				}
 			}
 
-			for (auto& p : seenVars)
+			metadata.phiNodes.clear();
+
+			for (auto& edge : edges)
 			{
-				ILVarId varId = p;
-				if (!IsTempVar(varId)) continue;
+				size_t pred = cfg.GetNode(edge.block)->GetPredecessors()[edge.slot];
+				auto& predNode = *cfg.GetNode(pred);
+
+				// a copy in front of a conditional jump would run on the other edge too and split the implicit condition from its jump.
+				bool critical = predNode.NumSuccessors() > 1;
+				if (!predNode.GetInstructions().empty())
+				{
+					auto opcode = predNode.GetInstructions().back().GetOpCode();
+					critical |= opcode == OpCode_JumpZero || opcode == OpCode_JumpNotZero;
+				}
 
-				auto type = metadata.GetTempVar(varId).typeId;
-				MarkAsFree(type, varId);
+				if (critical)
+				{
+					pred = cfg.SplitEdge(pred, edge.block);
+				}
+
+				EmitCopies(*cfg.GetNode(pred), edge.copies);
 			}
+		}
+
+		void SSAReducer::AssignVariables()
+		{
+			LivenessAnalyzer liveness = LivenessAnalyzer(cfg);
+			liveness.Analyze();
+
+			const size_t n = liveness.GetVarCount();
+			std::vector<ILVarId> finalIds(n);
+			std::vector<bool> fixed(n, false);
+			dense_set<uint64_t> usedIds;
 
-			for (auto& instr : node)
+			// read before any write, there is no definition to move them with.
+			liveness.GetLiveIn(0).for_each([&](size_t slot)
+				{
+					fixed[slot] = true;
+					finalIds[slot] = liveness.GetVar(slot);
+					usedIds.insert(liveness.GetVar(slot));
+				});
+
+			std::vector<size_t> order(n);
+			for (size_t i = 0; i < n; ++i)
 			{
-				RemapOperandsAndResult(instr);
+				order[i] = i;
 			}
+			std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+				{
+					auto startA = liveness.GetRange(a).start;
+					auto startB = liveness.GetRange(b).start;
+					return startA != startB ? startA < startB : a < b;
+				});
+
+			auto getPool = [&](const ILVarId& varId) -> std::vector<ILVarId>&
+				{
+					auto type = metadata.GetVar(varId).typeId;
+					return varId.temp() ? freeTemps[type] : freeVars[type];
+				};
+
+			// linear scan, a variable goes back to its pool once the range holding it has ended.
+			using ActiveRange = std::pair<size_t, size_t>;
+			std::priority_queue<ActiveRange, std::vector<ActiveRange>, std::greater<ActiveRange>> active;
+			for (auto slot : order)
+			{
+				if (fixed[slot]) continue;
 
-			DiscardMarkedInstructs(node);
+				auto& range = liveness.GetRange(slot);
+				while (!active.empty() && active.top().first < range.start)
+				{
+					auto expired = active.top().second;
+					active.pop();
+					getPool(liveness.GetVar(expired)).push_back(finalIds[expired]);
+				}
+
+				auto varId = liveness.GetVar(slot);
+				auto& pool = getPool(varId);
+				ILVarId finalId;
+				if (!pool.empty())
+				{
+					finalId = pool.back();
+					pool.pop_back();
+				}
+				else
+				{
+					finalId = varId.StripVersion();
+					if (!usedIds.insert(finalId).second)
+					{
+						auto type = metadata.GetVar(varId).typeId;
+						finalId = varId.temp() ? metadata.RegTempVar(type).id : metadata.RegVar(type).id;
+						usedIds.insert(finalId);
+					}
+				}
+
+				finalIds[slot] = finalId;
+				active.push({ range.end, slot });
+			}
+
+			// looked up before anything is written, an operand shared by two instructions must not be renamed twice.
+			std::vector<std::pair<ILVarId*, ILVarId>> renames;
+			for (auto b : liveness.GetPostOrder())
+			{
+				for (auto& instr : *cfg.GetNode(b))
+				{
+					for (auto& operand : instr.GetOperands())
+					{
+						if (auto var = dyn_cast<Variable>(operand))
+						{
+							renames.push_back({ &var->varId, finalIds[liveness.GetSlot(var->varId)] });
+						}
+					}
+
+					// a void call has no result to rename, stripping the version of INVALID_VARIABLE would make it a temp.
+					auto res = dyn_cast<ResultInstr>(&instr);
+					if (res && res->GetResult() != INVALID_VARIABLE)
+					{
+						renames.push_back({ &res->GetResult(), finalIds[liveness.GetSlot(res->GetResult())] });
+					}
+				}
+			}
+
+			for (auto& [target, finalId] : renames)
+			{
+				*target = finalId;
+			}
+
+			for (auto b : liveness.GetPostOrder())
+			{
+				auto& node = *cfg.GetNode(b);
+				for (auto& instr : node)
+				{
+					if (auto move = dyn_cast<MoveInstr>(&instr))
+					{
+						auto var = dyn_cast<Variable>(move->GetSource());
+						if (var && var->varId == move->GetResult())
+						{
+							DiscardInstr(instr);
+						}
+					}
+				}
+
+				DiscardMarkedInstructs(node);
+			}
 		}
 
 		void SSAReducer::Reduce()
 		{
-			for (auto& phi : metadata.phiNodes)
+			if (cfg.empty()) return;
+
 			{
-				for (auto& p : phi->GetOperands())
-				{
-					phiMap.insert({ cast<Variable>(p)->varId, phi->GetResult() });
-				}
+				LivenessAnalyzer liveness = LivenessAnalyzer(cfg);
+				liveness.Analyze();
+				BuildInterference(liveness);
+				Coalesce(liveness);
+				LowerPhis(liveness);
 			}
 
-			Traverse();
+			AssignVariables();
 		}
 	}
-}
\ No newline at end of file
+}
@@ -84,6 +84,12 @@ struct BenchStats
 			}
 		}
 	}
+
+	void print_throughput(size_t bytesPerOperation) const
+	{
+		double megabytes = static_cast<double>(bytesPerOperation) / (1024.0 * 1024.0);
+		std::cout << "  Throughput: " << std::fixed << std::setprecision(1) << megabytes / mean << " MB/s\n";
+	}
 };
 
 template <typename Derived, typename clock = Bench::clock, typename duration = Bench::duration>
@@ -0,0 +1,107 @@
+#ifndef FRONTEND_BENCH_HPP
+#define FRONTEND_BENCH_HPP
+
+#include "benchmark_base.hpp"
+#include "parsers/parallel_parser.hpp"
+#include "pch/localization.hpp"
+
+// Text span and diagnostic hooks the compiler driver normally installs.
+inline void InstallFrontendHooks()
+{
+	HXSL::TextSpan::textSpanGetSpan = [](const HXSL::TextSpan& span) -> HXSL::StringSpan
+		{
+			if (span.source == HXSL::INVALID_SOURCE_ID) return {};
+			return HXSL::ASTContext::GetCurrentContext()->GetSourceManager().GetSpan(span);
+		};
+	HXSL::TextSpan::textSpanGetStr = [](const HXSL::TextSpan& span) -> std::string
+		{
+			if (span.source == HXSL::INVALID_SOURCE_ID) return {};
+			return HXSL::ASTContext::GetCurrentContext()->GetSourceManager().GetString(span);
+		};
+	HXSL::DiagnosticCode::encodeDiagnosticCode = HXSL::EncodeCodeId;
+	HXSL::DiagnosticCode::getMessageForCode = HXSL::GetMessageForCode;
+	HXSL::DiagnosticCode::getStringForCode = HXSL::GetStringForCode;
+}
+
+class FrontendBench : public Benchmark<FrontendBench>
+{
+	std::vector<std::string> files;
+	size_t threadCount;
+
+	// One material library file, every file declares its own namespace so they can be parsed in any order.
+	static std::string GenerateFile(size_t index, size_t functions)
+	{
+		std::string ns = "Material" + std::to_string(index);
+		std::string text = "namespace " + ns + "\n{\n";
+		for (size_t i = 0; i < functions; ++i)
+		{
+			std::string id = std::to_string(i);
+			text.append("\tstruct Surface").append(id).append("\n\t{\n\t\tfloat3 albedo;\n\t\tfloat roughness;\n\t\tint flags;\n\t}\n\n");
+			text.append("\t// Evaluates the lighting term for the given surface.\n");
+			text.append("\tfloat Shade").append(id).append("(float3 normal, float3 light, Surface").append(id).append(" surface)\n\t{\n");
+			text.append("\t\tfloat nDotL = saturate(dot(normal, light));\n");
+			text.append("\t\tfloat alpha = surface.roughness * surface.roughness;\n");
+			text.append("\t\tfor (int i = 0; i < 4; i++)\n\t\t{\n\t\t\talpha += i * 0.25f - (surface.flags << 1);\n\t\t}\n");
+			text.append("\t\tif (nDotL > 0.5f && surface.flags != 3)\n\t\t{\n\t\t\tnDotL = nDotL * surface.albedo.x + alpha / (nDotL + 1.0f);\n\t\t}\n");
+			text.append("\t\treturn nDotL * alpha * 0.318309886f;\n\t}\n\n");
+		}
+		text.append("}\n");
+		return text;
+	}
+
+public:
+	FrontendBench(size_t threadCount) : Benchmark(5, 1, 10, 2), threadCount(threadCount)
+	{
+	}
+
+	size_t source_size() const
+	{
+		size_t size = 0;
+		for (auto& file : files)
+		{
+			size += file.size();
+		}
+		return size;
+	}
+
+	void setup()
+	{
+		InstallFrontendHooks();
+
+		if (!files.empty()) return;
+		for (size_t i = 0; i < 32; ++i)
+		{
+			files.push_back(GenerateFile(i, 256));
+		}
+	}
+
+	void reset()
+	{
+	}
+
+	void run_operation()
+	{
+		HXSL::ASTContext context;
+		HXSL::ASTContext::SetCurrentContext(&context);
+
+		std::vector<HXSL::SourceFile*> sources;
+		for (auto& file : files)
+		{
+			auto source = context.GetSourceManager().AddSource(nullptr, false);
+			source->GetInputStream()->Write(file.data(), file.size());
+			sources.push_back(source);
+		}
+
+		HXSL::ILogger logger;
+		HXSL::CompilationUnitBuilder builder = HXSL::CompilationUnitBuilder(&logger);
+		HXSL::ParallelParser parser = HXSL::ParallelParser(&logger, &context, threadCount);
+		parser.Parse(sources, builder);
+		builder.Build();
+	}
+
+	void tear_down()
+	{
+	}
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,108 @@
+#ifndef IDENTIFIER_BENCH_HPP
+#define IDENTIFIER_BENCH_HPP
+
+#include "benchmark_base.hpp"
+#include "lexical/identifier_table.hpp"
+#include "utils/dense_map.hpp"
+#include "utils/thread_pool.hpp"
+
+// The former unsynchronized table, kept as the single-threaded reference.
+class LegacyIdentifierTable
+{
+	HXSL::BumpAllocator allocator;
+	HXSL::dense_map<HXSL::StringSpan, HXSL::IdentifierInfo*> map;
+
+public:
+	HXSL::IdentifierInfo* Get(const HXSL::StringSpan& name)
+	{
+		auto it = map.find(name);
+		if (it != map.end())
+		{
+			return it->second;
+		}
+
+		auto info = allocator.Alloc<HXSL::IdentifierInfo>();
+		auto p = reinterpret_cast<char*>(allocator.Alloc(name.size() + 1, alignof(char)));
+		std::memcpy(p, name.data(), name.size());
+		p[name.size()] = '\0';
+		info->name = HXSL::StringSpan(p, name.size());
+		info->hashCode = info->name.hash();
+
+		map.insert({ info->name, info });
+		return info;
+	}
+};
+
+// Interns a token stream shaped like real code, a few thousand distinct names looked up many times each.
+template<typename TTable>
+class IdentifierBench : public Benchmark<IdentifierBench<TTable>>
+{
+	using Base = Benchmark<IdentifierBench<TTable>>;
+
+	std::vector<std::string> names;
+	std::vector<uint32_t> lookups;
+	uptr<TTable> table;
+	size_t threadCount;
+
+public:
+	IdentifierBench(size_t threadCount = 1) : Base(5, 1, 20, 3), threadCount(threadCount)
+	{
+	}
+
+	size_t lookup_count() const { return lookups.size(); }
+
+	void setup()
+	{
+		if (!names.empty()) return;
+		for (size_t i = 0; i < 4096; i++)
+		{
+			names.push_back("identifier" + std::to_string(i));
+		}
+
+		uint32_t state = 0x9E3779B9u;
+		lookups.resize(1 << 20);
+		for (auto& lookup : lookups)
+		{
+			state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+			lookup = state % names.size();
+		}
+	}
+
+	void reset()
+	{
+		table = make_uptr<TTable>();
+	}
+
+	void run_operation()
+	{
+		if constexpr (std::is_same_v<TTable, HXSL::IdentifierTable>)
+		{
+			if (threadCount > 1)
+			{
+				HXSL::ThreadPool pool = HXSL::ThreadPool(threadCount);
+				size_t chunk = (lookups.size() + threadCount - 1) / threadCount;
+				pool.ParallelFor(threadCount, [&](size_t t)
+					{
+						size_t end = std::min(lookups.size(), (t + 1) * chunk);
+						for (size_t i = t * chunk; i < end; i++)
+						{
+							table->Get(names[lookups[i]]);
+						}
+					});
+				return;
+			}
+		}
+
+		for (auto lookup : lookups)
+		{
+			table->Get(names[lookup]);
+		}
+	}
+
+	void tear_down()
+	{
+		table.reset();
+	}
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef INCLUDE_BENCH_HPP
+#define INCLUDE_BENCH_HPP
+
+#include "frontend_bench.hpp"
+#include "preprocessing/preprocessor.hpp"
+#include <filesystem>
+#include <fstream>
+
+// Shader permutations, every permutation includes the same guarded headers a few times like a material library does.
+class IncludeBench : public Benchmark<IncludeBench>
+{
+	std::filesystem::path directory;
+	std::vector<std::string> permutations;
+	bool coldCache;
+
+	static std::string GenerateHeader(size_t index, size_t functions)
+	{
+		std::string guard = "COMMON" + std::to_string(index) + "_H";
+		std::string text = "#ifndef " + guard + "\n#define " + guard + "\n";
+		for (size_t i = 0; i < functions; ++i)
+		{
+			std::string id = std::to_string(index) + "_" + std::to_string(i);
+			text.append("// Shared helper.\nfloat Helper").append(id).append("(float3 normal, float3 light)\n{\n");
+			text.append("\tfloat nDotL = saturate(dot(normal, light));\n\treturn nDotL * 0.318309886f;\n}\n\n");
+		}
+		text.append("#endif\n");
+		return text;
+	}
+
+public:
+	IncludeBench(bool coldCache) : Benchmark(5, 1, 10, 2), coldCache(coldCache)
+	{
+	}
+
+	void setup()
+	{
+		InstallFrontendHooks();
+		HXSL::Parser::InitializeSubSystems();
+
+		if (!permutations.empty()) return;
+		directory = std::filesystem::temp_directory_path() / "hxsl_include_bench";
+		std::filesystem::create_directories(directory);
+		for (size_t i = 0; i < 4; ++i)
+		{
+			std::ofstream(directory / ("common" + std::to_string(i) + ".hxsl"), std::ios::binary) << GenerateHeader(i, 256);
+		}
+
+		for (size_t i = 0; i < 64; ++i)
+		{
+			std::string text = "#define PERMUTATION " + std::to_string(i) + "\n";
+			for (size_t j = 0; j < 4; ++j)
+			{
+				text.append("#include \"common").append(std::to_string(j)).append(".hxsl\"\n");
+				text.append("#include \"common").append(std::to_string(j)).append(".hxsl\"\n");
+			}
+			auto path = directory / ("permutation" + std::to_string(i) + ".hxsl");
+			std::ofstream(path, std::ios::binary) << text;
+			permutations.push_back(path.string());
+		}
+	}
+
+	void reset()
+	{
+	}
+
+	void run_operation()
+	{
+		HXSL::ASTContext context;
+		HXSL::ASTContext::SetCurrentContext(&context);
+		HXSL::ILogger logger;
+		for (auto& permutation : permutations)
+		{
+			// a cold cache lexes every header again, like separate compiler invocations without the cache would.
+			if (coldCache)
+			{
+				HXSL::IncludeCache::Instance().Clear();
+			}
+
+			auto source = context.GetSourceManager().AddSource(HXSL::MappedSource::Open(permutation.c_str()));
+			HXSL::Preprocessor preprocessor = HXSL::Preprocessor(&logger);
+			preprocessor.Process(source);
+		}
+	}
+
+	void tear_down()
+	{
+		std::filesystem::remove_all(directory);
+		permutations.clear();
+	}
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,112 @@
+#ifndef INCREMENTAL_BENCH_HPP
+#define INCREMENTAL_BENCH_HPP
+
+#include "frontend_bench.hpp"
+#include "parsers/incremental_parser.hpp"
+
+// Latency of a single keystroke in the middle of a ~10k line file, either through the IncrementalParser or by parsing the
+// whole file again like the compiler does today. The edit inserts and removes a line break inside a function body.
+class IncrementalBench : public Benchmark<IncrementalBench>
+{
+	std::string text;
+	size_t editOffset = 0;
+	size_t editCount = 0;
+	bool incremental;
+	uptr<HXSL::ASTContext> context;
+	HXSL::SourceFile* source = nullptr;
+	uptr<HXSL::ILogger> logger;
+	uptr<HXSL::IncrementalParser> parser;
+
+	static std::string GenerateFile(size_t functions)
+	{
+		std::string text = "namespace Material\n{\n";
+		for (size_t i = 0; i < functions; ++i)
+		{
+			std::string id = std::to_string(i);
+			text.append("\tstruct Surface").append(id).append("\n\t{\n\t\tfloat3 albedo;\n\t\tfloat roughness;\n\t\tint flags;\n\t}\n\n");
+			text.append("\t// Evaluates the lighting term for the given surface.\n");
+			text.append("\tfloat Shade").append(id).append("(float3 normal, float3 light, Surface").append(id).append(" surface)\n\t{\n");
+			text.append("\t\tfloat nDotL = saturate(dot(normal, light));\n");
+			text.append("\t\tfloat alpha = surface.roughness * surface.roughness;\n");
+			text.append("\t\tfor (int i = 0; i < 4; i++)\n\t\t{\n\t\t\talpha += i * 0.25f - (surface.flags << 1);\n\t\t}\n");
+			text.append("\t\tif (nDotL > 0.5f && surface.flags != 3)\n\t\t{\n\t\t\tnDotL = nDotL * surface.albedo.x + alpha / (nDotL + 1.0f);\n\t\t}\n");
+			text.append("\t\treturn nDotL * alpha * 0.318309886f;\n\t}\n\n");
+		}
+		text.append("}\n");
+		return text;
+	}
+
+public:
+	IncrementalBench(bool incremental) : Benchmark(5, 1, 100, 10), incremental(incremental)
+	{
+	}
+
+	size_t source_size() const
+	{
+		return text.size();
+	}
+
+	void setup()
+	{
+		InstallFrontendHooks();
+		HXSL::Parser::InitializeSubSystems();
+
+		if (text.empty())
+		{
+			text = GenerateFile(460);
+			editOffset = text.find("\t\treturn", text.size() / 2);
+		}
+
+		context = make_uptr<HXSL::ASTContext>();
+		HXSL::ASTContext::SetCurrentContext(context.get());
+		logger = make_uptr<HXSL::ILogger>();
+		source = context->GetSourceManager().AddSource(nullptr, false);
+		source->GetInputStream()->Write(text.data(), text.size());
+		parser = make_uptr<HXSL::IncrementalParser>(logger.get());
+		if (incremental)
+		{
+			parser->Parse({ source });
+		}
+	}
+
+	void reset()
+	{
+	}
+
+	void run_operation()
+	{
+		// even edits insert the line break, odd ones remove it again.
+		HXSL::TextEdit edit = { source->GetID(), editOffset, 0, "\n" };
+		if (editCount++ & 1)
+		{
+			edit.length = 1;
+			edit.replacement.clear();
+		}
+
+		if (incremental)
+		{
+			parser->ApplyEdit(edit);
+			return;
+		}
+
+		text.replace(edit.start, edit.length, edit.replacement);
+		HXSL::ASTContext fullContext;
+		HXSL::ASTContext::SetCurrentContext(&fullContext);
+		auto fullSource = fullContext.GetSourceManager().AddSource(nullptr, false);
+		fullSource->GetInputStream()->Write(text.data(), text.size());
+
+		HXSL::ILogger fullLogger;
+		HXSL::CompilationUnitBuilder builder = HXSL::CompilationUnitBuilder(&fullLogger);
+		HXSL::ParallelParser(&fullLogger, &fullContext, 1).Parse({ fullSource }, builder);
+		builder.Build();
+	}
+
+	void tear_down()
+	{
+		parser.reset();
+		HXSL::ASTContext::SetCurrentContext(nullptr);
+		context.reset();
+	}
+};
+
+#endif
\ No newline at end of file
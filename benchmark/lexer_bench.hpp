@@ -0,0 +1,73 @@
+#ifndef LEXER_BENCH_HPP
+#define LEXER_BENCH_HPP
+
+#include "benchmark_base.hpp"
+#include "lexical/lexer.hpp"
+#include "io/source_manager.hpp"
+#include "utils/text_scan.hpp"
+
+class LexerBench : public Benchmark<LexerBench>
+{
+	HXSL::SourceManager sourceManager;
+	HXSL::IdentifierTable idTable;
+	HXSL::ILogger logger;
+	HXSL::SourceFile* source = nullptr;
+	size_t tokens = 0;
+
+	// Heavily commented library code, the shape that dominates cold compiles.
+	static void GenerateSource(HXSL::TextStream& stream, size_t functions)
+	{
+		std::string text;
+		for (size_t i = 0; i < functions; ++i)
+		{
+			text.clear();
+			text.append("/*\n * Evaluates the lighting term ").append(std::to_string(i)).append(" for the given surface.\n");
+			text.append(" * The result is already multiplied by the cosine of the incident angle.\r\n */\n");
+			text.append("float Term").append(std::to_string(i)).append("(float3 normal, float3 light, float roughness)\n{\n");
+			text.append("\t// clamp to avoid negative contributions from back facing lights\n");
+			text.append("\tfloat nDotL = saturate(dot(normal, light));\n");
+			text.append("\tfloat alpha = roughness * roughness;   \t\n");
+			text.append("\treturn nDotL * alpha * 0.318309886f; \"annotation \\\" text\";\n}\n\n");
+			stream.Write(text.data(), text.size());
+		}
+	}
+
+public:
+	LexerBench() : Benchmark(5, 1, 50, 5)
+	{
+	}
+
+	size_t source_size() const
+	{
+		return source->GetInputStream()->GetLength();
+	}
+
+	void setup()
+	{
+		if (source) return;
+		source = sourceManager.AddSource(nullptr, false);
+		GenerateSource(*source->GetInputStream(), 4096);
+	}
+
+	void reset()
+	{
+	}
+
+	void run_operation()
+	{
+		HXSL::LexerContext context = HXSL::LexerContext(idTable, source, source->GetInputStream().get(), &logger, HXSL::HXSLLexerConfig::Instance());
+		HXSL::LexerState state = context.MakeState();
+		while (!state.IsEOF())
+		{
+			HXSL::Lexer::TokenizeStep(state);
+			state.Advance();
+			tokens++;
+		}
+	}
+
+	void tear_down()
+	{
+	}
+};
+
+#endif
\ No newline at end of file
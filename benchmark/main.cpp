@@ -1,6 +1,14 @@
 #include "utils/dense_map_simd.hpp"
 #include "utils/dense_map.hpp"
 #include "benchmark_base.hpp"
+#include "lexer_bench.hpp"
+#include "frontend_bench.hpp"
+#include "identifier_bench.hpp"
+#include "parser_bench.hpp"
+#include "include_bench.hpp"
+#include "incremental_bench.hpp"
+#include "optimizer_bench.hpp"
+#include "ssa_bench.hpp"
 
 #include <windows.h>
 
@@ -89,5 +97,79 @@ int main()
 	DenseMapSIMDBench bench;
 	bench.run().print_stats();
 
+	std::cout << "IdentifierTable (legacy dense_map)\n";
+	IdentifierBench<LegacyIdentifierTable> legacyIds;
+	legacyIds.run().print_stats();
+
+	std::cout << "IdentifierTable (sharded, 1 thread)\n";
+	IdentifierBench<HXSL::IdentifierTable> ids;
+	ids.run().print_stats();
+
+	std::cout << "IdentifierTable (sharded, " << HXSL::ThreadPool::GetDefaultThreadCount() << " threads)\n";
+	IdentifierBench<HXSL::IdentifierTable> parallelIds(HXSL::ThreadPool::GetDefaultThreadCount());
+	parallelIds.run().print_stats();
+
+	auto maxScanLevel = TextScan::GetMaxScanLevel();
+	for (int level = TextScan::ScanLevel_Scalar; level <= maxScanLevel; ++level)
+	{
+		TextScan::SetScanLevel(static_cast<TextScan::ScanLevel>(level));
+		std::cout << "Lexer (" << TextScan::ToString(TextScan::GetScanLevel()) << ")\n";
+		LexerBench lexer;
+		auto stats = lexer.run();
+		stats.print_stats();
+		stats.print_throughput(lexer.source_size());
+	}
+	TextScan::SetScanLevel(maxScanLevel);
+
+	std::cout << "Parser\n";
+	ParserBench parserBench;
+	auto parserStats = parserBench.run();
+	parserStats.print_stats();
+	parserStats.print_throughput(parserBench.source_size());
+	std::cout << "Speculative sub parser attempts: " << parserBench.speculative_attempts() << "\n";
+
+	std::cout << "Preprocessor includes (cold cache)\n";
+	IncludeBench coldIncludes(true);
+	coldIncludes.run().print_stats();
+
+	std::cout << "Preprocessor includes (warm cache)\n";
+	IncludeBench warmIncludes(false);
+	warmIncludes.run().print_stats();
+
+	std::cout << "Incremental reparse (single declaration, 10k lines)\n";
+	IncrementalBench incremental(true);
+	incremental.run().print_stats();
+
+	std::cout << "Full reparse (10k lines)\n";
+	IncrementalBench full(false);
+	full.run().print_stats();
+
+	std::cout << "SSA construction (10k blocks)\n";
+	SSABench ssa;
+	ssa.run().print_stats();
+	std::cout << "Blocks: " << ssa.block_count() << ", phis: " << ssa.phi_count() << "\n";
+
+	// Only the main thread is pinned, the pool threads of the frontend are free to run on any core.
+	size_t maxThreads = HXSL::ThreadPool::GetDefaultThreadCount();
+	for (size_t threads = 1;; threads = std::min(threads * 2, maxThreads))
+	{
+		std::cout << "Frontend (" << threads << " threads)\n";
+		FrontendBench frontend(threads);
+		auto stats = frontend.run();
+		stats.print_stats();
+		stats.print_throughput(frontend.source_size());
+		if (threads == maxThreads) break;
+	}
+
+	for (size_t threads = 1;; threads = std::min(threads * 2, maxThreads))
+	{
+		std::cout << "Optimizer (" << threads << " threads)\n";
+		OptimizerBench optimizer(threads);
+		auto stats = optimizer.run();
+		stats.print_stats();
+		std::cout << "Functions: " << optimizer.function_count() << "\n";
+		if (threads == maxThreads) break;
+	}
+
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,123 @@
+#ifndef OPTIMIZER_BENCH_HPP
+#define OPTIMIZER_BENCH_HPP
+
+#include "frontend_bench.hpp"
+#include "hxls_compiler.hpp"
+#include "ast_modules/ast_validator.hpp"
+#include "semantics/semantic_analyzer.hpp"
+#include "semantics/assembly_resolver.hpp"
+#include "middleware/module_builder.hpp"
+#include "il/control_flow_analyzer.hpp"
+#include "optimizers/il_optimizer.hpp"
+
+// Backend optimization of a module with a few hundred functions. Every function calls the one before it in its group, so the
+// inliner sees short call chains and the functions of one chain position can be processed side by side. The module is
+// rebuilt by the frontend before each step, only ILOptimizer::Optimize is timed.
+class OptimizerBench : public Benchmark<OptimizerBench>
+{
+	std::vector<std::string> files;
+	size_t threadCount;
+	HXSL::AssemblyCollection references;
+	uptr<HXSL::ASTContext> context;
+	uptr<HXSL::ILogger> logger;
+	std::unique_ptr<HXSL::Backend::Module> module;
+	size_t functionCount = 0;
+
+	static constexpr size_t ChainLength = 4;
+
+	static std::string GenerateFile(size_t index, size_t functions)
+	{
+		std::string ns = "Lighting" + std::to_string(index);
+		std::string text = "namespace " + ns + "\n{\n";
+		for (size_t i = 0; i < functions; ++i)
+		{
+			std::string id = std::to_string(i);
+			text.append("\tfloat Blend").append(id).append("(float a, float b)\n\t{\n");
+			text.append("\t\tfloat x = a * 0.5f + b * 1.0f + 0.0f;\n");
+			text.append("\t\tfor (int k = 0; k < 4; k++)\n\t\t{\n\t\t\tx += k * a - b * 2.0f;\n\t\t}\n");
+			if (i % ChainLength != 0)
+			{
+				std::string callee = std::to_string(i - 1);
+				text.append("\t\tif (x > 1.0f)\n\t\t{\n\t\t\tx = Blend").append(callee).append("(x, a) + Blend").append(callee).append("(b, x);\n\t\t}\n");
+			}
+			text.append("\t\treturn x * (a + 0.0f);\n\t}\n\n");
+		}
+		text.append("}\n");
+		return text;
+	}
+
+public:
+	OptimizerBench(size_t threadCount) : Benchmark(5, 1, 1, 0), threadCount(threadCount)
+	{
+	}
+
+	size_t function_count() const
+	{
+		return functionCount;
+	}
+
+	void setup()
+	{
+		HXSL::Compiler::InitializeSubSystems();
+
+		if (!files.empty()) return;
+		HXSL::AssemblyResolver resolver;
+		references = resolver.BuildCollection();
+		for (size_t i = 0; i < 16; ++i)
+		{
+			files.push_back(GenerateFile(i, 32));
+		}
+	}
+
+	void reset()
+	{
+		module.reset();
+		logger = make_uptr<HXSL::ILogger>();
+		context = make_uptr<HXSL::ASTContext>();
+		HXSL::ASTContext::SetCurrentContext(context.get());
+
+		std::vector<HXSL::SourceFile*> sources;
+		for (auto& file : files)
+		{
+			auto source = context->GetSourceManager().AddSource(nullptr, false);
+			source->GetInputStream()->Write(file.data(), file.size());
+			sources.push_back(source);
+		}
+
+		HXSL::CompilationUnitBuilder builder = HXSL::CompilationUnitBuilder(logger.get());
+		HXSL::ParallelParser parser = HXSL::ParallelParser(logger.get(), context.get(), HXSL::ThreadPool::GetDefaultThreadCount());
+		parser.Parse(sources, builder);
+		auto compilation = builder.Build();
+
+		HXSL::ASTValidator validator = HXSL::ASTValidator(logger.get());
+		validator.Validate(compilation);
+
+		HXSL::SemanticAnalyzer analyzer = HXSL::SemanticAnalyzer(logger.get(), compilation, references);
+		analyzer.Analyze();
+
+		HXSL::ModuleBuilder conv;
+		for (auto& stub : analyzer.GetStubManager().GetAllStubs())
+		{
+			conv.AddExternModule(stub.get());
+		}
+		module = conv.Convert(compilation);
+		functionCount = module->GetAllFunctions().size();
+
+		HXSL::Backend::ControlFlowAnalyzer cfAnalyzer = HXSL::Backend::ControlFlowAnalyzer(logger.get(), module.get());
+		cfAnalyzer.Analyze();
+	}
+
+	void run_operation()
+	{
+		HXSL::Backend::ILOptimizer optimizer = HXSL::Backend::ILOptimizer(logger.get(), module.get(), HXSL::Backend::OptimizationLevel_Full, threadCount);
+		optimizer.Optimize();
+	}
+
+	void tear_down()
+	{
+		module.reset();
+		HXSL::ASTContext::SetCurrentContext(nullptr);
+	}
+};
+
+#endif
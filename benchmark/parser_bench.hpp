@@ -0,0 +1,81 @@
+#ifndef PARSER_BENCH_HPP
+#define PARSER_BENCH_HPP
+
+#include "frontend_bench.hpp"
+#include "lexical/token_buffer.hpp"
+
+// Declaration heavy code, every statement and member goes through the sub parser registries.
+class ParserBench : public Benchmark<ParserBench>
+{
+	std::string text;
+	size_t attempts = 0;
+
+	static std::string GenerateSource(size_t count)
+	{
+		std::string text = "namespace Scene\n{\n";
+		for (size_t i = 0; i < count; ++i)
+		{
+			std::string id = std::to_string(i);
+			text.append("\tstruct Light").append(id).append("\n\t{\n\t\tfloat3 position;\n\t\tfloat3 color;\n\t\tfloat range;\n\t}\n\n");
+			text.append("\tfloat Attenuate").append(id).append("(Light").append(id).append(" light, float3 position)\n\t{\n");
+			text.append("\t\tfloat3 delta = light.position - position;\n");
+			text.append("\t\tfloat distance = length(delta);\n");
+			text.append("\t\tfloat falloff = 1.0f;\n");
+			text.append("\t\tif (distance > light.range)\n\t\t{\n\t\t\treturn 0.0f;\n\t\t}\n");
+			text.append("\t\tfor (int i = 0; i < 2; i++)\n\t\t{\n\t\t\tfalloff = falloff * 0.5f;\n\t\t}\n");
+			text.append("\t\treturn falloff / (distance * distance + 1.0f);\n\t}\n\n");
+		}
+		text.append("}\n");
+		return text;
+	}
+
+public:
+	ParserBench() : Benchmark(5, 1, 20, 3)
+	{
+	}
+
+	size_t source_size() const { return text.size(); }
+
+	// Sub parser attempts of the last parse.
+	size_t speculative_attempts() const { return attempts; }
+
+	void setup()
+	{
+		InstallFrontendHooks();
+		HXSL::Parser::InitializeSubSystems();
+		if (text.empty())
+		{
+			text = GenerateSource(2048);
+		}
+	}
+
+	void reset()
+	{
+	}
+
+	void run_operation()
+	{
+		HXSL::ASTContext context;
+		HXSL::ASTContext::SetCurrentContext(&context);
+
+		auto source = context.GetSourceManager().AddSource(nullptr, false);
+		source->GetInputStream()->Write(text.data(), text.size());
+
+		HXSL::ILogger logger;
+		HXSL::LexerContext lexerContext = HXSL::LexerContext(context.GetIdentifierTable(), source, source->GetInputStream().get(), &logger, HXSL::HXSLLexerConfig::Instance());
+		HXSL::TokenBuffer tokens;
+		tokens.Tokenize(&lexerContext);
+		HXSL::TokenStream stream = HXSL::TokenStream(&lexerContext, &tokens);
+
+		HXSL::CompilationUnitBuilder builder = HXSL::CompilationUnitBuilder(&logger);
+		HXSL::Parser parser = HXSL::Parser(&logger, stream);
+		parser.Parse(builder);
+		attempts = parser.speculativeAttempts;
+	}
+
+	void tear_down()
+	{
+	}
+};
+
+#endif
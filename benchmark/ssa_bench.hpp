@@ -0,0 +1,150 @@
+#ifndef SSA_BENCH_HPP
+#define SSA_BENCH_HPP
+
+#include "benchmark_base.hpp"
+#include "ssa/ssa_builder.hpp"
+#include "core/layout_builder.hpp"
+
+// SSA construction on a synthetic function with 10k blocks, the size loop unrolling and inlining can leave behind. The
+// blocks form a chain of if/else diamonds over a few dozen named variables, every sixteenth merge jumps back a few diamonds
+// so there are loops too. The graph and its dominator tree are rebuilt before each step, only SSABuilder::Build is timed.
+class SSABench : public Benchmark<SSABench>
+{
+	HXSL::Backend::Module module;
+	HXSL::Backend::PrimitiveLayout* intType = nullptr;
+	HXSL::Backend::FunctionLayout* layout = nullptr;
+	uptr<HXSL::Backend::ILContext> function;
+	std::vector<HXSL::Backend::ILVarId> vars;
+
+	static constexpr size_t DiamondCount = 2500;
+	static constexpr size_t VarCount = 48;
+
+	template<typename T, typename... Args>
+	void Add(size_t block, Args&&... args)
+	{
+		auto& allocator = function->allocator;
+		function->cfg.GetNode(block)->AddInstr(allocator.Alloc<T>(allocator, std::forward<Args>(args)...));
+	}
+
+	void AddJump(size_t block, HXSL::Backend::ILOpCode opcode, size_t target)
+	{
+		Add<HXSL::Backend::JumpInstr>(block, opcode, function->allocator.Alloc<HXSL::Backend::Label>(HXSL::Backend::ILLabel(target)));
+	}
+
+	HXSL::Backend::Operand* Var(size_t index)
+	{
+		return function->MakeVariable(vars[index % VarCount]);
+	}
+
+	HXSL::Backend::Operand* Imm(int32_t value)
+	{
+		return function->MakeConstant(HXSL::Number(value));
+	}
+
+	HXSL::Backend::ILVarId Temp()
+	{
+		return function->metadata.RegTempVar(intType).id;
+	}
+
+public:
+	SSABench() : Benchmark(10, 1, 1, 0)
+	{
+	}
+
+	size_t block_count() const
+	{
+		return function ? function->cfg.size() : 0;
+	}
+
+	size_t phi_count() const
+	{
+		return function ? function->metadata.phiNodes.size() : 0;
+	}
+
+	void setup()
+	{
+		using namespace HXSL::Backend;
+		if (layout) return;
+		intType = PrimitiveLayoutBuilder(module).Name("int").Kind(HXSL::PrimitiveKind_Int).Class(HXSL::PrimitiveClass_Scalar).Rows(1).Columns(1).Build();
+		layout = FunctionLayoutBuilder(module).Name("f").ReturnType(intType).Peek();
+	}
+
+	void reset()
+	{
+		using namespace HXSL::Backend;
+		function = make_uptr<ILContext>(&module, layout);
+		auto& cfg = function->cfg;
+
+		vars.clear();
+		for (size_t i = 0; i < VarCount; ++i)
+		{
+			vars.push_back(function->metadata.RegVar(intType).id);
+		}
+
+		for (size_t g = 0; g < DiamondCount; ++g)
+		{
+			size_t a = g * 7, b = g * 11 + 1, c = g * 13 + 2, d = g * 5 + 3, e = g * 3 + 4;
+			size_t head = g * 4;
+			size_t then = head + 1;
+			size_t other = head + 2;
+			size_t merge = head + 3;
+			bool last = g + 1 == DiamondCount;
+			bool loops = g % 16 == 15;
+
+			cfg.AddNode(ControlFlowType_Conditional);
+			if (g > 0)
+			{
+				cfg.Link(head - 1, head);
+			}
+			auto sum = Temp();
+			auto condition = Temp();
+			Add<BinaryInstr>(head, OpCode_Add, sum, Var(a), Var(b));
+			Add<BinaryInstr>(head, OpCode_Multiply, vars[c % VarCount], function->MakeVariable(sum), Imm(2));
+			Add<BinaryInstr>(head, OpCode_LessThan, condition, Var(c), Imm(100));
+			AddJump(head, OpCode_JumpZero, other);
+
+			cfg.AddNode(ControlFlowType_Unconditional);
+			Add<BinaryInstr>(then, OpCode_Add, vars[d % VarCount], Var(a), Imm(1));
+			AddJump(then, OpCode_Jump, merge);
+
+			cfg.AddNode(ControlFlowType_Normal);
+			Add<BinaryInstr>(other, OpCode_Add, vars[d % VarCount], Var(b), Imm(2));
+
+			cfg.AddNode(last ? ControlFlowType_Exit : loops ? ControlFlowType_Conditional : ControlFlowType_Normal);
+			Add<BinaryInstr>(merge, OpCode_Multiply, vars[e % VarCount], Var(d), Var(c));
+			if (last)
+			{
+				Add<ReturnInstr>(merge, Var(e));
+			}
+			else if (loops)
+			{
+				auto loopCondition = Temp();
+				Add<BinaryInstr>(merge, OpCode_LessThan, loopCondition, Var(e), Imm(1000));
+				AddJump(merge, OpCode_JumpNotZero, head - 12);
+			}
+
+			cfg.Link(head, other);
+			cfg.Link(head, then);
+			cfg.Link(then, merge);
+			cfg.Link(other, merge);
+			if (loops)
+			{
+				cfg.Link(merge, head - 12);
+			}
+		}
+
+		cfg.EnsureDomTree();
+	}
+
+	void run_operation()
+	{
+		HXSL::Backend::SSABuilder builder = HXSL::Backend::SSABuilder(function.get());
+		builder.Build();
+	}
+
+	void tear_down()
+	{
+	}
+};
+
+#endif
@@ -10,7 +10,6 @@ typedef void(*IncludeClose)(const char* pFile, void* data, void* userdata);
 #if HXSL_ENABLE_CAPI
 C_API_BEGIN
 typedef struct HXSLCompiler HXSLCompiler;
-typedef struct HXSLCompilationResult HXSLCompilationResult;
 
 HXSL_API HXSLCompiler* HXSL_CreateCompiler();
 
@@ -18,7 +17,17 @@ HXSL_API void HXSL_CompilerRelease(HXSLCompiler* self);
 
 HXSL_API void HXSL_CompilerSetIncludeHandler(HXSLCompiler* self, IncludeOpen includeOpen, IncludeClose includeClose);
 
-HXSL_API HXSLCompilationResult* HXSL_CompilerCompile(HXSLCompiler* self, Blob* blob);
+// Number of threads a single compile uses, defaults to the hardware concurrency.
+HXSL_API void HXSL_CompilerSetThreadCount(HXSLCompiler* self, size_t threadCount);
+
+HXSL_API void HXSL_CompilerSetProfileOutput(HXSLCompiler* self, const char* path);
+
+// 0 keeps the IL as emitted, 1 folds, simplifies and removes dead code, 2 (the default) runs the whole pipeline.
+HXSL_API void HXSL_CompilerSetOptimizationLevel(HXSLCompiler* self, int level);
+
+// Compiles fileCount source files into the assembly at output, which is only written if the compilation had no errors.
+// Reentrant, several threads may compile at once, also through the same compiler as long as none of the setters runs meanwhile.
+HXSL_API void HXSL_CompilerCompile(HXSLCompiler* self, const char* const* files, size_t fileCount, const char* output);
 
 C_API_END
 #endif
@@ -4,19 +4,40 @@
 #include "c/hxsl_compiler.h"
 #include "parsers/parser.hpp"
 #include "semantics/semantic_analyzer.hpp"
+#include "utils/thread_pool.hpp"
 #include "pch/localization.hpp"
+#include "optimizers/pass_manager.hpp"
 
 namespace HXSL
 {
+	struct CompilationOptions;
+
+	// Compile runs every call in its own CompilationSession, any number of threads may compile at the same time through one
+	// or several Compiler instances, also against the same AssemblyCollection: a session only reads the referenced assemblies
+	// and loads their symbols into views of its own. Only the setters must not race with a Compile on the same instance.
+	// Profiling is process wide, a compile started while another one records a trace shows up in that trace instead of writing its own.
 	class Compiler
 	{
 	private:
-		IncludeOpen includeOpen_;
-		IncludeClose includeClose_;
+		IncludeOpen includeOpen_ = nullptr;
+		IncludeClose includeClose_ = nullptr;
+		size_t threadCount_ = ThreadPool::GetDefaultThreadCount();
+		std::string profileOutput_;
+		Backend::OptimizationLevel optimizationLevel_ = Backend::OptimizationLevel_Full;
+
+		CompilationOptions GetOptions() const;
 	public:
+		// Installs the process wide callbacks and builds the shared registries once, Compile calls it on its own.
+		static void InitializeSubSystems();
+
 		void Compile(const std::vector<std::string>& files, const std::string& output, const ConstSpan<AssemblyReference>& references = {});
 		void Compile(const std::vector<std::string>& files, const std::string& output, const AssemblyCollection& references);
 		void SetIncludeHandler(IncludeOpen includeOpen, IncludeClose includeClose);
+		// Number of threads used to preprocess and parse the input files, defaults to the hardware concurrency.
+		void SetThreadCount(size_t threadCount);
+		// Writes a Chrome trace (chrome://tracing, Perfetto) of every Compile call to path, an empty path turns profiling off.
+		void SetProfileOutput(const std::string& path);
+		void SetOptimizationLevel(Backend::OptimizationLevel level);
 	};
 }
 
@@ -14,44 +14,37 @@ namespace HXSL
 			return false;
 		}
 
-		auto dimsCount = Span->GetArrayDims().size();
-		std::string arrayHeadKey = Span->MakeArrayTypeName(dimsCount - 1, elementType); // full name
-
-		auto arrayTable = arrayAssembly->GetMutableSymbolTable();
-
-		auto handle = arrayTable->FindNodeIndexFullPath(arrayHeadKey);
-		if (handle.valid())
-		{
-			handleOut = handle;
-			arrayOut = handle.GetMetadata()->declaration;
-			Span->SetTable(handle);
-			return true;
-		}
-
-		auto context = ASTContext::GetCurrentContext();
+		// every dimension is its own type wrapping the previous one, so int[4][2] shares int[4] with every other user.
 		auto dims = Span->GetArrayDims();
 		SymbolDef* currentType = elementType;
-		for (size_t i = 0; i < dimsCount; i++)
+		InternedType type;
+		for (size_t i = 0; i < dims.size(); i++)
 		{
-			auto arrayKey = context->GetIdentifierTable().Get(Span->MakeArrayTypeName(i, currentType));
+			type = interner.GetOrCreate(ArrayTypeKey{ currentType, dims[i] }, [&]() -> InternedType
+				{
+					auto context = ASTContext::GetCurrentContext();
+					auto arrayKey = context->GetIdentifierTable().Get(Span->MakeArrayTypeName(i, elementType));
+
+					auto symbolRef = ref->Clone();
+					symbolRef->OverwriteType(SymbolRefType_Type);
+					symbolRef->SetDeclaration(currentType);
 
-			auto symbolRef = ref->Clone();
-			symbolRef->OverwriteType(SymbolRefType_Type);
-			symbolRef->SetDeclaration(currentType);
+					auto array = ArrayDecl::Create(TextSpan(), arrayKey, symbolRef, dims[i]);
 
-			auto array = ArrayDecl::Create(TextSpan(), arrayKey, symbolRef, dims[i]);
+					auto meta = SymbolMetadata::Create(array);
+					auto handle = arrayAssembly->GetMutableSymbolTable()->Insert(array->GetName(), meta);
+					array->SetAssembly(arrayAssembly.get(), handle);
 
-			
-			auto meta = SymbolMetadata::Create(array);
-			handle = arrayTable->Insert(array->GetName(), meta);
-			array->SetAssembly(arrayAssembly.get(), handle);
+					return { array, handle };
+				});
 
-			currentType = array;
+			currentType = type.def;
 		}
 
-		handleOut = handle;
+		handleOut = type.handle;
 		arrayOut = currentType;
+		Span->SetTable(type.handle);
 
 		return true;
 	}
-}
\ No newline at end of file
+}
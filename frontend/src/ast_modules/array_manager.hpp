@@ -2,6 +2,7 @@
 #define ARRAY_MANAGER_HPP
 
 #include "array.hpp"
+#include "type_interner.hpp"
 #include "semantics/symbols/symbol_table.hpp"
 
 namespace HXSL
@@ -10,8 +11,9 @@ namespace HXSL
 	{
 	private:
 		std::unique_ptr<Assembly> arrayAssembly = Assembly::Create("");
+		TypeInterner& interner;
 	public:
-		ArrayManager()
+		ArrayManager(TypeInterner& interner) : interner(interner)
 		{
 		}
 
@@ -19,4 +21,4 @@ namespace HXSL
 	};
 }
 
-#endif
\ No newline at end of file
+#endif
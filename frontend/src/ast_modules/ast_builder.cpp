@@ -39,4 +39,24 @@ namespace HXSL
 			break;
 		}
 	}
+
+	template<typename T>
+	static void AppendAll(std::vector<T*>& target, std::vector<T*>& source)
+	{
+		target.insert(target.end(), source.begin(), source.end());
+		source.clear();
+	}
+
+	void DeclContainerBuilder::Merge(DeclContainerBuilder& other)
+	{
+		AppendAll(fields, other.fields);
+		AppendAll(structs, other.structs);
+		AppendAll(classes, other.classes);
+		AppendAll(constructors, other.constructors);
+		AppendAll(functions, other.functions);
+		AppendAll(operators, other.operators);
+		AppendAll(enums, other.enums);
+		AppendAll(namespaces, other.namespaces);
+		AppendAll(usings, other.usings);
+	}
 }
\ No newline at end of file
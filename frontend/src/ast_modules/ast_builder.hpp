@@ -57,6 +57,9 @@ namespace HXSL
 		}
 
 		void AddDeclaration(ASTNode* decl);
+
+		// Appends the declarations of other after the own ones, as if they were added to this builder directly.
+		void Merge(DeclContainerBuilder& other);
 	};
 
 	class CompilationUnitBuilder
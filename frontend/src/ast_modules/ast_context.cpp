@@ -0,0 +1,37 @@
+#include "ast_context.hpp"
+#include "lang/language.hpp"
+
+namespace HXSL
+{
+	static void SeedPrimitiveNames(IdentifierTable& table)
+	{
+		table.Get(ToString(PrimitiveKind_Void));
+		for (int i = PrimitiveKind_Bool; i <= PrimitiveKind_Min16UInt; i++)
+		{
+			std::string scalarName = ToString(static_cast<PrimitiveKind>(i));
+			table.Get(scalarName);
+
+			for (uint32_t n = 2; n <= 4; ++n)
+			{
+				table.Get(scalarName + std::to_string(n));
+			}
+
+			for (uint32_t r = 1; r <= 4; ++r)
+			{
+				for (uint32_t c = 1; c <= 4; ++c)
+				{
+					table.Get(scalarName + std::to_string(r) + "x" + std::to_string(c));
+				}
+			}
+		}
+	}
+
+	ASTContext::ASTContext()
+	{
+		for (auto& entry : KeywordTable)
+		{
+			identifierTable.Get(entry.name);
+		}
+		SeedPrimitiveNames(identifierTable);
+	}
+}
@@ -12,6 +12,7 @@ namespace HXSL
 		BumpAllocator allocator;
 		SourceManager sourceManager;
 		IdentifierTable identifierTable;
+		ASTContext* parent = nullptr;
 
 		static ASTContext*& GetCurrentContextStorage()
 		{
@@ -20,9 +21,27 @@ namespace HXSL
 		}
 
 	public:
+		// Seeds the identifier table with keywords and primitive type names.
+		ASTContext();
+
+		// Context for a worker thread, it sees the sources and shares the identifier table of parent.
+		// Nodes are allocated from its own allocator and sources it adds are staged in its own manager,
+		// Merge hands both over to the parent once the worker is done.
+		explicit ASTContext(ASTContext* parent) : sourceManager(&parent->GetSourceManager()), parent(parent)
+		{
+		}
+
 		BumpAllocator& GetAllocator() { return allocator; }
 		SourceManager& GetSourceManager() { return sourceManager; }
-		IdentifierTable& GetIdentifierTable() { return identifierTable; }
+		IdentifierTable& GetIdentifierTable() { return parent ? parent->identifierTable : identifierTable; }
+
+		// Call in a fixed order, e.g. the order the workers were started in, the staged sources get their final ids here.
+		void Merge(ASTContext& child)
+		{
+			HXSL_ASSERT(child.parent == this, "Only child contexts can be merged.");
+			allocator.Adopt(child.allocator);
+			sourceManager.Adopt(child.sourceManager);
+		}
 
 		~ASTContext()
 		{
@@ -34,12 +53,12 @@ namespace HXSL
 
 		IdentifierInfo* GetIdentifier(const TextSpan& span)
 		{
-			return identifierTable.Get(sourceManager.GetSpan(span));
+			return GetIdentifierTable().Get(GetSourceManager().GetSpan(span));
 		}
 
 		IdentifierInfo* GetIdentifier(const StringSpan& span)
 		{
-			return identifierTable.Get(span);
+			return GetIdentifierTable().Get(span);
 		}
 
 		template<typename T, typename...Args>
@@ -5,17 +5,19 @@
 
 namespace HXSL
 {
-	class ASTValidator : ASTVisitor<>
+	class ASTValidator : public ASTVisitor<ASTValidator>
 	{
 	private:
+		friend ASTVisitor;
+
 		ILogger* logger;
 		bool hasErrors;
 
-		TraversalBehavior Visit(ASTNode*& node, size_t depth, bool deferred, EmptyDeferralContext& context) override;
-		void VisitClose(ASTNode* node, size_t depth) override;
+		TraversalBehavior Visit(ASTNode*& node, size_t depth, bool deferred, EmptyDeferralContext& context);
+		void VisitClose(ASTNode* node, size_t depth);
 
 	public:
-		ASTValidator(ILogger* logger) : ASTVisitor<>(), logger(logger), hasErrors(false) {}
+		ASTValidator(ILogger* logger) : logger(logger), hasErrors(false) {}
 		bool Validate(CompilationUnit* compilation);
 	};
 }
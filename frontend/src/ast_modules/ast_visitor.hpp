@@ -2,6 +2,7 @@
 #define AST_VISITOR_HPP
 
 #include "pch/ast.hpp"
+#include <array>
 
 namespace HXSL
 {
@@ -19,128 +20,250 @@ namespace HXSL
 	{
 	};
 
-	template<typename DeferralContext = EmptyDeferralContext>
+	// Statically dispatched pre-order walker, Derived provides Visit and optionally VisitClose.
+	// The node stack, deferral queue and captured contexts are kept between calls to Traverse, so a visitor reused
+	// for several trees stops allocating once the buffers reached the size of the deepest tree.
+	// A deferral context is only captured when a node gets deferred, the children of that node share it.
+	template<typename Derived, typename DeferralContext = EmptyDeferralContext>
 	class ASTVisitor
 	{
 	private:
-		struct StackContext
+		struct StackEntry
 		{
 			ASTNode* node;
-			size_t depth;
-			DeferralContext context;
+			uint32_t depth;
+			uint32_t context;
 			bool deferred;
 			bool closing;
 		};
-		
-		struct VisitChildContext
+
+		struct DeferredEntry
+		{
+			ASTNode* node;
+			uint32_t depth;
+			uint32_t context;
+			bool subTree;
+		};
+
+		struct ChildSink
 		{
-			std::vector<ASTNode*>& children;
+			std::vector<StackEntry>& stack;
+			uint32_t depth;
+			uint32_t context;
+			bool deferred;
 		};
 
-		static void VisitChild(ASTNode*& child, void* userdata)
+		std::vector<StackEntry> nodeStack;
+		std::vector<DeferredEntry> deferredQueue;
+		std::vector<DeferralContext> contexts;
+
+		static void PushChild(ASTNode*& child, void* userdata)
+		{
+			auto* sink = static_cast<ChildSink*>(userdata);
+			sink->stack.push_back({ child, sink->depth, sink->context, sink->deferred, false });
+		}
+
+		void PushChildren(ASTNode* node, uint32_t depth, uint32_t context, bool deferred)
 		{
-			VisitChildContext* ctx = reinterpret_cast<VisitChildContext*>(userdata);
-			ctx->children.push_back(child);
+			size_t first = nodeStack.size();
+			ChildSink sink = { nodeStack, depth, context, deferred };
+			node->ForEachChild2(PushChild, &sink);
+			// children are reported front to back, the first one has to end up on top.
+			std::reverse(nodeStack.begin() + first, nodeStack.end());
 		}
 
-	protected:
+		uint32_t Capture(DeferralContext&& context)
+		{
+			contexts.push_back(std::move(context));
+			return static_cast<uint32_t>(contexts.size() - 1);
+		}
 
-		virtual TraversalBehavior Visit(ASTNode*& node, size_t depth, bool deferred, DeferralContext& context) = 0;
-		virtual void VisitClose(ASTNode* node, size_t depth)
+		void Reset()
 		{
+			nodeStack.clear();
+			deferredQueue.clear();
+			contexts.clear();
 		}
+
 	public:
+		TraversalBehavior Visit(ASTNode*& node, size_t depth, bool deferred, DeferralContext& context)
+		{
+			return TraversalBehavior_Keep;
+		}
 
-		using VisitFnType = std::function<TraversalBehavior(ASTNode*& node, size_t depth, bool deferred, DeferralContext& context)>;
-		using VisitCloseFnType = std::function<void(ASTNode* node, size_t depth)>;
+		void VisitClose(ASTNode* node, size_t depth)
+		{
+		}
 
-		void Traverse(ASTNode* node, VisitFnType visit, VisitCloseFnType visitClose)
+		void Traverse(ASTNode* root)
 		{
-			std::deque<std::tuple<ASTNode*, size_t, DeferralContext, bool>> deferredQueue;
-			std::stack<StackContext> nodeStack;
-			std::vector<ASTNode*> children;
-			nodeStack.push(StackContext(node, 0, DeferralContext(), false, false));
+			auto& derived = static_cast<Derived&>(*this);
+
+			Reset();
+			contexts.emplace_back();
+			nodeStack.push_back({ root, 0, 0, false, false });
+
+			size_t deferredHead = 0;
 			do
 			{
 				while (!nodeStack.empty())
 				{
-					auto ctx = std::move(nodeStack.top());
-					auto currentNode = ctx.node;
-					auto depth = ctx.depth;
-					auto context = std::move(ctx.context);
-					auto deferred = ctx.deferred;
-					auto closing = ctx.closing;
-					nodeStack.pop();
-
-					if (closing)
+					StackEntry entry = nodeStack.back();
+					nodeStack.pop_back();
+					ASTNode* node = entry.node;
+
+					if (entry.closing)
 					{
-						if (visitClose)
-						{
-							visitClose(currentNode, depth);
-						}
+						derived.VisitClose(node, entry.depth);
+						continue;
 					}
-					else
+
+					DeferralContext context = contexts[entry.context];
+					TraversalBehavior result = derived.Visit(node, entry.depth, entry.deferred, context);
+
+					// break only abandons the current subtree and flushes deferred nodes early, the walk resumes afterwards.
+					if (result == TraversalBehavior_Break)
 					{
-						TraversalBehavior result = visit(currentNode, depth, deferred, context);
+						break;
+					}
+					else if (result == TraversalBehavior_Skip)
+					{
+						continue;
+					}
 
-						if (result == TraversalBehavior_Break)
-						{
-							break;
-						}
-						else if (result == TraversalBehavior_Skip)
-						{
-							continue;
-						}
-						else if (result == TraversalBehavior_Defer)
-						{
-							deferredQueue.push_back(std::make_tuple(currentNode, depth, context, false));
-						}
-						else if (result == TraversalBehavior_DeferSubTree)
+					uint32_t childContext = entry.context;
+					if (result == TraversalBehavior_Defer || result == TraversalBehavior_DeferSubTree)
+					{
+						childContext = Capture(std::move(context));
+						bool subTree = result == TraversalBehavior_DeferSubTree;
+						deferredQueue.push_back({ node, entry.depth, childContext, subTree });
+						if (subTree)
 						{
-							deferredQueue.push_back(std::make_tuple(currentNode, depth, std::move(context), true));
 							continue;
 						}
-						else
-						{
-							nodeStack.push(StackContext(currentNode, depth, context, deferred, true));
-						}
-
-						VisitChildContext visitCtx = VisitChildContext(children);
-						currentNode->ForEachChild2(VisitChild, &visitCtx);
-						for (size_t i = children.size() - 1; i != static_cast<size_t>(-1); --i)
-						{
-							nodeStack.push(StackContext(children[i], depth + 1, context, deferred, false));
-						}
-						children.clear();
 					}
+					else
+					{
+						nodeStack.push_back({ node, entry.depth, entry.context, entry.deferred, true });
+					}
+
+					PushChildren(node, entry.depth + 1, childContext, entry.deferred);
 				}
 
-				while (!deferredQueue.empty())
+				while (deferredHead < deferredQueue.size())
 				{
-					auto [currentNode, depth, context, subTree] = deferredQueue.front();
-					deferredQueue.pop_front();
-					if (subTree)
+					DeferredEntry entry = deferredQueue[deferredHead++];
+					if (entry.subTree)
 					{
-						nodeStack.push(StackContext(currentNode, depth, std::move(context), true, false));
+						nodeStack.push_back({ entry.node, entry.depth, entry.context, true, false });
 						continue;
 					}
-					TraversalBehavior result = visit(currentNode, depth, true, context);
+
+					ASTNode* node = entry.node;
+					DeferralContext context = contexts[entry.context];
+					TraversalBehavior result = derived.Visit(node, entry.depth, true, context);
 					if (result == TraversalBehavior_Break)
 					{
 						break;
 					}
 					else if (result == TraversalBehavior_Defer)
 					{
-						deferredQueue.push_back(std::make_tuple(currentNode, depth, std::move(context), false));
+						deferredQueue.push_back({ node, entry.depth, Capture(std::move(context)), false });
 					}
 				}
+
+				if (deferredHead == deferredQueue.size())
+				{
+					deferredQueue.clear();
+					deferredHead = 0;
+				}
 			} while (!nodeStack.empty());
+
+			Reset();
 		}
+	};
 
-		virtual void Traverse(ASTNode* node)
+	// Runs several passes in a single walk, each node is handed to the passes in the order they were given.
+	// Only passes which neither defer nor need a deferral context can be fused. A pass skipping or breaking on a node
+	// only stops that pass for the subtree, the walk descends as long as any pass keeps the node.
+	template<typename... Passes>
+	class FusedASTVisitor : public ASTVisitor<FusedASTVisitor<Passes...>>
+	{
+	private:
+		static constexpr size_t PassCount = sizeof...(Passes);
+
+		std::tuple<Passes&...> passes;
+		std::array<ASTNode*, PassCount> skippedAt = {};
+
+		template<typename Fn, size_t... Indices>
+		void ForEachPass(Fn&& fn, std::index_sequence<Indices...>)
+		{
+			(fn(std::get<Indices>(passes), Indices), ...);
+		}
+
+		template<typename Fn>
+		void ForEachPass(Fn&& fn)
 		{
-			Traverse(node, std::bind(&ASTVisitor::Visit, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4), std::bind(&ASTVisitor::VisitClose, this, std::placeholders::_1, std::placeholders::_2));
+			ForEachPass(std::forward<Fn>(fn), std::index_sequence_for<Passes...>());
+		}
+
+	public:
+		FusedASTVisitor(Passes&... fusedPasses) : passes(fusedPasses...)
+		{
+		}
+
+		TraversalBehavior Visit(ASTNode*& node, size_t depth, bool deferred, EmptyDeferralContext& context)
+		{
+			std::array<bool, PassCount> skipped = {};
+			bool keep = false;
+			bool anyBreak = false;
+			ForEachPass([&](auto& pass, size_t index)
+				{
+					if (skippedAt[index]) return;
+					auto result = pass.Visit(node, depth, deferred, context);
+					HXSL_ASSERT(result != TraversalBehavior_Defer && result != TraversalBehavior_DeferSubTree, "Deferring passes can't be fused.");
+					if (result == TraversalBehavior_Skip || result == TraversalBehavior_Break)
+					{
+						skipped[index] = true;
+						anyBreak |= result == TraversalBehavior_Break;
+					}
+					else
+					{
+						keep = true;
+					}
+				});
+
+			if (!keep)
+			{
+				// no close will be visited, nothing to restore.
+				return anyBreak ? TraversalBehavior_Break : TraversalBehavior_Skip;
+			}
+
+			for (size_t i = 0; i < PassCount; ++i)
+			{
+				if (skipped[i])
+				{
+					skippedAt[i] = node;
+				}
+			}
+
+			return TraversalBehavior_Keep;
+		}
+
+		void VisitClose(ASTNode* node, size_t depth)
+		{
+			ForEachPass([&](auto& pass, size_t index)
+				{
+					if (skippedAt[index] == node)
+					{
+						skippedAt[index] = nullptr;
+					}
+					else if (!skippedAt[index])
+					{
+						pass.VisitClose(node, depth);
+					}
+				});
 		}
 	};
 }
-#endif
\ No newline at end of file
+#endif
@@ -5,10 +5,11 @@
 
 namespace HXSL 
 {
-	class DebugVisitor : public ASTVisitor<EmptyDeferralContext>
+	class DebugVisitor : public ASTVisitor<DebugVisitor>
 	{
+	public:
 		size_t size = 0;
-		TraversalBehavior Visit(ASTNode*& node, size_t depth, bool deferred, EmptyDeferralContext& context) override
+		TraversalBehavior Visit(ASTNode*& node, size_t depth, bool deferred, EmptyDeferralContext& context)
 		{
 			size += sizeof(*node);
 			std::string indentation(depth * 2, ' ');
@@ -36,30 +36,30 @@ namespace HXSL
 			return cachedSignature;
 		}
 
-		std::ostringstream oss;
-		oss << GetName() << "(";
+		std::string str = GetName().str();
+		str.push_back('(');
 		bool first = true;
 		for (auto& param : GetParameters())
 		{
 			if (!first)
 			{
-				oss << ",";
+				str.push_back(',');
 			}
 			first = false;
 			if (placeholder)
 			{
-				oss << reinterpret_cast<size_t>(param);
+				str.append(std::to_string(reinterpret_cast<size_t>(param)));
 			}
 			else
 			{
-				oss << param->GetSymbolRef()->GetFullyQualifiedName();
+				str.append(param->GetSymbolRef()->GetFullyQualifiedName().view());
 			}
 		}
-		oss << ")";
+		str.push_back(')');
 
 		auto ctx = ASTContext::GetCurrentContext();
 		auto& table = ctx->GetIdentifierTable();
-		auto ident = table.Get(oss.str());
+		auto ident = table.Get(str);
 		if (placeholder)
 		{
 			return ident->name;
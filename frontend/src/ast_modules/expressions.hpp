@@ -497,40 +497,35 @@ namespace HXSL
 			return true;
 		}
 
+		// signatures are only rendered for diagnostics, overloads are looked up by OverloadKey.
 		std::string BuildOverloadSignature()
 		{
-			std::ostringstream oss;
-			oss << symbol->GetName() << "(";
-			bool first = true;
-			for (auto& param : GetParameters())
-			{
-				if (!first)
-				{
-					oss << ",";
-				}
-				first = false;
-				oss << param->GetExpression()->GetInferredType()->GetFullyQualifiedName();
-			}
-			oss << ")";
-			return oss.str();
+			std::string str = symbol->GetName().str();
+			AppendParameterTypes(str);
+			return str;
 		}
 
 		std::string BuildConstructorOverloadSignature()
 		{
-			std::ostringstream oss;
-			oss << "#ctor(";
+			std::string str = "#ctor";
+			AppendParameterTypes(str);
+			return str;
+		}
+
+		void AppendParameterTypes(std::string& str)
+		{
+			str.push_back('(');
 			bool first = true;
 			for (auto& param : GetParameters())
 			{
 				if (!first)
 				{
-					oss << ",";
+					str.push_back(',');
 				}
 				first = false;
-				oss << param->GetExpression()->GetInferredType()->GetFullyQualifiedName();
+				str.append(param->GetExpression()->GetInferredType()->GetFullyQualifiedName().view());
 			}
-			oss << ")";
-			return oss.str();
+			str.push_back(')');
 		}
 
 		SymbolRef* GetSymbolRef()
@@ -16,32 +16,27 @@ namespace HXSL
 			return false;
 		}
 
-		auto context = ASTContext::GetCurrentContext();
-		auto elementTypeName = elementType->GetFullyQualifiedName().str();
-		auto elementTypeN = context->GetIdentifierTable().Get(elementTypeName);
-		auto pointerKey = context->GetIdentifierTable().Get(elementTypeName + "*");
+		auto type = interner.GetOrCreate(PointerTypeKey{ elementType }, [&]() -> InternedType
+			{
+				auto context = ASTContext::GetCurrentContext();
+				auto elementTypeName = elementType->GetFullyQualifiedName().str();
+				auto elementTypeN = context->GetIdentifierTable().Get(elementTypeName);
+				auto pointerKey = context->GetIdentifierTable().Get(elementTypeName + "*");
 
-		auto table = pointerAssembly->GetMutableSymbolTable();
+				auto symbolRef = SymbolRef::Create(TextSpan(), elementTypeN, SymbolRefType_Type, true);
 
-		auto handle = table->FindNodeIndexFullPath(pointerKey->name);
-		if (handle.valid())
-		{
-			handleOut = handle;
-			pointerOut = handle.GetMetadata()->declaration;
-			return true;
-		}
-
-		auto symbolRef = SymbolRef::Create(TextSpan(), elementTypeN, SymbolRefType_Type, true);
+				auto pointer = Pointer::Create(TextSpan(), pointerKey, symbolRef);
 
-		auto pointer = Pointer::Create(TextSpan(), pointerKey, symbolRef);
+				auto meta = SymbolMetadata::Create(pointer);
+				auto handle = pointerAssembly->GetMutableSymbolTable()->Insert(pointer->GetName(), meta);
+				pointer->SetAssembly(pointerAssembly.get(), handle);
 
-		auto meta = SymbolMetadata::Create(pointer);
-		handle = table->Insert(pointer->GetName(), meta);
-		pointer->SetAssembly(pointerAssembly.get(), handle);
+				return { pointer, handle };
+			});
 
-		handleOut = handle;
-		pointerOut = pointer;
+		handleOut = type.handle;
+		pointerOut = type.def;
 
 		return true;
 	}
-}
\ No newline at end of file
+}
@@ -2,6 +2,7 @@
 #define POINTER_MANAGER_HPP
 
 #include "pointer.hpp"
+#include "type_interner.hpp"
 #include "semantics/symbols/symbol_table.hpp"
 
 namespace HXSL
@@ -10,12 +11,13 @@ namespace HXSL
 	{
 	private:
 		std::unique_ptr<Assembly> pointerAssembly = Assembly::Create("");
+		TypeInterner& interner;
 	public:
-		PointerManager() {}
+		PointerManager(TypeInterner& interner) : interner(interner) {}
 		bool TryGetOrCreatePointerType(SymbolRef* ref, SymbolDef* elementType, SymbolHandle& handleOut, SymbolDef*& pointerOut);
 
 		bool TryGetOrCreatePointerType(SymbolDef* elementType, SymbolHandle& handleOut, SymbolDef*& pointerOut);
 	};
 }
 
-#endif
\ No newline at end of file
+#endif
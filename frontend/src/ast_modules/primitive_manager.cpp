@@ -6,16 +6,14 @@ namespace HXSL
 {
 	SymbolHandle PrimitiveManager::Resolve(const StringSpan& span) const
 	{
-		auto table = assembly->GetSymbolTable();
+		auto table = universe.GetSymbolTable();
 		return table->FindNodeIndexFullPath(span);
 	}
 
 	static void AddPrim(std::vector<std::unique_ptr<PrimitiveBuilder>>& primBuilders, Assembly* assembly, PrimitiveKind kind, PrimitiveClass primitiveClass, uint32_t rows, uint32_t columns)
 	{
 		std::string scalarName = ToString(kind);
-
-		std::ostringstream name;
-		name << scalarName;
+		std::string nameStr = scalarName;
 
 		switch (primitiveClass)
 		{
@@ -23,16 +21,16 @@ namespace HXSL
 			break;
 
 		case PrimitiveClass_Vector:
-			name << rows;
+			nameStr.append(std::to_string(rows));
 			break;
 
 		case PrimitiveClass_Matrix:
-			name << rows << "x" << columns;
+			nameStr.append(std::to_string(rows));
+			nameStr.push_back('x');
+			nameStr.append(std::to_string(columns));
 			break;
 		}
 
-		std::string nameStr = name.str();
-
 		auto builder = std::make_unique<PrimitiveBuilder>(assembly);
 		builder->WithName(nameStr);
 		builder->WithKind(kind, primitiveClass);
@@ -82,7 +80,24 @@ namespace HXSL
 		primBuilders.push_back(std::move(builder));
 	}
 
-	void PrimitiveManager::Populate()
+	PrimitiveUniverse::PrimitiveUniverse() : context(make_uptr<ASTContext>()), assembly(Assembly::Create("HXSL.Core"))
+	{
+		// nodes and identifiers of the universe have to outlive every compilation, so they are built in the universe's own context.
+		auto* previous = ASTContext::GetCurrentContext();
+		ASTContext::SetCurrentContext(context.get());
+		Populate();
+		ASTContext::SetCurrentContext(previous);
+
+		assembly->Seal();
+	}
+
+	const PrimitiveUniverse& PrimitiveUniverse::Get()
+	{
+		static const PrimitiveUniverse universe;
+		return universe;
+	}
+
+	void PrimitiveUniverse::Populate()
 	{
 		std::vector<std::unique_ptr<PrimitiveBuilder>> primBuilders;
 
@@ -117,8 +132,6 @@ namespace HXSL
 		}
 		primBuilders.clear();
 
-		auto table = GetMutableSymbolTable();
-
 		ClassBuilder classBuilder = ClassBuilder(assembly.get());
 		classBuilder.WithName("string").Finish();
 		classBuilder.WithName("SamplerState").Finish();
@@ -130,15 +143,4 @@ namespace HXSL
 			.Returns("float4");
 		classBuilder.Finish();
 	}
-
-	void PrimitiveManager::ResolveInternal(SymbolRef* ref)
-	{
-		auto table = GetMutableSymbolTable();
-		auto handle = table->FindNodeIndexPart(ref->GetName());
-		if (handle.invalid())
-		{
-			HXSL_ASSERT(false, "Couldn't find primitive.");
-		}
-		ref->SetTable(handle);
-	}
 }
\ No newline at end of file
@@ -2,38 +2,57 @@
 #define PRIMITIVE_MANAGER_HPP
 
 #include "primitive.hpp"
+#include "ast_context.hpp"
 
 namespace HXSL
 {
-	class PrimitiveManager
+	// Scalar, vector and matrix primitives with their intrinsic operators and casts, plus the builtin classes.
+	// Built once on first use into its own context and sealed afterwards, every compilation and thread shares the same read only universe.
+	class PrimitiveUniverse
 	{
+		uptr<ASTContext> context;
+		std::unique_ptr<Assembly> assembly;
+
+		PrimitiveUniverse();
+
+		void Populate();
+
+		PrimitiveUniverse(const PrimitiveUniverse&) = delete;
+		PrimitiveUniverse& operator=(const PrimitiveUniverse&) = delete;
+
 	public:
-		PrimitiveManager()
+		static const PrimitiveUniverse& Get();
+
+		const Assembly* GetAssembly() const noexcept
 		{
-			Populate();
+			return assembly.get();
 		}
 
 		const SymbolTable* GetSymbolTable() const
 		{
 			return assembly->GetSymbolTable();
 		}
+	};
 
-		SymbolHandle Resolve(const StringSpan& span) const;
+	class PrimitiveManager
+	{
+	public:
+		PrimitiveManager() : universe(PrimitiveUniverse::Get())
+		{
+		}
 
-	private:
-		SymbolTable* GetMutableSymbolTable() const
+		const SymbolTable* GetSymbolTable() const
 		{
-			return assembly->GetMutableSymbolTable();
+			return universe.GetSymbolTable();
 		}
 
-		void Populate();
+		SymbolHandle Resolve(const StringSpan& span) const;
 
+	private:
 		PrimitiveManager(const PrimitiveManager&) = delete;
 		PrimitiveManager& operator=(const PrimitiveManager&) = delete;
 
-		std::unique_ptr<Assembly> assembly = Assembly::Create("HXSL.Core");
-
-		void ResolveInternal(SymbolRef* ref);
+		const PrimitiveUniverse& universe;
 	};
 }
 
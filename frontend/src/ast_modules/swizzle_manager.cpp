@@ -3,68 +3,64 @@
 
 namespace HXSL
 {
-	bool SwizzleManager::VerifySwizzle(Primitive* prim, SymbolRef* ref)
+	InternedType SwizzleManager::CreateSwizzle(Primitive* prim, const SwizzlePattern& pattern)
 	{
-		auto _class = prim->GetClass();
-		if (_class == PrimitiveClass_Matrix) return false;
-		auto pattern = ref->GetName();
-		if (pattern.size() < 1 || pattern.size() > 4)
-			return false;
-
-		auto primHandle = swizzleTable->FindNodeIndexPart(prim->GetName());
-
-		auto handle = primHandle.FindPart(pattern);
-
-		if (handle.valid())
-		{
-			ref->SetTable(handle);
-			return true;
-		}
-
-		auto componentCount = (int)prim->GetRows();
-
-		uint8_t mask = 0;
-		size_t shift = 0;
-		for (auto& c : pattern)
+		std::string typeName = ToString(prim->GetKind());
+		if (pattern.length > 1)
 		{
-			char n = NormalizeSwizzleChar(c);
-			int i = SwizzleCharToIndex(n);
-			if (i < 0 || i >= componentCount)
-			{
-				return false;
-			}
-			mask = (i & 0x3) | (mask << shift);
-			shift += 2;
+			typeName += std::to_string(pattern.length);
 		}
 
-		std::string typeName = ToString(prim->GetKind());
-		if (pattern.size() > 1)
+		auto primitivesTable = primitives.GetSymbolTable();
+		auto primitiveHandle = primitivesTable->FindNodeIndexPart(typeName);
+		if (primitiveHandle.invalid())
 		{
-			typeName += std::to_string(pattern.size());
+			return {};
 		}
 
 		auto context = ASTContext::GetCurrentContext();
 		auto& idTable = context->GetIdentifierTable();
 
-		auto typeN = primitives.GetSymbolTable();
-		auto primitivesTable = primitives.GetSymbolTable();
-		auto primitiveHandle = primitivesTable->FindNodeIndexPart(typeName);
-		auto& resultingType = primitiveHandle.GetMetadata()->declaration;
-
+		StringSpan name = StringSpan(pattern.name);
 		auto symbolRef = SymbolRef::Create(TextSpan(), idTable.Get(typeName), SymbolRefType_Member, false);
 		symbolRef->SetTable(primitiveHandle);
-		auto swizzleDef = SwizzleDefinition::Create(TextSpan(), idTable.Get(pattern), mask, prim, symbolRef);
+		auto swizzleDef = SwizzleDefinition::Create(TextSpan(), idTable.Get(name), pattern.mask, prim, symbolRef);
 		auto metaField = SymbolMetadata::Create(swizzleDef);
 
+		auto primHandle = swizzleTable->FindNodeIndexPart(prim->GetName());
 		if (primHandle.invalid())
 		{
 			auto meta = ObjPtr<SymbolMetadata>();
 			primHandle = swizzleTable->Insert(prim->GetName(), meta, 0);
 		}
 
-		handle = swizzleTable->Insert(pattern, metaField, primHandle);
-		ref->SetTable(handle);
+		auto handle = swizzleTable->Insert(name, metaField, primHandle);
+		return { swizzleDef, handle };
+	}
+
+	bool SwizzleManager::VerifySwizzle(Primitive* prim, SymbolRef* ref)
+	{
+		if (prim->GetClass() == PrimitiveClass_Matrix) return false;
+
+		uint16_t index;
+		if (!TryDecodeSwizzle(ref->GetName(), index))
+		{
+			return false;
+		}
+
+		auto& pattern = GetPattern(index);
+		if (pattern.maxLane >= prim->GetRows())
+		{
+			return false;
+		}
+
+		auto type = interner.GetOrCreate(SwizzleTypeKey{ prim, index }, [&]() { return CreateSwizzle(prim, pattern); });
+		if (!type.def)
+		{
+			return false;
+		}
 
+		ref->SetTable(type.handle);
 		return true;
 	}
-}
\ No newline at end of file
+}
@@ -3,48 +3,114 @@
 
 #include "swizzle.hpp"
 #include "primitive_manager.hpp"
+#include "type_interner.hpp"
 #include "semantics/symbols/symbol_table.hpp"
+#include <array>
 
 namespace HXSL
 {
-	class SwizzleManager
+	struct SwizzlePattern
 	{
-	private:
-		std::unique_ptr<SymbolTable> swizzleTable = std::make_unique<SymbolTable>();
-		PrimitiveManager& primitives;
+		char name[5]; // canonical xyzw spelling.
+		uint8_t length;
+		uint8_t maxLane;
+		uint8_t mask; // lane encoding consumed by vec_swiz.
+	};
+
+	// every pattern of one to four lanes, patterns of length n start at (4^n - 4) / 3 and are ordered by their lanes.
+	static constexpr size_t SwizzlePatternCount = 340;
 
-		static char NormalizeSwizzleChar(const char& c)
+	namespace Swizzles
+	{
+		constexpr std::array<SwizzlePattern, SwizzlePatternCount> BuildPatterns()
 		{
-			switch (c) {
-			case 'r': return 'x';
-			case 'g': return 'y';
-			case 'b': return 'z';
-			case 'a': return 'w';
-			case 's': return 'x';
-			case 't': return 'y';
-			case 'p': return 'z';
-			case 'q': return 'w';
-			default: return c;
+			std::array<SwizzlePattern, SwizzlePatternCount> patterns = {};
+			constexpr char laneNames[] = "xyzw";
+			size_t index = 0;
+			for (uint8_t length = 1; length <= 4; length++)
+			{
+				size_t count = size_t(1) << (2 * length);
+				for (size_t code = 0; code < count; code++)
+				{
+					SwizzlePattern& pattern = patterns[index++];
+					pattern.length = length;
+					uint8_t mask = 0;
+					size_t shift = 0;
+					for (uint8_t i = 0; i < length; i++)
+					{
+						uint8_t lane = static_cast<uint8_t>((code >> (2 * (length - 1 - i))) & 0x3);
+						pattern.name[i] = laneNames[lane];
+						pattern.maxLane = lane > pattern.maxLane ? lane : pattern.maxLane;
+						mask = static_cast<uint8_t>((lane & 0x3) | (mask << shift));
+						shift += 2;
+					}
+					pattern.name[length] = '\0';
+					pattern.mask = mask;
+				}
 			}
+			return patterns;
 		}
-		static int SwizzleCharToIndex(char c)
+
+		constexpr std::array<int8_t, 256> BuildLanes()
 		{
-			switch (c) {
-			case 'x': return 0;
-			case 'y': return 1;
-			case 'z': return 2;
-			case 'w': return 3;
-			default: return -1;
+			std::array<int8_t, 256> lanes = {};
+			for (auto& lane : lanes)
+			{
+				lane = -1;
 			}
+			lanes['x'] = lanes['r'] = lanes['s'] = 0;
+			lanes['y'] = lanes['g'] = lanes['t'] = 1;
+			lanes['z'] = lanes['b'] = lanes['p'] = 2;
+			lanes['w'] = lanes['a'] = lanes['q'] = 3;
+			return lanes;
 		}
 
+		static constexpr std::array<SwizzlePattern, SwizzlePatternCount> Patterns = BuildPatterns();
+		static constexpr std::array<int8_t, 256> Lanes = BuildLanes();
+	}
+
+	class SwizzleManager
+	{
+	private:
+		std::unique_ptr<SymbolTable> swizzleTable = std::make_unique<SymbolTable>();
+		PrimitiveManager& primitives;
+		TypeInterner& interner;
+
+		InternedType CreateSwizzle(Primitive* prim, const SwizzlePattern& pattern);
+
 	public:
-		SwizzleManager(PrimitiveManager& primitives) : primitives(primitives)
+		SwizzleManager(PrimitiveManager& primitives, TypeInterner& interner) : primitives(primitives), interner(interner)
+		{
+		}
+
+		// maps xyzw, rgba and stpq spellings onto the same index, fails on unknown characters or lengths outside 1..4.
+		static bool TryDecodeSwizzle(const StringSpan& pattern, uint16_t& index)
 		{
+			size_t length = pattern.size();
+			if (length < 1 || length > 4)
+			{
+				return false;
+			}
+
+			size_t code = 0;
+			for (size_t i = 0; i < length; i++)
+			{
+				int8_t lane = Swizzles::Lanes[static_cast<uint8_t>(pattern[i])];
+				if (lane < 0)
+				{
+					return false;
+				}
+				code = (code << 2) | static_cast<size_t>(lane);
+			}
+
+			index = static_cast<uint16_t>((((size_t(1) << (2 * length)) - 4) / 3) + code);
+			return true;
 		}
 
+		static const SwizzlePattern& GetPattern(uint16_t index) noexcept { return Swizzles::Patterns[index]; }
+
 		bool VerifySwizzle(Primitive* prim, SymbolRef* ref);
 	};
 }
 
-#endif
\ No newline at end of file
+#endif
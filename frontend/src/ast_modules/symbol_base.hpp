@@ -126,6 +126,8 @@ namespace HXSL
 
 		const StringSpan& GetFullyQualifiedName() const noexcept;
 
+		IdentifierInfo* GetFullyQualifiedIdentifier() const noexcept { return fullyQualifiedName; }
+
 		bool IsEquivalentTo(const SymbolDef* other) const noexcept
 		{
 			return other != nullptr && this->GetFullyQualifiedName() == other->GetFullyQualifiedName();
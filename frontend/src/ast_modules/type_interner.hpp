@@ -0,0 +1,149 @@
+#ifndef TYPE_INTERNER_HPP
+#define TYPE_INTERNER_HPP
+
+#include "semantics/symbols/symbol_table.hpp"
+#include "utils/hashing.hpp"
+#include "utils/dense_map.hpp"
+#include <shared_mutex>
+
+namespace HXSL
+{
+	class Primitive;
+
+	struct ArrayTypeKey
+	{
+		const SymbolDef* element;
+		size_t size;
+
+		bool operator==(const ArrayTypeKey& other) const noexcept { return element == other.element && size == other.size; }
+
+		void Hash(XXHash3Chain& chain) const noexcept
+		{
+			chain.Combine(reinterpret_cast<uintptr_t>(element));
+			chain.Combine(size);
+		}
+	};
+
+	struct PointerTypeKey
+	{
+		const SymbolDef* pointee;
+
+		bool operator==(const PointerTypeKey& other) const noexcept { return pointee == other.pointee; }
+
+		void Hash(XXHash3Chain& chain) const noexcept
+		{
+			chain.Combine(reinterpret_cast<uintptr_t>(pointee));
+		}
+	};
+
+	struct SwizzleTypeKey
+	{
+		const Primitive* vector;
+		uint16_t pattern; // index into the swizzle pattern table, see SwizzleManager.
+
+		bool operator==(const SwizzleTypeKey& other) const noexcept { return vector == other.vector && pattern == other.pattern; }
+
+		void Hash(XXHash3Chain& chain) const noexcept
+		{
+			chain.Combine(reinterpret_cast<uintptr_t>(vector));
+			chain.Combine(pattern);
+		}
+	};
+
+	struct InternedType
+	{
+		SymbolDef* def = nullptr;
+		SymbolHandle handle;
+	};
+
+	template<typename Key>
+	class TypeInternTable
+	{
+		struct KeyHash
+		{
+			size_t operator()(const Key& key) const noexcept
+			{
+				XXHash3Chain chain;
+				key.Hash(chain);
+				return static_cast<size_t>(chain.hash);
+			}
+		};
+
+		dense_map<Key, InternedType, KeyHash> types;
+
+	public:
+		bool TryGet(const Key& key, InternedType& out) const
+		{
+			auto it = types.find(key);
+			if (it == types.end())
+			{
+				return false;
+			}
+			out = it->second;
+			return true;
+		}
+
+		void Insert(const Key& key, const InternedType& type)
+		{
+			types.insert({ key, type });
+		}
+
+		size_t size() const noexcept { return types.size(); }
+	};
+
+	// Canonical array, pointer and swizzle types of a compilation, keyed by their structure instead of their names.
+	// A hit is a single probe under a shared lock, function bodies are checked concurrently. Misses create the type under
+	// the exclusive lock, so every structure maps to exactly one declaration.
+	class TypeInterner
+	{
+		TypeInternTable<ArrayTypeKey> arrays;
+		TypeInternTable<PointerTypeKey> pointers;
+		TypeInternTable<SwizzleTypeKey> swizzles;
+		mutable std::shared_mutex mutex;
+
+		template<typename Key, typename Factory>
+		InternedType GetOrCreate(TypeInternTable<Key>& table, const Key& key, Factory&& create)
+		{
+			InternedType type;
+			{
+				std::shared_lock<std::shared_mutex> lock(mutex);
+				if (table.TryGet(key, type))
+				{
+					return type;
+				}
+			}
+
+			std::unique_lock<std::shared_mutex> lock(mutex);
+			if (table.TryGet(key, type))
+			{
+				return type;
+			}
+
+			type = create();
+			if (type.def)
+			{
+				table.Insert(key, type);
+			}
+			return type;
+		}
+
+	public:
+		// create is called at most once per key, a result without declaration isn't cached.
+		template<typename Factory>
+		InternedType GetOrCreate(const ArrayTypeKey& key, Factory&& create) { return GetOrCreate(arrays, key, std::forward<Factory>(create)); }
+
+		template<typename Factory>
+		InternedType GetOrCreate(const PointerTypeKey& key, Factory&& create) { return GetOrCreate(pointers, key, std::forward<Factory>(create)); }
+
+		template<typename Factory>
+		InternedType GetOrCreate(const SwizzleTypeKey& key, Factory&& create) { return GetOrCreate(swizzles, key, std::forward<Factory>(create)); }
+
+		size_t GetArrayCount() const { std::shared_lock<std::shared_mutex> lock(mutex); return arrays.size(); }
+
+		size_t GetPointerCount() const { std::shared_lock<std::shared_mutex> lock(mutex); return pointers.size(); }
+
+		size_t GetSwizzleCount() const { std::shared_lock<std::shared_mutex> lock(mutex); return swizzles.size(); }
+	};
+}
+
+#endif
@@ -21,9 +21,28 @@ HXSL_API void HXSL_CompilerSetIncludeHandler(HXSLCompiler* self, IncludeOpen inc
 	compiler->SetIncludeHandler(includeOpen, includeClose);
 }
 
-HXSL_API HXSLCompilationResult* HXSL_CompilerCompile(HXSLCompiler* self, Blob* blob)
+HXSL_API void HXSL_CompilerSetThreadCount(HXSLCompiler* self, size_t threadCount)
 {
-	return nullptr;
+	auto compiler = reinterpret_cast<HXSL::Compiler*>(self);
+	compiler->SetThreadCount(threadCount);
+}
+
+HXSL_API void HXSL_CompilerSetProfileOutput(HXSLCompiler* self, const char* path)
+{
+	auto compiler = reinterpret_cast<HXSL::Compiler*>(self);
+	compiler->SetProfileOutput(path ? path : "");
+}
+
+HXSL_API void HXSL_CompilerSetOptimizationLevel(HXSLCompiler* self, int level)
+{
+	auto compiler = reinterpret_cast<HXSL::Compiler*>(self);
+	compiler->SetOptimizationLevel(static_cast<HXSL::Backend::OptimizationLevel>(std::clamp(level, 0, 2)));
+}
+
+HXSL_API void HXSL_CompilerCompile(HXSLCompiler* self, const char* const* files, size_t fileCount, const char* output)
+{
+	auto compiler = reinterpret_cast<HXSL::Compiler*>(self);
+	compiler->Compile(std::vector<std::string>(files, files + fileCount), output);
 }
 
 #endif
\ No newline at end of file
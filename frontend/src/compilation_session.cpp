@@ -0,0 +1,150 @@
+#include "compilation_session.hpp"
+
+#include "ast_modules/ast_validator.hpp"
+#include "parsers/parser.hpp"
+#include "parsers/parallel_parser.hpp"
+#include "semantics/semantic_analyzer.hpp"
+#include "middleware/module_builder.hpp"
+#include "il/control_flow_analyzer.hpp"
+#include "optimizers/il_optimizer.hpp"
+#include "utils/profiler.hpp"
+
+namespace HXSL
+{
+	// a broken file can repeat diagnostics many times over, errors stop at 100 but warnings don't.
+	static constexpr size_t MaxDiagnosticRecords = 1024;
+
+	CompilationSession::CompilationSession(const CompilationOptions& options, const AssemblyCollection& references) :
+		options(options),
+		context(make_uptr<ASTContext>()),
+		previousContext(ASTContext::GetCurrentContext()),
+		references(references.CreateViews())
+	{
+		logger.SetDeduplicate(true);
+		logger.SetMaxRecords(MaxDiagnosticRecords);
+		ASTContext::SetCurrentContext(context.get());
+	}
+
+	CompilationSession::~CompilationSession()
+	{
+		ASTContext::SetCurrentContext(previousContext);
+	}
+
+	std::unique_ptr<Backend::Module> CompilationSession::CompileFrontend(const std::vector<std::string>& files, uptr<SymbolIndexImage>& symbolIndex)
+	{
+		CompilationUnitBuilder builder = CompilationUnitBuilder(&logger);
+
+		std::vector<SourceFile*> sources;
+		for (auto& file : files)
+		{
+			auto mapped = MappedSource::Open(file.c_str());
+
+			if (!mapped)
+			{
+				std::cerr << "Error opening file." << std::endl;
+				continue;
+			}
+
+			auto source = context->GetSourceManager().AddSource(std::move(mapped));
+
+			if (!source->PrepareInputStream())
+			{
+				std::cerr << "Error reading file." << std::endl;
+				continue;
+			}
+
+			sources.push_back(source);
+		}
+
+		{
+			PROFILE_SCOPE("Parse");
+			ParallelParser parser = ParallelParser(&logger, context.get(), options.threadCount);
+			parser.Parse(sources, builder);
+		}
+
+		CompilationUnit* compilation;
+		{
+			PROFILE_SCOPE("Build Compilation Unit");
+			compilation = builder.Build();
+		}
+
+		{
+			PROFILE_SCOPE("Validate AST");
+			ASTValidator validator = ASTValidator(&logger);
+			validator.Validate(compilation);
+		}
+
+		uptr<SemanticAnalyzer> analyzer;
+		{
+			PROFILE_SCOPE("Initialize Semantic Analyzer");
+			analyzer = make_uptr<SemanticAnalyzer>(&logger, compilation, references);
+			analyzer->SetThreadCount(options.threadCount);
+		}
+
+		{
+			PROFILE_SCOPE("Semantic Analysis");
+			analyzer->Analyze();
+		}
+
+		if (logger.HasErrors())
+		{
+			return nullptr;
+		}
+
+		PROFILE_SCOPE("Build Module");
+		ModuleBuilder conv;
+		for (auto& stub : analyzer->GetStubManager().GetAllStubs())
+		{
+			conv.AddExternModule(stub.get());
+		}
+
+		auto module = conv.Convert(compilation);
+
+		{
+			PROFILE_SCOPE("Build Symbol Index");
+			symbolIndex = SymbolIndexImage::Build(*analyzer->GetOutputAssembly()->GetSymbolTable(), [&conv](SymbolDef* def) { return conv.GetLayout(def); });
+		}
+
+		return module;
+	}
+
+	void CompilationSession::Compile(const std::vector<std::string>& files, const std::string& output)
+	{
+		PROFILE_SCOPE("Compile");
+
+		std::unique_ptr<Backend::Module> module;
+		uptr<SymbolIndexImage> symbolIndex;
+		{
+			PROFILE_SCOPE("Frontend");
+			module = CompileFrontend(files, symbolIndex);
+		}
+		if (!module)
+		{
+			return;
+		}
+
+		auto pModule = module.get();
+		std::unique_ptr<Assembly> assembly = Assembly::Create(output);
+		assembly->SetModule(std::move(module));
+		assembly->SetSymbolIndex(std::move(symbolIndex));
+
+		{
+			PROFILE_SCOPE("Control Flow Analysis");
+			Backend::ControlFlowAnalyzer cfAnalyzer = Backend::ControlFlowAnalyzer(&logger, pModule);
+			cfAnalyzer.Analyze();
+		}
+
+		{
+			PROFILE_SCOPE("Optimize Module");
+			Backend::ILOptimizer optimizer = Backend::ILOptimizer(&logger, pModule, options.optimizationLevel, options.threadCount);
+			optimizer.Optimize();
+		}
+
+		if (!logger.HasErrors())
+		{
+			PROFILE_SCOPE("Write Assembly");
+			auto outputStream = FileStream::OpenCreate(output.c_str());
+			assembly->WriteToStream(*outputStream);
+		}
+	}
+}
@@ -0,0 +1,50 @@
+#ifndef COMPILATION_SESSION_HPP
+#define COMPILATION_SESSION_HPP
+
+#include "c/hxsl_compiler.h"
+#include "ast_modules/ast_context.hpp"
+#include "il/assembly_collection.hpp"
+#include "semantics/symbols/symbol_index.hpp"
+#include "logging/logger.hpp"
+#include "optimizers/pass_manager.hpp"
+
+namespace HXSL
+{
+	struct CompilationOptions
+	{
+		size_t threadCount = 1;
+		IncludeOpen includeOpen = nullptr;
+		IncludeClose includeClose = nullptr;
+		Backend::OptimizationLevel optimizationLevel = Backend::OptimizationLevel_Full;
+	};
+
+	// Everything a single compilation owns: its logger, the context holding its sources and nodes, views on the referenced
+	// assemblies and a copy of the options. Sessions share nothing mutable with each other, the referenced assemblies, the parser
+	// and analyzer registries, the lexer configs and the primitive universe are only read. The context is bound to the creating
+	// thread until the session is destroyed.
+	class CompilationSession
+	{
+	private:
+		CompilationOptions options;
+		ILogger logger;
+		uptr<ASTContext> context;
+		ASTContext* previousContext;
+		AssemblyCollection references; // declared after the context, the tables of the views point into it.
+
+		std::unique_ptr<Backend::Module> CompileFrontend(const std::vector<std::string>& files, uptr<SymbolIndexImage>& symbolIndex);
+
+	public:
+		CompilationSession(const CompilationOptions& options, const AssemblyCollection& references);
+
+		~CompilationSession();
+
+		CompilationSession(const CompilationSession&) = delete;
+		CompilationSession& operator=(const CompilationSession&) = delete;
+
+		void Compile(const std::vector<std::string>& files, const std::string& output);
+
+		const ILogger& GetLogger() const noexcept { return logger; }
+	};
+}
+
+#endif
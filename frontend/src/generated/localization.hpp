@@ -2,7 +2,6 @@
 #define LOCALIZATION_HPP
 
 #include <memory>
-#include <unordered_map>
 #include <string>
 #include "logging/diagnostic_code.hpp"
 #include "logging/logger.hpp"
@@ -11,10 +10,8 @@
 
 namespace HXSL
 {
-	extern std::unique_ptr<std::unordered_map<uint64_t, std::string>> current_locale_map;
-	
 	extern void SetLocale(const std::string& language_code);
-	extern std::string GetMessageForCode(uint64_t code);
+	extern StringSpan GetMessageForCode(uint64_t code);
 	extern std::string GetStringForCode(uint64_t code);
 	extern LogLevel GetLogLevelForCode(uint64_t code);
 	extern uint64_t EncodeCodeId(LogLevel level, const std::string& input);
@@ -91,6 +88,24 @@ namespace HXSL
 	/// </summary>
 	constexpr DiagnosticCode PREP_MISSING_IF = 9223373187906027528;
 	
+	/// <summary>
+	/// <para>Code: HL0009</para>
+	/// <para>Message: cannot open include file '{}'</para>
+	/// <para>Description: Desc</para>
+	/// <para>Category: Syntax Error</para>
+	/// <para>Severity: Error</para>
+	/// </summary>
+	constexpr DiagnosticCode PREP_INCLUDE_NOT_FOUND = 9223373187906027529;
+	
+	/// <summary>
+	/// <para>Code: HL0010</para>
+	/// <para>Message: #include nested too deeply in '{}'</para>
+	/// <para>Description: Desc</para>
+	/// <para>Category: Syntax Error</para>
+	/// <para>Severity: Error</para>
+	/// </summary>
+	constexpr DiagnosticCode PREP_INCLUDE_TOO_DEEP = 9223373187906027530;
+	
 	/// <summary>
 	/// <para>Code: HL0020</para>
 	/// <para>Message: expected ';'</para>
@@ -1,17 +1,15 @@
 #include "hxls_compiler.hpp"
+#include "compilation_session.hpp"
 
 #include "ast_modules/ast_context.hpp"
-#include "ast_modules/ast_validator.hpp"
 #include "pch/localization.hpp"
 #include "preprocessing/preprocessor.hpp"
 #include "parsers/parser.hpp"
 #include "semantics/semantic_analyzer.hpp"
 #include "semantics/assembly_resolver.hpp"
-#include "middleware/module_builder.hpp"
-#include "il/control_flow_analyzer.hpp"
-#include "optimizers/il_optimizer.hpp"
 #include "middleware/module_decompiler.hpp"
 #include "ast_modules/debug_visitor.hpp"
+#include "utils/profiler.hpp"
 
 namespace HXSL
 {
@@ -31,63 +29,20 @@ namespace HXSL
 		return source->GetString(span.start, span.length);
 	}
 
-	static std::unique_ptr<Backend::Module> CompileFrontend(ILogger* logger, const std::vector<std::string>& files, const AssemblyCollection& references)
+	void Compiler::InitializeSubSystems()
 	{
-		Parser::InitializeSubSystems();
-
-		uptr<ASTContext> context = make_uptr<ASTContext>();
-		ASTContext::SetCurrentContext(context.get());
-		CompilationUnitBuilder builder = CompilationUnitBuilder(logger);
-		for (auto& file : files)
-		{
-			auto fs = FileStream::OpenRead(file.c_str());
-
-			if (!fs)
-			{
-				std::cerr << "Error opening file." << std::endl;
-				continue;
-			}
-
-			auto source = context->GetSourceManager().AddSource(fs.release(), true);
-
-			if (!source->PrepareInputStream())
+		static std::once_flag initFlag;
+		std::call_once(initFlag, []()
 			{
-				std::cerr << "Error reading file." << std::endl;
-				continue;
-			}
-
-			Preprocessor preprocessor = Preprocessor(logger);
-			preprocessor.Process(source);
-
-			LexerContext lexerContext = LexerContext(context->GetIdentifierTable(), source, source->GetInputStream().get(), logger, HXSLLexerConfig::Instance());
-			TokenStream tokenStream = TokenStream(&lexerContext);
-
-			Parser parser = Parser(logger, tokenStream);
-
-			parser.Parse(builder);
-		}
-
-		CompilationUnit* compilation = builder.Build();
-
-		ASTValidator validator = ASTValidator(logger);
-		validator.Validate(compilation);
+				TextSpan::textSpanGetSpan = textSpanGetSpan;
+				TextSpan::textSpanGetStr = textSpanGetStr;
+				DiagnosticCode::encodeDiagnosticCode = EncodeCodeId;
+				DiagnosticCode::getMessageForCode = GetMessageForCode;
+				DiagnosticCode::getStringForCode = GetStringForCode;
+			});
 
+		Parser::InitializeSubSystems();
 		SemanticAnalyzer::InitializeSubSystems();
-		SemanticAnalyzer analyzer = SemanticAnalyzer(logger, compilation, references);
-		analyzer.Analyze();
-
-		if (logger->HasErrors())
-		{
-			return nullptr;
-		}
-
-		ModuleBuilder conv;
-		for (auto& stub : analyzer.GetStubManager().GetAllStubs())
-		{
-			conv.AddExternModule(stub.get());
-		}
-
-		return conv.Convert(compilation);
 	}
 
 	void Compiler::Compile(const std::vector<std::string>& files, const std::string& output, const ConstSpan<AssemblyReference>& references)
@@ -103,35 +58,47 @@ namespace HXSL
 
 	void Compiler::Compile(const std::vector<std::string>& files, const std::string& output, const AssemblyCollection& references)
 	{
-		TextSpan::textSpanGetSpan = textSpanGetSpan;
-		TextSpan::textSpanGetStr = textSpanGetStr;
-		DiagnosticCode::encodeDiagnosticCode = EncodeCodeId;
-		DiagnosticCode::getMessageForCode = GetMessageForCode;
-		DiagnosticCode::getStringForCode = GetStringForCode;
-
-		std::unique_ptr<ILogger> logger = std::make_unique<ILogger>();
+		InitializeSubSystems();
 
-		auto module = CompileFrontend(logger.get(), files, references);
-		if (!module)
+		// a session that is already running belongs to someone else, this compile only shows up in their trace.
+		bool profiling = !profileOutput_.empty() && Profiler::Begin();
 		{
-			return;
+			CompilationSession session = CompilationSession(GetOptions(), references);
+			session.Compile(files, output);
 		}
+		if (profiling)
+		{
+			Profiler::End();
+			if (!Profiler::WriteChromeTrace(profileOutput_))
+			{
+				std::cerr << "Error writing profile output." << std::endl;
+			}
+		}
+	}
 
-		auto pModule = module.get();
-		std::unique_ptr<Assembly> assembly = Assembly::Create(output);
-		assembly->SetModule(std::move(module));
+	CompilationOptions Compiler::GetOptions() const
+	{
+		CompilationOptions options;
+		options.threadCount = threadCount_;
+		options.includeOpen = includeOpen_;
+		options.includeClose = includeClose_;
+		options.optimizationLevel = optimizationLevel_;
+		return options;
+	}
 
-		Backend::ControlFlowAnalyzer cfAnalyzer = Backend::ControlFlowAnalyzer(logger.get(), pModule);
-		cfAnalyzer.Analyze();
+	void Compiler::SetProfileOutput(const std::string& path)
+	{
+		profileOutput_ = path;
+	}
 
-		Backend::ILOptimizer optimizer = Backend::ILOptimizer(logger.get(), pModule);
-		optimizer.Optimize();
+	void Compiler::SetThreadCount(size_t threadCount)
+	{
+		threadCount_ = std::max<size_t>(threadCount, 1);
+	}
 
-		if (!logger->HasErrors())
-		{
-			auto outputStream = FileStream::OpenCreate(output.c_str());
-			assembly->WriteToStream(*outputStream);
-		}
+	void Compiler::SetOptimizationLevel(Backend::OptimizationLevel level)
+	{
+		optimizationLevel_ = level;
 	}
 
 	void Compiler::SetIncludeHandler(IncludeOpen includeOpen, IncludeClose includeClose)
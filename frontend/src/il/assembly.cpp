@@ -1,6 +1,8 @@
 #include "assembly.hpp"
 #include "semantics/symbols/symbol_table.hpp"
+#include "semantics/symbols/symbol_index.hpp"
 #include "semantics/semantic_analyzer.hpp"
+#include "io/mapped_source.hpp"
 
 namespace HXSL
 {
@@ -21,6 +23,19 @@ namespace HXSL
 	{
 	}
 
+	Assembly::~Assembly() = default;
+
+	void Assembly::SetSymbolIndex(std::unique_ptr<SymbolIndexImage>&& image)
+	{
+		symbolIndex = std::move(image);
+	}
+
+	void Assembly::Seal()
+	{
+		sealed = true;
+		table->Freeze();
+	}
+
 	SymbolHandle Assembly::AddSymbol(const StringSpan& name, SymbolDef* def, const ObjPtr<SymbolMetadata>& metadata, SymbolTableNode* lookupIndex)
 	{
 		if (sealed)
@@ -49,25 +64,39 @@ namespace HXSL
 		return std::unique_ptr<Assembly>(new Assembly(path));
 	}
 
-	AssemblyLoadResult Assembly::LoadFromFile(const std::string& path, std::unique_ptr<Assembly>& assemblyOut)
+	std::unique_ptr<Assembly> Assembly::CreateView(const Assembly& source)
 	{
-		FILE* file;
-		auto error = fopen_s(&file, path.c_str(), "r");
+		auto view = Create(source.GetName());
+		view->referencedAssemblies = source.referencedAssemblies;
+		view->module.reset();
+		view->source = &source;
+		if (source.index)
+		{
+			view->table->AttachIndex(make_uptr<SymbolIndexLoader>(view.get(), view->table.get(), *source.index));
+		}
+		return view;
+	}
 
-		if (error != 0 || file == nullptr)
+	AssemblyLoadResult Assembly::LoadFromFile(const std::string& path, std::unique_ptr<Assembly>& assemblyOut)
+	{
+		// the symbol index is decoded straight from the mapping, so it stays alive as long as the assembly does.
+		auto mapped = MappedSource::Open(path.c_str());
+		if (!mapped)
 		{
 			return AssemblyLoadResult_FileNotFound;
 		}
 
-		std::unique_ptr<FILE, decltype(&fclose)> filePtr(file, &fclose);
-
-		FileStream fs(file);
-
-		auto result = LoadFromStream(path, fs, assemblyOut);
-		return result;
+		auto* data = reinterpret_cast<uint8_t*>(const_cast<char*>(mapped->GetData()));
+		MemoryStream stream(data, mapped->GetLength(), false);
+		return Load(path, stream, std::move(mapped), assemblyOut);
 	}
 
 	AssemblyLoadResult Assembly::LoadFromStream(const std::string& path, Stream& stream, std::unique_ptr<Assembly>& assemblyOut)
+	{
+		return Load(path, stream, nullptr, assemblyOut);
+	}
+
+	AssemblyLoadResult Assembly::Load(const std::string& path, Stream& stream, std::unique_ptr<MappedSource> mapping, std::unique_ptr<Assembly>& assemblyOut)
 	{
 		char buffer[magicSize];
 		stream.Read(buffer, magicSize);
@@ -90,6 +119,43 @@ namespace HXSL
 		Backend::ModuleReader reader(&stream);
 		assembly->module = reader.Read();
 
+		// assemblies written before the symbol index existed simply end here and fall back to decompiling the module.
+		int64_t position = stream.Position();
+		int64_t length = stream.Length();
+		if (position >= 0 && length - position >= static_cast<int64_t>(SymbolIndexView::HeaderSize))
+		{
+			size_t available = static_cast<size_t>(length - position);
+			const uint8_t* data = nullptr;
+			if (mapping)
+			{
+				data = reinterpret_cast<const uint8_t*>(mapping->GetData()) + position;
+			}
+			else
+			{
+				uint8_t header[SymbolIndexView::HeaderSize];
+				stream.Read(header, sizeof(header));
+				size_t size = SymbolIndexView::GetSectionSize(header, sizeof(header));
+				if (size != 0 && size <= available)
+				{
+					assembly->indexStorage.resize(size);
+					std::memcpy(assembly->indexStorage.data(), header, sizeof(header));
+					stream.Read(assembly->indexStorage.data() + sizeof(header), size - sizeof(header));
+					data = assembly->indexStorage.data();
+					available = size;
+				}
+			}
+
+			if (data)
+			{
+				auto index = std::make_unique<SymbolIndex>(reader.TakeRecordMap());
+				if (index->Open(data, available))
+				{
+					assembly->index = std::move(index);
+				}
+			}
+		}
+
+		assembly->mapping = std::move(mapping);
 		assembly->Seal();
 		assemblyOut = std::move(assembly);
 		return AssemblyLoadResult_Success;
@@ -122,7 +188,12 @@ namespace HXSL
 		}
 
 		Backend::ModuleWriter writer(&stream);
-		writer.Write(module.get());
+		writer.Write(GetModule());
+
+		if (symbolIndex)
+		{
+			symbolIndex->Write(stream, writer);
+		}
 		return 0;
 	}
 }
\ No newline at end of file
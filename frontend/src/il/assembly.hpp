@@ -14,6 +14,9 @@ namespace HXSL
 	class SymbolTable;
 	class SymbolDef;
 	class SymbolMetadata;
+	class SymbolIndexImage;
+	class SymbolIndex;
+	class MappedSource;
 
 	enum AssemblyLoadResult
 	{
@@ -37,25 +40,36 @@ namespace HXSL
 		std::unique_ptr<SymbolTable> table;
 		std::unique_ptr<Backend::Module> module;
 		std::vector<AssemblyReference> referencedAssemblies;
+		std::unique_ptr<SymbolIndexImage> symbolIndex; // written behind the module, only set for freshly compiled assemblies.
+		std::unique_ptr<MappedSource> mapping; // backs the symbol index of assemblies loaded from a file.
+		std::vector<uint8_t> indexStorage; // backs the symbol index of assemblies loaded from any other stream.
+		std::unique_ptr<SymbolIndex> index; // read only, materialized into the table of every view separately.
+		const Assembly* source = nullptr; // set for views, owns the module and the symbol index.
 		bool sealed;
+
+		static AssemblyLoadResult Load(const std::string& path, Stream& stream, std::unique_ptr<MappedSource> mapping, std::unique_ptr<Assembly>& assemblyOut);
+
 	public:
+		~Assembly();
+
 		const std::string& GetName() const noexcept { return *name.get(); }
 
 		ConstSpan<AssemblyReference> GetReferencedAssemblies() const noexcept { return referencedAssemblies; }
 
 		const SymbolTable* GetSymbolTable() const noexcept { return table.get(); }
 
-		Backend::Module* GetModule() noexcept { return module.get(); }
+		Backend::Module* GetModule() noexcept { return source ? source->module.get() : module.get(); }
 
-		const Backend::Module* GetModule() const noexcept { return module.get(); }
+		const Backend::Module* GetModule() const noexcept { return source ? source->module.get() : module.get(); }
 
 		void SetModule(std::unique_ptr<Backend::Module>&& newModule) { module = std::move(newModule); }
 
-		SymbolTable* GetMutableSymbolTable() const { if (sealed) { throw std::logic_error("Cannot modify symbol table: Assembly is sealed."); } return table.get(); }
+		void SetSymbolIndex(std::unique_ptr<SymbolIndexImage>&& image);
 
-		void Seal() noexcept { sealed = true; };
+		SymbolTable* GetMutableSymbolTable() const { if (sealed) { throw std::logic_error("Cannot modify symbol table: Assembly is sealed."); } return table.get(); }
 
-		void UnsealUnsafe() noexcept { sealed = false; }
+		// Seals the assembly and freezes the path index of its symbol table.
+		void Seal();
 
 		bool IsSealed() const noexcept { return sealed; }
 
@@ -65,6 +79,10 @@ namespace HXSL
 
 		static std::unique_ptr<Assembly> Create(const std::string& path);
 
+		// Creates an assembly for a single compilation that shares the module and symbol index of source but owns its symbol table,
+		// so compilations referencing the same assembly never write to each other's symbols. source has to outlive the view.
+		static std::unique_ptr<Assembly> CreateView(const Assembly& source);
+
 		static AssemblyLoadResult LoadFromFile(const std::string& path, std::unique_ptr<Assembly>& assemblyOut);
 
 		static AssemblyLoadResult LoadFromStream(const std::string& path, Stream& stream, std::unique_ptr<Assembly>& assemblyOut);
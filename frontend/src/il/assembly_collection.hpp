@@ -33,6 +33,17 @@ namespace HXSL
 			return assemblies;
 		}
 
+		// a collection of views on these assemblies for a single compilation, see Assembly::CreateView.
+		AssemblyCollection CreateViews() const
+		{
+			AssemblyCollection views;
+			for (auto& assembly : assemblies)
+			{
+				views.AddAssembly(Assembly::CreateView(*assembly));
+			}
+			return views;
+		}
+
 		void FindAssembliesByNamespace(const StringSpan& target, std::vector<AssemblySymbolRef>& assemblyRefs, SymbolTableNode* lookupIndex = nullptr) const
 		{
 			for (auto& assembly : assemblies)
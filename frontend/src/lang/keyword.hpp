@@ -316,156 +316,170 @@ namespace HXSL
 		}
 	}
 
+	struct KeywordEntry
+	{
+		std::string_view name;
+		Keyword value;
+	};
+
+	constexpr KeywordEntry KeywordTable[] =
+	{
+		{ "AppendStructuredBuffer", Keyword_AppendStructuredBuffer },
+		{ "asm", Keyword_Asm },
+		{ "asm_fragment", Keyword_AsmFragment },
+		{ "BlendState", Keyword_BlendState },
+		{ "bool", Keyword_Bool },
+		{ "break", Keyword_Break },
+		{ "Buffer", Keyword_Buffer },
+		{ "ByteAddressBuffer", Keyword_ByteAddressBuffer },
+		{ "case", Keyword_Case },
+		{ "cbuffer", Keyword_Cbuffer },
+		{ "centroid", Keyword_Centroid },
+		{ "class", Keyword_Class },
+		{ "column_major", Keyword_ColumnMajor },
+		{ "compile", Keyword_Compile },
+		{ "compile_fragment", Keyword_CompileFragment },
+		{ "CompileShader", Keyword_CompileShader },
+		{ "const", Keyword_Const },
+		{ "continue", Keyword_Continue },
+		{ "ComputeShader", Keyword_ComputeShader },
+		{ "ConsumeStructuredBuffer", Keyword_ConsumeStructuredBuffer },
+		{ "default", Keyword_Default },
+		{ "DepthStencilState", Keyword_DepthStencilState },
+		{ "DepthStencilView", Keyword_DepthStencilView },
+		{ "discard", Keyword_Discard },
+		{ "do", Keyword_Do },
+		{ "double", Keyword_Double },
+		{ "DomainShader", Keyword_DomainShader },
+		{ "dword", Keyword_Dword },
+		{ "else", Keyword_Else },
+		{ "enum", Keyword_Enum },
+		{ "export", Keyword_Export },
+		{ "extern", Keyword_Extern },
+		{ "false", Keyword_False },
+		{ "float", Keyword_Float },
+		{ "for", Keyword_For },
+		{ "fxgroup", Keyword_Fxgroup },
+		{ "GeometryShader", Keyword_GeometryShader },
+		{ "groupshared", Keyword_Groupshared },
+		{ "half", Keyword_Half },
+		{ "Hullshader", Keyword_Hullshader },
+		{ "if", Keyword_If },
+		{ "in", Keyword_In },
+		{ "inline", Keyword_Inline },
+		{ "inout", Keyword_Inout },
+		{ "InputPatch", Keyword_InputPatch },
+		{ "int", Keyword_Int },
+		{ "interface", Keyword_Interface },
+		{ "line", Keyword_Line },
+		{ "lineadj", Keyword_Lineadj },
+		{ "linear", Keyword_Linear },
+		{ "LineStream", Keyword_LineStream },
+		{ "matrix", Keyword_Matrix },
+		{ "min16float", Keyword_Min16float },
+		{ "min10float", Keyword_Min10float },
+		{ "min16int", Keyword_Min16int },
+		{ "min12int", Keyword_Min12int },
+		{ "min16uint", Keyword_Min16uint },
+		{ "namespace", Keyword_Namespace },
+		{ "nointerpolation", Keyword_NoInterpolation },
+		{ "noperspective", Keyword_Noperspective },
+		{ "NULL", Keyword_Null },
+		{ "out", Keyword_Out },
+		{ "OutputPatch", Keyword_OutputPatch },
+		{ "packoffset", Keyword_Packoffset },
+		{ "pass", Keyword_Pass },
+		{ "pixelfragment", Keyword_Pixelfragment },
+		{ "PixelShader", Keyword_PixelShader },
+		{ "point", Keyword_Point },
+		{ "PointStream", Keyword_PointStream },
+		{ "precise", Keyword_Precise },
+		{ "RasterizerState", Keyword_RasterizerState },
+		{ "RenderTargetView", Keyword_RenderTargetView },
+		{ "return", Keyword_Return },
+		{ "register", Keyword_Register },
+		{ "row_major", Keyword_RowMajor },
+		{ "RWBuffer", Keyword_RWBuffer },
+		{ "RWByteAddressBuffer", Keyword_RWByteAddressBuffer },
+		{ "RWStructuredBuffer", Keyword_RWStructuredBuffer },
+		{ "RWTexture1D", Keyword_RWTexture1D },
+		{ "RWTexture1DArray", Keyword_RWTexture1DArray },
+		{ "RWTexture2D", Keyword_RWTexture2D },
+		{ "RWTexture2DArray", Keyword_RWTexture2DArray },
+		{ "RWTexture3D", Keyword_RWTexture3D },
+		{ "sample", Keyword_Sample },
+		{ "sampler", Keyword_Sampler },
+		{ "SamplerState", Keyword_SamplerState },
+		{ "SamplerComparisonState", Keyword_SamplerComparisonState },
+		{ "shared", Keyword_Shared },
+		{ "snorm", Keyword_Snorm },
+		{ "stateblock", Keyword_Stateblock },
+		{ "stateblock_state", Keyword_StateblockState },
+		{ "static", Keyword_Static },
+		{ "string", Keyword_String },
+		{ "struct", Keyword_Struct },
+		{ "switch", Keyword_Switch },
+		{ "StructuredBuffer", Keyword_StructuredBuffer },
+		{ "tbuffer", Keyword_Tbuffer },
+		{ "technique", Keyword_Technique },
+		{ "technique10", Keyword_Technique10 },
+		{ "technique11", Keyword_Technique11 },
+		{ "texture", Keyword_Texture },
+		{ "Texture1D", Keyword_Texture1D },
+		{ "Texture1DArray", Keyword_Texture1DArray },
+		{ "Texture2D", Keyword_Texture2D },
+		{ "Texture2DArray", Keyword_Texture2DArray },
+		{ "Texture2DMS", Keyword_Texture2DMS },
+		{ "Texture2DMSArray", Keyword_Texture2DMSArray },
+		{ "Texture3D", Keyword_Texture3D },
+		{ "TextureCube", Keyword_TextureCube },
+		{ "TextureCubeArray", Keyword_TextureCubeArray },
+		{ "true", Keyword_True },
+		{ "typedef", Keyword_Typedef },
+		{ "triangle", Keyword_Triangle },
+		{ "triangleadj", Keyword_Triangleadj },
+		{ "TriangleStream", Keyword_TriangleStream },
+		{ "uint", Keyword_Uint },
+		{ "uniform", Keyword_Uniform },
+		{ "unorm", Keyword_Unorm },
+		{ "unsigned", Keyword_Unsigned },
+		{ "vector", Keyword_Vector },
+		{ "vertexfragment", Keyword_Vertexfragment },
+		{ "VertexShader", Keyword_VertexShader },
+		{ "void", Keyword_Void },
+		{ "volatile", Keyword_Volatile },
+		{ "while", Keyword_While },
+		{ "operator", Keyword_Operator },
+		{ "implicit", Keyword_Implicit },
+		{ "explicit", Keyword_Explicit },
+		{ "using", Keyword_Using },
+		{ "private", Keyword_Private },
+		{ "protected", Keyword_Protected },
+		{ "internal", Keyword_Internal },
+		{ "public", Keyword_Public },
+		//{ "this", Keyword_This },
+		{ "new", Keyword_New },
+		{ "mnew", Keyword_MNew },
+		{ "mfree", keyword_MFree },
+		{ "#define", Keyword_PrepDefine },
+		{ "#if", Keyword_PrepIf },
+		{ "#elif", Keyword_PrepElif },
+		{ "#else", Keyword_PrepElse },
+		{ "#endif", Keyword_PrepEndif },
+		{ "#ifdef", Keyword_PrepIfdef },
+		{ "#ifndef", Keyword_PrepIfndef },
+		{ "#include", Keyword_PrepInclude },
+		{ "#error", Keyword_PrepError },
+		{ "#warning", Keyword_PrepWarning },
+		{ "#pragma", Keyword_PrepPragma }
+	};
+
 	static void BuildKeywordRadix(RadixTree<int>& t)
 	{
-		t.Insert("AppendStructuredBuffer", Keyword_AppendStructuredBuffer);
-		t.Insert("asm", Keyword_Asm);
-		t.Insert("asm_fragment", Keyword_AsmFragment);
-		t.Insert("BlendState", Keyword_BlendState);
-		t.Insert("bool", Keyword_Bool);
-		t.Insert("break", Keyword_Break);
-		t.Insert("Buffer", Keyword_Buffer);
-		t.Insert("ByteAddressBuffer", Keyword_ByteAddressBuffer);
-		t.Insert("case", Keyword_Case);
-		t.Insert("cbuffer", Keyword_Cbuffer);
-		t.Insert("centroid", Keyword_Centroid);
-		t.Insert("class", Keyword_Class);
-		t.Insert("column_major", Keyword_ColumnMajor);
-		t.Insert("compile", Keyword_Compile);
-		t.Insert("compile_fragment", Keyword_CompileFragment);
-		t.Insert("CompileShader", Keyword_CompileShader);
-		t.Insert("const", Keyword_Const);
-		t.Insert("continue", Keyword_Continue);
-		t.Insert("ComputeShader", Keyword_ComputeShader);
-		t.Insert("ConsumeStructuredBuffer", Keyword_ConsumeStructuredBuffer);
-		t.Insert("default", Keyword_Default);
-		t.Insert("DepthStencilState", Keyword_DepthStencilState);
-		t.Insert("DepthStencilView", Keyword_DepthStencilView);
-		t.Insert("discard", Keyword_Discard);
-		t.Insert("do", Keyword_Do);
-		t.Insert("double", Keyword_Double);
-		t.Insert("DomainShader", Keyword_DomainShader);
-		t.Insert("dword", Keyword_Dword);
-		t.Insert("else", Keyword_Else);
-		t.Insert("enum", Keyword_Enum);
-		t.Insert("export", Keyword_Export);
-		t.Insert("extern", Keyword_Extern);
-		t.Insert("false", Keyword_False);
-		t.Insert("float", Keyword_Float);
-		t.Insert("for", Keyword_For);
-		t.Insert("fxgroup", Keyword_Fxgroup);
-		t.Insert("GeometryShader", Keyword_GeometryShader);
-		t.Insert("groupshared", Keyword_Groupshared);
-		t.Insert("half", Keyword_Half);
-		t.Insert("Hullshader", Keyword_Hullshader);
-		t.Insert("if", Keyword_If);
-		t.Insert("in", Keyword_In);
-		t.Insert("inline", Keyword_Inline);
-		t.Insert("inout", Keyword_Inout);
-		t.Insert("InputPatch", Keyword_InputPatch);
-		t.Insert("int", Keyword_Int);
-		t.Insert("interface", Keyword_Interface);
-		t.Insert("line", Keyword_Line);
-		t.Insert("lineadj", Keyword_Lineadj);
-		t.Insert("linear", Keyword_Linear);
-		t.Insert("LineStream", Keyword_LineStream);
-		t.Insert("matrix", Keyword_Matrix);
-		t.Insert("min16float", Keyword_Min16float);
-		t.Insert("min10float", Keyword_Min10float);
-		t.Insert("min16int", Keyword_Min16int);
-		t.Insert("min12int", Keyword_Min12int);
-		t.Insert("min16uint", Keyword_Min16uint);
-		t.Insert("namespace", Keyword_Namespace);
-		t.Insert("nointerpolation", Keyword_NoInterpolation);
-		t.Insert("noperspective", Keyword_Noperspective);
-		t.Insert("NULL", Keyword_Null);
-		t.Insert("out", Keyword_Out);
-		t.Insert("OutputPatch", Keyword_OutputPatch);
-		t.Insert("packoffset", Keyword_Packoffset);
-		t.Insert("pass", Keyword_Pass);
-		t.Insert("pixelfragment", Keyword_Pixelfragment);
-		t.Insert("PixelShader", Keyword_PixelShader);
-		t.Insert("point", Keyword_Point);
-		t.Insert("PointStream", Keyword_PointStream);
-		t.Insert("precise", Keyword_Precise);
-		t.Insert("RasterizerState", Keyword_RasterizerState);
-		t.Insert("RenderTargetView", Keyword_RenderTargetView);
-		t.Insert("return", Keyword_Return);
-		t.Insert("register", Keyword_Register);
-		t.Insert("row_major", Keyword_RowMajor);
-		t.Insert("RWBuffer", Keyword_RWBuffer);
-		t.Insert("RWByteAddressBuffer", Keyword_RWByteAddressBuffer);
-		t.Insert("RWStructuredBuffer", Keyword_RWStructuredBuffer);
-		t.Insert("RWTexture1D", Keyword_RWTexture1D);
-		t.Insert("RWTexture1DArray", Keyword_RWTexture1DArray);
-		t.Insert("RWTexture2D", Keyword_RWTexture2D);
-		t.Insert("RWTexture2DArray", Keyword_RWTexture2DArray);
-		t.Insert("RWTexture3D", Keyword_RWTexture3D);
-		t.Insert("sample", Keyword_Sample);
-		t.Insert("sampler", Keyword_Sampler);
-		t.Insert("SamplerState", Keyword_SamplerState);
-		t.Insert("SamplerComparisonState", Keyword_SamplerComparisonState);
-		t.Insert("shared", Keyword_Shared);
-		t.Insert("snorm", Keyword_Snorm);
-		t.Insert("stateblock", Keyword_Stateblock);
-		t.Insert("stateblock_state", Keyword_StateblockState);
-		t.Insert("static", Keyword_Static);
-		t.Insert("string", Keyword_String);
-		t.Insert("struct", Keyword_Struct);
-		t.Insert("switch", Keyword_Switch);
-		t.Insert("StructuredBuffer", Keyword_StructuredBuffer);
-		t.Insert("tbuffer", Keyword_Tbuffer);
-		t.Insert("technique", Keyword_Technique);
-		t.Insert("technique10", Keyword_Technique10);
-		t.Insert("technique11", Keyword_Technique11);
-		t.Insert("texture", Keyword_Texture);
-		t.Insert("Texture1D", Keyword_Texture1D);
-		t.Insert("Texture1DArray", Keyword_Texture1DArray);
-		t.Insert("Texture2D", Keyword_Texture2D);
-		t.Insert("Texture2DArray", Keyword_Texture2DArray);
-		t.Insert("Texture2DMS", Keyword_Texture2DMS);
-		t.Insert("Texture2DMSArray", Keyword_Texture2DMSArray);
-		t.Insert("Texture3D", Keyword_Texture3D);
-		t.Insert("TextureCube", Keyword_TextureCube);
-		t.Insert("TextureCubeArray", Keyword_TextureCubeArray);
-		t.Insert("true", Keyword_True);
-		t.Insert("typedef", Keyword_Typedef);
-		t.Insert("triangle", Keyword_Triangle);
-		t.Insert("triangleadj", Keyword_Triangleadj);
-		t.Insert("TriangleStream", Keyword_TriangleStream);
-		t.Insert("uint", Keyword_Uint);
-		t.Insert("uniform", Keyword_Uniform);
-		t.Insert("unorm", Keyword_Unorm);
-		t.Insert("unsigned", Keyword_Unsigned);
-		t.Insert("vector", Keyword_Vector);
-		t.Insert("vertexfragment", Keyword_Vertexfragment);
-		t.Insert("VertexShader", Keyword_VertexShader);
-		t.Insert("void", Keyword_Void);
-		t.Insert("volatile", Keyword_Volatile);
-		t.Insert("while", Keyword_While);
-		t.Insert("operator", Keyword_Operator);
-		t.Insert("implicit", Keyword_Implicit);
-		t.Insert("explicit", Keyword_Explicit);
-		t.Insert("using", Keyword_Using);
-		t.Insert("private", Keyword_Private);
-		t.Insert("protected", Keyword_Protected);
-		t.Insert("internal", Keyword_Internal);
-		t.Insert("public", Keyword_Public);
-		//t.Insert("this", Keyword_This);
-		t.Insert("new", Keyword_New);
-		t.Insert("mnew", Keyword_MNew);
-		t.Insert("mfree", keyword_MFree);
-		t.Insert("#define", Keyword_PrepDefine);
-		t.Insert("#if", Keyword_PrepIf);
-		t.Insert("#elif", Keyword_PrepElif);
-		t.Insert("#else", Keyword_PrepElse);
-		t.Insert("#endif", Keyword_PrepEndif);
-		t.Insert("#ifdef", Keyword_PrepIfdef);
-		t.Insert("#ifndef", Keyword_PrepIfndef);
-		t.Insert("#include", Keyword_PrepInclude);
-		t.Insert("#error", Keyword_PrepError);
-		t.Insert("#warning", Keyword_PrepWarning);
-		t.Insert("#pragma", Keyword_PrepPragma);
+		for (auto& entry : KeywordTable)
+		{
+			t.Insert(entry.name, entry.value);
+		}
 	}
 }
 #endif
\ No newline at end of file
@@ -94,44 +94,58 @@ namespace HXSL
 		}
 	}
 
+	struct OperatorEntry
+	{
+		std::string_view name;
+		Operator value;
+	};
+
+	constexpr OperatorEntry OperatorTable[] =
+	{
+		{ "+", Operator_Add },
+		{ "-", Operator_Subtract },
+		{ "*", Operator_Multiply },
+		{ "/", Operator_Divide },
+		{ "%", Operator_Modulus },
+		{ "=", Operator_Assign },
+		{ "+=", Operator_PlusAssign },
+		{ "-=", Operator_MinusAssign },
+		{ "*=", Operator_MultiplyAssign },
+		{ "/=", Operator_DivideAssign },
+		{ "%=", Operator_ModulusAssign },
+		{ "~", Operator_BitwiseNot },
+		{ "<<", Operator_BitwiseShiftLeft },
+		{ ">>", Operator_BitwiseShiftRight },
+		{ "&", Operator_BitwiseAnd },
+		{ "|", Operator_BitwiseOr },
+		{ "^", Operator_BitwiseXor },
+		{ "<<=", Operator_BitwiseShiftLeftAssign },
+		{ ">>=", Operator_BitwiseShiftRightAssign },
+		{ "&=", Operator_BitwiseAndAssign },
+		{ "|=", Operator_BitwiseOrAssign },
+		{ "^=", Operator_BitwiseXorAssign },
+		{ "&&", Operator_AndAnd },
+		{ "||", Operator_OrOr },
+		{ "?", Operator_Ternary },
+		{ ":", Operator_TernaryElse },
+		{ "<", Operator_LessThan },
+		{ ">", Operator_GreaterThan },
+		{ "==", Operator_Equal },
+		{ "!=", Operator_NotEqual },
+		{ "<=", Operator_LessThanOrEqual },
+		{ ">=", Operator_GreaterThanOrEqual },
+		{ "++", Operator_Increment },
+		{ "--", Operator_Decrement },
+		{ ".", Operator_MemberAccess },
+		{ "!", Operator_LogicalNot }
+	};
+
 	static void BuildOperatorRadix(RadixTree<int>& t)
 	{
-		t.Insert("+", Operator_Add);
-		t.Insert("-", Operator_Subtract);
-		t.Insert("*", Operator_Multiply);
-		t.Insert("/", Operator_Divide);
-		t.Insert("%", Operator_Modulus);
-		t.Insert("=", Operator_Assign);
-		t.Insert("+=", Operator_PlusAssign);
-		t.Insert("-=", Operator_MinusAssign);
-		t.Insert("*=", Operator_MultiplyAssign);
-		t.Insert("/=", Operator_DivideAssign);
-		t.Insert("%=", Operator_ModulusAssign);
-		t.Insert("~", Operator_BitwiseNot);
-		t.Insert("<<", Operator_BitwiseShiftLeft);
-		t.Insert(">>", Operator_BitwiseShiftRight);
-		t.Insert("&", Operator_BitwiseAnd);
-		t.Insert("|", Operator_BitwiseOr);
-		t.Insert("^", Operator_BitwiseXor);
-		t.Insert("<<=", Operator_BitwiseShiftLeftAssign);
-		t.Insert(">>=", Operator_BitwiseShiftRightAssign);
-		t.Insert("&=", Operator_BitwiseAndAssign);
-		t.Insert("|=", Operator_BitwiseOrAssign);
-		t.Insert("^=", Operator_BitwiseXorAssign);
-		t.Insert("&&", Operator_AndAnd);
-		t.Insert("||", Operator_OrOr);
-		t.Insert("?", Operator_Ternary);
-		t.Insert(":", Operator_TernaryElse);
-		t.Insert("<", Operator_LessThan);
-		t.Insert(">", Operator_GreaterThan);
-		t.Insert("==", Operator_Equal);
-		t.Insert("!=", Operator_NotEqual);
-		t.Insert("<=", Operator_LessThanOrEqual);
-		t.Insert(">=", Operator_GreaterThanOrEqual);
-		t.Insert("++", Operator_Increment);
-		t.Insert("--", Operator_Decrement);
-		t.Insert(".", Operator_MemberAccess);
-		t.Insert("!", Operator_LogicalNot);
+		for (auto& entry : OperatorTable)
+		{
+			t.Insert(entry.name, entry.value);
+		}
 	}
 
 	namespace Operators
@@ -0,0 +1,379 @@
+#include "builtin_recognizer.hpp"
+#include "lang/language.hpp"
+#include "pch/std.hpp"
+
+namespace HXSL::BuiltinRecognizer
+{
+	namespace
+	{
+		constexpr uint8_t NonIdentifierClass = 63;
+
+		// Maps [A-Za-z0-9_] to 0..62 so a set of identifier characters fits into a single uint64_t.
+		constexpr std::array<uint8_t, 256> BuildIdentifierClasses()
+		{
+			std::array<uint8_t, 256> classes{};
+			uint8_t next = 0;
+			for (size_t c = 0; c < 256; c++)
+			{
+				bool identifier = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+				classes[c] = identifier ? next++ : NonIdentifierClass;
+			}
+			return classes;
+		}
+
+		constexpr std::array<uint8_t, 256> IdentifierClasses = BuildIdentifierClasses();
+
+		constexpr uint32_t Load32(const char* text)
+		{
+			if (std::is_constant_evaluated())
+			{
+				return static_cast<uint8_t>(text[0]) | static_cast<uint8_t>(text[1]) << 8 | static_cast<uint8_t>(text[2]) << 16 | static_cast<uint32_t>(static_cast<uint8_t>(text[3])) << 24;
+			}
+			uint32_t value;
+			std::memcpy(&value, text, sizeof(uint32_t));
+			return value;
+		}
+
+		// Head, middle and tail windows of a word, for words of up to 12 characters they cover every byte so comparing them is an exact match.
+		struct WordKey
+		{
+			uint32_t head;
+			uint32_t middle;
+			uint32_t tail;
+
+			constexpr bool operator==(const WordKey& other) const = default;
+
+			constexpr uint32_t Hash() const
+			{
+				return head ^ ((middle << 7) | (middle >> 25)) * 0x85EBCA6Bu ^ ((tail << 17) | (tail >> 15)) * 0xC2B2AE35u;
+			}
+		};
+
+		constexpr size_t WordKeyCoveredLength = 12;
+
+		constexpr WordKey MakeWordKey(const char* text, size_t length)
+		{
+			if (length < 4)
+			{
+				uint32_t value = 0;
+				for (size_t i = 0; i < length; i++)
+				{
+					value |= static_cast<uint32_t>(static_cast<uint8_t>(text[i])) << (i * 8);
+				}
+				return { value, 0, 0 };
+			}
+
+			return { Load32(text), Load32(text + (length - 4) / 2), Load32(text + length - 4) };
+		}
+
+		constexpr size_t KeywordCount = std::size(KeywordTable);
+
+		constexpr size_t ComputeMaxKeywordLength()
+		{
+			size_t maxLength = 0;
+			for (auto& entry : KeywordTable)
+			{
+				maxLength = std::max(maxLength, entry.name.size());
+			}
+			return maxLength;
+		}
+
+		constexpr size_t MaxKeywordLength = ComputeMaxKeywordLength();
+
+		// Rejects most identifiers after two characters, without it every identifier would be scanned to its end before the hash lookup.
+		struct KeywordPrefixFilter
+		{
+			std::array<uint8_t, 256> rowOf{}; // row + 1 for characters a keyword starts with, 0 otherwise.
+			std::array<uint64_t, 64> secondChars{};
+		};
+
+		constexpr KeywordPrefixFilter BuildKeywordPrefixFilter()
+		{
+			KeywordPrefixFilter filter{};
+			uint8_t rows = 0;
+			for (auto& entry : KeywordTable)
+			{
+				auto& row = filter.rowOf[static_cast<uint8_t>(entry.name[0])];
+				if (row == 0)
+				{
+					row = ++rows;
+				}
+				filter.secondChars[row - 1] |= uint64_t(1) << IdentifierClasses[static_cast<uint8_t>(entry.name[1])];
+			}
+			return filter;
+		}
+
+		constexpr KeywordPrefixFilter KeywordPrefixes = BuildKeywordPrefixFilter();
+
+		constexpr bool VerifyKeywordPrefixes()
+		{
+			for (auto& entry : KeywordTable)
+			{
+				if (entry.name.size() < 2 || IdentifierClasses[static_cast<uint8_t>(entry.name[1])] == NonIdentifierClass) return false;
+				for (size_t i = 2; i < entry.name.size(); i++)
+				{
+					if (IdentifierClasses[static_cast<uint8_t>(entry.name[i])] == NonIdentifierClass) return false;
+				}
+			}
+			return true;
+		}
+
+		static_assert(VerifyKeywordPrefixes(), "Keywords must be at least two characters long and may only contain identifier characters after the first one.");
+
+		// Each length gets its own table with at least twice as many slots as keywords, the multiplier is searched until the bucket has no collisions.
+		constexpr uint32_t BucketBits(size_t length)
+		{
+			size_t count = 0;
+			for (auto& entry : KeywordTable)
+			{
+				if (entry.name.size() == length) count++;
+			}
+
+			uint32_t bits = 0;
+			while (count != 0 && (size_t(1) << bits) < count * 2)
+			{
+				bits++;
+			}
+			return bits;
+		}
+
+		constexpr size_t ComputeKeywordSlotCount()
+		{
+			size_t total = 0;
+			for (size_t length = 0; length <= MaxKeywordLength; length++)
+			{
+				uint32_t bits = BucketBits(length);
+				total += bits ? size_t(1) << bits : 0;
+			}
+			return total;
+		}
+
+		constexpr size_t KeywordSlotCount = ComputeKeywordSlotCount();
+
+		struct KeywordBucket
+		{
+			uint16_t offset;
+			uint8_t bits;
+			uint32_t multiplier;
+
+			constexpr uint32_t Slot(uint32_t hash) const
+			{
+				return (hash * multiplier) >> (32 - bits);
+			}
+		};
+
+		struct KeywordHashTable
+		{
+			std::array<KeywordBucket, MaxKeywordLength + 1> buckets{};
+			std::array<uint8_t, KeywordSlotCount> slots{}; // index into KeywordTable + 1, 0 is empty.
+			std::array<WordKey, KeywordCount> keys{};
+		};
+
+		constexpr KeywordHashTable BuildKeywordHashTable()
+		{
+			KeywordHashTable table{};
+			for (size_t i = 0; i < KeywordCount; i++)
+			{
+				table.keys[i] = MakeWordKey(KeywordTable[i].name.data(), KeywordTable[i].name.size());
+			}
+
+			size_t offset = 0;
+			for (size_t length = 0; length <= MaxKeywordLength; length++)
+			{
+				auto& bucket = table.buckets[length];
+				bucket.offset = static_cast<uint16_t>(offset);
+				bucket.bits = static_cast<uint8_t>(BucketBits(length));
+				if (bucket.bits == 0)
+				{
+					continue;
+				}
+
+				size_t size = size_t(1) << bucket.bits;
+				for (uint32_t multiplier = 0x9E3779B1u, attempts = 0; attempts < 4096; multiplier += 2, attempts++)
+				{
+					bucket.multiplier = multiplier;
+					for (size_t i = 0; i < size; i++)
+					{
+						table.slots[offset + i] = 0;
+					}
+
+					bool collision = false;
+					for (size_t i = 0; i < KeywordCount && !collision; i++)
+					{
+						auto& name = KeywordTable[i].name;
+						if (name.size() != length) continue;
+						auto& slot = table.slots[offset + bucket.Slot(MakeWordKey(name.data(), length).Hash())];
+						collision = slot != 0;
+						slot = static_cast<uint8_t>(i + 1);
+					}
+
+					if (!collision) break;
+					bucket.multiplier = 0;
+				}
+
+				offset += size;
+			}
+			return table;
+		}
+
+		constexpr KeywordHashTable KeywordHash = BuildKeywordHashTable();
+
+		constexpr bool VerifyKeywordHash()
+		{
+			for (size_t i = 0; i < KeywordCount; i++)
+			{
+				auto& name = KeywordTable[i].name;
+				auto& bucket = KeywordHash.buckets[name.size()];
+				if (KeywordHash.slots[bucket.offset + bucket.Slot(MakeWordKey(name.data(), name.size()).Hash())] != i + 1)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		static_assert(KeywordCount < std::numeric_limits<uint8_t>::max(), "Keyword slots store indices as uint8_t.");
+		static_assert(KeywordSlotCount <= std::numeric_limits<uint16_t>::max(), "Keyword bucket offsets are stored as uint16_t.");
+		static_assert(VerifyKeywordHash(), "Keyword hash table is not perfect.");
+
+		// Operators are recognized by a DFA over the operator trie, characters are first mapped to a small class index
+		// so each state only needs a transition per operator character instead of per byte.
+		constexpr size_t MaxOperatorStates = []()
+			{
+				size_t count = 1;
+				for (auto& entry : OperatorTable)
+				{
+					count += entry.name.size();
+				}
+				return count;
+			}();
+
+		struct OperatorClasses
+		{
+			std::array<uint8_t, 256> classOf{};
+			size_t count = 1; // class 0 is "not an operator character".
+		};
+
+		constexpr OperatorClasses BuildOperatorClasses()
+		{
+			OperatorClasses classes{};
+			for (auto& entry : OperatorTable)
+			{
+				for (char c : entry.name)
+				{
+					auto& cls = classes.classOf[static_cast<uint8_t>(c)];
+					if (cls == 0)
+					{
+						cls = static_cast<uint8_t>(classes.count++);
+					}
+				}
+			}
+			return classes;
+		}
+
+		constexpr OperatorClasses OperatorCharClasses = BuildOperatorClasses();
+		constexpr size_t OperatorClassCount = OperatorCharClasses.count;
+
+		struct OperatorDFA
+		{
+			std::array<std::array<uint8_t, OperatorClassCount>, MaxOperatorStates> next{}; // 0 is no transition, the root is never re-entered.
+			std::array<Operator, MaxOperatorStates> accept{};
+		};
+
+		constexpr OperatorDFA BuildOperatorDFA()
+		{
+			OperatorDFA dfa{};
+			size_t stateCount = 1;
+			for (auto& entry : OperatorTable)
+			{
+				size_t state = 0;
+				for (char c : entry.name)
+				{
+					auto& next = dfa.next[state][OperatorCharClasses.classOf[static_cast<uint8_t>(c)]];
+					if (next == 0)
+					{
+						next = static_cast<uint8_t>(stateCount++);
+					}
+					state = next;
+				}
+				dfa.accept[state] = entry.value;
+			}
+			return dfa;
+		}
+
+		constexpr OperatorDFA OperatorStates = BuildOperatorDFA();
+
+		static_assert(MaxOperatorStates <= std::numeric_limits<uint8_t>::max(), "Operator states are stored as uint8_t.");
+	}
+
+	bool MatchKeyword(const char* text, size_t length, int& keyword, size_t& keywordLength)
+	{
+		if (length < 2)
+		{
+			return false;
+		}
+
+		uint8_t row = KeywordPrefixes.rowOf[static_cast<uint8_t>(text[0])];
+		if (row == 0 || (KeywordPrefixes.secondChars[row - 1] >> IdentifierClasses[static_cast<uint8_t>(text[1])] & 1) == 0)
+		{
+			return false;
+		}
+
+		size_t limit = std::min(length, MaxKeywordLength + 1);
+		size_t end = 2;
+		while (end < limit && IdentifierClasses[static_cast<uint8_t>(text[end])] != NonIdentifierClass)
+		{
+			end++;
+		}
+
+		if (end > MaxKeywordLength)
+		{
+			return false;
+		}
+
+		auto& bucket = KeywordHash.buckets[end];
+		if (bucket.bits == 0)
+		{
+			return false;
+		}
+
+		WordKey key = MakeWordKey(text, end);
+		uint8_t index = KeywordHash.slots[bucket.offset + bucket.Slot(key.Hash())];
+		if (index == 0 || KeywordHash.keys[index - 1] != key)
+		{
+			return false;
+		}
+
+		auto& entry = KeywordTable[index - 1];
+		if (end > WordKeyCoveredLength && std::memcmp(entry.name.data() + 4, text + 4, end - 8) != 0)
+		{
+			return false;
+		}
+
+		keyword = entry.value;
+		keywordLength = end;
+		return true;
+	}
+
+	bool MatchOperator(const char* text, size_t length, int& op, size_t& operatorLength)
+	{
+		size_t state = 0;
+		size_t matched = 0;
+		for (size_t i = 0; i < length; i++)
+		{
+			uint8_t cls = OperatorCharClasses.classOf[static_cast<uint8_t>(text[i])];
+			if (cls == 0) break;
+			uint8_t next = OperatorStates.next[state][cls];
+			if (next == 0) break;
+			state = next;
+			if (OperatorStates.accept[state] != Operator_Unknown)
+			{
+				op = OperatorStates.accept[state];
+				matched = i + 1;
+			}
+		}
+
+		operatorLength = matched;
+		return matched != 0;
+	}
+}
\ No newline at end of file
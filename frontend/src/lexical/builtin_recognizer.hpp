@@ -0,0 +1,19 @@
+#ifndef BUILTIN_RECOGNIZER_HPP
+#define BUILTIN_RECOGNIZER_HPP
+
+#include "pch/std.hpp"
+
+namespace HXSL
+{
+	// Recognizers for the fixed HXSL keyword and operator sets, the tables are generated at compile time from KeywordTable and OperatorTable.
+	namespace BuiltinRecognizer
+	{
+		// Matches a whole keyword at the start of text, keywords are only matched if the identifier run is exactly a keyword.
+		bool MatchKeyword(const char* text, size_t length, int& keyword, size_t& keywordLength);
+
+		// Matches the longest operator at the start of text.
+		bool MatchOperator(const char* text, size_t length, int& op, size_t& operatorLength);
+	}
+}
+
+#endif
\ No newline at end of file
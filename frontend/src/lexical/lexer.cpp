@@ -1,5 +1,6 @@
 #include "lexer.hpp"
 #include "utils/text_helper.hpp"
+#include "utils/text_scan.hpp"
 #include "numbers.hpp"
 #include "pch/localization.hpp"
 
@@ -19,7 +20,7 @@ namespace HXSL
 
 		int keyword;
 		size_t keywordLength;
-		if (config->keywords.Find(state.AsSpan(), keyword, keywordLength) && keyword != 0)
+		if (config->MatchKeyword(state.AsSpan(), keyword, keywordLength))
 		{
 			size_t wordLength = state.FindWordBoundary(i + keywordLength);
 			if (wordLength == 0)
@@ -31,7 +32,7 @@ namespace HXSL
 
 		int op;
 		size_t operatorLength;
-		if (config->operators.Find(state.AsSpan(), op, operatorLength))
+		if (config->MatchOperator(state.AsSpan(), op, operatorLength))
 		{
 			// causes problems with -( for example, that's why we forward the delimiters.
 			size_t wordLength = state.FindOperatorBoundary(i + operatorLength, config->delimiters);
@@ -124,60 +125,67 @@ namespace HXSL
 		const char* current = state.Current();
 		if (std::isspace(*current))
 		{
-			auto end = state.End();
-			while (current < end)
+			const char* buffer = state.GetBuffer();
+			size_t len = state.GetLength();
+
+			if (!config->enableNewline && !config->enableWhitespace)
+			{
+				size_t lines = 0;
+				size_t next = TextScan::SkipWhitespace(buffer, i, len, lines);
+				if (lines)
+				{
+					state.NewLine(static_cast<uint32_t>(lines));
+				}
+				state.Jump(next);
+			}
+			else
 			{
-				char c = *current;
-				bool isCR = c == '\r';
-				if (isCR || c == '\n')
+				auto end = state.End();
+				while (current < end)
 				{
-					size_t width = 1;
-					const char* next = current + 1;
-					if (isCR && next < end && *next == '\n')
+					char c = *current;
+					bool isCR = c == '\r';
+					if (isCR || c == '\n')
 					{
-						width++;
-					}
+						size_t width = 1;
+						const char* next = current + 1;
+						if (isCR && next < end && *next == '\n')
+						{
+							width++;
+						}
 
-					state.NewLine();
+						state.NewLine();
 
-					if (config->enableNewline)
-					{
-						size_t idx = current - state.GetBuffer();
-						state.IndexNext = idx + width;
-						return Token(state.AsTextSpan(idx, width), TokenType_NewLine);
-					}
+						if (config->enableNewline)
+						{
+							size_t idx = current - buffer;
+							state.IndexNext = idx + width;
+							return Token(state.AsTextSpan(idx, width), TokenType_NewLine);
+						}
 
-					current = current + width;
-				}
-				else if (std::isspace(c))
-				{
-					const char* next = current + 1;
-					while (next < end)
+						current = current + width;
+					}
+					else if (std::isspace(c))
 					{
-						c = *next;
-						if (!std::isspace(c) || c == '\n' || c == '\r')
+						const char* next = buffer + TextScan::SkipBlanks(buffer, current - buffer + 1, len);
+						size_t width = next - current;
+						if (config->enableWhitespace)
 						{
-							break;
+							size_t idx = current - buffer;
+							state.IndexNext = idx + width;
+							return Token(state.AsTextSpan(idx, width), TokenType_Whitespace);
 						}
-						next++;
+
+						current = next;
 					}
-					size_t width = next - current;
-					if (config->enableWhitespace)
+					else
 					{
-						size_t idx = current - state.GetBuffer();
-						state.IndexNext = idx + width;
-						return Token(state.AsTextSpan(idx, width), TokenType_Whitespace);
+						break;
 					}
-
-					current = next;
-				}
-				else
-				{
-					break;
 				}
-			}
 
-			state.Jump(current - state.GetBuffer());
+				state.Jump(current - buffer);
+			}
 		}
 
 		if (state.IsEOF())
@@ -1,5 +1,4 @@
 #include "lexer_config.hpp"
-#include "lang/language.hpp"
 #include "pch/std.hpp"
 
 namespace HXSL
@@ -11,15 +10,13 @@ namespace HXSL
 	static void Init()
 	{
 		mainConfig = std::make_unique<LexerConfig>();
-		BuildKeywordRadix(mainConfig->keywords);
-		BuildOperatorRadix(mainConfig->operators);
+		mainConfig->useBuiltinRecognizer = true;
 		mainConfig->delimiters = { '{', '}', '[', ']', '(', ')', ',', ';', '#', '@' };
 
 		preprocessorConfig = std::make_unique<LexerConfig>();
 		preprocessorConfig->enableNewline = true;
 		preprocessorConfig->enableWhitespace = true;
-		BuildKeywordRadix(preprocessorConfig->keywords);
-		BuildOperatorRadix(preprocessorConfig->operators);
+		preprocessorConfig->useBuiltinRecognizer = true;
 		preprocessorConfig->delimiters = { '{', '}', '[', ']', '(', ')', ',', ';', '#', '@' };
 	}
 
@@ -1,6 +1,7 @@
 #ifndef LEXER_CONFIG_HPP
 #define LEXER_CONFIG_HPP
 
+#include "builtin_recognizer.hpp"
 #include "utils/radix_tree.hpp"
 #include "pch/std.hpp"
 
@@ -11,18 +12,37 @@ namespace HXSL
 	public:
 		bool enableNewline;
 		bool enableWhitespace;
+		bool useBuiltinRecognizer;
 		std::unordered_set<char> delimiters;
 		RadixTree<int> keywords;
 		RadixTree<int> operators;
 
-		LexerConfig() : enableNewline(false), enableWhitespace(false)
+		LexerConfig() : enableNewline(false), enableWhitespace(false), useBuiltinRecognizer(false)
 		{
 		}
 
 		LexerConfig(bool enableNewline, bool enableWhitespace, bool specialParseTreatIdentiferAsLiteral, const std::unordered_set<char>& delimiters, const RadixTree<int>& keywords, const RadixTree<int>& operators)
-			: enableNewline(enableNewline), enableWhitespace(enableWhitespace), delimiters(delimiters), keywords(keywords), operators(operators)
+			: enableNewline(enableNewline), enableWhitespace(enableWhitespace), useBuiltinRecognizer(false), delimiters(delimiters), keywords(keywords), operators(operators)
 		{
 		}
+
+		bool MatchKeyword(const StringSpan& text, int& keyword, size_t& keywordLength) const
+		{
+			if (useBuiltinRecognizer)
+			{
+				return BuiltinRecognizer::MatchKeyword(text.data(), text.size(), keyword, keywordLength);
+			}
+			return keywords.Find(text, keyword, keywordLength) && keyword != 0;
+		}
+
+		bool MatchOperator(const StringSpan& text, int& op, size_t& operatorLength) const
+		{
+			if (useBuiltinRecognizer)
+			{
+				return BuiltinRecognizer::MatchOperator(text.data(), text.size(), op, operatorLength);
+			}
+			return operators.Find(text, op, operatorLength);
+		}
 	};
 
 	class HXSLLexerConfig
@@ -0,0 +1,165 @@
+#include "token_buffer.hpp"
+
+namespace HXSL
+{
+	void TokenBuffer::AddToken(const Token& token, size_t end)
+	{
+		uint32_t index = static_cast<uint32_t>(types.size());
+		uint32_t start = static_cast<uint32_t>(token.Span.start);
+		int32_t columnBase = static_cast<int32_t>(token.Span.column - RawStart(start, token.Type));
+		if (anchors.empty() || anchors.back().line != token.Span.line || anchors.back().columnBase != columnBase)
+		{
+			anchors.push_back({ index, token.Span.line, columnBase });
+		}
+
+		TokenValue value;
+		switch (token.Type)
+		{
+		case TokenType_Numeric:
+			value.number = numbers.size();
+			numbers.push_back(token.Numeric);
+			break;
+		case TokenType_Identifier:
+			value.ii = token.ii;
+			break;
+		default:
+			value.value = token.Value;
+			break;
+		}
+
+		types.push_back(static_cast<uint8_t>(token.Type));
+		values.push_back(value);
+		starts.push_back(start);
+		lengths.push_back(static_cast<uint32_t>(token.Span.length));
+		ends.push_back(static_cast<uint32_t>(end));
+	}
+
+	bool TokenBuffer::Tokenize(LexerContext* context)
+	{
+		Clear();
+
+		if (context->GetLength() >= std::numeric_limits<uint32_t>::max())
+		{
+			return false;
+		}
+
+		source = context->source->GetID();
+
+		// roughly one token per five bytes for typical shader code.
+		size_t expected = context->GetLength() / 5;
+		types.reserve(expected);
+		values.reserve(expected);
+		starts.reserve(expected);
+		lengths.reserve(expected);
+		ends.reserve(expected);
+
+		LexerState state = context->MakeState();
+		while (!state.IsEOF() && !context->HasCriticalErrors())
+		{
+			Token token = Lexer::TokenizeStep(state);
+			state.Advance();
+
+			if (token.Type == TokenType_Comment || token.Type == TokenType_Unknown)
+			{
+				continue;
+			}
+
+			AddToken(token, state.Index);
+		}
+
+		endIndex = state.Index;
+		endLine = state.Line;
+		endColumn = state.Column;
+		return true;
+	}
+
+	void TokenBuffer::Rebind(const TokenBuffer& other, SourceFileID source, IdentifierTable& idTable)
+	{
+		*this = other;
+		this->source = source;
+
+		for (size_t i = 0; i < types.size(); i++)
+		{
+			if (GetType(i) == TokenType_Identifier)
+			{
+				values[i].ii = idTable.Get(values[i].ii->name);
+			}
+		}
+	}
+
+	void TokenBuffer::Clear()
+	{
+		source = INVALID_SOURCE_ID;
+		types.clear();
+		values.clear();
+		starts.clear();
+		lengths.clear();
+		ends.clear();
+		numbers.clear();
+		anchors.clear();
+		endIndex = 0;
+		endLine = 1;
+		endColumn = 1;
+	}
+
+	size_t TokenBuffer::FindAnchor(size_t index, size_t hint) const
+	{
+		auto covers = [&](size_t anchor)
+			{
+				return anchors[anchor].token <= index && (anchor + 1 == anchors.size() || anchors[anchor + 1].token > index);
+			};
+
+		if (hint < anchors.size() && covers(hint))
+		{
+			return hint;
+		}
+
+		if (hint + 1 < anchors.size() && covers(hint + 1))
+		{
+			return hint + 1;
+		}
+
+		auto it = std::upper_bound(anchors.begin(), anchors.end(), index, [](size_t value, const LineAnchor& anchor) { return value < anchor.token; });
+		return static_cast<size_t>(it - anchors.begin()) - 1;
+	}
+
+	Token TokenBuffer::GetToken(size_t index, size_t& anchorHint) const
+	{
+		anchorHint = FindAnchor(index, anchorHint);
+		auto& anchor = anchors[anchorHint];
+
+		TokenType type = GetType(index);
+		uint32_t start = starts[index];
+		uint32_t column = RawStart(start, type) + anchor.columnBase;
+		TextSpan span = TextSpan(source, start, lengths[index], anchor.line, column);
+
+		auto& value = values[index];
+		switch (type)
+		{
+		case TokenType_Numeric:
+			return Token(span, type, numbers[value.number]);
+		case TokenType_Identifier:
+			return Token(span, type, value.ii);
+		default:
+			return Token(span, type, value.value);
+		}
+	}
+
+	void TokenBuffer::RestoreLexerState(size_t index, LexerState& state, size_t& anchorHint) const
+	{
+		if (index >= Size())
+		{
+			state.Index = state.IndexNext = endIndex;
+			state.Line = endLine;
+			state.Column = endColumn;
+			return;
+		}
+
+		anchorHint = FindAnchor(index, anchorHint);
+		auto& anchor = anchors[anchorHint];
+
+		state.Index = state.IndexNext = ends[index];
+		state.Line = anchor.line;
+		state.Column = ends[index] + anchor.columnBase;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#ifndef TOKEN_BUFFER_HPP
+#define TOKEN_BUFFER_HPP
+
+#include "lexical/lexer.hpp"
+#include "pch/std.hpp"
+
+namespace HXSL
+{
+	// Struct of arrays holding every token of a source after a single lexer pass, comments and unknown tokens are dropped.
+	// Line and column are not stored per token, they are derived from line anchors when a token is materialized.
+	class TokenBuffer
+	{
+		union TokenValue
+		{
+			int value;
+			IdentifierInfo* ii;
+			size_t number; // index into numbers.
+		};
+
+		// Starting at token, column = RawStart() + columnBase until the next anchor. The lexer does not count skipped
+		// whitespace into the column, so a new anchor starts at every line and after every whitespace run.
+		struct LineAnchor
+		{
+			uint32_t token;
+			uint32_t line;
+			int32_t columnBase;
+		};
+
+		// Literal spans exclude the quotes but the lexer column refers to the opening quote.
+		static uint32_t RawStart(uint32_t start, TokenType type) noexcept
+		{
+			return type == TokenType_Literal ? start - 1 : start;
+		}
+
+		SourceFileID source = INVALID_SOURCE_ID;
+		std::vector<uint8_t> types;
+		std::vector<TokenValue> values;
+		std::vector<uint32_t> starts;
+		std::vector<uint32_t> lengths;
+		std::vector<uint32_t> ends;
+		std::vector<Number> numbers;
+		std::vector<LineAnchor> anchors;
+		size_t endIndex = 0;
+		uint32_t endLine = 1;
+		uint32_t endColumn = 1;
+
+		void AddToken(const Token& token, size_t end);
+
+		size_t FindAnchor(size_t index, size_t hint) const;
+
+	public:
+		// Lexes the whole stream of context, returns false if the source is too large for 32-bit offsets.
+		bool Tokenize(LexerContext* context);
+
+		void Clear();
+
+		// Copies other for another source and identifier table, identifiers are interned again into idTable.
+		// Lets a buffer lexed once be shared by contexts that each have their own table.
+		void Rebind(const TokenBuffer& other, SourceFileID source, IdentifierTable& idTable);
+
+		size_t Size() const noexcept { return types.size(); }
+
+		bool Empty() const noexcept { return types.empty(); }
+
+		TokenType GetType(size_t index) const noexcept { return static_cast<TokenType>(types[index]); }
+
+		// Offset of the lexer after the token, includes closing quotes of literals.
+		size_t GetEnd(size_t index) const noexcept { return ends[index]; }
+
+		// anchorHint is the anchor of the previously requested token, sequential access then never has to search.
+		Token GetToken(size_t index, size_t& anchorHint) const;
+
+		Token GetToken(size_t index) const
+		{
+			size_t anchorHint = 0;
+			return GetToken(index, anchorHint);
+		}
+
+		// Restores the lexer position, line and column as they were directly after lexing the token at index, or after the last token if index is Size().
+		void RestoreLexerState(size_t index, LexerState& state, size_t& anchorHint) const;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -16,16 +16,6 @@ namespace HXSL
 		{
 			streamState = stack.top();
 		}
-		/*
-		else if (currentStack == 0)
-		{
-			auto& state = streamState;
-			auto& cache = this->cache;
-			if (state.tokenPosition >= cache.Position())
-			{
-				cache.Flush(state.tokenPosition);
-			}
-		}*/
 		stack.pop();
 	}
 
@@ -40,31 +30,47 @@ namespace HXSL
 		}
 	}
 
-	bool TokenStream::TryAdvance()
+	bool TokenStream::TryAdvanceBuffered()
 	{
 		auto& state = streamState;
-		auto& lexerState = state.state;
 		auto& currentToken = state.currentToken;
-		auto& cache = this->cache;
 
 		state.lastToken = currentToken;
 
-		/*
-		if (cache.CanAccess(state.tokenPosition))
+		size_t position = state.bufferPosition;
+		size_t size = buffer->Size();
+		while (position < size && skipWhitespace && buffer->GetType(position) == TokenType_Whitespace)
 		{
-			if (currentStack == 0)
-			{
-				currentToken = cache.GetToken();
-			}
-			else
-			{
-				currentToken = cache.PeekToken(state.tokenPosition);
-			}
+			position++;
+		}
 
-			state.tokenPosition++;
-			return true;
+		if (IsEndOfTokens() || position >= size || context->HasCriticalErrors())
+		{
+			buffer->RestoreLexerState(size, state.state, state.anchorHint);
+			state.bufferPosition = size;
+			currentToken = {};
+			return false;
 		}
-		*/
+
+		currentToken = buffer->GetToken(position, state.anchorHint);
+		buffer->RestoreLexerState(position, state.state, state.anchorHint);
+		state.bufferPosition = position + 1;
+		state.tokenPosition++;
+		return true;
+	}
+
+	bool TokenStream::TryAdvance()
+	{
+		if (buffer)
+		{
+			return TryAdvanceBuffered();
+		}
+
+		auto& state = streamState;
+		auto& lexerState = state.state;
+		auto& currentToken = state.currentToken;
+
+		state.lastToken = currentToken;
 
 		do
 		{
@@ -78,17 +84,6 @@ namespace HXSL
 			lexerState.Advance();
 		} while (currentToken.Type == TokenType_Comment || currentToken.Type == TokenType_Unknown || (skipWhitespace && currentToken.Type == TokenType_Whitespace));
 
-		/*
-		if (currentStack == 0)
-		{
-			cache.IncrementPosition();
-		}
-		else
-		{
-			cache.AddToken(currentToken);
-		}
-		*/
-
 		state.tokenPosition++;
 		return true;
 	}
@@ -2,86 +2,12 @@
 #define TOKEN_STREAM_HPP
 
 #include "lexical/lexer.hpp"
+#include "lexical/token_buffer.hpp"
 #include "logging/logger.hpp"
 #include "pch/localization.hpp"
 
 namespace HXSL
 {
-	struct TokenCache
-	{
-		std::deque<Token> tokens;
-		size_t maxSize = 10;
-		size_t tokenPosition = 0;
-
-		void IncrementPosition()
-		{
-			tokenPosition++;
-		}
-
-		void AddToken(const Token& token)
-		{
-			if (tokens.size() >= maxSize)
-			{
-				tokens.pop_front();
-				tokenPosition++;
-			}
-			tokens.push_back(token);
-		}
-
-		Token PeekToken(size_t index) const
-		{
-			index -= tokenPosition;
-			if (index < tokens.size())
-			{
-				return tokens[index];
-			}
-			return {};
-		}
-
-		Token GetToken()
-		{
-			if (!tokens.empty())
-			{
-				Token token = tokens.front();
-				tokens.pop_front();
-				tokenPosition++;
-				return token;
-			}
-			return {};
-		}
-
-		size_t Position() const
-		{
-			return tokenPosition;
-		}
-
-		size_t EndPosition() const
-		{
-			return tokenPosition + tokens.size();
-		}
-
-		bool CanAccess(size_t pos) const
-		{
-			return tokenPosition >= pos && pos < EndPosition();
-		}
-
-		size_t Size() const
-		{
-			return tokens.size();
-		}
-
-		bool IsEmpty() const
-		{
-			return tokens.empty();
-		}
-
-		void Flush(size_t pos)
-		{
-			tokens.clear();
-			tokenPosition = pos;
-		}
-	};
-
 	struct TokenStream
 	{
 	protected:
@@ -91,25 +17,34 @@ namespace HXSL
 			Token lastToken;
 			Token currentToken;
 			size_t tokenPosition = 0;
+			size_t bufferPosition = 0;
+			size_t anchorHint = 0;
 
 			TokenStreamState() = default;
 
-			TokenStreamState(LexerState lexerState) : state(lexerState), lastToken({}), currentToken({}), tokenPosition(0)
+			TokenStreamState(LexerState lexerState) : state(lexerState), lastToken({}), currentToken({}), tokenPosition(0), bufferPosition(0), anchorHint(0)
 			{
 			}
 
 			bool IsEndOfTokens() const noexcept { return state.IsEOF(); }
 		};
 		LexerContext* context;
+		const TokenBuffer* buffer;
 		TokenStreamState streamState;
 		TokenStreamState restorePoint;
 		std::stack<TokenStreamState> stack;
 		size_t currentStack;
-		TokenCache cache;
 		bool skipWhitespace;
 
+		bool TryAdvanceBuffered();
+
 	public:
-		TokenStream(LexerContext* context) : context(context), streamState(TokenStreamState(context->MakeState())), currentStack(0), skipWhitespace(false)
+		TokenStream(LexerContext* context) : context(context), buffer(nullptr), streamState(TokenStreamState(context->MakeState())), currentStack(0), skipWhitespace(false)
+		{
+		}
+
+		// Reads tokens from a buffer that was tokenized from the same context, restoring a pushed state then doesn't lex anything again.
+		TokenStream(LexerContext* context, const TokenBuffer* buffer) : context(context), buffer(buffer), streamState(TokenStreamState(context->MakeState())), currentStack(0), skipWhitespace(false)
 		{
 		}
 
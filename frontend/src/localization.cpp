@@ -1,5 +1,6 @@
 #include "pch/localization.hpp"
 #include "config.h"
+#include "io/mapped_source.hpp"
 #include <filesystem>
 #include <iostream>
 #include <fstream>
@@ -8,155 +9,231 @@
 namespace HXSL
 {
 	const std::string MAGIC_STRING = "TRANSL";
-	const uint32_t CURRENT_VERSION = 1;
+	const uint32_t CURRENT_VERSION = 2;
 
-	std::unique_ptr<std::unordered_map<uint64_t, std::string>> current_locale_map = std::make_unique<std::unordered_map<uint64_t, std::string>>();
+	// Layout after the magic and version, every integer little endian:
+	// uint32 entry count, uint32 block count,
+	// the entries sorted by code, then the block table, then the blocks.
+	// Every block is an independent zstd frame holding the messages of a run of consecutive entries.
+	struct TranslationEntry
+	{
+		uint64_t code;
+		uint32_t block;
+		uint32_t offset; // into the decompressed block.
+		uint32_t length;
+		uint32_t reserved;
+	};
 
-	struct ZSTDStream
+	struct TranslationBlock
 	{
-		std::istream& in;
-		ZSTD_DStream* dstream = nullptr;
-		std::vector<char> inputBuffer;
-		std::vector<char> outputBuffer;
-		size_t bufferSize;
-		ZSTD_inBuffer inBuffer{};
-		ZSTD_outBuffer outBuffer{};
-
-		ZSTDStream(std::istream& in, size_t bufferSize = 1024 * 1024) : in(in), bufferSize(bufferSize), inputBuffer(bufferSize), outputBuffer(bufferSize)
-		{
-			dstream = ZSTD_createDStream();
-			if (!dstream) throw std::runtime_error("Failed to create ZSTD_DStream");
-			size_t initResult = ZSTD_initDStream(dstream);
-			if (ZSTD_isError(initResult)) throw std::runtime_error(ZSTD_getErrorName(initResult));
-			inBuffer = { inputBuffer.data(), 0, 0 };
-			outBuffer = { outputBuffer.data(), 0, 0 };
-		}
+		uint64_t offset; // from the start of the file.
+		uint32_t compressedSize;
+		uint32_t size;
+	};
 
-		~ZSTDStream()
-		{
-			if (dstream) ZSTD_freeDStream(dstream);
-		}
+	static_assert(sizeof(TranslationEntry) == 24 && sizeof(TranslationBlock) == 16, "Must match tools/transl_writer.py");
 
-		bool DecompressNextChunk()
+	static constexpr size_t TranslationHeaderSize = 6 + sizeof(uint32_t) * 3;
+
+	template<typename T>
+	static T ReadUnaligned(const char* data)
+	{
+		T value;
+		std::memcpy(&value, data, sizeof(T));
+		return value;
+	}
+
+	// A memory mapped .transl file, only the index is touched when it is opened.
+	class TranslationFile
+	{
+		std::unique_ptr<MappedSource> source;
+		const char* entries = nullptr;
+		const char* blocks = nullptr;
+		uint32_t entryCount = 0;
+		uint32_t blockCount = 0;
+
+	public:
+		static std::shared_ptr<const TranslationFile> Open(const std::string& filename)
 		{
-			if (inBuffer.pos == inBuffer.size)
+			auto source = MappedSource::Open(filename.c_str());
+			if (!source)
 			{
-				in.read(inputBuffer.data(), bufferSize);
-				size_t bytesRead = in.gcount();
-				if (bytesRead == 0) return false;
-				inBuffer = { inputBuffer.data(), bytesRead, 0 };
+				std::cerr << "Failed to open file: " << filename << std::endl;
+				return nullptr;
 			}
 
-			outBuffer = { outputBuffer.data(), outputBuffer.size(), 0 };
-			size_t result = ZSTD_decompressStream(dstream, &outBuffer, &inBuffer);
-			if (ZSTD_isError(result))
+			const char* data = source->GetData();
+			size_t length = source->GetLength();
+			if (length < TranslationHeaderSize || std::memcmp(data, MAGIC_STRING.data(), MAGIC_STRING.size()) != 0)
 			{
-				std::cerr << "ZSTD decompression error: " << ZSTD_getErrorName(result) << std::endl;
-				return false;
+				std::cerr << "Invalid magic string!" << std::endl;
+				return nullptr;
+			}
+
+			if (ReadUnaligned<uint32_t>(data + 6) != CURRENT_VERSION)
+			{
+				std::cerr << "Version mismatch!" << std::endl;
+				return nullptr;
+			}
+
+			auto file = std::make_shared<TranslationFile>();
+			file->entryCount = ReadUnaligned<uint32_t>(data + 10);
+			file->blockCount = ReadUnaligned<uint32_t>(data + 14);
+
+			size_t tablesSize = static_cast<size_t>(file->entryCount) * sizeof(TranslationEntry) + static_cast<size_t>(file->blockCount) * sizeof(TranslationBlock);
+			if (length - TranslationHeaderSize < tablesSize)
+			{
+				std::cerr << "Translation index is truncated!" << std::endl;
+				return nullptr;
 			}
-			outBuffer.size = outBuffer.pos;
-			outBuffer.pos = 0;
-			return outBuffer.size > 0;
+
+			file->entries = data + TranslationHeaderSize;
+			file->blocks = file->entries + static_cast<size_t>(file->entryCount) * sizeof(TranslationEntry);
+			file->source = std::move(source);
+			return file;
 		}
 
-		bool Read(void* dst, size_t size)
+		bool Find(uint64_t code, TranslationEntry& entry) const
 		{
-			size_t copied = 0;
-			while (copied < size)
+			size_t low = 0;
+			size_t high = entryCount;
+			while (low < high)
 			{
-				if (outBuffer.pos == outBuffer.size)
+				size_t mid = low + (high - low) / 2;
+				uint64_t midCode = ReadUnaligned<uint64_t>(entries + mid * sizeof(TranslationEntry));
+				if (midCode < code)
+				{
+					low = mid + 1;
+				}
+				else
 				{
-					if (!DecompressNextChunk()) return false;
+					high = mid;
 				}
+			}
 
-				size_t available = outBuffer.size - outBuffer.pos;
-				size_t toCopy = std::min(size - copied, available);
-				std::memcpy((char*)dst + copied, outputBuffer.data() + outBuffer.pos, toCopy);
-				outBuffer.pos += toCopy;
-				copied += toCopy;
+			if (low == entryCount)
+			{
+				return false;
 			}
-			return true;
+
+			entry = ReadUnaligned<TranslationEntry>(entries + low * sizeof(TranslationEntry));
+			return entry.code == code && entry.block < blockCount;
 		}
-	};
 
-	static bool LoadTranslations(const std::string& filename)
-	{
-		std::ifstream file(filename, std::ios::binary);
-		if (!file)
+		bool Decompress(uint32_t index, std::vector<char>& output) const
 		{
-			std::cerr << "Failed to open file: " << filename << std::endl;
-			return false;
-		}
+			auto block = ReadUnaligned<TranslationBlock>(blocks + static_cast<size_t>(index) * sizeof(TranslationBlock));
+			if (block.offset > source->GetLength() || source->GetLength() - block.offset < block.compressedSize)
+			{
+				return false;
+			}
 
-		char magic[6];
-		file.read(magic, MAGIC_STRING.size());
+			output.resize(block.size);
+			size_t result = ZSTD_decompress(output.data(), output.size(), source->GetData() + block.offset, block.compressedSize);
+			if (ZSTD_isError(result))
+			{
+				std::cerr << "ZSTD decompression error: " << ZSTD_getErrorName(result) << std::endl;
+				return false;
+			}
 
-		if (std::string(magic, MAGIC_STRING.size()) != MAGIC_STRING)
-		{
-			std::cerr << "Invalid magic string!" << std::endl;
-			return false;
+			return result == block.size;
 		}
+	};
 
-		uint32_t version = 0;
+	static std::mutex localeMutex;
+	static std::shared_ptr<const TranslationFile> currentLocale;
 
-		file.read(reinterpret_cast<char*>(&version), sizeof(version));
+	static std::shared_ptr<const TranslationFile> GetCurrentLocale()
+	{
+		std::lock_guard<std::mutex> lock(localeMutex);
+		return currentLocale;
+	}
+
+	// Decoded blocks of the current locale, per thread so that handing out spans needs no locking.
+	// A span stays valid until the same thread touched BlockCacheCapacity other blocks or the locale changed.
+	struct BlockCache
+	{
+		static constexpr size_t BlockCacheCapacity = 8;
 
-		if (version != CURRENT_VERSION)
+		struct DecodedBlock
 		{
-			std::cerr << "Version mismatch!" << std::endl;
-			return false;
-		}
+			uint32_t index;
+			uint64_t lastUse;
+			std::vector<char> data;
+		};
 
-		uint64_t entryCount = 0;
-		file.read(reinterpret_cast<char*>(&entryCount), sizeof(entryCount));
+		std::shared_ptr<const TranslationFile> file;
+		std::vector<DecodedBlock> blocks;
+		uint64_t clock = 0;
 
-		auto& map = *current_locale_map.get();
+		const std::vector<char>* Get(const std::shared_ptr<const TranslationFile>& locale, uint32_t index)
+		{
+			if (file != locale)
+			{
+				blocks.clear();
+				file = locale;
+			}
 
-		map.clear();
-		map.reserve(entryCount);
+			DecodedBlock* victim = nullptr;
+			for (auto& block : blocks)
+			{
+				if (block.index == index)
+				{
+					block.lastUse = ++clock;
+					return &block.data;
+				}
 
-		ZSTDStream stream = ZSTDStream(file);
-		for (size_t i = 0; i < entryCount; i++)
-		{
-			uint64_t key;
-			uint32_t strLength;
-			if (!stream.Read(&key, sizeof(uint64_t)) ||
-				!stream.Read(&strLength, sizeof(uint32_t)))
+				if (!victim || block.lastUse < victim->lastUse)
+				{
+					victim = &block;
+				}
+			}
+
+			if (blocks.size() < BlockCacheCapacity)
 			{
-				std::cerr << "Stream read error for entry metadata" << std::endl;
-				return false;
+				blocks.reserve(BlockCacheCapacity);
+				victim = &blocks.emplace_back();
 			}
 
-			std::string translation;
-			translation.resize(strLength);
-			if (!stream.Read(translation.data(), strLength))
+			victim->index = index;
+			victim->lastUse = ++clock;
+			if (!file->Decompress(index, victim->data))
 			{
-				std::cerr << "Stream read error for string data" << std::endl;
-				return false;
+				victim->index = std::numeric_limits<uint32_t>::max();
+				victim->lastUse = 0;
+				return nullptr;
 			}
 
-			map[key] = translation;
+			return &victim->data;
 		}
-
-		return true;
-	}
+	};
 
 	void SetLocale(const std::string& languageCode)
 	{
 		std::filesystem::path base = HXSL_LOCALE_PATH;
 		std::filesystem::path path = base / (languageCode + ".transl");
-		LoadTranslations(path.string());
+		auto locale = TranslationFile::Open(path.string());
+
+		std::lock_guard<std::mutex> lock(localeMutex);
+		currentLocale = std::move(locale);
 	}
 
-	std::string GetMessageForCode(uint64_t code)
+	StringSpan GetMessageForCode(uint64_t code)
 	{
-		if (current_locale_map != nullptr)
+		static thread_local BlockCache cache;
+
+		auto locale = GetCurrentLocale();
+		if (locale)
 		{
 			code &= ~(0x3ull << 62ull);
-			auto msg_it = current_locale_map->find(code);
-			if (msg_it != current_locale_map->end())
+			TranslationEntry entry;
+			if (locale->Find(code, entry))
 			{
-				return msg_it->second;
+				auto block = cache.Get(locale, entry.block);
+				if (block && entry.offset <= block->size() && block->size() - entry.offset >= entry.length)
+				{
+					return StringSpan(block->data() + entry.offset, entry.length);
+				}
 			}
 		}
 
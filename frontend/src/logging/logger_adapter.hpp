@@ -8,6 +8,12 @@ namespace HXSL
 {
 	class LoggerAdapter
 	{
+		static ILogger*& GetThreadRedirect()
+		{
+			static thread_local ILogger* redirect = nullptr;
+			return redirect;
+		}
+
 	protected:
 		ILogger* logger;
 	public:
@@ -17,7 +23,28 @@ namespace HXSL
 
 		virtual ~LoggerAdapter() = default;
 
-		ILogger* GetLogger() const noexcept { return logger; }
+		// Sends everything logged through any adapter on the calling thread to target while alive,
+		// workers use it to buffer the diagnostics of a task in a deferred logger.
+		struct ScopedRedirect
+		{
+			ILogger* previous;
+
+			explicit ScopedRedirect(ILogger* target) : previous(GetThreadRedirect())
+			{
+				GetThreadRedirect() = target;
+			}
+
+			~ScopedRedirect()
+			{
+				GetThreadRedirect() = previous;
+			}
+		};
+
+		ILogger* GetLogger() const noexcept
+		{
+			auto redirect = GetThreadRedirect();
+			return redirect ? redirect : logger;
+		}
 
 		template <typename T>
 		auto format_arg(T&& arg) const -> decltype(std::forward<T>(arg))
@@ -33,7 +60,7 @@ namespace HXSL
 		template <typename... Args>
 		void Log(DiagnosticCode code, const TextSpan& span, Args&&... args) const
 		{
-			logger->LogFormattedEx(code, span.start, " (Line: {}, Column: {})", format_arg(std::forward<Args>(args))..., span.line, span.column);
+			GetLogger()->LogFormattedEx(code, span.start, " (Line: {}, Column: {})", format_arg(std::forward<Args>(args))..., span.line, span.column);
 		}
 
 		template<typename... Args>
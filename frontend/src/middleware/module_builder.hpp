@@ -82,6 +82,16 @@ namespace HXSL
 
 		Backend::Module* GetModule() const { return module.get(); }
 
+		Backend::Layout* GetLayout(SymbolDef* def) const
+		{
+			auto it = map.find(def);
+			if (it != map.end())
+			{
+				return it->second;
+			}
+			return nullptr;
+		}
+
 		[[nodiscard]] std::unique_ptr<Backend::Module> Convert(CompilationUnit* compilation);
 	};
 }
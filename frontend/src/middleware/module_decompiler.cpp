@@ -40,6 +40,43 @@ namespace HXSL
 		return nullptr;
 	}
 
+	SymbolDef* ModuleDecompiler::DeconvertLayout(Layout* layout)
+	{
+		auto it = map.find(layout);
+		if (it != map.end())
+		{
+			return it->second;
+		}
+
+		// constructors are only reachable through their parent, namespaces are never decompiled one by one.
+		if (auto* type = dyn_cast<TypeLayout>(layout))
+		{
+			return DeconvertType(type);
+		}
+
+		if (auto* field = dyn_cast<FieldLayout>(layout))
+		{
+			return DeconvertField(field);
+		}
+
+		if (auto* param = dyn_cast<ParameterLayout>(layout))
+		{
+			return DeconvertParameter(param);
+		}
+
+		if (auto* op = dyn_cast<OperatorLayout>(layout))
+		{
+			return DeconvertOperator(op);
+		}
+
+		if (auto* func = dyn_cast<FunctionLayout>(layout))
+		{
+			return DeconvertFunction(func);
+		}
+
+		return nullptr;
+	}
+
 	Primitive* ModuleDecompiler::DeconvertPrimitive(PrimitiveLayout* prim)
 	{
 		auto it = map.find(prim);
@@ -39,6 +39,7 @@ namespace HXSL
 		dense_map<ASTNode*, Backend::Layout*>& GetReverseMap() { return reverseMap; }
 
 		SymbolDef* DeconvertType(Backend::TypeLayout* type);
+		SymbolDef* DeconvertLayout(Backend::Layout* layout);
 		Primitive* DeconvertPrimitive(Backend::PrimitiveLayout* prim);
 		Field* DeconvertField(Backend::FieldLayout* field);
 		Parameter* DeconvertParameter(Backend::ParameterLayout* param);
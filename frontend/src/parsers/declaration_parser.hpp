@@ -8,11 +8,15 @@ namespace HXSL
 	class NamespaceParser : public SubParser
 	{
 		bool TryParse(Parser& parser, TokenStream& stream, ASTNode*& declOut) override;
+
+		FirstTokenSet GetFirstTokens() const override { return FirstTokenSet::Keywords({ Keyword_Namespace }); }
 	};
 
 	class UsingParser : public SubParser
 	{
 		bool TryParse(Parser& parser, TokenStream& stream, ASTNode*& declOut) override;
+
+		FirstTokenSet GetFirstTokens() const override { return FirstTokenSet::Keywords({ Keyword_Using }); }
 	};
 
 	class DeclarationParser : public SubParser
@@ -23,16 +27,22 @@ namespace HXSL
 	class OperatorParser : public SubParser
 	{
 		bool TryParse(Parser& parser, TokenStream& stream, ASTNode*& declOut) override;
+
+		FirstTokenSet GetFirstTokens() const override { return FirstTokenSet::Keywords({ Keyword_Explicit, Keyword_Implicit, Keyword_Operator }); }
 	};
 
 	class StructParser : public SubParser
 	{
 		bool TryParse(Parser& parser, TokenStream& stream, ASTNode*& declOut) override;
+
+		FirstTokenSet GetFirstTokens() const override { return FirstTokenSet::Keywords({ Keyword_Struct }); }
 	};
 
 	class EnumParser : public SubParser
 	{
 		bool TryParse(Parser& parser, TokenStream& stream, ASTNode*& declOut) override;
+
+		FirstTokenSet GetFirstTokens() const override { return FirstTokenSet::Keywords({ Keyword_Enum }); }
 	};
 }
 
@@ -0,0 +1,438 @@
+#include "incremental_parser.hpp"
+#include "parallel_parser.hpp"
+#include "il/assembly.hpp"
+#include "semantics/symbols/symbol_table.hpp"
+
+namespace HXSL
+{
+	struct SpanShift
+	{
+		int64_t offset;
+		int32_t lines;
+
+		void Apply(TextSpan& span) const
+		{
+			if (span.source == INVALID_SOURCE_ID) return;
+			span.start += offset;
+			span.line += lines;
+		}
+
+		void Apply(ASTNode* node)
+		{
+			auto span = node->GetSpan();
+			Apply(span);
+			node->SetSpan(span);
+
+			if (auto literal = dyn_cast<LiteralExpression>(node))
+			{
+				Apply(literal->GetLiteral().Span);
+			}
+
+			// the const iteration, the mutable one hands out unadjusted pointers for nodes with more than one base.
+			node->ForEachChild2([](ASTNode* const& child, void* userdata)
+				{
+					if (child) static_cast<SpanShift*>(userdata)->Apply(child);
+				}, this);
+		}
+	};
+
+	// Lexes from the current position until the state is at or past target, false if a token crosses target.
+	static bool LexTo(LexerState& state, size_t target)
+	{
+		while (state.Index < target && !state.IsEOF())
+		{
+			Lexer::TokenizeStep(state);
+			state.Advance();
+		}
+		return state.Index == target;
+	}
+
+	static void InvalidateSymbols(ASTNode* node)
+	{
+		auto def = dyn_cast<SymbolDef>(node);
+		if (!def) return;
+
+		auto assembly = def->GetAssembly();
+		auto& handle = def->GetSymbolHandle();
+		if (assembly && !assembly->IsSealed() && handle.valid())
+		{
+			assembly->GetMutableSymbolTable()->Remove(handle);
+		}
+	}
+
+	static void Splice(Namespace* parent, uint32_t index, ASTNode* decl)
+	{
+		switch (decl->GetType())
+		{
+		case NodeType_Struct:
+			parent->GetStructs()[index] = cast<Struct>(decl);
+			break;
+		case NodeType_Class:
+			parent->GetClasses()[index] = cast<Class>(decl);
+			break;
+		case NodeType_FunctionOverload:
+			parent->GetFunctions()[index] = cast<FunctionOverload>(decl);
+			break;
+		case NodeType_Field:
+			parent->GetFields()[index] = cast<Field>(decl);
+			break;
+		case NodeType_Enum:
+			parent->GetEnums()[index] = cast<Enum>(decl);
+			break;
+		case NodeType_UsingDecl:
+			parent->GetUsings()[index] = cast<UsingDecl>(decl);
+			break;
+		default:
+			HXSL_ASSERT(false, "Unhandled namespace member in IncrementalParser.");
+			break;
+		}
+		decl->SetParent(parent);
+	}
+
+	IncrementalParser::SourceState* IncrementalParser::FindSource(SourceFileID id)
+	{
+		for (auto& state : sources)
+		{
+			if (state.file->GetID() == id)
+			{
+				return &state;
+			}
+		}
+		return nullptr;
+	}
+
+	void IncrementalParser::Parse(const std::vector<SourceFile*>& files)
+	{
+		sources.clear();
+		for (auto file : files)
+		{
+			auto& input = file->GetInputStream();
+			SourceState state = {};
+			state.file = file;
+			state.text = std::string(input->GetBuffer(), input->GetLength());
+			sources.push_back(std::move(state));
+		}
+
+		ParseAll();
+	}
+
+	void IncrementalParser::ParseAll()
+	{
+		Parser::InitializeSubSystems();
+
+		CompilationUnitBuilder builder = CompilationUnitBuilder(logger);
+		for (auto& state : sources)
+		{
+			// the preprocessor replaces the input, every full parse starts from the edited original text.
+			auto input = std::make_unique<TextStream>();
+			input->Write(state.text.data(), state.text.size());
+			auto inputPtr = input.get();
+			state.file->SetInputStream(std::move(input));
+
+			ILogger sourceLogger = ILogger(true);
+			ParallelParser::ParseSource(&sourceLogger, state.file, builder);
+			logger->Replay(sourceLogger);
+
+			bool rewritten = state.file->GetInputStream().get() != inputPtr || inputPtr->GetLength() != state.text.size();
+			state.incremental = !rewritten && !sourceLogger.HasMessages();
+		}
+
+		compilation = builder.Build();
+
+		entries.clear();
+		for (auto& state : sources)
+		{
+			IndexSource(state);
+		}
+	}
+
+	bool IncrementalParser::IndexNamespace(SourceState& state, LexerContext& context, Namespace* ns, uint32_t scopeDepth, std::vector<DeclEntry>& found)
+	{
+		state.namespaces.push_back(ns);
+
+		// 'namespace Name {' or 'namespace Name;', the first member starts behind it.
+		auto& span = ns->GetSpan();
+		LexerState lexer = context.MakeState();
+		lexer.Index = lexer.IndexNext = span.start;
+		lexer.Line = span.line;
+		lexer.Column = span.column;
+		Token token;
+		for (size_t i = 0; i < 3;)
+		{
+			token = Lexer::TokenizeStep(lexer);
+			lexer.Advance();
+			if (token.Type == TokenType_Unknown)
+			{
+				return false;
+			}
+			if (token.Type != TokenType_Comment)
+			{
+				i++;
+			}
+		}
+
+		if (token.isDelimiterOf('{'))
+		{
+			scopeDepth++;
+		}
+		else if (!token.isDelimiterOf(';'))
+		{
+			return false;
+		}
+
+		std::vector<std::pair<ASTNode*, uint32_t>> members;
+		auto addMembers = [&members](auto span)
+			{
+				for (uint32_t i = 0; i < span.size(); i++)
+				{
+					members.push_back({ span[i], i });
+				}
+			};
+		addMembers(ns->GetStructs());
+		addMembers(ns->GetClasses());
+		addMembers(ns->GetFunctions());
+		addMembers(ns->GetFields());
+		addMembers(ns->GetEnums());
+		addMembers(ns->GetNestedNamespaces());
+		addMembers(ns->GetUsings());
+		std::sort(members.begin(), members.end(), [](auto& a, auto& b) { return a.first->GetSpan().start < b.first->GetSpan().start; });
+
+		size_t previousEnd = lexer.Index;
+		for (auto& [member, index] : members)
+		{
+			auto& memberSpan = member->GetSpan();
+			if (memberSpan.source != state.file->GetID() || memberSpan.start < previousEnd)
+			{
+				return false;
+			}
+
+			if (auto nested = dyn_cast<Namespace>(member))
+			{
+				if (!IndexNamespace(state, context, nested, scopeDepth, found))
+				{
+					return false;
+				}
+			}
+			else
+			{
+				DeclEntry entry = {};
+				entry.parent = ns;
+				entry.decl = member;
+				entry.index = index;
+				entry.scopeDepth = scopeDepth;
+				entry.startOffset = previousEnd;
+				found.push_back(entry);
+			}
+
+			previousEnd = memberSpan.End();
+		}
+
+		return true;
+	}
+
+	void IncrementalParser::IndexSource(SourceState& state)
+	{
+		state.decls.Clear();
+		state.namespaces.clear();
+		state.firstEntry = state.lastEntry = static_cast<uint32_t>(entries.size());
+		if (!state.incremental)
+		{
+			return;
+		}
+
+		ILogger lexerLogger = ILogger(true);
+		auto& input = state.file->GetInputStream();
+		LexerContext context = LexerContext(ASTContext::GetCurrentContext()->GetIdentifierTable(), state.file, input.get(), &lexerLogger, HXSLLexerConfig::Instance());
+
+		std::vector<DeclEntry> found;
+		for (auto ns : compilation->GetNamespaces())
+		{
+			// members of a namespace that can't be indexed would keep stale spans, the whole source is parsed again then.
+			if (ns->GetSpan().source == state.file->GetID() && !IndexNamespace(state, context, ns, 0, found))
+			{
+				state.incremental = false;
+				state.namespaces.clear();
+				return;
+			}
+		}
+		std::sort(found.begin(), found.end(), [](auto& a, auto& b) { return a.startOffset < b.startOffset; });
+
+		// one pass over the text for the lexer positions at the interval boundaries, re-lexing a member starts there.
+		LexerState lexer = context.MakeState();
+		for (auto& entry : found)
+		{
+			size_t end = entry.decl->GetSpan().End();
+			entry.usable = LexTo(lexer, entry.startOffset);
+			entry.startLine = lexer.Line;
+			entry.startColumn = lexer.Column;
+			entry.usable &= LexTo(lexer, end);
+			entry.endLine = lexer.Line;
+
+			// the last token has to be on a single line, it gives the end line of a re-parsed member.
+			char last = end > 0 ? state.text[end - 1] : 0;
+			entry.usable &= last == '}' || last == ';';
+
+			state.decls.Insert({ entry.startOffset, end }, static_cast<uint32_t>(entries.size()));
+			entries.push_back(entry);
+		}
+		state.lastEntry = static_cast<uint32_t>(entries.size());
+	}
+
+	bool IncrementalParser::TryReparseDeclaration(SourceState& state, uint32_t entryIndex, size_t start, size_t end, const TextEdit& edit)
+	{
+		auto& entry = entries[entryIndex];
+		if (!entry.usable)
+		{
+			return false;
+		}
+
+		auto& text = state.text;
+		int64_t delta = static_cast<int64_t>(edit.replacement.size()) - static_cast<int64_t>(edit.length);
+		size_t newEnd = end + delta;
+
+		// anything behind the member on its last line would get other columns, directives need the preprocessor.
+		for (size_t i = newEnd; i < text.size() && text[i] != '\n' && text[i] != '\r'; i++)
+		{
+			if (!std::isspace(static_cast<unsigned char>(text[i])))
+			{
+				return false;
+			}
+		}
+		if (std::memchr(text.data() + start, '#', newEnd - start))
+		{
+			return false;
+		}
+
+		auto input = std::make_unique<TextStream>();
+		input->Write(text.data(), text.size());
+		auto inputPtr = input.get();
+		state.file->SetInputStream(std::move(input));
+
+		ILogger parseLogger = ILogger(true);
+		LexerContext context = LexerContext(ASTContext::GetCurrentContext()->GetIdentifierTable(), state.file, inputPtr, &parseLogger, HXSLLexerConfig::Instance());
+		TokenStream stream = TokenStream(&context);
+		auto& lexer = stream.GetLexerState();
+		lexer.Index = lexer.IndexNext = start;
+		lexer.Line = entry.startLine;
+		lexer.Column = entry.startColumn;
+
+		Parser parser = Parser(&parseLogger, stream);
+		for (uint32_t i = 0; i < entry.scopeDepth; i++)
+		{
+			parser.EnterScopeInternal(ScopeType_Namespace, nullptr);
+		}
+
+		stream.Advance();
+		ASTNode* decl = nullptr;
+		if (!parser.ParseSubStepInner(decl) || !decl || parseLogger.HasMessages())
+		{
+			return false;
+		}
+
+		auto last = stream.LastToken();
+		if (decl->GetType() != entry.decl->GetType() || decl->GetSpan().End() != newEnd || last.Span.End() != newEnd || !(last.isDelimiterOf('}') || last.isDelimiterOf(';')))
+		{
+			return false;
+		}
+
+		InvalidateSymbols(entry.decl);
+		Splice(entry.parent, entry.index, decl);
+
+		int32_t lineDelta = static_cast<int32_t>(last.Span.line) - static_cast<int32_t>(entry.endLine);
+		entry.decl = decl;
+		entry.endLine = last.Span.line;
+		entry.pendingOffset = 0;
+		entry.pendingLines = 0;
+
+		for (uint32_t i = entryIndex + 1; i < state.lastEntry; i++)
+		{
+			auto& next = entries[i];
+			next.startLine += lineDelta;
+			next.endLine += lineDelta;
+			next.pendingOffset += delta;
+			next.pendingLines += lineDelta;
+		}
+
+		state.decls.Shift(end, delta);
+
+		// namespaces only have their own span moved here, the members are covered by the entries.
+		for (auto ns : state.namespaces)
+		{
+			auto span = ns->GetSpan();
+			if (span.start >= end)
+			{
+				span.start += delta;
+				span.line += lineDelta;
+			}
+			else if (span.End() >= end)
+			{
+				span.length += delta;
+			}
+			ns->SetSpan(span);
+		}
+
+		return true;
+	}
+
+	bool IncrementalParser::ApplyEdit(const TextEdit& edit)
+	{
+		auto state = FindSource(edit.source);
+		HXSL_ASSERT(state, "Edit of a source that wasn't parsed.");
+		if (!state)
+		{
+			return false;
+		}
+		HXSL_ASSERT(edit.start + edit.length <= state->text.size(), "Edit out of range.");
+
+		uint32_t entryIndex = std::numeric_limits<uint32_t>::max();
+		size_t start = 0;
+		size_t end = 0;
+		if (state->incremental && edit.replacement.find('#') == std::string::npos)
+		{
+			std::vector<const IntervalTree<uint32_t>::Node*> hits;
+			state->decls.SearchOverlapping(edit.start, hits);
+			for (auto hit : hits)
+			{
+				if (hit->interval.start <= edit.start && edit.start + edit.length <= hit->interval.end)
+				{
+					entryIndex = hit->value;
+					start = hit->interval.start;
+					end = hit->interval.end;
+					break;
+				}
+			}
+		}
+
+		state->text.replace(edit.start, edit.length, edit.replacement);
+
+		if (entryIndex != std::numeric_limits<uint32_t>::max() && TryReparseDeclaration(*state, entryIndex, start, end, edit))
+		{
+			return true;
+		}
+
+		ParseAll();
+		return false;
+	}
+
+	void IncrementalParser::ApplyPendingShifts()
+	{
+		for (auto& entry : entries)
+		{
+			if (entry.pendingOffset == 0 && entry.pendingLines == 0)
+			{
+				continue;
+			}
+
+			SpanShift shift = { entry.pendingOffset, entry.pendingLines };
+			shift.Apply(entry.decl);
+			entry.pendingOffset = 0;
+			entry.pendingLines = 0;
+		}
+	}
+
+	CompilationUnit* IncrementalParser::GetCompilationUnit()
+	{
+		ApplyPendingShifts();
+		return compilation;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef INCREMENTAL_PARSER_HPP
+#define INCREMENTAL_PARSER_HPP
+
+#include "parsers/parser.hpp"
+#include "ast_modules/ast_context.hpp"
+#include "utils/interval_tree.hpp"
+
+namespace HXSL
+{
+	// Replaces [start, start + length) of the original text of a source.
+	struct TextEdit
+	{
+		SourceFileID source;
+		size_t start;
+		size_t length;
+		std::string replacement;
+	};
+
+	// Keeps a parsed compilation unit in sync with text edits. An edit that lies within a single namespace member re-lexes
+	// and re-parses only that member and splices it into its namespace, the symbol table entries of the replaced member are
+	// removed. Everything else (edits of namespace headers, preprocessed sources, parse errors) falls back to a full parse.
+	// Members behind an edit keep their old spans until GetCompilationUnit() moves them, SymbolRef spans aren't moved.
+	class IncrementalParser
+	{
+		struct DeclEntry
+		{
+			Namespace* parent;
+			ASTNode* decl;
+			uint32_t index; // index of decl in the trailing span of its kind.
+			uint32_t scopeDepth; // number of braced namespaces around decl.
+			size_t startOffset; // only valid while indexing, the interval tree follows the edits.
+			// lexer position at the start of the interval, the end of the previous sibling or of the namespace header.
+			uint32_t startLine;
+			uint32_t startColumn;
+			uint32_t endLine;
+			bool usable;
+			// shift that isn't applied to the spans of decl yet.
+			int64_t pendingOffset;
+			int32_t pendingLines;
+		};
+
+		struct SourceState
+		{
+			SourceFile* file;
+			std::string text; // original text with all edits applied.
+			bool incremental; // false if the preprocessor rewrote the text or the parse reported diagnostics.
+			IntervalTree<uint32_t> decls;
+			uint32_t firstEntry;
+			uint32_t lastEntry;
+			std::vector<Namespace*> namespaces;
+		};
+
+		ILogger* logger;
+		std::vector<SourceState> sources;
+		std::vector<DeclEntry> entries;
+		CompilationUnit* compilation = nullptr;
+
+		SourceState* FindSource(SourceFileID id);
+		void ParseAll();
+		void IndexSource(SourceState& state);
+		bool IndexNamespace(SourceState& state, LexerContext& context, Namespace* ns, uint32_t scopeDepth, std::vector<DeclEntry>& found);
+		bool TryReparseDeclaration(SourceState& state, uint32_t entryIndex, size_t start, size_t end, const TextEdit& edit);
+		void ApplyPendingShifts();
+
+	public:
+		IncrementalParser(ILogger* logger) : logger(logger)
+		{
+		}
+
+		// Preprocesses and parses the sources from scratch, they have to belong to the current ASTContext.
+		void Parse(const std::vector<SourceFile*>& files);
+
+		// Returns true if only the enclosing declaration was parsed again, false if the whole unit was.
+		bool ApplyEdit(const TextEdit& edit);
+
+		CompilationUnit* GetCompilationUnit();
+	};
+}
+
+#endif
\ No newline at end of file
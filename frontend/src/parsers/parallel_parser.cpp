@@ -0,0 +1,76 @@
+#include "parallel_parser.hpp"
+#include "preprocessing/preprocessor.hpp"
+#include "utils/profiler.hpp"
+
+namespace HXSL
+{
+	void ParallelParser::ParseSource(ILogger* logger, SourceFile* source, CompilationUnitBuilder& builder)
+	{
+		PROFILE_SCOPE_DETAIL("Parse Source", source->GetPath());
+		{
+			PROFILE_SCOPE("Preprocess");
+			Preprocessor preprocessor = Preprocessor(logger);
+			preprocessor.Process(source);
+		}
+
+		LexerContext lexerContext = LexerContext(ASTContext::GetCurrentContext()->GetIdentifierTable(), source, source->GetInputStream().get(), logger, HXSLLexerConfig::Instance());
+		TokenBuffer tokens;
+		bool tokenized;
+		{
+			PROFILE_SCOPE("Lex");
+			tokenized = tokens.Tokenize(&lexerContext);
+		}
+		TokenStream tokenStream = tokenized ? TokenStream(&lexerContext, &tokens) : TokenStream(&lexerContext);
+
+		PROFILE_SCOPE("Parse");
+		Parser parser = Parser(logger, tokenStream);
+
+		parser.Parse(builder);
+	}
+
+	void ParallelParser::Parse(const std::vector<SourceFile*>& sources, CompilationUnitBuilder& builder)
+	{
+		Parser::InitializeSubSystems();
+
+		size_t threads = std::min(threadCount, sources.size());
+		if (threads <= 1)
+		{
+			for (auto source : sources)
+			{
+				ParseSource(logger, source, builder);
+			}
+			return;
+		}
+
+		std::vector<SourceTask> tasks;
+		tasks.reserve(sources.size());
+		for (auto source : sources)
+		{
+			tasks.push_back({ source, make_uptr<ASTContext>(context), make_uptr<ILogger>(true), nullptr });
+			tasks.back().builder = make_uptr<CompilationUnitBuilder>(tasks.back().logger.get());
+		}
+
+		ThreadPool pool = ThreadPool(threads);
+		pool.ParallelFor(tasks.size(), [&](size_t i)
+			{
+				auto& task = tasks[i];
+				auto previous = ASTContext::GetCurrentContext();
+				ASTContext::SetCurrentContext(task.context.get());
+				ParseSource(task.logger.get(), task.source, *task.builder);
+				ASTContext::SetCurrentContext(previous);
+			});
+
+		PROFILE_SCOPE("Merge Sources");
+		for (auto& task : tasks)
+		{
+			context->Merge(*task.context);
+			if (logger->HasCriticalErrors())
+			{
+				continue;
+			}
+
+			logger->Replay(*task.logger);
+			builder.GetBuilder().Merge(task.builder->GetBuilder());
+		}
+	}
+}
\ No newline at end of file
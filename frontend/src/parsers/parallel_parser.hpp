@@ -0,0 +1,39 @@
+#ifndef PARALLEL_PARSER_HPP
+#define PARALLEL_PARSER_HPP
+
+#include "parsers/parser.hpp"
+#include "ast_modules/ast_context.hpp"
+#include "utils/thread_pool.hpp"
+
+namespace HXSL
+{
+	// Preprocesses, lexes and parses a set of sources, with more than one thread every source gets a child ASTContext,
+	// a deferred logger and its own builder. They are merged in source order afterwards, so declarations and
+	// diagnostics come out exactly as in a serial run, unless the error limit is reached.
+	class ParallelParser
+	{
+		struct SourceTask
+		{
+			SourceFile* source;
+			uptr<ASTContext> context;
+			uptr<ILogger> logger;
+			uptr<CompilationUnitBuilder> builder;
+		};
+
+		ILogger* logger;
+		ASTContext* context;
+		size_t threadCount;
+
+	public:
+		ParallelParser(ILogger* logger, ASTContext* context, size_t threadCount = ThreadPool::GetDefaultThreadCount()) : logger(logger), context(context), threadCount(threadCount)
+		{
+		}
+
+		void Parse(const std::vector<SourceFile*>& sources, CompilationUnitBuilder& builder);
+
+		// Runs the whole per-source pipeline on the calling thread with the current ASTContext.
+		static void ParseSource(ILogger* logger, SourceFile* source, CompilationUnitBuilder& builder);
+	};
+}
+
+#endif
\ No newline at end of file
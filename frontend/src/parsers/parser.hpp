@@ -203,6 +203,7 @@ namespace HXSL
 		TakeHandle<AttributeDecl> attribute;
 		ModifierList modifierList;
 		size_t lastRecovery;
+		size_t speculativeAttempts = 0; // Sub parser attempts made by the registries, only used for statistics.
 
 		Parser() = default;
 		Parser(ILogger* logger, TokenStream& stream) : LoggerAdapter(logger), stream(&stream), ScopeLevel(0), NamespaceScope(0), CurrentScope(ParserScopeContext(ScopeType_Global, nullptr, ScopeFlags_None)), modifierList({}), lastRecovery(-1)
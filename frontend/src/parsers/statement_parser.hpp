@@ -7,41 +7,57 @@ namespace HXSL
 	class MiscKeywordStatementParser : public StatementParser
 	{
 		bool TryParse(Parser& parser, TokenStream& stream, ASTNode*& statementOut) override;
+
+		FirstTokenSet GetFirstTokens() const override { return FirstTokenSet::Keywords({ Keyword_Break, Keyword_Continue, Keyword_Discard }); }
 	};
 
 	class BlockStatementParser : public StatementParser
 	{
 		bool TryParse(Parser& parser, TokenStream& stream, ASTNode*& statementOut) override;
+
+		FirstTokenSet GetFirstTokens() const override { return FirstTokenSet::Delimiters({ '{' }); }
 	};
 
 	class ForStatementParser : public StatementParser
 	{
 		bool TryParse(Parser& parser, TokenStream& stream, ASTNode*& statementOut) override;
+
+		FirstTokenSet GetFirstTokens() const override { return FirstTokenSet::Keywords({ Keyword_For }); }
 	};
 
 	class SwitchStatementParser : public StatementParser
 	{
 		bool TryParse(Parser& parser, TokenStream& stream, ASTNode*& statementOut) override;
+
+		FirstTokenSet GetFirstTokens() const override { return FirstTokenSet::Keywords({ Keyword_Switch }); }
 	};
 
 	class IfStatementParser : public StatementParser
 	{
 		bool TryParse(Parser& parser, TokenStream& stream, ASTNode*& statementOut) override;
+
+		FirstTokenSet GetFirstTokens() const override { return FirstTokenSet::Keywords({ Keyword_If }); }
 	};
 
 	class WhileStatementParser : public StatementParser
 	{
 		bool TryParse(Parser& parser, TokenStream& stream, ASTNode*& statementOut) override;
+
+		FirstTokenSet GetFirstTokens() const override { return FirstTokenSet::Keywords({ Keyword_While }); }
 	};
 
 	class DoWhileStatementParser : public StatementParser
 	{
 		bool TryParse(Parser& parser, TokenStream& stream, ASTNode*& statementOut) override;
+
+		FirstTokenSet GetFirstTokens() const override { return FirstTokenSet::Keywords({ Keyword_Do }); }
 	};
 
 	class ReturnStatementParser : public StatementParser
 	{
 		bool TryParse(Parser& parser, TokenStream& stream, ASTNode*& statementOut) override;
+
+		FirstTokenSet GetFirstTokens() const override { return FirstTokenSet::Keywords({ Keyword_Return }); }
 	};
 
 	class MemberAccessStatementParser : public StatementParser
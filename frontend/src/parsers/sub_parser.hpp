@@ -27,6 +27,87 @@ namespace HXSL
 		return false; \
 	}
 
+	// Tokens a sub parser can start with. A parser may only narrow its set if it fails without side effects on every other token.
+	struct FirstTokenSet
+	{
+		bool any = false;
+		std::vector<Keyword> keywords;
+		std::vector<char> delimiters;
+
+		static FirstTokenSet Any()
+		{
+			FirstTokenSet set;
+			set.any = true;
+			return set;
+		}
+
+		static FirstTokenSet Keywords(std::initializer_list<Keyword> keywords)
+		{
+			FirstTokenSet set;
+			set.keywords = keywords;
+			return set;
+		}
+
+		static FirstTokenSet Delimiters(std::initializer_list<char> delimiters)
+		{
+			FirstTokenSet set;
+			set.delimiters = delimiters;
+			return set;
+		}
+	};
+
+	// Maps a token to the registered parsers that can start with it, as a bit mask in registration order.
+	class FirstTokenDispatch
+	{
+		static constexpr size_t KeywordCount = Keyword_PrepPragma + 1;
+		static constexpr size_t DelimiterCount = 128;
+		static constexpr size_t OtherKey = KeywordCount + DelimiterCount;
+
+		std::vector<uint32_t> masks;
+
+		static size_t GetKey(const Token& token) noexcept
+		{
+			if (token.isKeyword() && static_cast<size_t>(token.Value) < KeywordCount) return static_cast<size_t>(token.Value);
+			if (token.isDelimiter() && static_cast<size_t>(token.Value) < DelimiterCount) return KeywordCount + static_cast<size_t>(token.Value);
+			return OtherKey;
+		}
+
+	public:
+		template <typename T>
+		void Build(const std::vector<std::unique_ptr<T>>& parsers)
+		{
+			HXSL_ASSERT(parsers.size() <= 32, "First token dispatch supports at most 32 parsers per registry.");
+			masks.assign(OtherKey + 1, 0);
+			for (size_t i = 0; i < parsers.size(); i++)
+			{
+				uint32_t bit = 1u << i;
+				auto set = parsers[i]->GetFirstTokens();
+				if (set.any)
+				{
+					for (auto& mask : masks)
+					{
+						mask |= bit;
+					}
+					continue;
+				}
+
+				for (auto keyword : set.keywords)
+				{
+					masks[static_cast<size_t>(keyword)] |= bit;
+				}
+				for (auto delimiter : set.delimiters)
+				{
+					masks[KeywordCount + static_cast<unsigned char>(delimiter)] |= bit;
+				}
+			}
+		}
+
+		uint32_t Get(const Token& token) const noexcept
+		{
+			return masks[GetKey(token)];
+		}
+	};
+
 	class SubParser
 	{
 	protected:
@@ -35,6 +116,8 @@ namespace HXSL
 		}
 	public:
 		virtual bool TryParse(Parser& parser, TokenStream& stream, ASTNode*& declOut) = 0;
+
+		virtual FirstTokenSet GetFirstTokens() const { return FirstTokenSet::Any(); }
 	};
 
 	class StatementParser
@@ -45,6 +128,8 @@ namespace HXSL
 		}
 	public:
 		virtual bool TryParse(Parser& parser, TokenStream& stream, ASTNode*& statementOut) = 0;
+
+		virtual FirstTokenSet GetFirstTokens() const { return FirstTokenSet::Any(); }
 	};
 
 	class ExpressionParser
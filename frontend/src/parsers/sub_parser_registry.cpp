@@ -7,8 +7,10 @@
 namespace HXSL
 {
 	std::vector<std::unique_ptr<SubParser>> SubParserRegistry::parsers;
+	FirstTokenDispatch SubParserRegistry::dispatch;
 	std::once_flag SubParserRegistry::initFlag;
 	std::vector<std::unique_ptr<StatementParser>> StatementParserRegistry::parsers;
+	FirstTokenDispatch StatementParserRegistry::dispatch;
 	std::once_flag StatementParserRegistry::initFlag;
 	std::vector<std::unique_ptr<ExpressionParser>> ExpressionParserRegistry::parsers;
 	std::once_flag ExpressionParserRegistry::initFlag;
@@ -23,6 +25,7 @@ namespace HXSL
 				Register<EnumParser>();
 				Register<UsingParser>();
 				Register<NamespaceParser>();
+				dispatch.Build(parsers);
 			});
 	}
 
@@ -39,6 +42,7 @@ namespace HXSL
 				Register<IfStatementParser>();
 				Register<ReturnStatementParser>();
 				Register<MemberAccessStatementParser>();
+				dispatch.Build(parsers);
 			});
 	}
 
@@ -2,6 +2,7 @@
 #define SUB_PARSER_REGISTRY_HPP
 
 #include "sub_parser.hpp"
+#include <bit>
 
 namespace HXSL
 {
@@ -9,6 +10,7 @@ namespace HXSL
 	{
 	private:
 		static std::vector<std::unique_ptr<SubParser>> parsers;
+		static FirstTokenDispatch dispatch;
 		static std::once_flag initFlag;
 
 	public:
@@ -18,8 +20,10 @@ namespace HXSL
 		{
 			do
 			{
-				for (auto& subParser : parsers)
+				for (auto mask = dispatch.Get(stream.Current()); mask != 0; mask &= mask - 1)
 				{
+					auto& subParser = parsers[std::countr_zero(mask)];
+					parser.speculativeAttempts++;
 					stream.PushState();
 					if (subParser->TryParse(parser, stream, declOut))
 					{
@@ -51,6 +55,7 @@ namespace HXSL
 	{
 	private:
 		static std::vector<std::unique_ptr<StatementParser>> parsers;
+		static FirstTokenDispatch dispatch;
 		static std::once_flag initFlag;
 
 	public:
@@ -58,8 +63,10 @@ namespace HXSL
 
 		static bool TryParse(Parser& parser, TokenStream& stream, ASTNode*& statementOut, bool leaveOpen = false)
 		{
-			for (auto& subParser : parsers)
+			for (auto mask = dispatch.Get(stream.Current()); mask != 0; mask &= mask - 1)
 			{
+				auto& subParser = parsers[std::countr_zero(mask)];
+				parser.speculativeAttempts++;
 				stream.PushState();
 				if (subParser->TryParse(parser, stream, statementOut))
 				{
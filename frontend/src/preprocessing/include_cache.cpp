@@ -0,0 +1,250 @@
+#include "include_cache.hpp"
+#include "utils/hashing.hpp"
+
+namespace HXSL
+{
+	// Index of the next token that is not whitespace or a line break, Size() if there is none.
+	static size_t NextSignificant(const TokenBuffer& tokens, size_t index)
+	{
+		while (index < tokens.Size())
+		{
+			auto type = tokens.GetType(index);
+			if (type != TokenType_Whitespace && type != TokenType_NewLine)
+			{
+				break;
+			}
+			index++;
+		}
+		return index;
+	}
+
+	static bool IsKeywordAt(const TokenBuffer& tokens, size_t index, Keyword keyword)
+	{
+		return index < tokens.Size() && tokens.GetType(index) == TokenType_Keyword && tokens.GetToken(index).asKeyword() == keyword;
+	}
+
+	static IdentifierInfo* IdentifierAt(const TokenBuffer& tokens, size_t index)
+	{
+		return index < tokens.Size() && tokens.GetType(index) == TokenType_Identifier ? tokens.GetToken(index).ii : nullptr;
+	}
+
+	// Matches '#ifndef X #define X ... #endif' where the #endif is the last token and closes the #ifndef.
+	static IdentifierInfo* DetectIncludeGuard(const TokenBuffer& tokens)
+	{
+		size_t index = NextSignificant(tokens, 0);
+		if (!IsKeywordAt(tokens, index, Keyword_PrepIfndef))
+		{
+			return nullptr;
+		}
+
+		index = NextSignificant(tokens, index + 1);
+		auto guard = IdentifierAt(tokens, index);
+		if (!guard)
+		{
+			return nullptr;
+		}
+
+		index = NextSignificant(tokens, index + 1);
+		if (!IsKeywordAt(tokens, index, Keyword_PrepDefine))
+		{
+			return nullptr;
+		}
+
+		index = NextSignificant(tokens, index + 1);
+		if (IdentifierAt(tokens, index) != guard)
+		{
+			return nullptr;
+		}
+
+		size_t depth = 1;
+		for (index++; index < tokens.Size(); index++)
+		{
+			if (tokens.GetType(index) != TokenType_Keyword)
+			{
+				continue;
+			}
+
+			switch (tokens.GetToken(index).asKeyword())
+			{
+			case Keyword_PrepIf:
+			case Keyword_PrepIfdef:
+			case Keyword_PrepIfndef:
+				depth++;
+				break;
+			case Keyword_PrepElif:
+			case Keyword_PrepElse:
+				if (depth == 1)
+				{
+					return nullptr;
+				}
+				break;
+			case Keyword_PrepEndif:
+				if (--depth == 0)
+				{
+					return NextSignificant(tokens, index + 1) == tokens.Size() ? guard : nullptr;
+				}
+				break;
+			}
+		}
+
+		return nullptr;
+	}
+
+	static bool DetectPragmaOnce(const TokenBuffer& tokens)
+	{
+		for (size_t i = 0; i < tokens.Size(); i++)
+		{
+			if (!IsKeywordAt(tokens, i, Keyword_PrepPragma))
+			{
+				continue;
+			}
+
+			auto name = IdentifierAt(tokens, NextSignificant(tokens, i + 1));
+			if (name && name->name == "once")
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	IncludeCache& IncludeCache::Instance()
+	{
+		static IncludeCache instance;
+		return instance;
+	}
+
+	std::shared_ptr<const IncludeFile> IncludeCache::Load(const std::string& path, std::shared_ptr<MappedSource> source, uint64_t hash)
+	{
+		auto file = std::make_shared<IncludeFile>();
+		file->path = path;
+		file->hash = hash;
+		file->source = source;
+		file->identifiers = std::make_unique<IdentifierTable>();
+
+		SourceFile sourceFile = SourceFile(nullptr, INVALID_SOURCE_ID, std::move(source));
+		ILogger logger = ILogger(true);
+		LexerContext context = LexerContext(*file->identifiers, &sourceFile, sourceFile.GetInputStream().get(), &logger, HXSLLexerConfig::InstancePreprocess());
+		file->tokenized = file->tokens.Tokenize(&context) && !logger.HasMessages();
+		if (file->tokenized)
+		{
+			file->pragmaOnce = DetectPragmaOnce(file->tokens);
+			file->guard = DetectIncludeGuard(file->tokens);
+		}
+
+		return file;
+	}
+
+	void IncludeCache::EvictLeastRecentlyUsed()
+	{
+		while (capacity != 0 && files.size() > capacity)
+		{
+			auto oldest = files.begin();
+			for (auto it = files.begin(); it != files.end(); ++it)
+			{
+				if (it->second.lastUse < oldest->second.lastUse)
+				{
+					oldest = it;
+				}
+			}
+			files.erase(oldest);
+		}
+	}
+
+	std::shared_ptr<const IncludeFile> IncludeCache::Get(const std::string& path)
+	{
+		std::error_code error;
+		auto lastWrite = std::filesystem::last_write_time(path, error);
+		auto size = error ? 0 : std::filesystem::file_size(path, error);
+		if (error)
+		{
+			return nullptr;
+		}
+
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			auto it = files.find(path);
+			if (it != files.end() && it->second.lastWrite == lastWrite && it->second.size == size && !it->second.IsRacy())
+			{
+				it->second.lastUse = ++useCounter;
+				return it->second.file;
+			}
+		}
+
+		std::shared_ptr<MappedSource> source = MappedSource::Open(path.c_str());
+		if (!source)
+		{
+			return nullptr;
+		}
+
+		auto verifiedAt = std::filesystem::file_time_type::clock::now();
+		uint64_t hash = XXH3_64bits(source->GetData(), source->GetLength());
+		{
+			// touched or racily written but unchanged, only the stamp is refreshed.
+			std::lock_guard<std::mutex> guard(lock);
+			auto it = files.find(path);
+			if (it != files.end() && it->second.file->hash == hash)
+			{
+				auto& entry = it->second;
+				entry.lastWrite = lastWrite;
+				entry.size = size;
+				entry.verifiedAt = verifiedAt;
+				entry.lastUse = ++useCounter;
+				return entry.file;
+			}
+		}
+
+		// lexed outside of the lock, if two threads race on the same file the first one to finish wins.
+		auto file = Load(path, std::move(source), hash);
+
+		std::lock_guard<std::mutex> guard(lock);
+		auto& entry = files[path];
+		if (!entry.file || entry.file->hash != hash)
+		{
+			entry.file = std::move(file);
+		}
+		entry.lastWrite = lastWrite;
+		entry.size = size;
+		entry.verifiedAt = verifiedAt;
+		entry.lastUse = ++useCounter;
+		auto result = entry.file;
+		EvictLeastRecentlyUsed();
+		return result;
+	}
+
+	size_t IncludeCache::Size() const
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		return files.size();
+	}
+
+	size_t IncludeCache::GetIdentifierCount() const
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		size_t count = 0;
+		for (auto& [path, entry] : files)
+		{
+			count += entry.file->identifiers->Size();
+		}
+		return count;
+	}
+
+	size_t IncludeCache::GetCapacity() const
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		return capacity;
+	}
+
+	void IncludeCache::SetCapacity(size_t value)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		capacity = value;
+		EvictLeastRecentlyUsed();
+	}
+
+	void IncludeCache::Clear()
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		files.clear();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#ifndef INCLUDE_CACHE_HPP
+#define INCLUDE_CACHE_HPP
+
+#include "lexical/token_buffer.hpp"
+#include "io/mapped_source.hpp"
+#include "pch/std.hpp"
+#include <filesystem>
+
+namespace HXSL
+{
+	// An include file lexed once with the preprocessor config. The tokens belong to no source and reference the
+	// identifiers of the file's own table, TokenBuffer::Rebind maps them onto the including context.
+	struct IncludeFile
+	{
+		std::string path;
+		uint64_t hash = 0;
+		std::shared_ptr<MappedSource> source;
+		// owned by the file, evicting it releases its identifiers once the last includer is done with it.
+		std::unique_ptr<IdentifierTable> identifiers;
+		TokenBuffer tokens;
+		// false if lexing reported diagnostics, the includer then lexes the file itself so they are logged against it.
+		bool tokenized = false;
+		bool pragmaOnce = false;
+		// Macro of an #ifndef/#define ... #endif guard around the whole file, nullptr if there is none.
+		IdentifierInfo* guard = nullptr;
+	};
+
+	// Process wide cache of include files keyed by path. An entry is reused without opening the file again as long as its
+	// modification time and size match, files written within RacyWindow of being cached are hashed again since coarse file
+	// system timestamps could hide a second write. The least recently used entries are dropped past the capacity.
+	class IncludeCache
+	{
+		static constexpr size_t DefaultCapacity = 256;
+		static constexpr auto RacyWindow = std::chrono::seconds(2); // FAT write times have a two second resolution.
+
+		struct Entry
+		{
+			std::shared_ptr<const IncludeFile> file;
+			std::filesystem::file_time_type lastWrite;
+			uintmax_t size = 0;
+			std::filesystem::file_time_type verifiedAt; // last time the content hash was checked against the file.
+			uint64_t lastUse = 0;
+
+			bool IsRacy() const noexcept { return lastWrite + RacyWindow >= verifiedAt; }
+		};
+
+		mutable std::mutex lock;
+		std::unordered_map<std::string, Entry> files;
+		size_t capacity = DefaultCapacity;
+		uint64_t useCounter = 0;
+
+		std::shared_ptr<const IncludeFile> Load(const std::string& path, std::shared_ptr<MappedSource> source, uint64_t hash);
+
+		void EvictLeastRecentlyUsed();
+
+	public:
+		static IncludeCache& Instance();
+
+		// Returns nullptr if the file can't be opened.
+		std::shared_ptr<const IncludeFile> Get(const std::string& path);
+
+		size_t Size() const;
+
+		// identifiers interned by the cached files, counted once per file.
+		size_t GetIdentifierCount() const;
+
+		size_t GetCapacity() const;
+
+		// Evicts entries right away if there are more than capacity, zero means no limit.
+		void SetCapacity(size_t value);
+
+		void Clear();
+	};
+}
+
+#endif
\ No newline at end of file
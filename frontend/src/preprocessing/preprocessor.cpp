@@ -3,8 +3,27 @@
 #include "parsers/parser.hpp"
 #include "parsers/hybrid_expr_parser.hpp"
 #include "evaluator.hpp"
+#include <filesystem>
+
 namespace HXSL
 {
+	// Literal spans exclude the quotes, writing the raw source text keeps them.
+	static TextSpan GetRawTokenSpan(const Token& token)
+	{
+		auto span = token.Span;
+		if (token.Type == TokenType_Literal)
+		{
+			span.start -= 1;
+			span.length += 2;
+		}
+		return span;
+	}
+
+	void TokenWriter::AddToken(const Token& token)
+	{
+		stream.Write(GetRawTokenSpan(token).span());
+	}
+
 	void Preprocessor::ParseMacroExpression(TokenStream& stream, Parser& parser, TokenCollection& tokens)
 	{
 		while (!stream.Current().isNewLine() && stream.CanAdvance())
@@ -12,24 +31,22 @@ namespace HXSL
 			auto current = stream.Current();
 			if (current.isIdentifier())
 			{
-				auto span = current.Span.span();
-				auto it = symbolTable.find(span);
-				if (it != symbolTable.end())
+				if (auto macro = FindMacro(current.ii))
 				{
 					stream.Advance();
-					ExpandMacroInner(stream, parser, it->second, &tokens);
+					ExpandMacroInner(stream, parser, *macro, &tokens);
 					continue;
 				}
 
-				if (span == "defined")
+				if (current.ii == definedId)
 				{
 					stream.Advance();
 					stream.ExpectDelimiter('(', EXPECTED_LEFT_PAREN);
-					TextSpan name;
-					stream.ExpectIdentifier(name);
+					Token name = stream.Current();
+					IdentifierInfo* nameId;
+					stream.ExpectIdentifier(nameId);
 					stream.ExpectDelimiter(')', EXPECTED_RIGHT_PAREN);
-					bool isDefined = symbolTable.find(name.span()) != symbolTable.end();
-					tokens.AddToken(Token(name, TokenType_Numeric, Number(isDefined)));
+					tokens.AddToken(Token(name.Span, TokenType_Numeric, Number(IsDefined(nameId))));
 					continue;
 				}
 			}
@@ -41,23 +58,28 @@ namespace HXSL
 
 	PrepTransformResult Preprocessor::TryExpandMacro(TokenStream& stream, Parser& parser, const Token& current)
 	{
-		auto id = current.Span.span();
-		auto it = symbolTable.find(id);
-		if (it == symbolTable.end())
+		auto macro = FindMacro(current.ii);
+		if (!macro)
 		{
 			return PrepTransformResult::Keep;
 		}
 
 		auto start = outputStream->GetPosition();
+
+		// the arguments of function-like macros may follow after whitespace, object-like ones keep it.
+		stream.SkipWhitespace(macro->parameters.size() > 0);
+		stream.TryAdvance();
 		stream.SkipWhitespace(false);
+
 		auto writer = TokenWriter(*outputStream.get());
-		ExpandMacroInner(stream, parser, it->second, &writer);
+		ExpandMacroInner(stream, parser, *macro, &writer);
 
 		auto end = outputStream->GetPosition();
 
 		MakeMapping(start, end, 0, -1, true);
 
-		return PrepTransformResult::Keep;
+		// the token after the invocation was not looked at yet, it might be a macro or directive itself.
+		return PrepTransformResult::Loop;
 	}
 
 	Number Preprocessor::EvalExpression(TokenStream& stream, Parser& parser)
@@ -135,10 +157,10 @@ namespace HXSL
 	{
 		stream.SkipWhitespace(true);
 		stream.Advance();
-		TextSpan name;
+		IdentifierInfo* name;
 		stream.ExpectIdentifier(name);
 
-		bool result = (symbolTable.find(name.span()) != symbolTable.end()) ^ negate;
+		bool result = IsDefined(name) ^ negate;
 
 		ifStateStack.push(ifState);
 		ifState = IfState_None;
@@ -189,27 +211,9 @@ namespace HXSL
 			auto& state = streamState;
 			auto& lexerState = state.state;
 			auto& currentToken = state.currentToken;
-			auto& cache = this->cache;
 
 			state.lastToken = currentToken;
 
-			/*
-			if (cache.CanAccess(state.tokenPosition))
-			{
-				if (currentStack == 0)
-				{
-					currentToken = cache.GetToken();
-				}
-				else
-				{
-					currentToken = cache.PeekToken(state.tokenPosition);
-				}
-
-				state.tokenPosition++;
-				return true;
-			}
-			*/
-
 			do
 			{
 				if (IsEndOfTokens() || context->HasCriticalErrors())
@@ -218,40 +222,24 @@ namespace HXSL
 					return false;
 				}
 
+				size_t start = lexerState.Index;
 				currentToken = Lexer::TokenizeStep(lexerState);
 				lexerState.Advance();
 
 				if (currentToken.Type == TokenType_Comment)
 				{
-					auto diff = lexerState.Line - currentToken.Span.line;
-					for (size_t i = 0; i < diff; i++)
-					{
-						outputStream->Write("\n", 1);
-					}
+					// comments are kept verbatim, files without directives then stay identical to their input.
+					outputStream->Write(lexerState.GetBuffer() + start, lexerState.Index - start);
 				}
 			} while (currentToken.Type == TokenType_Comment || currentToken.Type == TokenType_Unknown || (skipWhitespace && currentToken.Type == TokenType_Whitespace));
 
-			/*
-			if (currentStack == 0)
-			{
-				cache.IncrementPosition();
-			}
-			else
-			{
-				cache.AddToken(currentToken);
-			}
-			*/
-
 			state.tokenPosition++;
 			return true;
 		}
 	};
 
-	void Preprocessor::Process(SourceFile* file)
+	void Preprocessor::ProcessStream(TokenStream& stream)
 	{
-		state.file = file;
-		LexerContext lexerContext = LexerContext(ASTContext::GetCurrentContext()->GetIdentifierTable(), file, file->GetInputStream().get(), logger, HXSLLexerConfig::InstancePreprocess());
-		PrepTokenStream stream = PrepTokenStream(&lexerContext, outputStream.get());
 		Parser parser = Parser(logger, stream);
 		auto result = PrepTransformResult::Keep;
 		while (stream.CanAdvance())
@@ -268,32 +256,109 @@ namespace HXSL
 				{
 					if (current.isNewLine())
 					{
-						outputStream->Write("\n", 1);
+						outputStream->Write(current.Span.span());
 						break;
 					}
 
-					outputStream->Write(current.Span.span());
+					outputStream->Write(GetRawTokenSpan(current).span());
 					break;
 				}
 			} while (result == PrepTransformResult::Loop);
 		}
+	}
 
-		file->SetInputStream(std::move(outputStream));
+	static std::string ResolveIncludePath(const SourceFile* includer, const StringSpan& name)
+	{
+		std::filesystem::path path = std::filesystem::path(name.str());
+		if (path.is_relative() && !includer->GetPath().empty())
+		{
+			path = std::filesystem::path(includer->GetPath()).parent_path() / path;
+		}
+		return path.lexically_normal().string();
 	}
 
-	PrepTransformResult Preprocessor::Transform(Token& current, TokenStream& stream, Parser& parser)
+	void Preprocessor::HandleInclude(TokenStream& stream, const TextSpan& literal)
 	{
-		if (current.isNewLine())
+		auto path = ResolveIncludePath(state.file, literal.span());
+
+		// repeated includes of guarded files are dropped before the file is even opened again.
+		auto it = includedFiles.find(path);
+		if (it != includedFiles.end())
 		{
-			return PrepTransformResult::Keep;
+			auto& included = it->second;
+			if (included->pragmaOnce || (included->guard && IsDefined(idTable.Find(included->guard->name))))
+			{
+				return;
+			}
+		}
+
+		if (stack.size() >= MaxIncludeDepth)
+		{
+			stream.LogFormatted(PREP_INCLUDE_TOO_DEEP, path);
+			return;
+		}
+
+		auto file = IncludeCache::Instance().Get(path);
+		if (!file)
+		{
+			stream.LogFormatted(PREP_INCLUDE_NOT_FOUND, path);
+			return;
+		}
+		includedFiles[path] = file;
+
+		auto& sourceManager = ASTContext::GetCurrentContext()->GetSourceManager();
+		auto source = sourceManager.AddSource(file->source);
+
+		stack.push(state);
+		state = {};
+		state.file = source;
+
+		auto start = outputStream->GetPosition();
+		LexerContext lexerContext = LexerContext(idTable, source, source->GetInputStream().get(), logger, HXSLLexerConfig::InstancePreprocess());
+		if (file->tokenized)
+		{
+			TokenBuffer tokens;
+			tokens.Rebind(file->tokens, source->GetID(), idTable);
+			TokenStream includeStream = TokenStream(&lexerContext, &tokens);
+			ProcessStream(includeStream);
+		}
+		else
+		{
+			TokenStream includeStream = TokenStream(&lexerContext);
+			ProcessStream(includeStream);
+		}
+		MakeMapping(start, outputStream->GetPosition(), 0, 0);
+
+		state = stack.top();
+		stack.pop();
+	}
+
+	void Preprocessor::Process(SourceFile* file)
+	{
+		state.file = file;
+		auto& input = file->GetInputStream();
+		outputStream = std::make_unique<TextStream>(input->GetBuffer(), input->GetLength());
+		LexerContext lexerContext = LexerContext(idTable, file, file->GetInputStream().get(), logger, HXSLLexerConfig::InstancePreprocess());
+		PrepTokenStream stream = PrepTokenStream(&lexerContext, outputStream.get());
+		ProcessStream(stream);
+
+		outputStream->SetLength(outputStream->GetPosition());
+		if (outputStream->IsView())
+		{
+			// nothing was rewritten, keep reading from the input (and its mapping) directly.
+			input->SetLength(outputStream->GetLength());
+			outputStream.reset();
+			return;
 		}
 
-		auto& lexerState = stream.GetLexerState();
+		file->SetInputStream(std::move(outputStream));
+	}
 
-		if (lexerState.Index >= state.includeEnd)
+	PrepTransformResult Preprocessor::Transform(Token& current, TokenStream& stream, Parser& parser)
+	{
+		if (current.isNewLine())
 		{
-			state = stack.top();
-			stack.pop();
+			return PrepTransformResult::Keep;
 		}
 
 		if (current.isDelimiterOf('#'))
@@ -322,9 +387,9 @@ namespace HXSL
 		{
 			stream.SkipWhitespace(true);
 			stream.Advance();
-			TextSpan name;
+			IdentifierInfo* name;
 			stream.ExpectIdentifier(name);
-			MacroSymbol symbol = MacroSymbol(name);
+			std::vector<IdentifierInfo*> parameters;
 
 			if (stream.TryGetDelimiter('('))
 			{
@@ -343,17 +408,24 @@ namespace HXSL
 						}
 					}
 					first = false;
-					TextSpan paramName;
+					IdentifierInfo* paramName;
 					stream.ExpectIdentifier(paramName, EXPECTED_IDENTIFIER);
-					symbol.AddParameter(paramName);
+					parameters.push_back(paramName);
 				}
 			}
 
 			stream.SkipWhitespace(false);
-			ParseMacroExpression(stream, parser, symbol);
+			TokenCollection tokens;
+			ParseMacroExpression(stream, parser, tokens);
 
-			StringSpan nameSpan = *symbol.name.get();
-			symbolTable.insert(std::make_pair(nameSpan, std::move(symbol)));
+			if (name && !IsDefined(name))
+			{
+				auto symbol = allocator.Alloc<MacroSymbol>();
+				symbol->name = name;
+				symbol->parameters = allocator.CopySpan(parameters);
+				symbol->tokens = allocator.CopySpan(tokens.tokens);
+				symbolTable.insert({ name, symbol });
+			}
 		}
 		break;
 		case Keyword_PrepIf:
@@ -431,8 +503,13 @@ namespace HXSL
 		case Keyword_PrepIfndef: return HandleIfdef(stream, parser, true);
 		case Keyword_PrepInclude:
 		{
+			stream.SkipWhitespace(true);
+			stream.Advance();
 			TextSpan literal;
-			stream.ExpectLiteral(literal);
+			if (stream.ExpectLiteral(literal))
+			{
+				HandleInclude(stream, literal);
+			}
 		}
 		break;
 		case Keyword_PrepError:
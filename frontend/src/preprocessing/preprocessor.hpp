@@ -4,6 +4,7 @@
 #include "lexical/token_stream.hpp"
 #include "lexical/text_mapping.hpp"
 #include "parsers/parser.hpp"
+#include "include_cache.hpp"
 #include "utils/span.hpp"
 
 namespace HXSL
@@ -23,21 +24,22 @@ namespace HXSL
 		}
 	};
 
-	struct MacroSymbol : public TokenCollection
+	// Macros live in the arena of the preprocessor, the name and parameters are interned identifiers of the current context.
+	struct MacroSymbol
 	{
-		std::unique_ptr<std::string> name;
-		std::vector<std::unique_ptr<std::string>> parameters;
-		std::unordered_map<StringSpan, size_t> parametersLookup;
+		IdentifierInfo* name;
+		Span<IdentifierInfo*> parameters;
+		Span<Token> tokens;
 
-		MacroSymbol(TextSpan span) : name(std::make_unique<std::string>(span.str()))
+		// Index of the parameter ii, parameters.size() if ii is none.
+		size_t FindParameter(IdentifierInfo* ii) const noexcept
 		{
-		}
-
-		void AddParameter(const TextSpan& span)
-		{
-			auto index = parameters.size();
-			parameters.push_back(std::make_unique<std::string>(span.str()));
-			parametersLookup.insert({ StringSpan(*parameters.back()), index });
+			size_t i = 0;
+			while (i < parameters.size() && parameters[i] != ii)
+			{
+				i++;
+			}
+			return i;
 		}
 	};
 
@@ -50,7 +52,6 @@ namespace HXSL
 		SourceFile* file = nullptr;
 		uint32_t linesSkippedCumulative = 0;
 		uint32_t columnsSkippedCumulative = 0;
-		size_t includeEnd = SIZE_MAX;
 
 		TextMapping MakeMapping(size_t start, size_t end, int32_t lineOffset, int32_t columnOffset, bool resetColumn)
 		{
@@ -98,10 +99,7 @@ namespace HXSL
 		TextStream& stream;
 		TokenWriter(TextStream& stream) : stream(stream) {}
 
-		const void AddToken(const Token& token)
-		{
-			stream.Write(token.Span.span());
-		}
+		void AddToken(const Token& token);
 	};
 
 	class Decoder
@@ -164,8 +162,14 @@ namespace HXSL
 
 	class Preprocessor
 	{
+		static constexpr size_t MaxIncludeDepth = 64;
+
 		ILogger* logger;
-		std::unordered_map<StringSpan, MacroSymbol> symbolTable;
+		IdentifierTable& idTable;
+		IdentifierInfo* definedId;
+		BumpAllocator allocator;
+		std::unordered_map<IdentifierInfo*, MacroSymbol*> symbolTable;
+		std::unordered_map<std::string, std::shared_ptr<const IncludeFile>> includedFiles;
 		std::vector<TextMapping> mappings;
 		OffsetMappingStorage lineOffsets;
 		std::stack<PreprocessorState> stack;
@@ -176,6 +180,14 @@ namespace HXSL
 		std::stack<IfState> ifStateStack;
 		std::vector<DiagnosticSuppressionRange> suppressionRanges;
 
+		MacroSymbol* FindMacro(IdentifierInfo* name) const
+		{
+			auto it = symbolTable.find(name);
+			return it != symbolTable.end() ? it->second : nullptr;
+		}
+
+		bool IsDefined(IdentifierInfo* name) const { return symbolTable.find(name) != symbolTable.end(); }
+
 		void ParseMacroExpression(TokenStream& stream, Parser& parser, TokenCollection& tokens);
 
 		template<typename TokenOutput>
@@ -236,24 +248,22 @@ namespace HXSL
 
 							if (token.isIdentifier())
 							{
-								auto span = token.Span.span();
-								auto it = symbolTable.find(span);
-								if (it != symbolTable.end())
+								if (auto macro = FindMacro(token.ii))
 								{
 									stream.Advance();
-									ExpandMacroInner(stream, parser, it->second, &expr);
+									ExpandMacroInner(stream, parser, *macro, &expr);
 									continue;
 								}
 
-								if (span == "defined")
+								if (token.ii == definedId)
 								{
 									stream.Advance();
 									stream.ExpectDelimiter('(', EXPECTED_LEFT_PAREN);
-									TextSpan name;
-									stream.ExpectIdentifier(name);
+									Token name = stream.Current();
+									IdentifierInfo* nameId;
+									stream.ExpectIdentifier(nameId);
 									stream.ExpectDelimiter(')', EXPECTED_RIGHT_PAREN);
-									bool isDefined = symbolTable.find(name.span()) != symbolTable.end();
-									expr.AddToken(Token(name, TokenType_Numeric, Number(isDefined)));
+									expr.AddToken(Token(name.Span, TokenType_Numeric, Number(IsDefined(nameId))));
 									continue;
 								}
 							}
@@ -271,14 +281,12 @@ namespace HXSL
 				stream.LogFormatted(MACRO_PARAM_COUNT_MISMATCH);
 			}
 
-			size_t paramIndex = 0;
 			for (auto& t : symbol.tokens)
 			{
-				auto itt = symbol.parametersLookup.find(t.Span.span());
-				if (itt != symbol.parametersLookup.end() && itt->second < args.size())
+				size_t param = t.isIdentifier() ? symbol.FindParameter(t.ii) : symbol.parameters.size();
+				if (param < args.size())
 				{
-					auto& inner = args[itt->second];
-					for (auto& tInner : inner.tokens)
+					for (auto& tInner : args[param].tokens)
 					{
 						output->AddToken(tInner);
 					}
@@ -298,10 +306,14 @@ namespace HXSL
 
 		PrepTransformResult HandleIfdef(TokenStream& stream, Parser& parser, bool negate);
 
+		void HandleInclude(TokenStream& stream, const TextSpan& literal);
+
+		void ProcessStream(TokenStream& stream);
+
 		void MakeMapping(size_t start, size_t end, int32_t lineOffset, int32_t columnOffset, bool resetColumn = false);
 
 	public:
-		Preprocessor(ILogger* logger) : logger(logger), outputStream(std::make_unique<TextStream>())
+		Preprocessor(ILogger* logger) : logger(logger), idTable(ASTContext::GetCurrentContext()->GetIdentifierTable()), definedId(idTable.Get("defined"))
 		{
 		}
 
@@ -24,4 +24,15 @@ namespace HXSL
 		stubMap.insert({ assembly, pStub });
 		return pStub;
 	}
+
+	StubModule* ASTStubManager::AddLazyStub(Assembly* assembly)
+	{
+		auto stub = make_uptr<StubModule>();
+		stub->module = assembly->GetModule();
+		stub->unit = nullptr;
+		auto pStub = stub.get();
+		stubs.push_back(std::move(stub));
+		stubMap.insert({ assembly, pStub });
+		return pStub;
+	}
 }
@@ -13,6 +13,8 @@ namespace HXSL
 		ASTStubManager() = default;
 		StubModule* GetStub(Assembly* assembly);
 		StubModule* AddStub(Assembly* assembly);
+		// stub without a decompiled unit, filled by the symbol index loader as declarations get decoded.
+		StubModule* AddLazyStub(Assembly* assembly);
 		Span<uptr<StubModule>> GetAllStubs() { return stubs; }
 
 	};
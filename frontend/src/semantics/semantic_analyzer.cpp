@@ -1,17 +1,21 @@
 #include "semantic_analyzer.hpp"
 #include "sub_analyzer_registry.hpp"
 #include "symbols/symbol_table.hpp"
+#include "symbols/symbol_index.hpp"
 #include "symbols/symbol_resolver.hpp"
 #include "symbols/symbol_collector.hpp"
 #include "type_checker.hpp"
 #include "config.h"
+#include "utils/profiler.hpp"
+#include "utils/thread_pool.hpp"
 
 namespace HXSL
 {
-	class DebugVisitor : public ASTVisitor<EmptyDeferralContext>
+	class DebugVisitor : public ASTVisitor<DebugVisitor>
 	{
+	public:
 		size_t size = 0;
-		TraversalBehavior Visit(ASTNode*& node, size_t depth, bool deferred, EmptyDeferralContext& context) override
+		TraversalBehavior Visit(ASTNode*& node, size_t depth, bool deferred, EmptyDeferralContext& context)
 		{
 			size += sizeof(*node);
 			std::string indentation(depth * 2, ' ');
@@ -23,6 +27,11 @@ namespace HXSL
 
 	TraversalBehavior SemanticAnalyzer::AnalyzerVisitor::Visit(ASTNode*& node, size_t depth, bool deferred, EmptyDeferralContext& context)
 	{
+		// sub analyzers only look at declarations.
+		if (IsStatementType(node->GetType()))
+		{
+			return TraversalBehavior_Skip;
+		}
 		return SubAnalyzerRegistry::TryAnalyze(analyzer, node, analyzer.Compilation());
 	}
 
@@ -58,13 +67,95 @@ namespace HXSL
 
 	}
 
+	struct FunctionBodyResult
+	{
+		uptr<ASTContext> context;
+		uptr<ILogger> logger;
+	};
+
+	void SemanticAnalyzer::TypeCheck(SymbolResolver& resolver)
+	{
+		// sub analyzers only look at declarations, which are final after resolving, so both share a walk.
+		TypeChecker checker(*this, resolver);
+		AnalyzerVisitor visitor(*this);
+		FusedASTVisitor<TypeChecker, AnalyzerVisitor> fused(checker, visitor);
+		if (threadCount <= 1)
+		{
+			fused.Traverse(compilation);
+			return;
+		}
+
+		// declarations first, bodies only depend on declarations and are checked concurrently afterwards.
+		ILogger declarationLog = ILogger(true);
+		std::vector<FunctionBodyTask> bodies;
+		{
+			LoggerAdapter::ScopedRedirect redirect(&declarationLog);
+			checker.SetBodyTasks(&bodies);
+			fused.Traverse(compilation);
+			checker.SetBodyTasks(nullptr);
+		}
+
+		auto* context = ASTContext::GetCurrentContext();
+		std::vector<FunctionBodyResult> results(bodies.size());
+		for (auto& result : results)
+		{
+			result.context = make_uptr<ASTContext>(context);
+			result.logger = make_uptr<ILogger>(true);
+		}
+
+		if (!bodies.empty())
+		{
+			PROFILE_SCOPE("Check Function Bodies");
+			ThreadPool pool = ThreadPool(std::min(threadCount, bodies.size()));
+			pool.ParallelFor(bodies.size(), [&](size_t i)
+				{
+					auto& task = bodies[i];
+					auto& result = results[i];
+					auto previous = ASTContext::GetCurrentContext();
+					ASTContext::SetCurrentContext(result.context.get());
+					{
+						LoggerAdapter::ScopedRedirect redirect(result.logger.get());
+						SymbolResolver bodyResolver(*this, references, *outputAssembly.get(), *primitiveManager.get(), *arrayManager.get(), *pointerManager.get(), *swizzleManager.get());
+						bodyResolver.RestoreScope(task.scope);
+						TypeChecker bodyChecker(*this, bodyResolver);
+						bodyChecker.Traverse(task.body);
+					}
+					ASTContext::SetCurrentContext(previous);
+				});
+		}
+
+		for (auto& result : results)
+		{
+			context->Merge(*result.context);
+		}
+
+		// diagnostics come out in the order of a serial walk.
+		size_t position = 0;
+		for (size_t i = 0; i < bodies.size(); ++i)
+		{
+			logger->Replay(declarationLog, position, bodies[i].logPosition);
+			logger->Replay(*results[i].logger);
+			position = bodies[i].logPosition;
+		}
+		logger->Replay(declarationLog, position, declarationLog.GetDeferredEventCount());
+	}
+
 	bool SemanticAnalyzer::Analyze()
 	{
 		for (auto& ref : references.GetAssemblies())
 		{
 			auto* refAsm = ref.get();
+			PROFILE_SCOPE("Load Reference");
+			if (auto* loader = refAsm->GetSymbolTable()->GetIndexLoader())
+			{
+				// symbols get decoded from the index as lookups reach them.
+				loader->Bind(stubManager.AddLazyStub(refAsm), &references);
+				refAsm->Seal();
+				continue;
+			}
+
+			// references are views owned by the compilation, see Assembly::CreateView, filling their tables touches nothing shared.
 			auto* stub = stubManager.AddStub(refAsm);
-			refAsm->UnsealUnsafe();
 			SymbolCollector collector(*this, refAsm);
 			collector.Traverse(stub->unit);
 
@@ -82,29 +173,37 @@ namespace HXSL
 #endif
 
 		SymbolCollector collector(*this, outputAssembly.get());
-		collector.Traverse(compilation);
+		{
+			PROFILE_SCOPE("Collect Symbols");
+			collector.Traverse(compilation);
+		}
 
 		WarmupCache();
 
 		SymbolResolver resolver(*this, references, *outputAssembly.get(), *primitiveManager.get(), *arrayManager.get(), *pointerManager.get(), *swizzleManager.get());
-		resolver.Traverse(compilation);
+		{
+			PROFILE_SCOPE("Resolve Symbols");
+			resolver.Traverse(compilation);
+		}
 
 #if HXSL_DEBUG
 		logger->LogFormattedInternal(LogLevel_Verbose, "Symbol resolve initial phase done! {} errors.", logger->GetErrorCount());
 #endif
 
-		collector.LateTraverse();
+		{
+			PROFILE_SCOPE("Late Collect Symbols");
+			collector.LateTraverse();
+		}
 
-		TypeChecker checker(*this, resolver);
-		checker.Traverse(compilation);
+		{
+			PROFILE_SCOPE("Type Check & Sub Analyzers");
+			TypeCheck(resolver);
+		}
 
 #if HXSL_DEBUG
 		logger->LogFormattedInternal(LogLevel_Verbose, "Type checks done! {} errors.", logger->GetErrorCount());
 #endif
 
-		AnalyzerVisitor visitor(*this);
-		visitor.Traverse(compilation);
-
 #if HXSL_DEBUG
 		debug.Traverse(compilation);
 #endif
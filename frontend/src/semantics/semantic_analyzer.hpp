@@ -4,9 +4,12 @@
 #include "pch/ast_analyzers.hpp"
 #include "logging/logger_adapter.hpp"
 #include "ast_stub_manager.hpp"
+#include "symbols/overload_index.hpp"
 
 namespace HXSL
 {
+	class SymbolResolver;
+
 #define IF_ERR_RET_BREAK(expr) \
 if (!expr) { \
 	return TraversalBehavior_Break; \
@@ -21,11 +24,14 @@ if (!expr) { \
 		ASTStubManager stubManager;
 		uptr<Assembly> outputAssembly;
 		uptr<PrimitiveManager> primitiveManager;
+		uptr<TypeInterner> typeInterner;
 		uptr<PointerManager> pointerManager;
 		uptr<ArrayManager> arrayManager;
 		uptr<SwizzleManager> swizzleManager;
+		OverloadIndex overloadIndex;
+		size_t threadCount = 1;
 
-		class AnalyzerVisitor : public ASTVisitor<EmptyDeferralContext>
+		class AnalyzerVisitor : public ASTVisitor<AnalyzerVisitor>
 		{
 		private:
 			SemanticAnalyzer& analyzer;
@@ -35,13 +41,15 @@ if (!expr) { \
 			{
 			}
 
-			TraversalBehavior Visit(ASTNode*& node, size_t depth, bool deferred, EmptyDeferralContext& context) override;
+			TraversalBehavior Visit(ASTNode*& node, size_t depth, bool deferred, EmptyDeferralContext& context);
 		};
 
 		friend class SymbolResolver;
 
 		void AnalyzeInner(CompilationUnit* compilation);
 
+		void TypeCheck(SymbolResolver& resolver);
+
 	public:
 		SemanticAnalyzer(ILogger* logger, CompilationUnit* compilation, const AssemblyCollection& references) :
 			LoggerAdapter(logger),
@@ -49,14 +57,20 @@ if (!expr) { \
 			references(references),
 			outputAssembly(Assembly::Create("")),
 			primitiveManager(std::make_unique<PrimitiveManager>()),
-			pointerManager(std::make_unique<PointerManager>()),
-			arrayManager(std::make_unique<ArrayManager>()),
-			swizzleManager(std::make_unique<SwizzleManager>(*primitiveManager.get()))
+			typeInterner(std::make_unique<TypeInterner>()),
+			pointerManager(std::make_unique<PointerManager>(*typeInterner.get())),
+			arrayManager(std::make_unique<ArrayManager>(*typeInterner.get())),
+			swizzleManager(std::make_unique<SwizzleManager>(*primitiveManager.get(), *typeInterner.get()))
 		{
 		}
 
 		ASTStubManager& GetStubManager() { return stubManager; }
 
+		OverloadIndex& GetOverloadIndex() noexcept { return overloadIndex; }
+
+		// with more than one thread, function bodies are type checked concurrently once all declarations are checked.
+		void SetThreadCount(size_t count) noexcept { threadCount = std::max<size_t>(count, 1); }
+
 		static void InitializeSubSystems();
 
 		DEFINE_GET_SET_MOVE(uptr<ArrayManager>, ArrayManager, arrayManager)
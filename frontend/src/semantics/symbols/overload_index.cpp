@@ -0,0 +1,191 @@
+#include "overload_index.hpp"
+
+namespace HXSL
+{
+	static bool IsSameType(const SymbolDef* a, const SymbolDef* b) noexcept
+	{
+		return a == b || (a != nullptr && a->IsEquivalentTo(b));
+	}
+
+	static bool TryGetKind(const FunctionOverload* overload, OverloadKind& kind) noexcept
+	{
+		switch (overload->GetType())
+		{
+		case NodeType_FunctionOverload:
+			kind = OverloadKind_Function;
+			return true;
+		case NodeType_ConstructorOverload:
+			kind = OverloadKind_Constructor;
+			return true;
+		case NodeType_OperatorOverload:
+			kind = OverloadKind_Operator;
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	bool OverloadKey::TryHash(uint64_t& hash) const noexcept
+	{
+		XXHash3Chain chain;
+		chain.Combine(static_cast<uint64_t>(kind) | static_cast<uint64_t>(static_cast<uint8_t>(op)) << 8);
+
+		if (result)
+		{
+			auto fqn = result->GetFullyQualifiedIdentifier();
+			if (!fqn) return false;
+			chain.Combine(fqn->hash());
+		}
+
+		for (auto param : parameters)
+		{
+			auto fqn = param ? param->GetFullyQualifiedIdentifier() : nullptr;
+			if (!fqn) return false;
+			chain.Combine(fqn->hash());
+		}
+
+		chain.Combine(parameters.size());
+		hash = chain.hash;
+		return true;
+	}
+
+	bool OverloadSet::Matches(const FunctionOverload* overload, const OverloadKey& key) noexcept
+	{
+		OverloadKind kind;
+		if (!TryGetKind(overload, kind) || kind != key.kind)
+		{
+			return false;
+		}
+
+		if (kind == OverloadKind_Operator)
+		{
+			auto op = static_cast<const OperatorOverload*>(overload)->GetOperator();
+			if (ToLookupChar(op) != key.op)
+			{
+				return false;
+			}
+
+			if (op == Operator_Cast && !IsSameType(overload->GetReturnType(), key.result))
+			{
+				return false;
+			}
+		}
+
+		auto params = overload->GetParameters();
+		if (params.size() != key.parameters.size())
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < params.size(); ++i)
+		{
+			if (!IsSameType(params[i]->GetDeclaredType(), key.parameters[i]))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void OverloadSet::Build(const SymbolTableNode* owner)
+	{
+		entries.clear();
+		candidates.clear();
+
+		auto& children = owner->GetChildren();
+		version = owner->GetVersion();
+
+		std::vector<const SymbolDef*> types;
+		for (auto& [name, child] : children)
+		{
+			if (!child || !child->GetMetadata())
+			{
+				continue;
+			}
+
+			auto overload = dyn_cast<FunctionOverload>(child->GetMetadata()->declaration);
+			OverloadKind kind;
+			if (!overload || !TryGetKind(overload, kind))
+			{
+				continue;
+			}
+
+			candidates.push_back(overload);
+
+			types.clear();
+			for (auto param : overload->GetParameters())
+			{
+				types.push_back(param->GetDeclaredType());
+			}
+
+			OverloadKey key = OverloadKey(kind, types);
+			if (kind == OverloadKind_Operator)
+			{
+				auto op = static_cast<OperatorOverload*>(overload)->GetOperator();
+				key = OverloadKey(op, op == Operator_Cast ? overload->GetReturnType() : nullptr, types);
+			}
+
+			// parameter types that failed to resolve were already reported, such an overload can only be found by cast matching.
+			uint64_t hash;
+			if (!key.TryHash(hash))
+			{
+				continue;
+			}
+
+			entries.push_back({ hash, InvalidIndex, overload });
+		}
+
+		size_t bucketCount = 1;
+		while (bucketCount < entries.size())
+		{
+			bucketCount <<= 1;
+		}
+
+		buckets.assign(bucketCount, InvalidIndex);
+		for (uint32_t i = 0; i < entries.size(); ++i)
+		{
+			auto& bucket = buckets[entries[i].hash & (bucketCount - 1)];
+			entries[i].next = bucket;
+			bucket = i;
+		}
+	}
+
+	FunctionOverload* OverloadSet::Find(const OverloadKey& key) const noexcept
+	{
+		uint64_t hash;
+		if (entries.empty() || !key.TryHash(hash))
+		{
+			return nullptr;
+		}
+
+		uint32_t index = buckets[hash & (buckets.size() - 1)];
+		while (index != InvalidIndex)
+		{
+			auto& entry = entries[index];
+			if (entry.hash == hash && Matches(entry.overload, key))
+			{
+				return entry.overload;
+			}
+			index = entry.next;
+		}
+
+		return nullptr;
+	}
+
+	const OverloadSet& OverloadIndex::GetSet(const SymbolTableNode* owner)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto& set = sets[owner];
+		if (!set)
+		{
+			set = make_uptr<OverloadSet>();
+		}
+
+		if (set->IsStale(owner))
+		{
+			set->Build(owner);
+		}
+		return *set;
+	}
+}
\ No newline at end of file
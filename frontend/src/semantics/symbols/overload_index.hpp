@@ -0,0 +1,91 @@
+#ifndef OVERLOAD_INDEX_HPP
+#define OVERLOAD_INDEX_HPP
+
+#include "symbol_table.hpp"
+#include "utils/hashing.hpp"
+
+namespace HXSL
+{
+	enum OverloadKind : uint8_t
+	{
+		OverloadKind_Function,
+		OverloadKind_Constructor,
+		OverloadKind_Operator,
+	};
+
+	// Structural key of an overload, the owning node already implies the name so only the kind and the types take part.
+	// Types hash by their interned fully qualified name, building a key never formats or hashes a string.
+	struct OverloadKey
+	{
+		OverloadKind kind;
+		char op = 0; // lookup char of the operator, see ToLookupChar.
+		const SymbolDef* result = nullptr; // target type, only set for casts.
+		Span<const SymbolDef*> parameters;
+
+		OverloadKey(OverloadKind kind, const Span<const SymbolDef*>& parameters) : kind(kind), parameters(parameters)
+		{
+		}
+
+		OverloadKey(Operator op, const SymbolDef* result, const Span<const SymbolDef*>& parameters) : kind(OverloadKind_Operator), op(ToLookupChar(op)), result(result), parameters(parameters)
+		{
+		}
+
+		// returns false if a type was never entered into a symbol table, such a key can't match anything.
+		bool TryHash(uint64_t& hash) const noexcept;
+	};
+
+	// All overloads declared directly below one symbol table node, e.g. the "Foo" node of a function or the node of a type
+	// for its constructors and operators. Lookups by key are a single probe into a chained hash table.
+	class OverloadSet
+	{
+		static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+		struct Entry
+		{
+			uint64_t hash;
+			uint32_t next;
+			FunctionOverload* overload;
+		};
+
+		std::vector<Entry> entries;
+		std::vector<FunctionOverload*> candidates;
+		std::vector<uint32_t> buckets;
+		uint64_t version = std::numeric_limits<uint64_t>::max();
+
+		static bool Matches(const FunctionOverload* overload, const OverloadKey& key) noexcept;
+
+	public:
+		void Build(const SymbolTableNode* owner);
+
+		bool IsStale(const SymbolTableNode* owner) const noexcept { return owner->GetVersion() != version; }
+
+		FunctionOverload* Find(const OverloadKey& key) const noexcept;
+
+		// every overload below the node, including ones with unresolved parameter types, used for implicit cast matching.
+		const std::vector<FunctionOverload*>& GetCandidates() const noexcept { return candidates; }
+	};
+
+	// Overload sets of the symbol table nodes, built on first use. Sets are boxed, a reference stays valid while other sets are added.
+	// Bodies are checked concurrently, no overloads are declared anymore at that point so a built set is never rebuilt while being read.
+	class OverloadIndex
+	{
+		dense_map<const SymbolTableNode*, uptr<OverloadSet>> sets;
+		std::mutex mutex;
+
+	public:
+		const OverloadSet& GetSet(const SymbolTableNode* owner);
+
+		FunctionOverload* Find(const SymbolTableNode* owner, const OverloadKey& key)
+		{
+			if (owner == nullptr)
+			{
+				return nullptr;
+			}
+			return GetSet(owner).Find(key);
+		}
+
+		void Clear() { sets.clear(); }
+	};
+}
+
+#endif
\ No newline at end of file
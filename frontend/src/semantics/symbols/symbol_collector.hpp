@@ -24,9 +24,11 @@ namespace HXSL
 		std::stack<CollectorScopeContext> stack;
 	};
 
-	class SymbolCollector : public ASTVisitor<EmptyDeferralContext>
+	class SymbolCollector : public ASTVisitor<SymbolCollector>
 	{
 	private:
+		friend ASTVisitor;
+
 
 		SemanticAnalyzer& analyzer;
 		Assembly* targetAssembly;
@@ -45,9 +47,9 @@ namespace HXSL
 			lateNodes.push_back(node);
 		}
 
-		void VisitClose(ASTNode* node, size_t depth) override;
+		void VisitClose(ASTNode* node, size_t depth);
 
-		TraversalBehavior Visit(ASTNode*& node, size_t depth, bool deferred, EmptyDeferralContext& context) override;
+		TraversalBehavior Visit(ASTNode*& node, size_t depth, bool deferred, EmptyDeferralContext& context);
 
 	public:
 		SymbolCollector(SemanticAnalyzer& analyzer, Assembly* assembly) : analyzer(analyzer), targetAssembly(assembly), current({})
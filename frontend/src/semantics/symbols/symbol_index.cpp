@@ -0,0 +1,686 @@
+#include "symbol_index.hpp"
+#include "middleware/module_decompiler.hpp"
+#include "ast_modules/primitive_manager.hpp"
+#include "il/assembly_collection.hpp"
+#include "utils/endianness.hpp"
+
+namespace HXSL
+{
+	static constexpr uint32_t SymbolIndexMagic = 0x49535848; // "HXSI"
+	static constexpr uint32_t SymbolIndexVersion = 2;
+	static constexpr size_t HeaderSize = SymbolIndexView::HeaderSize;
+	static constexpr size_t NodeRecordSize = sizeof(uint32_t) * 7;
+	static constexpr size_t PayloadRecordSize = sizeof(uint64_t) + sizeof(uint32_t) * 4;
+
+	template<typename T>
+	static void WriteLittleEndian(Stream& stream, T value)
+	{
+		stream.WriteValue(EndianUtils::ToLittleEndian(value));
+	}
+
+	template<typename T>
+	static T ReadLittleEndian(const uint8_t* data)
+	{
+		T value;
+		std::memcpy(&value, data, sizeof(T));
+		return EndianUtils::FromLittleEndian(value);
+	}
+
+	static SymbolRef* GetTypeRef(SymbolDef* decl)
+	{
+		switch (decl->GetType())
+		{
+		case NodeType_Field:
+			return cast<Field>(decl)->GetSymbolRef();
+		case NodeType_Parameter:
+			return cast<Parameter>(decl)->GetSymbolRef();
+		case NodeType_FunctionOverload:
+			return cast<FunctionOverload>(decl)->GetReturnSymbolRef();
+		case NodeType_OperatorOverload:
+			return cast<OperatorOverload>(decl)->GetReturnSymbolRef();
+		case NodeType_ConstructorOverload:
+			return cast<ConstructorOverload>(decl)->GetTargetTypeSymbolRef();
+		case NodeType_Enum:
+			return cast<Enum>(decl)->GetSymbolRef();
+		default:
+			return nullptr;
+		}
+	}
+
+	static bool IsFunctionGroup(SymbolTableNode* node)
+	{
+		for (auto& [name, child] : node->GetChildren())
+		{
+			auto& metadata = child->GetMetadata();
+			if (!metadata || metadata->declaration == nullptr)
+			{
+				continue;
+			}
+
+			switch (metadata->declaration->GetType())
+			{
+			case NodeType_FunctionOverload:
+			case NodeType_OperatorOverload:
+			case NodeType_ConstructorOverload:
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static bool ShouldIndex(SymbolTableNode* node, const SymbolIndexImage::LayoutLookup& layoutOf)
+	{
+		auto& metadata = node->GetMetadata();
+		if (!metadata)
+		{
+			// namespace paths and function groups.
+			return true;
+		}
+
+		auto* decl = metadata->declaration;
+		if (decl == nullptr)
+		{
+			// block scopes, nothing below them is visible from outside.
+			return false;
+		}
+
+		switch (decl->GetType())
+		{
+		case NodeType_Namespace:
+		case NodeType_EnumItem:
+			return true;
+		}
+
+		return layoutOf(decl) != nullptr;
+	}
+
+	static uint32_t GetNodeFlags(SymbolTableNode* node)
+	{
+		auto& metadata = node->GetMetadata();
+		if (metadata && metadata->declaration)
+		{
+			if (metadata->declaration->GetType() == NodeType_Namespace)
+			{
+				return SymbolIndexNodeFlags_Lazy | SymbolIndexNodeFlags_Namespace;
+			}
+			return SymbolIndexNodeFlags_None;
+		}
+
+		return IsFunctionGroup(node) ? SymbolIndexNodeFlags_None : SymbolIndexNodeFlags_Lazy;
+	}
+
+	// types outside of the indexed table are stored by name, only those that can be looked up by it again.
+	static SymbolIndexTypeKind GetExternalTypeKind(SymbolDef* type)
+	{
+		if (type->GetFullyQualifiedName().empty())
+		{
+			return SymbolIndexTypeKind_None;
+		}
+
+		switch (type->GetType())
+		{
+		case NodeType_Primitive:
+			return type->GetAssembly() == PrimitiveUniverse::Get().GetAssembly() ? SymbolIndexTypeKind_Name : SymbolIndexTypeKind_None;
+		case NodeType_Struct:
+		case NodeType_Class:
+		case NodeType_Enum:
+			return SymbolIndexTypeKind_External;
+		default:
+			// arrays, pointers and swizzles are created per compilation and have no path in any table.
+			return SymbolIndexTypeKind_None;
+		}
+	}
+
+	uptr<SymbolIndexImage> SymbolIndexImage::Build(const SymbolTable& table, const LayoutLookup& layoutOf)
+	{
+		auto image = make_uptr<SymbolIndexImage>();
+		auto& nodes = image->nodes;
+
+		std::vector<SymbolTableNode*> sources;
+		dense_map<const SymbolTableNode*, uint32_t> indices;
+
+		auto* root = table.GetRoot();
+		nodes.push_back({ {}, SymbolIndexNone, 0, 0, SymbolIndexNone, SymbolIndexNodeFlags_Lazy });
+		sources.push_back(root);
+		indices.insert({ root, 0 });
+
+		// breadth first, so the children of every node end up next to each other.
+		std::vector<SymbolTableNode*> children;
+		for (size_t i = 0; i < sources.size(); i++)
+		{
+			children.clear();
+			for (auto& [name, child] : sources[i]->GetChildren())
+			{
+				if (ShouldIndex(child, layoutOf))
+				{
+					children.push_back(child);
+				}
+			}
+
+			std::sort(children.begin(), children.end(), [](SymbolTableNode* a, SymbolTableNode* b) { return a->GetName().view() < b->GetName().view(); });
+
+			nodes[i].firstChild = static_cast<uint32_t>(nodes.size());
+			nodes[i].childCount = static_cast<uint32_t>(children.size());
+			for (auto* child : children)
+			{
+				indices.insert({ child, static_cast<uint32_t>(nodes.size()) });
+				sources.push_back(child);
+				nodes.push_back({ child->GetName().str(), static_cast<uint32_t>(i), 0, 0, SymbolIndexNone, GetNodeFlags(child) });
+			}
+		}
+
+		// payloads once all nodes have their index, type references can point anywhere.
+		for (size_t i = 1; i < sources.size(); i++)
+		{
+			auto& metadata = sources[i]->GetMetadata();
+			if (!metadata || metadata->declaration == nullptr || metadata->declaration->GetType() == NodeType_Namespace)
+			{
+				continue;
+			}
+
+			auto* decl = metadata->declaration;
+			ImagePayload payload = { layoutOf(decl), SymbolIndexTypeKind_None, SymbolIndexNone, {} };
+			auto* ref = GetTypeRef(decl);
+			if (auto* type = ref ? ref->GetDeclaration() : nullptr)
+			{
+				auto it = indices.find(type->GetSymbolHandle().GetNode());
+				if (it != indices.end())
+				{
+					payload.typeKind = SymbolIndexTypeKind_Node;
+					payload.typeNode = it->second;
+				}
+				else
+				{
+					payload.typeKind = GetExternalTypeKind(type);
+					if (payload.typeKind == SymbolIndexTypeKind_None)
+					{
+						// a reference the loader couldn't bind, without an index the assembly is decompiled as a whole.
+						return nullptr;
+					}
+					payload.typeName = type->GetFullyQualifiedName().str();
+				}
+			}
+
+			if (payload.layout == nullptr && payload.typeKind == SymbolIndexTypeKind_None)
+			{
+				continue;
+			}
+
+			nodes[i].payload = static_cast<uint32_t>(image->payloads.size());
+			image->payloads.push_back(std::move(payload));
+		}
+
+		return image;
+	}
+
+	void SymbolIndexImage::Write(Stream& stream, const Backend::ModuleWriter& writer) const
+	{
+		std::vector<StringSpan> strings;
+		strings.reserve(nodes.size());
+		for (auto& node : nodes)
+		{
+			strings.push_back(node.name);
+		}
+		for (auto& payload : payloads)
+		{
+			if (payload.typeKind == SymbolIndexTypeKind_Name || payload.typeKind == SymbolIndexTypeKind_External)
+			{
+				strings.push_back(payload.typeName);
+			}
+		}
+
+		std::sort(strings.begin(), strings.end(), [](const StringSpan& a, const StringSpan& b) { return a.view() < b.view(); });
+		strings.erase(std::unique(strings.begin(), strings.end()), strings.end());
+
+		dense_map<StringSpan, uint32_t> offsets;
+		uint32_t stringTableSize = 0;
+		for (auto& str : strings)
+		{
+			offsets.insert({ str, stringTableSize });
+			stringTableSize += static_cast<uint32_t>(str.size());
+		}
+
+		WriteLittleEndian(stream, SymbolIndexMagic);
+		WriteLittleEndian(stream, SymbolIndexVersion);
+		WriteLittleEndian(stream, static_cast<uint32_t>(nodes.size()));
+		WriteLittleEndian(stream, static_cast<uint32_t>(payloads.size()));
+		WriteLittleEndian(stream, stringTableSize);
+		WriteLittleEndian(stream, 0u);
+
+		for (auto& node : nodes)
+		{
+			WriteLittleEndian(stream, offsets[node.name]);
+			WriteLittleEndian(stream, static_cast<uint32_t>(node.name.size()));
+			WriteLittleEndian(stream, node.parent);
+			WriteLittleEndian(stream, node.firstChild);
+			WriteLittleEndian(stream, node.childCount);
+			WriteLittleEndian(stream, node.payload);
+			WriteLittleEndian(stream, node.flags);
+		}
+
+		for (auto& payload : payloads)
+		{
+			uint64_t record = payload.layout ? writer.FindRecordId(payload.layout) : 0;
+			WriteLittleEndian(stream, record);
+			WriteLittleEndian(stream, static_cast<uint32_t>(payload.typeKind));
+			switch (payload.typeKind)
+			{
+			case SymbolIndexTypeKind_Node:
+				WriteLittleEndian(stream, payload.typeNode);
+				WriteLittleEndian(stream, 0u);
+				break;
+			case SymbolIndexTypeKind_Name:
+			case SymbolIndexTypeKind_External:
+				WriteLittleEndian(stream, offsets[payload.typeName]);
+				WriteLittleEndian(stream, static_cast<uint32_t>(payload.typeName.size()));
+				break;
+			default:
+				WriteLittleEndian(stream, SymbolIndexNone);
+				WriteLittleEndian(stream, 0u);
+				break;
+			}
+			WriteLittleEndian(stream, 0u);
+		}
+
+		for (auto& str : strings)
+		{
+			if (!str.empty())
+			{
+				stream.Write(str.data(), str.size());
+			}
+		}
+	}
+
+	size_t SymbolIndexView::GetSectionSize(const uint8_t* data, size_t size)
+	{
+		if (data == nullptr || size < HeaderSize)
+		{
+			return 0;
+		}
+
+		if (ReadLittleEndian<uint32_t>(data) != SymbolIndexMagic || ReadLittleEndian<uint32_t>(data + 4) != SymbolIndexVersion)
+		{
+			return 0;
+		}
+
+		uint64_t nodeCount = ReadLittleEndian<uint32_t>(data + 8);
+		uint64_t payloadCount = ReadLittleEndian<uint32_t>(data + 12);
+		uint64_t stringTableSize = ReadLittleEndian<uint32_t>(data + 16);
+		return static_cast<size_t>(HeaderSize + nodeCount * NodeRecordSize + payloadCount * PayloadRecordSize + stringTableSize);
+	}
+
+	bool SymbolIndexView::Open(const uint8_t* data, size_t size)
+	{
+		auto sectionSize = GetSectionSize(data, size);
+		if (sectionSize == 0 || sectionSize > size)
+		{
+			return false;
+		}
+
+		nodeCount = ReadLittleEndian<uint32_t>(data + 8);
+		payloadCount = ReadLittleEndian<uint32_t>(data + 12);
+		stringTableSize = ReadLittleEndian<uint32_t>(data + 16);
+		if (nodeCount == 0)
+		{
+			return false;
+		}
+
+		nodes = data + HeaderSize;
+		payloads = nodes + static_cast<size_t>(nodeCount) * NodeRecordSize;
+		strings = reinterpret_cast<const char*>(payloads + static_cast<size_t>(payloadCount) * PayloadRecordSize);
+		return true;
+	}
+
+	// records are checked when they are decoded instead of up front, opening the index must not touch every page of it.
+	SymbolIndexView::Node SymbolIndexView::GetNode(uint32_t index) const
+	{
+		Node node = { {}, SymbolIndexNone, 0, 0, SymbolIndexNone, SymbolIndexNodeFlags_None };
+		if (index >= nodeCount)
+		{
+			return node;
+		}
+
+		auto* record = nodes + static_cast<size_t>(index) * NodeRecordSize;
+		uint64_t nameOffset = ReadLittleEndian<uint32_t>(record);
+		uint64_t nameLength = ReadLittleEndian<uint32_t>(record + 4);
+		if (nameOffset + nameLength <= stringTableSize)
+		{
+			node.name = StringSpan(strings + nameOffset, static_cast<size_t>(nameLength));
+		}
+
+		node.parent = ReadLittleEndian<uint32_t>(record + 8);
+		node.firstChild = ReadLittleEndian<uint32_t>(record + 12);
+		node.childCount = ReadLittleEndian<uint32_t>(record + 16);
+		node.payload = ReadLittleEndian<uint32_t>(record + 20);
+		node.flags = ReadLittleEndian<uint32_t>(record + 24);
+
+		if (static_cast<uint64_t>(node.firstChild) + node.childCount > nodeCount)
+		{
+			node.childCount = 0;
+		}
+
+		return node;
+	}
+
+	bool SymbolIndexView::GetPayload(uint32_t index, Payload& payload) const
+	{
+		if (index >= payloadCount)
+		{
+			return false;
+		}
+
+		auto* record = payloads + static_cast<size_t>(index) * PayloadRecordSize;
+		payload.record = ReadLittleEndian<uint64_t>(record);
+		payload.typeKind = static_cast<SymbolIndexTypeKind>(ReadLittleEndian<uint32_t>(record + 8));
+		payload.typeTarget = ReadLittleEndian<uint32_t>(record + 12);
+		payload.typeName = {};
+
+		if (payload.typeKind == SymbolIndexTypeKind_Name || payload.typeKind == SymbolIndexTypeKind_External)
+		{
+			uint64_t length = ReadLittleEndian<uint32_t>(record + 16);
+			if (static_cast<uint64_t>(payload.typeTarget) + length > stringTableSize)
+			{
+				payload.typeKind = SymbolIndexTypeKind_None;
+				return true;
+			}
+			payload.typeName = StringSpan(strings + payload.typeTarget, static_cast<size_t>(length));
+		}
+
+		return true;
+	}
+
+	uint32_t SymbolIndexView::FindChild(uint32_t parent, const StringSpan& name) const
+	{
+		auto node = GetNode(parent);
+		auto target = name.view();
+
+		uint32_t low = node.firstChild;
+		uint32_t high = node.firstChild + node.childCount;
+		while (low < high)
+		{
+			uint32_t mid = low + (high - low) / 2;
+			auto midName = GetNode(mid).name.view();
+			if (midName < target)
+			{
+				low = mid + 1;
+			}
+			else if (target < midName)
+			{
+				high = mid;
+			}
+			else
+			{
+				return mid;
+			}
+		}
+
+		return SymbolIndexNone;
+	}
+
+	SymbolIndexLoader::SymbolIndexLoader(Assembly* assembly, SymbolTable* table, const SymbolIndex& source)
+		: source(source), view(source.GetView()), assembly(assembly), table(table)
+	{
+		ModuleDecompilerOptions options;
+		options.markAsExtern = true;
+		decompiler = make_uptr<ModuleDecompiler>(options);
+
+		auto* root = table->GetRoot();
+		indexToNode.assign(view.GetNodeCount(), nullptr);
+		indexToNode[0] = root;
+		lazyNodes.insert({ root, 0 });
+	}
+
+	SymbolIndexLoader::~SymbolIndexLoader() = default;
+
+	void SymbolIndexLoader::Bind(StubModule* target, const AssemblyCollection* targetReferences)
+	{
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+		stub = target;
+		references = targetReferences;
+	}
+
+	SymbolTableNode* SymbolIndexLoader::LoadChild(SymbolTableNode* parent, const StringSpan& name)
+	{
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+		auto it = lazyNodes.find(parent);
+		if (it == lazyNodes.end())
+		{
+			// everything below non lazy nodes is loaded together with them, so this is a plain miss.
+			return nullptr;
+		}
+
+		auto index = view.FindChild(it->second, name);
+		if (index == SymbolIndexNone)
+		{
+			return nullptr;
+		}
+
+		auto* node = EnsureNode(index);
+		FlushReverseMap();
+		return node;
+	}
+
+	SymbolTableNode* SymbolIndexLoader::EnsureNode(uint32_t index)
+	{
+		if (index >= indexToNode.size())
+		{
+			return nullptr;
+		}
+
+		if (auto* node = indexToNode[index])
+		{
+			return node;
+		}
+
+		auto record = view.GetNode(index);
+		if (record.parent >= index)
+		{
+			// parents always come first, anything else is a broken index.
+			return nullptr;
+		}
+
+		auto* parent = EnsureNode(record.parent);
+		if (parent == nullptr)
+		{
+			return nullptr;
+		}
+
+		if (auto* node = indexToNode[index])
+		{
+			return node;
+		}
+
+		if (lazyNodes.find(parent) == lazyNodes.end())
+		{
+			// the parent was loaded as a whole but dropped this node.
+			return nullptr;
+		}
+
+		if (record.flags & SymbolIndexNodeFlags_Lazy)
+		{
+			return LoadLazyNode(index, record, parent);
+		}
+
+		return LoadSubtree(index, parent);
+	}
+
+	SymbolTableNode* SymbolIndexLoader::LoadLazyNode(uint32_t index, const SymbolIndexView::Node& record, SymbolTableNode* parent)
+	{
+		ObjPtr<SymbolMetadata> metadata;
+		Namespace* ns = nullptr;
+		if (record.flags & SymbolIndexNodeFlags_Namespace)
+		{
+			// only the name is needed to resolve through it, the members are looked up in the table.
+			auto* context = ASTContext::GetCurrentContext();
+			ns = Namespace::Create({}, context->GetIdentifier(record.name), {}, {}, {}, {}, {}, {}, {});
+			ns->SetExtern(true);
+			metadata = SymbolMetadata::Create(ns);
+		}
+
+		auto* node = table->AddNode(record.name, std::move(metadata), parent);
+		if (ns)
+		{
+			ns->SetAssembly(assembly, SymbolHandle(node));
+		}
+
+		indexToNode[index] = node;
+		lazyNodes.insert({ node, index });
+		return node;
+	}
+
+	SymbolTableNode* SymbolIndexLoader::LoadSubtree(uint32_t index, SymbolTableNode* parent)
+	{
+		struct Pending
+		{
+			uint32_t index;
+			SymbolTableNode* parent;
+		};
+
+		std::vector<Pending> queue;
+		std::vector<std::pair<SymbolDef*, uint32_t>> typed;
+		queue.push_back({ index, parent });
+
+		for (size_t i = 0; i < queue.size(); i++)
+		{
+			auto [current, currentParent] = queue[i];
+			auto record = view.GetNode(current);
+			auto* decl = DecodeDeclaration(record, currentParent);
+			if (decl == nullptr && record.payload != SymbolIndexNone)
+			{
+				// the record didn't make it into the module, neither does its subtree.
+				continue;
+			}
+
+			ObjPtr<SymbolMetadata> metadata;
+			if (decl)
+			{
+				metadata = SymbolMetadata::Create(decl);
+			}
+
+			auto* node = table->AddNode(record.name, std::move(metadata), currentParent);
+			if (decl)
+			{
+				decl->SetAssembly(assembly, SymbolHandle(node));
+				if (record.payload != SymbolIndexNone)
+				{
+					typed.push_back({ decl, record.payload });
+				}
+			}
+			indexToNode[current] = node;
+
+			if (record.firstChild <= current)
+			{
+				continue;
+			}
+
+			for (uint32_t c = 0; c < record.childCount; c++)
+			{
+				queue.push_back({ record.firstChild + c, node });
+			}
+		}
+
+		// types are bound after the whole subtree exists, members may refer to their parent type.
+		for (auto& [decl, payloadIndex] : typed)
+		{
+			SymbolIndexView::Payload payload;
+			if (view.GetPayload(payloadIndex, payload))
+			{
+				BindTypeRef(decl, payload);
+			}
+		}
+
+		return indexToNode[index];
+	}
+
+	SymbolDef* SymbolIndexLoader::DecodeDeclaration(const SymbolIndexView::Node& record, SymbolTableNode* parent)
+	{
+		SymbolIndexView::Payload payload;
+		if (record.payload != SymbolIndexNone && view.GetPayload(record.payload, payload) && payload.record != 0)
+		{
+			auto* layout = source.FindRecord(payload.record);
+			if (layout == nullptr)
+			{
+				return nullptr;
+			}
+			return decompiler->DeconvertLayout(layout);
+		}
+
+		// enum items are no records of their own, they come with their enum.
+		auto& parentMetadata = parent->GetMetadata();
+		if (!parentMetadata || parentMetadata->declaration == nullptr)
+		{
+			return nullptr;
+		}
+
+		if (auto* enm = dyn_cast<Enum>(parentMetadata->declaration))
+		{
+			for (auto* item : enm->GetItems())
+			{
+				if (item->GetName() == record.name)
+				{
+					return item;
+				}
+			}
+		}
+
+		return nullptr;
+	}
+
+	void SymbolIndexLoader::BindTypeRef(SymbolDef* decl, const SymbolIndexView::Payload& payload)
+	{
+		auto* ref = GetTypeRef(decl);
+		if (ref == nullptr)
+		{
+			return;
+		}
+
+		SymbolHandle handle;
+		switch (payload.typeKind)
+		{
+		case SymbolIndexTypeKind_Node:
+			handle = SymbolHandle(EnsureNode(payload.typeTarget));
+			break;
+		case SymbolIndexTypeKind_Name:
+			handle = PrimitiveUniverse::Get().GetSymbolTable()->FindNodeIndexFullPath(payload.typeName);
+			break;
+		case SymbolIndexTypeKind_External:
+			if (references)
+			{
+				for (auto& reference : references->GetAssemblies())
+				{
+					if (reference.get() == assembly)
+					{
+						continue;
+					}
+					handle = reference->GetSymbolTable()->FindNodeIndexFullPath(payload.typeName);
+					if (handle.valid())
+					{
+						break;
+					}
+				}
+			}
+			break;
+		default:
+			return;
+		}
+
+		auto* metadata = handle.valid() ? handle.GetMetadata() : nullptr;
+		if (metadata && metadata->declaration)
+		{
+			ref->SetTable(handle);
+		}
+	}
+
+	void SymbolIndexLoader::FlushReverseMap()
+	{
+		auto& reverseMap = decompiler->GetReverseMap();
+		if (stub)
+		{
+			for (auto& [node, layout] : reverseMap)
+			{
+				stub->reverseMap.insert({ node, layout });
+			}
+		}
+		reverseMap.clear();
+	}
+}
@@ -0,0 +1,195 @@
+#ifndef SYMBOL_INDEX_HPP
+#define SYMBOL_INDEX_HPP
+
+#include "symbol_table.hpp"
+#include "core/module.hpp"
+
+namespace HXSL
+{
+	class ModuleDecompiler;
+	class AssemblyCollection;
+	struct StubModule;
+
+	// On disk symbol index of an assembly, stored behind the module in .hlib files.
+	//
+	// header   | magic, version, node count, payload count, string table size, reserved (6 x u32)
+	// nodes    | name offset, name length, parent, first child, child count, payload, flags (7 x u32)
+	// payloads | record, type kind, type target, type name length, reserved (u64 + 4 x u32)
+	// strings  | sorted, deduplicated names without terminators
+	//
+	// Nodes are stored breadth first, so the children of a node are contiguous and sorted by name. The root is node 0.
+	// Payloads point at the module record holding the declaration plus the declared, return or base type of it.
+	// All values are little endian.
+
+	enum SymbolIndexNodeFlags : uint32_t
+	{
+		SymbolIndexNodeFlags_None = 0,
+		SymbolIndexNodeFlags_Lazy = 1 << 0, // children are materialized one by one, otherwise the whole subtree is loaded at once.
+		SymbolIndexNodeFlags_Namespace = 1 << 1,
+	};
+
+	enum SymbolIndexTypeKind : uint32_t
+	{
+		SymbolIndexTypeKind_None,
+		SymbolIndexTypeKind_Node, // type target is a node of the same index.
+		SymbolIndexTypeKind_Name, // type target is the string offset of the fully qualified name of a primitive.
+		SymbolIndexTypeKind_External, // type target is the string offset of the fully qualified name of a type in a referenced assembly.
+	};
+
+	static constexpr uint32_t SymbolIndexNone = ~0u;
+
+	// Writer side, captures the symbol table of a compilation while its AST is still alive.
+	// Types the index can't name (arrays, pointers and other compiler generated types) make Build return null, the assembly is
+	// then written without an index and loaded through the full decompile instead of binding those references wrong.
+	class SymbolIndexImage
+	{
+	public:
+		using LayoutLookup = std::function<const Backend::Layout* (SymbolDef* def)>;
+
+	private:
+		struct ImageNode
+		{
+			std::string name;
+			uint32_t parent;
+			uint32_t firstChild;
+			uint32_t childCount;
+			uint32_t payload;
+			uint32_t flags;
+		};
+
+		struct ImagePayload
+		{
+			const Backend::Layout* layout;
+			SymbolIndexTypeKind typeKind;
+			uint32_t typeNode;
+			std::string typeName;
+		};
+
+		std::vector<ImageNode> nodes;
+		std::vector<ImagePayload> payloads;
+
+	public:
+		static uptr<SymbolIndexImage> Build(const SymbolTable& table, const LayoutLookup& layoutOf);
+
+		size_t GetNodeCount() const noexcept { return nodes.size(); }
+
+		// record ids are taken from the writer, so the module has to be written first.
+		void Write(Stream& stream, const Backend::ModuleWriter& writer) const;
+	};
+
+	// Reader side, decodes records straight from the (usually memory mapped) section without copying it.
+	class SymbolIndexView
+	{
+		const uint8_t* nodes = nullptr;
+		const uint8_t* payloads = nullptr;
+		const char* strings = nullptr;
+		uint32_t nodeCount = 0;
+		uint32_t payloadCount = 0;
+		uint32_t stringTableSize = 0;
+
+	public:
+		struct Node
+		{
+			StringSpan name;
+			uint32_t parent;
+			uint32_t firstChild;
+			uint32_t childCount;
+			uint32_t payload;
+			uint32_t flags;
+		};
+
+		struct Payload
+		{
+			uint64_t record;
+			SymbolIndexTypeKind typeKind;
+			uint32_t typeTarget;
+			StringSpan typeName;
+		};
+
+		// validates the header and section bounds, the data has to outlive the view.
+		bool Open(const uint8_t* data, size_t size);
+
+		static constexpr size_t HeaderSize = sizeof(uint32_t) * 6;
+
+		// total size of the section described by the header, 0 if the header isn't one of a symbol index.
+		static size_t GetSectionSize(const uint8_t* data, size_t size);
+
+		uint32_t GetNodeCount() const noexcept { return nodeCount; }
+
+		Node GetNode(uint32_t index) const;
+
+		bool GetPayload(uint32_t index, Payload& payload) const;
+
+		uint32_t FindChild(uint32_t parent, const StringSpan& name) const;
+	};
+
+	// Symbol index of a loaded assembly, opened once and only read afterwards, so every compilation referencing the assembly shares it.
+	class SymbolIndex
+	{
+		SymbolIndexView view;
+		dense_map<Backend::Module::RecordId, Backend::Layout*> recordMap;
+
+	public:
+		SymbolIndex(dense_map<Backend::Module::RecordId, Backend::Layout*>&& recordMap) : recordMap(std::move(recordMap))
+		{
+		}
+
+		bool Open(const uint8_t* data, size_t size) { return view.Open(data, size); }
+
+		const SymbolIndexView& GetView() const noexcept { return view; }
+
+		Backend::Layout* FindRecord(Backend::Module::RecordId record) const
+		{
+			auto it = recordMap.find(record);
+			return it != recordMap.end() ? it->second : nullptr;
+		}
+	};
+
+	// Materializes nodes of a symbol index into the symbol table of a referenced assembly the first time a lookup reaches them.
+	// Namespaces are loaded child by child, anything below a type or function group is decoded as a whole, since
+	// overload resolution and member lookups walk the children of those directly.
+	// A loader belongs to the table of a single compilation, the nodes it creates live in that compilation's AST context.
+	class SymbolIndexLoader
+	{
+		const SymbolIndex& source;
+		const SymbolIndexView& view;
+		Assembly* assembly;
+		SymbolTable* table;
+		uptr<ModuleDecompiler> decompiler;
+		StubModule* stub = nullptr;
+		const AssemblyCollection* references = nullptr;
+		std::vector<SymbolTableNode*> indexToNode;
+		dense_map<const SymbolTableNode*, uint32_t> lazyNodes;
+		std::recursive_mutex mutex;
+
+		SymbolTableNode* EnsureNode(uint32_t index);
+
+		SymbolTableNode* LoadLazyNode(uint32_t index, const SymbolIndexView::Node& record, SymbolTableNode* parent);
+
+		SymbolTableNode* LoadSubtree(uint32_t index, SymbolTableNode* parent);
+
+		SymbolDef* DecodeDeclaration(const SymbolIndexView::Node& record, SymbolTableNode* parent);
+
+		void BindTypeRef(SymbolDef* decl, const SymbolIndexView::Payload& payload);
+
+		void FlushReverseMap();
+
+	public:
+		SymbolIndexLoader(Assembly* assembly, SymbolTable* table, const SymbolIndex& index);
+
+		~SymbolIndexLoader();
+
+		const SymbolIndexView& GetView() const noexcept { return view; }
+
+		// held by symbol table lookups, the table grows while being searched.
+		std::recursive_mutex& GetMutex() noexcept { return mutex; }
+
+		// Decoded declarations are registered in the stub so the module builder can link against their layouts, types of
+		// other assemblies are looked up in references.
+		void Bind(StubModule* stub, const AssemblyCollection* references);
+
+		SymbolTableNode* LoadChild(SymbolTableNode* parent, const StringSpan& name);
+	};
+}
+
+#endif
@@ -0,0 +1,95 @@
+#include "symbol_path_index.hpp"
+
+namespace HXSL
+{
+	void SymbolPathIndex::Add(uint64_t hash, SymbolTableNode* node)
+	{
+		auto result = live.insert({ hash, node });
+		if (!result.second)
+		{
+			if (result.first->second != node)
+			{
+				collisions++;
+			}
+			return;
+		}
+
+		if (IsFrozen())
+		{
+			overlay.insert({ hash, node });
+			if (overlay.size() * 4 > frozen.size())
+			{
+				Freeze();
+			}
+		}
+	}
+
+	void SymbolPathIndex::Remove(uint64_t hash, SymbolTableNode* node)
+	{
+		Thaw();
+		auto it = live.find(hash);
+		if (it != live.end() && it->second == node)
+		{
+			live.erase(it);
+		}
+	}
+
+	SymbolTableNode* SymbolPathIndex::Find(uint64_t hash) const noexcept
+	{
+		if (!frozen.empty())
+		{
+			size_t index = static_cast<size_t>(hash) & frozenMask;
+			while (true)
+			{
+				auto& slot = frozen[index];
+				if (slot.node == nullptr)
+				{
+					break;
+				}
+				if (slot.hash == hash)
+				{
+					return slot.node;
+				}
+				index = (index + 1) & frozenMask;
+			}
+
+			if (overlay.empty())
+			{
+				return nullptr;
+			}
+			auto it = overlay.find(hash);
+			return it != overlay.end() ? it->second : nullptr;
+		}
+
+		auto it = live.find(hash);
+		if (it != live.end())
+		{
+			return it->second;
+		}
+		return nullptr;
+	}
+
+	void SymbolPathIndex::Freeze()
+	{
+		// keep the load factor at or below 50% so probe sequences stay short.
+		size_t capacity = 16;
+		while (capacity < live.size() * 2)
+		{
+			capacity <<= 1;
+		}
+
+		frozen.assign(capacity, FrozenSlot{ 0, nullptr });
+		frozenMask = capacity - 1;
+		overlay.clear();
+
+		for (auto& [hash, node] : live)
+		{
+			size_t index = static_cast<size_t>(hash) & frozenMask;
+			while (frozen[index].node != nullptr)
+			{
+				index = (index + 1) & frozenMask;
+			}
+			frozen[index] = { hash, node };
+		}
+	}
+}
@@ -0,0 +1,67 @@
+#ifndef SYMBOL_PATH_INDEX_HPP
+#define SYMBOL_PATH_INDEX_HPP
+
+#include "pch/std.hpp"
+#include "utils/span.hpp"
+#include "utils/dense_map.hpp"
+#include "utils/hashing.hpp"
+
+namespace HXSL
+{
+	class SymbolTableNode;
+
+	// Flat index from the path hash of a node to the node, the path hash of a child is the hash of its name seeded with the path hash of its parent.
+	// Candidates must be verified by the caller, two nodes sharing a hash are recorded as a collision and only the first one is indexed.
+	class SymbolPathIndex
+	{
+		struct FrozenSlot
+		{
+			uint64_t hash;
+			SymbolTableNode* node;
+		};
+
+		dense_map<uint64_t, SymbolTableNode*> live;
+		std::vector<FrozenSlot> frozen; // open addressing, linear probing, only populated while frozen.
+		dense_map<uint64_t, SymbolTableNode*> overlay; // nodes added while frozen, e.g. materialized by a symbol index loader.
+		size_t frozenMask = 0;
+		size_t collisions = 0;
+
+	public:
+		static uint64_t HashPart(uint64_t parentHash, const StringSpan& part) noexcept
+		{
+			return XXH3_64bits_withSeed(part.data(), part.size(), parentHash);
+		}
+
+		void Add(uint64_t hash, SymbolTableNode* node);
+
+		void Remove(uint64_t hash, SymbolTableNode* node);
+
+		SymbolTableNode* Find(uint64_t hash) const noexcept;
+
+		// a miss is only authoritative if no two nodes ever shared a hash, otherwise the caller has to fall back to walking the tree.
+		bool HasCollisions() const noexcept { return collisions != 0; }
+
+		bool IsFrozen() const noexcept { return !frozen.empty(); }
+
+		// builds the read only probe table, called once the owning assembly is sealed. Nodes added later go to an overlay
+		// that is folded into the table once it grows past a quarter of it, only removals thaw the index.
+		void Freeze();
+
+		void Thaw() noexcept
+		{
+			frozen.clear();
+			frozen.shrink_to_fit();
+			overlay.clear();
+			frozenMask = 0;
+		}
+
+		void Clear()
+		{
+			Thaw();
+			live.clear();
+			collisions = 0;
+		}
+	};
+}
+
+#endif
@@ -466,73 +466,6 @@ namespace HXSL
 		return true;
 	}
 
-	bool SymbolResolver::ResolveConstructor(FunctionCallExpression* funcCallExpr, SymbolDef*& outDefinition, bool silent) const
-	{
-		outDefinition = nullptr;
-
-		SymbolRef* ref = funcCallExpr->GetSymbolRef();
-
-		SymbolHandle handle;
-		SymbolDef* typeDef = ResolveSymbol({}, ref->GetName(), ref->HasFullyQualifiedName(), handle, true);
-
-		if (handle.invalid() || typeDef == nullptr || !IsDataType(typeDef->GetType()))
-		{
-			return false;
-		}
-
-		auto signature = funcCallExpr->BuildConstructorOverloadSignature();
-		auto ctorHandle = handle.FindPart(signature);
-		if (ctorHandle.valid())
-		{
-			auto ctorMetadata = ctorHandle.GetMetadata();
-			if (SymbolTypeSanityCheck(ctorMetadata, ref, silent))
-			{
-				ref->SetTable(ctorHandle);
-				outDefinition = ctorMetadata->declaration;
-				return true;
-			}
-		}
-
-		if (!silent)
-		{
-			analyzer.Log(CTOR_OVERLOAD_NOT_FOUND, ref->GetSpan(), signature, typeDef->GetName());
-		}
-		return false;
-	}
-
-	bool SymbolResolver::ResolveFunction(FunctionCallExpression* funcCallExpr, SymbolDef*& outDefinition, bool silent) const
-	{
-		SymbolRef* ref = funcCallExpr->GetSymbolRef();
-
-		auto signature = funcCallExpr->BuildOverloadSignature();
-
-		bool success = false;
-		if (auto expr = funcCallExpr->FindAncestor<MemberAccessExpression>(NodeType_MemberAccessExpression, 1))
-		{
-			auto memberRef = expr->GetSymbolRef()->GetBaseDeclaration();
-			if (memberRef)
-			{
-				success = ResolveSymbol(ref, signature, memberRef->GetTable(), memberRef->GetSymbolHandle(), true);
-			}
-		}
-		else
-		{
-			success = ResolveSymbol(ref, signature, true);
-		}
-
-		if (!success && !silent)
-		{
-			analyzer.Log(FUNC_OVERLOAD_NOT_FOUND, funcCallExpr->GetSpan(), signature);
-		}
-
-		if (success)
-		{
-			outDefinition = ref->GetDeclaration();
-		}
-
-		return success;
-	}
-
 	void SymbolResolver::PushScope(ASTNode* parent, const StringSpan& span, bool external, SymbolHandle* searchHandle)
 	{
 		stack.push(current);
@@ -836,17 +769,19 @@ namespace HXSL
 
 		refInner->SetDeferred(false);
 
-		auto indexNext = handle.FindPart(refInner->GetName());
-		if (indexNext.invalid())
+		// swizzles are interned by pattern, checking them first avoids hashing the name for every vector member access.
+		auto decl = type->GetDeclaration();
+		if (auto prim = dyn_cast<Primitive>(decl))
 		{
-			auto decl = type->GetDeclaration();
-			if (auto prim = dyn_cast<Primitive>(decl))
+			if (swizzleManager.VerifySwizzle(prim, refInner))
 			{
-				if (swizzleManager.VerifySwizzle(prim, refInner))
-				{
-					return ResolveMemberResult::Success;
-				}
+				return ResolveMemberResult::Success;
 			}
+		}
+
+		auto indexNext = handle.FindPart(refInner->GetName());
+		if (indexNext.invalid())
+		{
 			return ResolveMemberResult::Failure;
 		}
 		auto metaInner = indexNext.GetMetadata();
@@ -38,7 +38,7 @@ namespace HXSL
 		Skip = 2   /// Skip resolution (e.g., function call or indexer)
 	};
 
-	class SymbolResolver : public ASTVisitor<ResolverDeferralContext>
+	class SymbolResolver : public ASTVisitor<SymbolResolver, ResolverDeferralContext>
 	{
 	private:
 
@@ -84,24 +84,6 @@ namespace HXSL
 
 		bool ResolveSymbol(SymbolRef* ref, std::optional<StringSpan> name, const SymbolTable* table, const SymbolHandle& lookup, bool silent = false) const;
 
-		/**
-		 * @brief Attempts to resolve the constructor call represented by the given expression.
-		 *
-		 * This function checks whether the given expression corresponds to a constructor call.
-		 *
-		 * @param funcCallExpr Pointer to the function call expression to analyze.
-		 * @param[out] outDefinition Pointer to the declaration. The pointer to the constructor overload if the ctor overload was successfully resolved; nullptr otherwise.
-		 * @param[out] success Optional output parameter. If provided, set to true if the constructor overload
-		 *                    was successfully resolved; false otherwise. Defaults to nullptr.
-		 * @param silent If true, suppresses error logging for resolution failures. Defaults to false.
-		 *
-		 * @return true if the expression represents a constructor call (regardless of resolution success).
-		 * @return false if the expression does not represent a constructor call.
-		 */
-		bool ResolveConstructor(FunctionCallExpression* funcCallExpr, SymbolDef*& outDefinition, bool silent = false) const;
-
-		bool ResolveFunction(FunctionCallExpression* funcCallExpr, SymbolDef*& outDefinition, bool silent = false) const;
-
 		/**
 		 * @brief Attempts to resolve a member within a chain expression.
 		 *
@@ -125,15 +107,24 @@ namespace HXSL
 
 		ResolverScopeContext& CurrentScope() noexcept { return current; }
 
-		void VisitClose(ASTNode* node, size_t depth) override;
+		ResolverDeferralContext CaptureScope() const { return ResolverDeferralContext(current, stack); }
+
+		// continues at a scope captured by another resolver, used to check function bodies on their own.
+		void RestoreScope(const ResolverDeferralContext& scope)
+		{
+			current = scope.current;
+			stack = scope.stack;
+		}
+
+		void VisitClose(ASTNode* node, size_t depth);
 
 		TraversalBehavior VisitExternal(ASTNode*& node, size_t depth, bool deferred, ResolverDeferralContext& context);
 
 		bool UseBeforeDeclarationCheck(SymbolRef* ref, ASTNode* parent) const;
 
-		TraversalBehavior Visit(ASTNode*& node, size_t depth, bool deferred, ResolverDeferralContext& context) override;
+		TraversalBehavior Visit(ASTNode*& node, size_t depth, bool deferred, ResolverDeferralContext& context);
 
-		void Traverse(ASTNode* node) override
+		void Traverse(ASTNode* node)
 		{
 			auto assemblyBackup = targetAssembly;
 			for (auto& reference : references.GetAssemblies())
@@ -1,4 +1,5 @@
 #include "symbol_table.hpp"
+#include "symbol_index.hpp"
 #include "ast_modules/instantiator.hpp"
 
 namespace HXSL
@@ -13,6 +14,23 @@ namespace HXSL
 		return declaration->GetAccessModifiers();
 	}
 
+	SymbolTable::SymbolTable() : allocator(this)
+	{
+		root = allocator.Alloc(StringSpan(), ObjPtr<SymbolMetadata>(), nullptr, this);
+	}
+
+	SymbolTable::~SymbolTable()
+	{
+		indexLoader.reset();
+		RemoveNode(root);
+		root = nullptr;
+	}
+
+	void SymbolTable::AttachIndex(uptr<SymbolIndexLoader>&& loader)
+	{
+		indexLoader = std::move(loader);
+	}
+
 	void SymbolTable::RemoveNode(SymbolTableNode* node)
 	{
 		std::stack<SymbolTableNode*> stack;
@@ -25,10 +43,45 @@ namespace HXSL
 			{
 				stack.push(childNode);
 			}
+			pathIndex.Remove(node->pathHash, node);
 			allocator.Free(node);
 		}
 	}
 
+	void SymbolTable::ReindexNode(SymbolTableNode* node)
+	{
+		std::stack<SymbolTableNode*> stack;
+		stack.push(node);
+		while (!stack.empty())
+		{
+			auto* current = stack.top();
+			stack.pop();
+
+			pathIndex.Remove(current->pathHash, current);
+			current->pathHash = SymbolPathIndex::HashPart(current->parent->pathHash, current->name);
+			pathIndex.Add(current->pathHash, current);
+
+			for (const auto& [childSpan, childNode] : current->GetChildren())
+			{
+				stack.push(childNode);
+			}
+		}
+	}
+
+	void SymbolTable::Remove(const SymbolHandle& handle)
+	{
+		auto* node = handle.GetNode();
+		if (node == nullptr || node == root)
+		{
+			return;
+		}
+
+		std::unique_lock<std::shared_mutex> writeLock(nodeMutex);
+		node->GetParent()->GetChildren().erase(node->GetName());
+		node->GetParent()->MarkModified();
+		RemoveNode(node);
+	}
+
 	SymbolHandle SymbolTable::Insert(StringSpan span, const ObjPtr<SymbolMetadata>& metadata, SymbolTableNode* start)
 	{
 		SymbolTableNode* current = start;
@@ -65,6 +118,10 @@ namespace HXSL
 		}
 
 		current->metadata = metadata;
+		if (current->parent)
+		{
+			current->parent->MarkModified();
+		}
 		return SymbolHandle(current);
 	}
 
@@ -85,13 +142,99 @@ namespace HXSL
 		return -1;
 	}
 
+	// checks that the path of node relative to start is span, walks up from the node and compares the parts back to front.
+	static bool IsPathOf(const SymbolTableNode* node, const SymbolTableNode* start, const StringSpan& span)
+	{
+		// separators inside a signature don't split, same as FindSep.
+		size_t limit = 0;
+		while (limit < span.size() && span[limit] != '(')
+		{
+			limit++;
+		}
+
+		size_t end = span.size();
+		while (true)
+		{
+			size_t begin = std::min(end, limit);
+			while (begin > 0 && span[begin - 1] != QUALIFIER_SEP)
+			{
+				begin--;
+			}
+
+			if (node == nullptr || node == start || node->GetName() != span.slice(begin, end - begin))
+			{
+				return false;
+			}
+
+			node = node->GetParent();
+			if (begin == 0)
+			{
+				return node == start;
+			}
+			end = begin - 1;
+		}
+	}
+
+	// tables backed by an index grow on lookup, lookups from concurrent analysis tasks are serialized by the loader.
+	static std::unique_lock<std::recursive_mutex> LockIndex(SymbolIndexLoader* loader)
+	{
+		if (loader == nullptr)
+		{
+			return {};
+		}
+		return std::unique_lock<std::recursive_mutex>(loader->GetMutex());
+	}
+
+	SymbolHandle SymbolTable::FindNodeIndexPart(StringSpan path, SymbolTableNode* startingNode) const
+	{
+		auto lock = LockIndex(indexLoader.get());
+		if (startingNode == nullptr)
+		{
+			startingNode = root;
+		}
+		auto child = startingNode->GetChild(path);
+		if (child == nullptr && indexLoader)
+		{
+			child = indexLoader->LoadChild(startingNode, path);
+		}
+		return MakeHandle(child);
+	}
+
 	SymbolHandle SymbolTable::FindNodeIndexFullPath(StringSpan span, SymbolTableNode* startingNode) const
 	{
+		auto lock = LockIndex(indexLoader.get());
 		if (startingNode == nullptr)
 		{
 			startingNode = root;
 		}
 
+		uint64_t hash = startingNode->GetPathHash();
+		StringSpan rest = span;
+		while (true)
+		{
+			size_t idx = FindSep(rest);
+			if (idx == -1) idx = rest.size();
+			hash = SymbolPathIndex::HashPart(hash, rest.slice(0, idx));
+
+			if (idx == rest.size())
+			{
+				break;
+			}
+			rest = rest.slice(idx + 1);
+		}
+
+		auto* candidate = pathIndex.Find(hash);
+		if (candidate && IsPathOf(candidate, startingNode, span))
+		{
+			return MakeHandle(candidate);
+		}
+
+		// nodes backed by an index only show up in the path index once they were materialized.
+		if (!pathIndex.HasCollisions() && !indexLoader)
+		{
+			return {};
+		}
+
 		auto* current = startingNode;
 		while (true)
 		{
@@ -100,6 +243,10 @@ namespace HXSL
 			StringSpan part = span.slice(0, idx);
 
 			auto* child = current->GetChild(part);
+			if (child == nullptr && indexLoader)
+			{
+				child = indexLoader->LoadChild(current, part);
+			}
 
 			if (child)
 			{
@@ -123,6 +270,7 @@ namespace HXSL
 
 	void SymbolTable::Clear()
 	{
+		pathIndex.Clear();
 		stringPool.clear();
 		RemoveNode(root);
 		root = allocator.Alloc(StringSpan(), ObjPtr<SymbolMetadata>(), nullptr, this);
@@ -144,209 +292,4 @@ namespace HXSL
 			}
 		}
 	}
-
-	void SymbolMetadata::Write(Stream& stream) const
-	{
-		// TODO: Remove stub.
-		HXSL_ASSERT(false, "SymbolMetadata::Write is not implemented.");
-	}
-
-	void SymbolMetadata::Read(Stream& stream, SymbolDef*& node, StringPool& container)
-	{
-		// TODO: Remove stub.
-		HXSL_ASSERT(false, "SymbolMetadata::Read is not implemented.");
-	}
-
-	void SymbolTable::Write(Stream& stream) const
-	{
-		// TODO: Remove stub.
-		HXSL_ASSERT(false, "SymbolTable::Write is not implemented.");
-	}
-
-	void SymbolTable::Read(Stream& stream, Assembly* parentAssembly)
-	{
-		// TODO: Remove stub.
-		HXSL_ASSERT(false, "SymbolTable::Read is not implemented.");
-	}
-
-	/*
-	void SymbolMetadata::Write(Stream& stream) const
-	{
-		stream.WriteUInt((uint32_t)symbolType);
-		stream.WriteUInt((uint32_t)scope);
-		stream.WriteUInt((uint32_t)accessModifier);
-		stream.WriteUInt((uint32_t)size);
-		if (symbolType == SymbolType_Namespace)
-		{
-			stream.WriteValue<bool>(false);
-			return;
-		}
-		stream.WriteValue<bool>(declaration);
-		if (declaration)
-		{
-			stream.WriteUInt(declaration->GetType());
-			declaration->Write(stream);
-		}
-	}
-
-	void SymbolMetadata::Read(Stream& stream, SymbolDef*& node, StringPool& container)
-	{
-		symbolType = static_cast<SymbolType>(stream.ReadUInt());
-		scope = static_cast<SymbolScopeType>(stream.ReadUInt());
-		accessModifier = static_cast<AccessModifier>(stream.ReadUInt());
-		size = stream.ReadUInt();
-		bool hasDeclaration = stream.ReadValue<bool>();
-		if (hasDeclaration)
-		{
-			auto type = static_cast<NodeType>(stream.ReadUInt());
-			auto pt = CreateInstance(type);
-			declaration = pt;
-			declaration->Read(stream, container);
-			node = pt;
-		}
-	}
-
-	static void WriteNode(Stream& stream, const SymbolTableNode& node, const size_t& index)
-	{
-		stream.WriteUInt((uint32_t)index);
-		stream.WriteString(node.GetName());
-		stream.WriteUInt((uint32_t)node.Children.size());
-		for (const auto& [childSpan, childIdx] : node.Children)
-		{
-			stream.WriteUInt((uint32_t)childIdx);
-		}
-		stream.WriteUInt((uint32_t)node.Depth);
-		stream.WriteUInt((uint32_t)node.ParentIndex);
-
-		if (node.Metadata)
-		{
-			stream.WriteValue<bool>(1);
-			node.Metadata->Write(stream);
-		}
-		else
-		{
-			stream.WriteValue<bool>(0);
-		}
-	}
-
-	void SymbolTable::Write(Stream& stream) const
-	{
-		std::stack<size_t> walkStack;
-		walkStack.push(0);
-
-		size_t written = 0;
-		size_t start = stream.Position();
-		stream.WriteUInt(0);
-		while (!walkStack.empty())
-		{
-			size_t idx = walkStack.top();
-			walkStack.pop();
-
-			auto& node = nodes[idx];
-			WriteNode(stream, node, idx);
-			written++;
-
-			for (const auto& [childSpan, childIdx] : node.Children)
-			{
-				walkStack.push(childIdx);
-			}
-		}
-		size_t end = stream.Position();
-		stream.Position(start);
-		stream.WriteUInt((uint32_t)written);
-		stream.Position(end);
-	}
-
-	struct DiskSymbolTableNode
-	{
-		SymbolTableNode Node;
-		std::vector<size_t> Children;
-	};
-
-	static void ReadNode(Stream& stream, DiskSymbolTableNode& diskNode, std::vector<SymbolDef*>& nodes, StringPool& container, size_t& index)
-	{
-		auto& node = diskNode.Node;
-		index = stream.ReadUInt();
-		node.Name = std::make_unique<std::string>(stream.ReadString());
-		size_t children = stream.ReadUInt();
-		for (size_t i = 0; i < children; i++)
-		{
-			diskNode.Children.push_back(stream.ReadUInt());
-		}
-		node.Depth = stream.ReadUInt();
-		node.ParentIndex = stream.ReadUInt();
-		auto metadata = stream.ReadValue<bool>();
-		if (metadata)
-		{
-			SymbolDef* astNode;
-			node.Metadata = std::make_shared<SymbolMetadata>();
-			node.Metadata->Read(stream, astNode, container);
-			nodes[index] = std::move(astNode);
-		}
-	}
-
-	
-	void SymbolTable::Read(Stream& stream, Assembly* parentAssembly)
-	{
-		size_t nodeCount = stream.ReadUInt();
-
-		std::vector<std::vector<size_t>> tempNodes;
-		tempNodes.resize(nodeCount);
-		nodes.resize(nodeCount);
-		compilation->Clear();
-
-		std::vector<SymbolDef*> externalAstNodes;
-		externalAstNodes.resize(nodeCount);
-
-		for (size_t i = 0; i < nodeCount; i++)
-		{
-			size_t index = 0;
-			DiskSymbolTableNode diskNode;
-			ReadNode(stream, diskNode, externalAstNodes, stringPool, index);
-			nodes[index] = std::move(diskNode.Node);
-			nodes[index].handle = std::make_shared<size_t>(index);
-			tempNodes[index] = std::move(diskNode.Children);
-		}
-
-		for (size_t i = 0; i < nodeCount; i++)
-		{
-			auto& node = nodes[i];
-			auto& diskNode = tempNodes[i];
-
-			for (auto idx : diskNode)
-			{
-				node.Children[nodes[idx].GetName()] = idx;
-			}
-		}
-
-		std::stack<size_t> walkStack;
-		walkStack.push(0);
-
-		while (!walkStack.empty())
-		{
-			size_t idx = walkStack.top();
-			walkStack.pop();
-
-			auto& node = nodes[idx];
-			if (node.Metadata && node.Metadata->symbolType == SymbolType_Scope) continue;
-			if (node.Metadata && node.Metadata->declaration)
-			{
-				auto decl = node.Metadata->declaration;
-
-				if (auto ns = dyn_cast<Namespace>(decl))
-				{
-					auto actual = externalAstNodes[idx];
-					compilation->AddNamespace(dyn_cast<Namespace>(actual));
-				}
-
-				decl->Build(*this, idx, compilation, externalAstNodes);
-				decl->SetAssembly(parentAssembly, MakeHandle(idx));
-			}
-
-			for (const auto& [childSpan, childIdx] : node.Children)
-			{
-				walkStack.push(childIdx);
-			}
-		}
-	}*/
 }
\ No newline at end of file
@@ -3,12 +3,14 @@
 
 #include "pch/ast.hpp"
 #include "symbol_handle.hpp"
+#include "symbol_path_index.hpp"
 
 #include "io/stream.hpp"
 #include "utils/string_pool.hpp"
 #include "utils/span.hpp"
 #include "utils/dense_map.hpp"
 #include "utils/memory.hpp"
+#include <atomic>
 
 namespace HXSL
 {
@@ -23,16 +25,13 @@ namespace HXSL
 		{
 		}
 
-		void Write(Stream& stream) const;
-
-		void Read(Stream& stream, SymbolDef*& node, StringPool& container);
-
 		SymbolType GetSymbolType() const;
 
 		AccessModifier GetAccessModifiers() const;
 	};
 
 	class SymbolTable;
+	class SymbolIndexLoader;
 	class SymbolTableNode
 	{
 		friend class SymbolTable;
@@ -41,6 +40,15 @@ namespace HXSL
 		ObjPtr<SymbolMetadata> metadata; // TODO: Could get concretized since the ptr is never stored actually anywhere and we don't do merging anymore.
 		SymbolTableNode* parent;
 		SymbolTable* table;
+		uint64_t pathHash = 0; // see SymbolPathIndex, the root has a hash of zero.
+		uint64_t version = 0; // see MarkModified.
+
+		// Stamps are unique across all nodes, a node allocated at the address of a removed one never repeats its stamp.
+		static uint64_t NextVersion() noexcept
+		{
+			static std::atomic<uint64_t> counter = 0;
+			return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+		}
 
 	public:
 		SymbolTableNode()
@@ -77,11 +85,32 @@ namespace HXSL
 			return parent;
 		}
 
+		const SymbolTableNode* GetParent() const
+		{
+			return parent;
+		}
+
 		const StringSpan& GetName() const
 		{
 			return name;
 		}
 
+		uint64_t GetPathHash() const noexcept
+		{
+			return pathHash;
+		}
+
+		// Changes whenever a child is added, removed or renamed or the metadata of a child is set, caches built from the children compare it.
+		uint64_t GetVersion() const noexcept
+		{
+			return version;
+		}
+
+		void MarkModified() noexcept
+		{
+			version = NextVersion();
+		}
+
 		SymbolTableNode* GetChild(const StringSpan& path) const
 		{
 			auto it = children.find(path);
@@ -231,16 +260,22 @@ namespace HXSL
 	class SymbolTable
 	{
 	private:
+		friend class SymbolIndexLoader;
 		std::shared_mutex nodeMutex;
 		SymbolTableNodeAllocator allocator;
 		SymbolTableNode* root;
 		StringPool2 stringPool;
+		SymbolPathIndex pathIndex;
+		uptr<SymbolIndexLoader> indexLoader; // only set for tables backed by a symbol index, see SymbolIndexLoader.
 
 		SymbolTableNode* AddNode(const StringSpan& name, ObjPtr<SymbolMetadata>&& metadata, SymbolTableNode* parent)
 		{
 			std::unique_lock<std::shared_mutex> writeLock(nodeMutex);
 			auto* node = allocator.Alloc(stringPool.add(name), std::move(metadata), parent, this);
+			node->pathHash = SymbolPathIndex::HashPart(parent->pathHash, node->GetName());
 			parent->GetChildren()[node->GetName()] = node;
+			parent->MarkModified();
+			pathIndex.Add(node->pathHash, node);
 			return node;
 		}
 
@@ -248,21 +283,23 @@ namespace HXSL
 		{
 			auto* parent = node->GetParent();
 			parent->GetChildren().erase(node->GetName());
+			parent->MarkModified();
+			pathIndex.Remove(node->pathHash, node);
 			allocator.Free(node);
 		}
 
 		void RemoveNode(SymbolTableNode* node);
 
+		void ReindexNode(SymbolTableNode* node);
+
 	public:
-		SymbolTable() : allocator(this)
-		{
-			root = allocator.Alloc(StringSpan(), ObjPtr<SymbolMetadata>(), nullptr, this);
-		}
+		SymbolTable();
 
-		~SymbolTable()
+		~SymbolTable();
+
+		SymbolTableNode* GetRoot() const noexcept
 		{
-			RemoveNode(root);
-			root = nullptr;
+			return root;
 		}
 
 		StringPool2& GetStringPool()
@@ -295,6 +332,8 @@ namespace HXSL
 			node->name = str;
 
 			parent->children[str] = node;
+			parent->MarkModified();
+			ReindexNode(node);
 
 			return true;
 		}
@@ -320,23 +359,26 @@ namespace HXSL
 
 		SymbolHandle Insert(StringSpan span, const ObjPtr<SymbolMetadata>& metadata, SymbolTableNode* start = nullptr);
 
-		SymbolHandle FindNodeIndexPart(StringSpan path, SymbolTableNode* startingNode = nullptr) const
-		{
-			if (startingNode == nullptr)
-			{
-				startingNode = root;
-			}
-			auto child = startingNode->GetChild(path);
-			return MakeHandle(child);
-		}
+		// Detaches the node from its parent and frees it together with its children, handles into the subtree dangle afterwards.
+		void Remove(const SymbolHandle& handle);
+
+		SymbolHandle FindNodeIndexPart(StringSpan path, SymbolTableNode* startingNode = nullptr) const;
 
 		SymbolHandle FindNodeIndexFullPath(StringSpan span, SymbolTableNode* startingNode = nullptr) const;
 
 		void Strip();
 
-		void Write(Stream& stream) const;
+		// Freezes the path index into a read only probe table, added nodes stay findable and only removals thaw it again.
+		void Freeze() { pathIndex.Freeze(); }
+
+		void Thaw() noexcept { pathIndex.Thaw(); }
+
+		bool IsFrozen() const noexcept { return pathIndex.IsFrozen(); }
+
+		// Backs the table by a symbol index, lookups that miss materialize the missing nodes from the index on demand.
+		void AttachIndex(uptr<SymbolIndexLoader>&& loader);
 
-		void Read(Stream& stream, Assembly* parentAssembly);
+		SymbolIndexLoader* GetIndexLoader() const noexcept { return indexLoader.get(); }
 	};
 }
 
@@ -5,6 +5,12 @@
 
 namespace HXSL
 {
+	static bool IsFunctionBody(const ASTNode* node)
+	{
+		auto function = dyn_cast<FunctionOverload>(node->GetParent());
+		return function && function->GetBody() == node;
+	}
+
 	TraversalBehavior TypeChecker::Visit(ASTNode*& node, size_t depth, bool deferred, EmptyDeferralContext& context)
 	{
 		auto type = node->GetType();
@@ -20,6 +26,11 @@ namespace HXSL
 		}
 		else if (IsStatementType(type))
 		{
+			if (bodyTasks && IsFunctionBody(node))
+			{
+				bodyTasks->push_back({ cast<BlockStatement>(node), resolver.CaptureScope(), analyzer.GetLogger()->GetDeferredEventCount() });
+				return TraversalBehavior_Skip;
+			}
 			TypeCheckStatement(node);
 		}
 		else if (type == NodeType_OperatorOverload)
@@ -150,10 +161,6 @@ namespace HXSL
 			return false;
 		}
 
-		auto& handleB = b->GetSymbolHandle();
-
-		std::string signature;
-		BinaryExpression::PrepareOverloadSignature(signature, op);
 		for (auto& _operator : operators)
 		{
 			if (_operator->GetOperator() != Operator_Cast || (_operator->GetOperatorFlags() & OperatorFlags_Implicit) == 0)
@@ -161,14 +168,12 @@ namespace HXSL
 				continue;
 			}
 
-			auto decl = _operator->GetReturnType();
-			BinaryExpression::BuildOverloadSignature(signature, decl, b);
-
-			auto match = handleB.FindPart(signature);
-			if (match.valid())
+			const SymbolDef* types[] = { _operator->GetReturnType(), b };
+			auto match = FindOverload(b, OverloadKey(op, nullptr, Span<const SymbolDef*>(types, 2)));
+			if (match)
 			{
 				castMatchOut = _operator;
-				opRef->SetTable(match);
+				opRef->SetTable(match->GetSymbolHandle());
 				return true;
 			}
 		}
@@ -176,6 +181,29 @@ namespace HXSL
 		return false;
 	}
 
+	FunctionOverload* TypeChecker::FindOverload(const SymbolDef* owner, const OverloadKey& key) const
+	{
+		return analyzer.GetOverloadIndex().Find(owner->GetSymbolHandle(), key);
+	}
+
+	bool TypeChecker::BindOverload(SymbolRef* ref, const FunctionOverload* overload, bool silent) const
+	{
+		if (overload == nullptr)
+		{
+			return false;
+		}
+
+		auto& handle = overload->GetSymbolHandle();
+		if (!resolver.SymbolTypeSanityCheck(handle.GetMetadata(), ref, silent))
+		{
+			ref->SetNotFound(true);
+			return false;
+		}
+
+		ref->SetTable(handle);
+		return true;
+	}
+
 	static void InjectCast(Expression*& target, OperatorOverload* cast, SymbolDef* targetType)
 	{
 		auto castExpr = CastExpression::Create(TextSpan(), cast->MakeSymbolRef(), targetType->MakeSymbolRef(), nullptr);
@@ -205,27 +233,20 @@ namespace HXSL
 			TryLiteralReinterpret(left, rightType);
 		}
 
-		auto signature = binary->BuildOverloadSignature();
+		const SymbolDef* types[] = { left->GetInferredType(), right->GetInferredType() };
+		OverloadKey key = OverloadKey(op, nullptr, Span<const SymbolDef*>(types, 2));
 
 		auto& ref = binary->GetOperatorSymbolRef();
 
-		bool found = false;
-
-		{
-			auto table = leftType->GetTable();
-			auto& index = leftType->GetSymbolHandle();
-			found = resolver.ResolveSymbol(ref, signature, table, index, true);
-		}
+		bool found = BindOverload(ref, FindOverload(leftType, key), true);
 
 		if (!leftType->IsEquivalentTo(rightType))
 		{
-			auto table = rightType->GetTable();
-			auto& index = rightType->GetSymbolHandle();
-			if (resolver.ResolveSymbol(ref, signature, table, index, true))
+			if (BindOverload(ref, FindOverload(rightType, key), true))
 			{
 				if (found)
 				{
-					analyzer.Log(AMBIGUOUS_OP_OVERLOAD, binary->GetSpan(), signature);
+					analyzer.Log(AMBIGUOUS_OP_OVERLOAD, binary->GetSpan(), binary->BuildOverloadSignature());
 					return false;
 				}
 				found = true;
@@ -276,27 +297,21 @@ namespace HXSL
 		}
 		auto leftType = left->GetInferredType();
 		auto rightType = right->GetInferredType();
-		auto signature = binary->BuildOverloadSignature();
+
+		const SymbolDef* types[] = { leftType, rightType };
+		OverloadKey key = OverloadKey(op, nullptr, Span<const SymbolDef*>(types, 2));
 
 		auto& ref = binary->GetOperatorSymbolRef();
 
-		bool found = false;
-
-		{
-			auto table = leftType->GetTable();
-			auto& index = leftType->GetSymbolHandle();
-			found = resolver.ResolveSymbol(ref, signature, table, index, true);
-		}
+		bool found = BindOverload(ref, FindOverload(leftType, key), true);
 
 		if (!leftType->IsEquivalentTo(rightType))
 		{
-			auto table = rightType->GetTable();
-			auto& index = rightType->GetSymbolHandle();
-			if (resolver.ResolveSymbol(ref, signature, table, index, true))
+			if (BindOverload(ref, FindOverload(rightType, key), true))
 			{
 				if (found)
 				{
-					analyzer.Log(AMBIGUOUS_OP_OVERLOAD, binary->GetSpan(), signature);
+					analyzer.Log(AMBIGUOUS_OP_OVERLOAD, binary->GetSpan(), binary->BuildOverloadSignature());
 					return false;
 				}
 				found = true;
@@ -340,15 +355,12 @@ namespace HXSL
 			return false;
 		}
 		auto leftType = operand->GetInferredType();
-		auto signature = unary->BuildOverloadSignature();
 
-		auto& ref = unary->GetOperatorSymbolRef();
+		const SymbolDef* types[] = { leftType };
 
-		bool found = false;
+		auto& ref = unary->GetOperatorSymbolRef();
 
-		auto table = leftType->GetTable();
-		auto& index = leftType->GetSymbolHandle();
-		found = resolver.ResolveSymbol(ref, signature, table, index, true);
+		bool found = BindOverload(ref, FindOverload(leftType, OverloadKey(op, nullptr, Span<const SymbolDef*>(types, 1))), true);
 
 		auto operatorDecl = dyn_cast<OperatorOverload>(ref->GetDeclaration());
 		if (!operatorDecl || !found)
@@ -369,15 +381,13 @@ namespace HXSL
 	bool TypeChecker::CastOperatorCheck(CastExpression* cast, const SymbolDef* type, const Expression* operand, SymbolDef*& result, bool explicitCast) const
 	{
 		auto operandType = operand->GetInferredType();
-		auto signature = cast->BuildOverloadSignature();
 
-		auto& ref = cast->GetOperatorSymbolRef();
+		const SymbolDef* types[] = { operandType };
+		OverloadKey key = OverloadKey(Operator_Cast, cast->GetTypeSymbol()->GetDeclaration(), Span<const SymbolDef*>(types, 1));
 
-		bool found = false;
+		auto& ref = cast->GetOperatorSymbolRef();
 
-		auto table = operandType->GetTable();
-		auto& index = operandType->GetSymbolHandle();
-		found = resolver.ResolveSymbol(ref, signature, table, index, true);
+		bool found = BindOverload(ref, FindOverload(operandType, key), true);
 
 		auto operatorDecl = dyn_cast<OperatorOverload>(ref->GetDeclaration());
 		if (!operatorDecl || !found)
@@ -393,26 +403,14 @@ namespace HXSL
 
 	bool TypeChecker::CastOperatorCheck(const SymbolDef* target, const SymbolDef* source, SymbolRef*& result) const
 	{
-		auto signature = CastExpression::BuildOverloadSignatureCast(target, source);
-
-		auto ref = SymbolRef::Create({}, ASTContext::GetCurrentContext()->GetIdentifier(signature), SymbolRefType_OperatorOverload, false);
-
-		auto table = source->GetTable();
-		auto& index = source->GetSymbolHandle();
-		auto found = resolver.ResolveSymbol(ref, signature, table, index, true);
-		if (!found)
+		const SymbolDef* types[] = { source };
+		auto operatorDecl = dyn_cast<OperatorOverload>(FindOverload(source, OverloadKey(Operator_Cast, target, Span<const SymbolDef*>(types, 1))));
+		if (!operatorDecl || (operatorDecl->GetOperatorFlags() & OperatorFlags_Implicit) == 0)
 		{
 			return false;
 		}
 
-		auto operatorDecl = static_cast<OperatorOverload*>(ref->GetDeclaration());
-
-		if ((operatorDecl->GetOperatorFlags() & OperatorFlags_Implicit) == 0)
-		{
-			return false;
-		}
-
-		result = std::move(ref);
+		result = operatorDecl->MakeSymbolRef();
 
 		return true;
 	}
@@ -508,6 +506,16 @@ namespace HXSL
 		}
 	}
 
+	Span<const SymbolDef*> TypeChecker::GetArgumentTypes(FunctionCallExpression* funcCallExpr) const
+	{
+		argumentTypes.clear();
+		for (auto& param : funcCallExpr->GetParameters())
+		{
+			argumentTypes.push_back(param->GetExpression()->GetInferredType());
+		}
+		return argumentTypes;
+	}
+
 	bool TypeChecker::ResolveConstructor(FunctionCallExpression* funcCallExpr, SymbolDef*& outDefinition, bool silent) const
 	{
 		outDefinition = nullptr;
@@ -522,22 +530,16 @@ namespace HXSL
 			return false;
 		}
 
-		auto signature = funcCallExpr->BuildConstructorOverloadSignature();
-		auto ctorHandle = handle.FindPart(signature);
-		if (ctorHandle.valid())
+		auto constructor = analyzer.GetOverloadIndex().Find(handle, OverloadKey(OverloadKind_Constructor, GetArgumentTypes(funcCallExpr)));
+		if (BindOverload(ref, constructor, silent))
 		{
-			auto ctorMetadata = ctorHandle.GetMetadata();
-			if (resolver.SymbolTypeSanityCheck(ctorMetadata, ref, silent))
-			{
-				ref->SetTable(ctorHandle);
-				outDefinition = ctorMetadata->declaration;
-				return true;
-			}
+			outDefinition = constructor;
+			return true;
 		}
 
 		if (!silent)
 		{
-			analyzer.Log(CTOR_OVERLOAD_NOT_FOUND, ref->GetSpan(), signature, typeDef->GetName());
+			analyzer.Log(CTOR_OVERLOAD_NOT_FOUND, ref->GetSpan(), funcCallExpr->BuildConstructorOverloadSignature(), typeDef->GetName());
 		}
 		return false;
 	}
@@ -546,78 +548,57 @@ namespace HXSL
 	{
 		SymbolRef* ref = funcCallExpr->GetSymbolRef();
 
-		auto signature = funcCallExpr->BuildOverloadSignature();
-
 		bool success = false;
-		if (auto expr = funcCallExpr->FindAncestor<MemberAccessExpression>(NodeType_MemberAccessExpression, 1))
+		if (auto funcNode = FindFunctionNode(funcCallExpr))
 		{
-			auto memberRef = expr->GetSymbolRef()->GetBaseDeclaration();
-			if (memberRef)
+			// calling a type by name resolves to one of its constructors.
+			auto& metadata = funcNode->GetMetadata();
+			auto kind = metadata && metadata->declaration && IsDataType(metadata->declaration->GetType()) ? OverloadKind_Constructor : OverloadKind_Function;
+
+			auto& set = analyzer.GetOverloadIndex().GetSet(funcNode);
+			auto overload = set.Find(OverloadKey(kind, GetArgumentTypes(funcCallExpr)));
+			success = BindOverload(ref, overload, true);
+			if (success)
 			{
-				success = resolver.ResolveSymbol(ref, signature, memberRef->GetTable(), memberRef->GetSymbolHandle(), true);
+				outDefinition = overload;
 			}
-		}
-		else
-		{
-			success = resolver.ResolveSymbol(ref, signature, true);
-		}
 
-		// If exact match not found, try implicit cast matching
-		if (!success)
-		{
-			success = TryResolveFunctionWithImplicitCasts(funcCallExpr, outDefinition, silent);
+			// If exact match not found, try implicit cast matching
+			if (!success)
+			{
+				success = TryResolveFunctionWithImplicitCasts(funcCallExpr, set.GetCandidates(), outDefinition, silent);
+			}
 		}
 
 		if (!success && !silent)
 		{
-			analyzer.Log(FUNC_OVERLOAD_NOT_FOUND, funcCallExpr->GetSpan(), signature);
-		}
-
-		if (success && !outDefinition)
-		{
-			outDefinition = ref->GetDeclaration();
+			analyzer.Log(FUNC_OVERLOAD_NOT_FOUND, funcCallExpr->GetSpan(), funcCallExpr->BuildOverloadSignature());
 		}
 
 		return success;
 	}
 
-	void TypeChecker::CollectFunctionOverloads(FunctionCallExpression* expression, const SymbolTableNode* node, std::vector<FunctionOverload*>& overloads) const
+	SymbolTableNode* TypeChecker::FindFunctionNode(FunctionCallExpression* funcCallExpr) const
 	{
 		// namespace Foo { void Baa(float a) void Baa(int a) }
 		// Foo |-> Baa |-> (float)
 		//             \-> (int)
 
-		auto symbolRef = expression->GetSymbolRef();
+		auto symbolRef = funcCallExpr->GetSymbolRef();
 		auto functionName = symbolRef->GetName();
-		SymbolTableNode* funcNode = nullptr;
-		if (node == nullptr)
-		{
-			auto& span = symbolRef->GetSpan();
-			SymbolHandle rootHandle;
-			resolver.ResolveSymbol(span, functionName, false, rootHandle, true);
-			funcNode = rootHandle;
-		}
-		else
-		{
-			funcNode = node->GetChild(functionName);
-		}
-
-		if (!funcNode)
-		{
-			return;
-		}
-
-		for (auto& [childName, childNode] : funcNode->GetChildren())
+		if (auto expr = funcCallExpr->FindAncestor<MemberAccessExpression>(NodeType_MemberAccessExpression, 1))
 		{
-			if (childNode && childNode->GetMetadata())
+			auto memberRef = expr->GetSymbolRef()->GetBaseDeclaration();
+			if (memberRef == nullptr || memberRef->GetSymbolHandle().invalid())
 			{
-				auto decl = childNode->GetMetadata()->declaration;
-				if (auto funcOverload = dyn_cast<FunctionOverload>(decl))
-				{
-					overloads.push_back(funcOverload);
-				}
+				return nullptr;
 			}
+			return memberRef->GetSymbolHandle().GetNode()->GetChild(functionName);
 		}
+
+		SymbolHandle handle;
+		resolver.ResolveSymbol(symbolRef->GetSpan(), functionName, false, handle, true);
+		return handle;
 	}
 
 	bool TypeChecker::TryMatchOverloadWithImplicitCasts(FunctionCallExpression* funcCallExpr, FunctionOverload* overload, std::vector<SymbolRef*>& outCasts) const
@@ -672,28 +653,10 @@ namespace HXSL
 		return true;
 	}
 
-	bool TypeChecker::TryResolveFunctionWithImplicitCasts(FunctionCallExpression* funcCallExpr, SymbolDef*& outDefinition, bool silent) const
+	bool TypeChecker::TryResolveFunctionWithImplicitCasts(FunctionCallExpression* funcCallExpr, const std::vector<FunctionOverload*>& candidateOverloads, SymbolDef*& outDefinition, bool silent) const
 	{
 		SymbolRef* ref = funcCallExpr->GetSymbolRef();
 
-		const SymbolTableNode* searchHandle;
-
-		if (auto expr = funcCallExpr->FindAncestor<MemberAccessExpression>(NodeType_MemberAccessExpression, 1))
-		{
-			auto memberRef = expr->GetSymbolRef()->GetBaseDeclaration();
-			if (memberRef)
-			{
-				searchHandle = memberRef->GetSymbolHandle();
-			}
-		}
-		else
-		{
-			searchHandle = nullptr;
-		}
-
-		std::vector<FunctionOverload*> candidateOverloads;
-		CollectFunctionOverloads(funcCallExpr, searchHandle, candidateOverloads);
-
 		if (candidateOverloads.empty())
 		{
 			return false;
@@ -7,11 +7,21 @@
 
 namespace HXSL
 {
-	class TypeChecker : public ASTVisitor<EmptyDeferralContext>
+	// Body of a function, operator or constructor split off the declaration walk, checked on its own afterwards.
+	struct FunctionBodyTask
+	{
+		BlockStatement* body;
+		ResolverDeferralContext scope;
+		size_t logPosition; // events the declaration walk had logged when the body was reached.
+	};
+
+	class TypeChecker : public ASTVisitor<TypeChecker>
 	{
 	private:
 		SemanticAnalyzer& analyzer;
 		SymbolResolver& resolver;
+		mutable std::vector<const SymbolDef*> argumentTypes;
+		std::vector<FunctionBodyTask>* bodyTasks = nullptr;
 
 	public:
 		TypeChecker(SemanticAnalyzer& analyzer, SymbolResolver& resolver) : analyzer(analyzer), resolver(resolver)
@@ -20,9 +30,12 @@ namespace HXSL
 			StatementCheckerRegistry::EnsureCreated();
 		}
 
-		TraversalBehavior Visit(ASTNode*& node, size_t depth, bool deferred, EmptyDeferralContext& context) override;
+		// while set, function bodies are skipped and appended to tasks in source order instead of being checked.
+		void SetBodyTasks(std::vector<FunctionBodyTask>* tasks) noexcept { bodyTasks = tasks; }
+
+		TraversalBehavior Visit(ASTNode*& node, size_t depth, bool deferred, EmptyDeferralContext& context);
 
-		void VisitClose(ASTNode* node, size_t depth) override;
+		void VisitClose(ASTNode* node, size_t depth);
 
 		SymbolDef* GetBoolType() const;
 
@@ -59,9 +72,15 @@ namespace HXSL
 		bool ResolveFunction(FunctionCallExpression* funcCallExpr, SymbolDef*& outDefinition, bool silent = false) const;
 
 	private:
-		bool TryResolveFunctionWithImplicitCasts(FunctionCallExpression* funcCallExpr, SymbolDef*& outDefinition, bool silent) const;
+		FunctionOverload* FindOverload(const SymbolDef* owner, const OverloadKey& key) const;
+
+		bool BindOverload(SymbolRef* ref, const FunctionOverload* overload, bool silent) const;
+
+		Span<const SymbolDef*> GetArgumentTypes(FunctionCallExpression* funcCallExpr) const;
+
+		SymbolTableNode* FindFunctionNode(FunctionCallExpression* funcCallExpr) const;
 
-		void CollectFunctionOverloads(FunctionCallExpression* expression, const SymbolTableNode* handle, std::vector<FunctionOverload*>& overloads) const;
+		bool TryResolveFunctionWithImplicitCasts(FunctionCallExpression* funcCallExpr, const std::vector<FunctionOverload*>& candidateOverloads, SymbolDef*& outDefinition, bool silent) const;
 
 		bool TryMatchOverloadWithImplicitCasts(FunctionCallExpression* funcCallExpr, FunctionOverload* overload, std::vector<SymbolRef*>& outCasts) const;
 	};
@@ -0,0 +1,122 @@
+#include "common.hpp"
+#include "parsers/incremental_parser.hpp"
+
+class ASTVisitorTest : public ASTContextTest
+{
+protected:
+	uptr<IncrementalParser> parser;
+
+	void TearDown() override
+	{
+		parser.reset();
+		ASTContextTest::TearDown();
+	}
+
+	CompilationUnit* Parse(const std::string& text)
+	{
+		auto* source = context->GetSourceManager().AddSource(nullptr, false);
+		source->GetInputStream()->Write(text.data(), text.size());
+		parser = make_uptr<IncrementalParser>(&logger);
+		parser->Parse({ source });
+		return parser->GetCompilationUnit();
+	}
+};
+
+static const char* VisitorSource =
+"namespace Lighting\n"
+"{\n"
+"\tfloat Diffuse(float3 normal, float3 light)\n"
+"\t{\n"
+"\t\treturn saturate(dot(normal, light));\n"
+"\t}\n"
+"\n"
+"\tstruct Material\n"
+"\t{\n"
+"\t\tfloat roughness;\n"
+"\t};\n"
+"}\n";
+
+class RecordingVisitor : public ASTVisitor<RecordingVisitor>
+{
+public:
+	std::vector<std::pair<NodeType, size_t>> opened;
+	std::vector<NodeType> closed;
+	NodeType skipType = NodeType_Unknown;
+
+	TraversalBehavior Visit(ASTNode*& node, size_t depth, bool deferred, EmptyDeferralContext& context)
+	{
+		opened.push_back({ node->GetType(), depth });
+		return node->GetType() == skipType ? TraversalBehavior_Skip : TraversalBehavior_Keep;
+	}
+
+	void VisitClose(ASTNode* node, size_t depth)
+	{
+		closed.push_back(node->GetType());
+	}
+};
+
+TEST_F(ASTVisitorTest, VisitsPreOrderAndClosesPostOrder)
+{
+	auto* compilation = Parse(VisitorSource);
+
+	RecordingVisitor visitor;
+	visitor.Traverse(compilation);
+
+	ASSERT_GE(visitor.opened.size(), 4u);
+	EXPECT_EQ(visitor.opened[0], std::make_pair(NodeType_CompilationUnit, size_t(0)));
+	EXPECT_EQ(visitor.opened[1], std::make_pair(NodeType_Namespace, size_t(1)));
+	EXPECT_EQ(visitor.opened.size(), visitor.closed.size());
+	EXPECT_EQ(visitor.closed.back(), NodeType_CompilationUnit);
+
+	auto function = std::find_if(visitor.opened.begin(), visitor.opened.end(), [](auto& e) { return e.first == NodeType_FunctionOverload; });
+	auto strct = std::find_if(visitor.opened.begin(), visitor.opened.end(), [](auto& e) { return e.first == NodeType_Struct; });
+	ASSERT_NE(function, visitor.opened.end());
+	ASSERT_NE(strct, visitor.opened.end());
+	EXPECT_LT(function, strct);
+
+	// the visitor keeps its buffers, a second walk has to produce the same sequence.
+	auto first = visitor.opened;
+	visitor.opened.clear();
+	visitor.closed.clear();
+	visitor.Traverse(compilation);
+	EXPECT_EQ(visitor.opened, first);
+}
+
+TEST_F(ASTVisitorTest, SkipDropsSubtreeAndClose)
+{
+	auto* compilation = Parse(VisitorSource);
+
+	RecordingVisitor full;
+	full.Traverse(compilation);
+
+	RecordingVisitor skipping;
+	skipping.skipType = NodeType_FunctionOverload;
+	skipping.Traverse(compilation);
+
+	EXPECT_LT(skipping.opened.size(), full.opened.size());
+	EXPECT_EQ(std::count(skipping.closed.begin(), skipping.closed.end(), NodeType_FunctionOverload), 0);
+	EXPECT_EQ(std::count_if(skipping.opened.begin(), skipping.opened.end(), [](auto& e) { return e.first == NodeType_ReturnStatement; }), 0);
+	EXPECT_EQ(skipping.opened.size(), skipping.closed.size() + 1);
+}
+
+TEST_F(ASTVisitorTest, FusedPassesMatchSeparateWalks)
+{
+	auto* compilation = Parse(VisitorSource);
+
+	RecordingVisitor separateFull;
+	separateFull.Traverse(compilation);
+	RecordingVisitor separateSkipping;
+	separateSkipping.skipType = NodeType_FunctionOverload;
+	separateSkipping.Traverse(compilation);
+
+	RecordingVisitor fusedFull;
+	RecordingVisitor fusedSkipping;
+	fusedSkipping.skipType = NodeType_FunctionOverload;
+	FusedASTVisitor<RecordingVisitor, RecordingVisitor> fused(fusedFull, fusedSkipping);
+	fused.Traverse(compilation);
+
+	EXPECT_EQ(fusedFull.opened, separateFull.opened);
+	EXPECT_EQ(fusedFull.closed, separateFull.closed);
+	EXPECT_EQ(fusedSkipping.opened, separateSkipping.opened);
+	EXPECT_EQ(fusedSkipping.closed, separateSkipping.closed);
+}
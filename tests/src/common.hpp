@@ -5,15 +5,18 @@
 #include "parsers/parser.hpp"
 #include "parsers/hybrid_expr_parser.hpp"
 #include "pch/ast_analyzers.hpp"
+#include "hxls_compiler.hpp"
 #include "expect_file.hpp"
 
 using namespace HXSL;
 
-class ASTValidatorVisitor : ASTVisitor<EmptyDeferralContext>
+class ASTValidatorVisitor : public ASTVisitor<ASTValidatorVisitor>
 {
+	friend ASTVisitor;
+
 	std::ostringstream debugOutput;
 
-	TraversalBehavior Visit(ASTNode*& node, size_t depth, bool deferred, EmptyDeferralContext& context) override
+	TraversalBehavior Visit(ASTNode*& node, size_t depth, bool deferred, EmptyDeferralContext& context)
 	{
 		std::string indentation(depth * 2, ' ');
 		auto& span = node->GetSpan();
@@ -125,6 +128,26 @@ public:
 	}
 };
 
+// Installs the process wide callbacks and gives every test its own current ASTContext.
+class ASTContextTest : public ::testing::Test
+{
+protected:
+	uptr<ASTContext> context;
+	ILogger logger;
+
+	void SetUp() override
+	{
+		Compiler::InitializeSubSystems();
+		context = make_uptr<ASTContext>();
+		ASTContext::SetCurrentContext(context.get());
+	}
+
+	void TearDown() override
+	{
+		ASTContext::SetCurrentContext(nullptr);
+	}
+};
+
 using CompilationPtr = std::unique_ptr<CompilationUnit>;
 using ASTNodePtr = std::unique_ptr<ASTNode>;
 
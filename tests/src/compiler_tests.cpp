@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include "hxls_compiler.hpp"
+#include "il/assembly_collection.hpp"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace HXSL;
+
+static const char* CompilerSource =
+"namespace Math\n"
+"{\n"
+"\tfloat pow2(float x)\n"
+"\t{\n"
+"\t\treturn x * x;\n"
+"\t}\n"
+"\n"
+"\tfloat3 scale(float3 v, float s)\n"
+"\t{\n"
+"\t\tfloat3 result = v * pow2(s);\n"
+"\t\tfor (int i = 0; i < 3; i++)\n"
+"\t\t{\n"
+"\t\t\tresult.x += result.y;\n"
+"\t\t}\n"
+"\t\treturn result.xyz;\n"
+"\t}\n"
+"}\n";
+
+static const char* ReferencingSource =
+"namespace Game\n"
+"{\n"
+"\tusing Math;\n"
+"\n"
+"\tfloat3 grow(float3 v, float s)\n"
+"\t{\n"
+"\t\treturn scale(v, pow2(s));\n"
+"\t}\n"
+"}\n";
+
+static std::filesystem::path GetTestDirectory()
+{
+	auto directory = std::filesystem::temp_directory_path() / "hxsl_compiler_tests";
+	std::filesystem::create_directories(directory);
+	return directory;
+}
+
+static std::string WriteSource(const std::string& name, const char* text)
+{
+	auto path = (GetTestDirectory() / name).string();
+	std::ofstream file(path, std::ios::binary);
+	file << text;
+	return path;
+}
+
+static void ExpectSameOutputs(const std::vector<std::string>& outputs)
+{
+	ASSERT_TRUE(std::filesystem::exists(outputs[0])) << outputs[0];
+	auto expectedSize = std::filesystem::file_size(outputs[0]);
+	EXPECT_GT(expectedSize, 0u);
+	for (auto& output : outputs)
+	{
+		ASSERT_TRUE(std::filesystem::exists(output)) << output;
+		EXPECT_EQ(std::filesystem::file_size(output), expectedSize) << output;
+	}
+}
+
+// Run with ENABLE_TSAN to check the guarantee documented on Compiler, every thread compiles through the C API while the others
+// do, with profiling on so the trace of one compile is written while the others record into it.
+TEST(CompilerTest, CompilesConcurrently)
+{
+	auto directory = GetTestDirectory();
+	auto input = WriteSource("math.txt", CompilerSource);
+	const char* inputs[] = { input.c_str() };
+
+	constexpr size_t ThreadCount = 8;
+	constexpr size_t Iterations = 4;
+
+	HXSLCompiler* shared = HXSL_CreateCompiler();
+	HXSL_CompilerSetThreadCount(shared, 2);
+	auto sharedTrace = (directory / "math_shared.json").string();
+	std::filesystem::remove(sharedTrace);
+	HXSL_CompilerSetProfileOutput(shared, sharedTrace.c_str());
+
+	std::vector<std::string> outputs;
+	for (size_t i = 0; i < ThreadCount * Iterations; i++)
+	{
+		outputs.push_back((directory / ("math" + std::to_string(i) + ".hlib")).string());
+		std::filesystem::remove(outputs.back());
+	}
+
+	std::vector<std::string> traces = { sharedTrace };
+	for (size_t t = 0; t < ThreadCount; t++)
+	{
+		traces.push_back((directory / ("math" + std::to_string(t) + ".json")).string());
+		std::filesystem::remove(traces.back());
+	}
+
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < ThreadCount; t++)
+	{
+		threads.emplace_back([&, t]()
+			{
+				// half of the threads share one compiler, the others bring their own.
+				HXSLCompiler* own = HXSL_CreateCompiler();
+				HXSL_CompilerSetThreadCount(own, 2);
+				HXSL_CompilerSetProfileOutput(own, traces[t + 1].c_str());
+				HXSLCompiler* compiler = t % 2 == 0 ? shared : own;
+				for (size_t i = 0; i < Iterations; i++)
+				{
+					HXSL_CompilerCompile(compiler, inputs, 1, outputs[t * Iterations + i].c_str());
+				}
+				HXSL_CompilerRelease(own);
+			});
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+	HXSL_CompilerRelease(shared);
+
+	ExpectSameOutputs(outputs);
+
+	// only one compile at a time owns the profiling session, the ones started meanwhile end up in its trace.
+	size_t written = 0;
+	for (auto& trace : traces)
+	{
+		if (std::filesystem::exists(trace))
+		{
+			EXPECT_GT(std::filesystem::file_size(trace), 0u) << trace;
+			written++;
+		}
+	}
+	EXPECT_GT(written, 0u);
+}
+
+// every compile resolves against the same loaded assembly, each one has to work on its own view of it.
+TEST(CompilerTest, CompilesConcurrentlyAgainstReference)
+{
+	auto directory = GetTestDirectory();
+	auto library = (directory / "math_ref.hlib").string();
+	std::filesystem::remove(library);
+	Compiler().Compile({ WriteSource("math_ref.txt", CompilerSource) }, library);
+	ASSERT_TRUE(std::filesystem::exists(library));
+
+	AssemblyCollection references;
+	references.LoadAssemblyFromFile(library);
+	ASSERT_EQ(references.GetAssemblies().size(), 1u);
+	auto input = WriteSource("game.txt", ReferencingSource);
+
+	constexpr size_t ThreadCount = 8;
+	constexpr size_t Iterations = 4;
+
+	std::vector<std::string> outputs;
+	for (size_t i = 0; i < ThreadCount * Iterations; i++)
+	{
+		outputs.push_back((directory / ("game" + std::to_string(i) + ".hlib")).string());
+		std::filesystem::remove(outputs.back());
+	}
+
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < ThreadCount; t++)
+	{
+		threads.emplace_back([&, t]()
+			{
+				Compiler compiler = Compiler();
+				compiler.SetThreadCount(2);
+				for (size_t i = 0; i < Iterations; i++)
+				{
+					compiler.Compile({ input }, outputs[t * Iterations + i], references);
+				}
+			});
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	// an output is only written if the calls into Math resolved.
+	ExpectSameOutputs(outputs);
+
+	// the loaded assembly itself is only read, the symbols were materialized into the views of the compiles.
+	auto* reference = references.GetAssemblies()[0].get();
+	EXPECT_TRUE(reference->IsSealed());
+	EXPECT_TRUE(reference->GetSymbolTable()->GetRoot()->GetChildren().empty());
+}
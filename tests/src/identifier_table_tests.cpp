@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "lexical/identifier_table.hpp"
+
+using namespace HXSL;
+
+static std::vector<std::string> MakeNames(size_t count)
+{
+	std::vector<std::string> names;
+	names.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		names.push_back("identifier_" + std::to_string(i * 7919 % count));
+	}
+	return names;
+}
+
+TEST(IdentifierTableTest, InternsOncePerName)
+{
+	IdentifierTable table;
+	auto names = MakeNames(5000);
+	std::vector<IdentifierInfo*> infos;
+	for (auto& name : names)
+	{
+		infos.push_back(table.Get(name));
+	}
+
+	EXPECT_EQ(table.Size(), names.size());
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		EXPECT_EQ(table.Get(names[i]), infos[i]);
+		EXPECT_EQ(table.Find(names[i]), infos[i]);
+		EXPECT_EQ(infos[i]->name.str(), names[i]);
+	}
+	EXPECT_EQ(table.Find("not_interned"), nullptr);
+}
+
+TEST(IdentifierTableTest, ConcurrentInternStress)
+{
+	constexpr size_t ThreadCount = 8;
+	constexpr size_t NameCount = 20000;
+
+	IdentifierTable table;
+	auto names = MakeNames(NameCount);
+	std::vector<std::vector<IdentifierInfo*>> results(ThreadCount, std::vector<IdentifierInfo*>(NameCount));
+
+	std::atomic<bool> start = false;
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < ThreadCount; t++)
+	{
+		threads.emplace_back([&, t]()
+			{
+				while (!start.load(std::memory_order_acquire)) std::this_thread::yield();
+
+				// Threads start at different offsets and half of them walk backwards, so inserts and lookups of the same name race.
+				for (size_t i = 0; i < NameCount; i++)
+				{
+					size_t index = (i + t * NameCount / ThreadCount) % NameCount;
+					if (t % 2) index = NameCount - 1 - index;
+					results[t][index] = table.Get(names[index]);
+				}
+			});
+	}
+
+	start.store(true, std::memory_order_release);
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	EXPECT_EQ(table.Size(), NameCount);
+	for (size_t i = 0; i < NameCount; i++)
+	{
+		auto info = results[0][i];
+		ASSERT_NE(info, nullptr);
+		EXPECT_EQ(info->name.str(), names[i]);
+		for (size_t t = 1; t < ThreadCount; t++)
+		{
+			EXPECT_EQ(results[t][i], info);
+		}
+	}
+}
@@ -0,0 +1,73 @@
+#ifndef IL_TEST_FIXTURE_HPP
+#define IL_TEST_FIXTURE_HPP
+
+#include <gtest/gtest.h>
+#include "il/il_context.hpp"
+#include "core/layout_builder.hpp"
+
+using namespace HXSL;
+using namespace HXSL::Backend;
+
+// A single int returning function "f" whose control flow graph the tests build block by block.
+class ILTest : public ::testing::Test
+{
+protected:
+	Module module;
+	PrimitiveLayout* intType = nullptr;
+	uptr<ILContext> function;
+
+	void SetUp() override
+	{
+		intType = PrimitiveLayoutBuilder(module).Name("int").Kind(PrimitiveKind_Int).Class(PrimitiveClass_Scalar).Rows(1).Columns(1).Build();
+		auto* layout = FunctionLayoutBuilder(module).Name("f").ReturnType(intType).Peek();
+		function = make_uptr<ILContext>(&module, layout);
+	}
+
+	ILVarId Var()
+	{
+		return function->metadata.RegVar(intType).id;
+	}
+
+	ILVarId Temp()
+	{
+		return function->metadata.RegTempVar(intType).id;
+	}
+
+	template<typename T, typename... Args>
+	T* Add(size_t block, Args&&... args)
+	{
+		auto& allocator = function->allocator;
+		auto* instr = allocator.Alloc<T>(allocator, std::forward<Args>(args)...);
+		function->cfg.GetNode(block)->AddInstr(instr);
+		return instr;
+	}
+
+	void AddJump(size_t block, ILOpCode opcode, size_t target)
+	{
+		Add<JumpInstr>(block, opcode, function->allocator.Alloc<Label>(ILLabel(target)));
+	}
+
+	// a call of a void function, its result stays INVALID_VARIABLE.
+	CallInstr* AddVoidCall(size_t block)
+	{
+		auto* callee = FunctionLayoutBuilder(module).Name("g").Peek();
+		auto* callMetadata = function->metadata.RegFunc(callee);
+		auto* call = Add<CallInstr>(block, function->allocator.Alloc<Function>(callMetadata));
+		callMetadata->callSites.push_back(call);
+		return call;
+	}
+
+	PhiInstr* AddPhi(size_t block, ILVarId result, std::initializer_list<ILVarId> inputs)
+	{
+		auto* phi = Add<PhiInstr>(block, result, inputs.size());
+		size_t slot = 0;
+		for (auto& input : inputs)
+		{
+			phi->GetOperand(slot++) = function->MakeVariable(input);
+		}
+		function->metadata.phiNodes.push_back(phi);
+		return phi;
+	}
+};
+
+#endif
@@ -0,0 +1,73 @@
+#include "common.hpp"
+#include "parsers/incremental_parser.hpp"
+
+class IncrementalParserTest : public ASTContextTest
+{
+protected:
+	SourceFile* source = nullptr;
+	std::string text;
+
+	void Load(IncrementalParser& parser, const std::string& input)
+	{
+		text = input;
+		source = context->GetSourceManager().AddSource(nullptr, false);
+		source->GetInputStream()->Write(text.data(), text.size());
+		parser.Parse({ source });
+	}
+
+	bool Edit(IncrementalParser& parser, const std::string& match, size_t length, const std::string& replacement)
+	{
+		size_t start = text.find(match);
+		text.replace(start, length, replacement);
+		return parser.ApplyEdit({ source->GetID(), start, length, replacement });
+	}
+
+	static FunctionOverload* GetFunction(CompilationUnit* compilation, size_t index)
+	{
+		return compilation->GetNamespaces()[0]->GetFunctions()[index];
+	}
+};
+
+static const char* IncrementalSource =
+"namespace Lighting\n"
+"{\n"
+"\tfloat Diffuse(float3 normal, float3 light)\n"
+"\t{\n"
+"\t\treturn saturate(dot(normal, light));\n"
+"\t}\n"
+"\n"
+"\tfloat Specular(float power)\n"
+"\t{\n"
+"\t\treturn power * 2;\n"
+"\t}\n"
+"}\n";
+
+TEST_F(IncrementalParserTest, ReparsesOnlyEnclosingFunction)
+{
+	IncrementalParser parser = IncrementalParser(&logger);
+	Load(parser, IncrementalSource);
+	auto specular = GetFunction(parser.GetCompilationUnit(), 1);
+
+	EXPECT_TRUE(Edit(parser, "\t\treturn saturate", 0, "\t\tfloat scale = 1;\n\n"));
+	auto compilation = parser.GetCompilationUnit();
+	EXPECT_EQ(GetFunction(compilation, 1), specular);
+	EXPECT_NE(GetFunction(compilation, 0)->GetBody(), nullptr);
+
+	// the untouched function has to follow the edit.
+	auto& span = specular->GetSpan();
+	size_t start = text.find("float Specular");
+	EXPECT_EQ(span.str(), text.substr(start, text.find("\t}\n}", start) + 2 - start));
+	EXPECT_EQ(span.line, 10);
+	EXPECT_FALSE(logger.HasErrors());
+}
+
+TEST_F(IncrementalParserTest, FallsBackOutsideDeclarations)
+{
+	IncrementalParser parser = IncrementalParser(&logger);
+	Load(parser, IncrementalSource);
+
+	EXPECT_FALSE(Edit(parser, "Lighting", 8, "Shading"));
+	EXPECT_EQ(parser.GetCompilationUnit()->GetNamespaces()[0]->GetName(), "Shading");
+	EXPECT_TRUE(Edit(parser, "power * 2", 9, "power * 4"));
+	EXPECT_FALSE(logger.HasErrors());
+}
\ No newline at end of file
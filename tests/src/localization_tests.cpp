@@ -0,0 +1,17 @@
+#include <gtest/gtest.h>
+#include "pch/localization.hpp"
+
+using namespace HXSL;
+
+TEST(LocalizationTest, LooksUpMessagesWithoutCopies)
+{
+	auto message = GetMessageForCode(INVALID_TOKEN.value);
+	EXPECT_EQ(message, StringSpan("invalid token"));
+
+	// the level bits aren't part of the lookup and a cached block is handed out as is.
+	auto again = GetMessageForCode(INVALID_TOKEN.value & ~(0x3ull << 62));
+	EXPECT_EQ(again.data(), message.data());
+
+	EXPECT_EQ(GetMessageForCode(MISSING_END_COMMENT.value), StringSpan("comment unclosed at end of file"));
+	EXPECT_EQ(GetMessageForCode(1), StringSpan("Unknown localization code"));
+}
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include "logging/logger_adapter.hpp"
+#include "utils/thread_pool.hpp"
+
+using namespace HXSL;
+
+static std::vector<std::string> GetTexts(const ILogger& logger)
+{
+	std::vector<std::string> texts;
+	for (auto& message : logger.GetMessages())
+	{
+		texts.push_back(message.Message);
+	}
+	return texts;
+}
+
+TEST(LoggerTest, ReplaysRangesInCallerOrder)
+{
+	ILogger declarations = ILogger(true);
+	declarations.Log(LogLevel_Info, "a");
+	declarations.Log(LogLevel_Info, "b");
+	size_t split = declarations.GetDeferredEventCount();
+	declarations.Log(LogLevel_Info, "d");
+
+	ILogger body = ILogger(true);
+	body.Log(LogLevel_Info, "c");
+
+	ILogger output;
+	output.Replay(declarations, 0, split);
+	output.Replay(body);
+	output.Replay(declarations, split, declarations.GetDeferredEventCount());
+
+	EXPECT_EQ(GetTexts(output), (std::vector<std::string>{ "a", "b", "c", "d" }));
+}
+
+TEST(LoggerTest, RedirectIsPerThreadAndScoped)
+{
+	ILogger target;
+	LoggerAdapter adapter = LoggerAdapter(&target);
+
+	std::vector<uptr<ILogger>> buffers;
+	for (size_t i = 0; i < 8; ++i)
+	{
+		buffers.push_back(make_uptr<ILogger>(true));
+	}
+
+	ThreadPool pool = ThreadPool(4);
+	pool.ParallelFor(buffers.size(), [&](size_t i)
+		{
+			LoggerAdapter::ScopedRedirect redirect(buffers[i].get());
+			adapter.GetLogger()->Log(LogLevel_Info, std::to_string(i));
+		});
+
+	EXPECT_EQ(adapter.GetLogger(), &target);
+	EXPECT_TRUE(target.GetMessages().empty());
+	for (size_t i = 0; i < buffers.size(); ++i)
+	{
+		EXPECT_EQ(GetTexts(*buffers[i]), (std::vector<std::string>{ std::to_string(i) }));
+	}
+}
+
+class LoggerDiagnosticsTest : public ::testing::Test
+{
+protected:
+	DiagnosticCode::GetMessageForCode previousMessage = nullptr;
+	DiagnosticCode::GetStringForCode previousString = nullptr;
+	static inline size_t renderCount = 0;
+
+	void SetUp() override
+	{
+		previousMessage = DiagnosticCode::getMessageForCode;
+		previousString = DiagnosticCode::getStringForCode;
+		renderCount = 0;
+		DiagnosticCode::getMessageForCode = [](uint64_t code) -> StringSpan { renderCount++; return "message {}"; };
+		DiagnosticCode::getStringForCode = [](uint64_t code) -> std::string { return "HX" + std::to_string(code & 0xFFFF); };
+	}
+
+	void TearDown() override
+	{
+		DiagnosticCode::getMessageForCode = previousMessage;
+		DiagnosticCode::getStringForCode = previousString;
+	}
+
+	static DiagnosticCode MakeCode(uint64_t id, LogLevel level = LogLevel_Error)
+	{
+		// the two top bits hold the level relative to info.
+		return DiagnosticCode(id | (static_cast<uint64_t>(level - LogLevel_Info) << 62));
+	}
+};
+
+TEST_F(LoggerDiagnosticsTest, RendersOnlyWhenAsked)
+{
+	ILogger logger;
+	std::string transient = "value";
+	logger.LogFormattedEx(MakeCode(1), 10, " at {}", StringSpan(transient), 7);
+	transient = "changed";
+
+	EXPECT_TRUE(logger.HasMessages());
+	EXPECT_EQ(renderCount, 0u);
+	EXPECT_EQ(GetTexts(logger), (std::vector<std::string>{ "HX1: message value at 7" }));
+	EXPECT_EQ(renderCount, 1u);
+
+	GetTexts(logger);
+	EXPECT_EQ(renderCount, 1u);
+}
+
+TEST_F(LoggerDiagnosticsTest, SuppressesOverlappingRanges)
+{
+	ILogger logger;
+	logger.AddDiagnosticSuppressionRange(DiagnosticSuppressionRange(MakeCode(1), 0, 100));
+	logger.AddDiagnosticSuppressionRange(DiagnosticSuppressionRange(MakeCode(2), 50, 60));
+
+	logger.LogFormattedEx(MakeCode(1), 55, "");
+	logger.LogFormattedEx(MakeCode(2), 55, "");
+	logger.LogFormattedEx(MakeCode(2), 60, "");
+	logger.Log(MakeCode(1), 100, "end");
+
+	ASSERT_EQ(logger.GetRecords().size(), 2u);
+	EXPECT_EQ(logger.GetRecords()[0].location, 60u);
+	EXPECT_EQ(logger.GetRecords()[1].location, 100u);
+	EXPECT_EQ(renderCount, 0u);
+}
+
+TEST_F(LoggerDiagnosticsTest, DeduplicatesAndCaps)
+{
+	ILogger logger;
+	logger.SetDeduplicate(true);
+	logger.SetMaxRecords(3);
+
+	for (size_t i = 0; i < 50; i++)
+	{
+		logger.LogFormattedEx(MakeCode(1), 5, "", 3);
+	}
+	EXPECT_EQ(logger.GetRecords().size(), 1u);
+	EXPECT_EQ(logger.GetRecords()[0].count, 50u);
+	EXPECT_EQ(logger.GetErrorCount(), 1);
+	EXPECT_EQ(GetTexts(logger), (std::vector<std::string>{ "HX1: message 3 (x50)" }));
+
+	// folded after it was rendered, the cached message follows the count.
+	logger.LogFormattedEx(MakeCode(1), 5, "", 3);
+	EXPECT_EQ(GetTexts(logger), (std::vector<std::string>{ "HX1: message 3 (x51)" }));
+
+	for (size_t i = 0; i < 10; i++)
+	{
+		logger.LogFormattedEx(MakeCode(2, LogLevel_Warn), i, "");
+	}
+	EXPECT_EQ(logger.GetRecords().size(), 3u);
+	EXPECT_EQ(logger.GetDroppedCount(), 8u);
+	EXPECT_FALSE(logger.HasCriticalErrors());
+}
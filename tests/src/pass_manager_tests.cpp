@@ -0,0 +1,229 @@
+#include "il_test_fixture.hpp"
+#include "optimizers/pass_manager.hpp"
+#include "optimizers/il_optimizer.hpp"
+#include "il/il_code_blob.hpp"
+#include "il/il_text.hpp"
+
+class PassManagerTest : public ILTest
+{
+};
+
+TEST_F(PassManagerTest, RebuildsAnalysesOnlyAfterCfgChanges)
+{
+	auto& cfg = function->cfg;
+	auto value = Temp();
+
+	size_t entry = cfg.AddNode(ControlFlowType_Normal);
+	Add<MoveInstr>(entry, value, function->MakeConstant(Number(0)));
+	size_t loop = cfg.AddNode(ControlFlowType_Conditional);
+	Add<BinaryInstr>(loop, OpCode_Add, value, function->MakeVariable(value), function->MakeConstant(Number(1)));
+	size_t exit = cfg.AddNode(ControlFlowType_Exit);
+	Add<ReturnInstr>(exit, function->MakeVariable(value));
+	cfg.Link(entry, loop);
+	cfg.Link(loop, loop);
+	cfg.Link(loop, exit);
+
+	auto& loopTree = function->loopTree;
+	EXPECT_FALSE(cfg.IsDomTreeValid());
+	EXPECT_FALSE(loopTree.IsValid());
+
+	loopTree.Ensure();
+	EXPECT_TRUE(cfg.IsDomTreeValid());
+	EXPECT_TRUE(loopTree.IsValid());
+	ASSERT_EQ(loopTree.GetNodes().size(), 1u);
+	EXPECT_EQ(loopTree.GetNodes()[0]->GetHeader(), cfg.GetNode(loop).get());
+
+	auto version = cfg.GetVersion();
+	loopTree.Ensure();
+	cfg.EnsureDomTree();
+	EXPECT_EQ(cfg.GetVersion(), version);
+
+	cfg.Unlink(loop, loop);
+	EXPECT_FALSE(cfg.IsDomTreeValid());
+	EXPECT_FALSE(loopTree.IsValid());
+
+	loopTree.Ensure();
+	EXPECT_TRUE(cfg.IsDomTreeValid());
+	EXPECT_TRUE(loopTree.GetNodes().empty());
+}
+
+TEST_F(PassManagerTest, RunsToFixedPoint)
+{
+	auto& cfg = function->cfg;
+	auto input = Temp();
+	auto sum = Temp();
+	auto product = Temp();
+
+	size_t entry = cfg.AddNode(ControlFlowType_Exit);
+	Add<BinaryInstr>(entry, OpCode_Add, sum, function->MakeVariable(input), function->MakeConstant(Number(0)));
+	Add<BinaryInstr>(entry, OpCode_Multiply, product, function->MakeVariable(sum), function->MakeConstant(Number(1)));
+	Add<ReturnInstr>(entry, function->MakeVariable(product));
+
+	ILPassManager manager = ILPassManager(function.get(), OptimizationLevel_Basic);
+	EXPECT_EQ(manager.GetPassCount(), 4u);
+	EXPECT_TRUE(manager.Run());
+
+	auto& block = *cfg.GetNode(entry);
+	ASSERT_EQ(block.GetInstructions().size(), 1u);
+	auto& ret = *cast<ReturnInstr>(&*block.begin());
+	ASSERT_TRUE(isa<Variable>(ret.GetReturnValue()));
+	EXPECT_EQ(cast<Variable>(ret.GetReturnValue())->varId, input);
+
+	// the passes are kept, a second run over an unchanged function finds nothing to do.
+	EXPECT_FALSE(manager.Run());
+	EXPECT_EQ(cfg.CountInstructions(), 1u);
+}
+
+TEST_F(PassManagerTest, NoneLevelHasNoPasses)
+{
+	ILPassManager manager = ILPassManager(function.get(), OptimizationLevel_None);
+	EXPECT_EQ(manager.GetPassCount(), 0u);
+	EXPECT_FALSE(manager.Run());
+}
+
+// builds a small program straight into a module, the way the frontend hands it to the optimizer.
+struct ProgramBuilder
+{
+	Module& module;
+	PrimitiveLayout* intType;
+	std::vector<uptr<ILContext>>& contexts;
+	std::vector<FunctionLayout*> layouts = {};
+
+	ILContext& AddFunction(const char* name)
+	{
+		auto* layout = FunctionLayoutBuilder(module).Name(name).ReturnType(intType).Peek();
+		auto& context = contexts.emplace_back(make_uptr<ILContext>(&module, layout));
+		layout->SetContext(context.get());
+		layouts.push_back(layout);
+		return *context;
+	}
+
+	template<typename T, typename... Args>
+	T* Add(ILContext& context, size_t block, Args&&... args)
+	{
+		auto& allocator = context.allocator;
+		auto* instr = allocator.Alloc<T>(allocator, std::forward<Args>(args)...);
+		context.cfg.GetNode(block)->AddInstr(instr);
+		return instr;
+	}
+
+	ILVarId Call(ILContext& context, size_t block, ILContext& callee)
+	{
+		auto result = context.metadata.RegTempVar(intType).id;
+		auto* callMetadata = context.metadata.RegFunc(callee.GetFunction());
+		auto* call = Add<CallInstr>(context, block, result, context.allocator.Alloc<Function>(callMetadata));
+		callMetadata->callSites.push_back(call);
+		return result;
+	}
+
+	ILVarId Binary(ILContext& context, size_t block, ILOpCode opcode, Operand* lhs, Operand* rhs)
+	{
+		auto result = context.metadata.RegTempVar(intType).id;
+		Add<BinaryInstr>(context, block, opcode, result, lhs, rhs);
+		return result;
+	}
+
+	void Build()
+	{
+		module.SetAllFunctions(module.GetAllocator().CopySpan(layouts));
+	}
+};
+
+static std::string PrintCodeBlob(const FunctionLayout* layout)
+{
+	std::string text;
+	auto* blob = layout->GetCodeBlob();
+	for (auto& instr : blob->GetInstructions())
+	{
+		text += ToString(instr, blob->GetMetadata()) + "\n";
+	}
+	return text;
+}
+
+TEST_F(PassManagerTest, ParallelOptimizeMatchesSerial)
+{
+	auto build = [&](Module& target, std::vector<uptr<ILContext>>& contexts)
+		{
+			ProgramBuilder program = ProgramBuilder{ target, intType, contexts };
+
+			// leaf is called from every level above it, so the inliner has to finish it before any of its callers.
+			auto& leaf = program.AddFunction("leaf");
+			size_t leafEntry = leaf.cfg.AddNode(ControlFlowType_Exit);
+			auto two = program.Binary(leaf, leafEntry, OpCode_Add, leaf.MakeConstant(Number(1)), leaf.MakeConstant(Number(1)));
+			auto six = program.Binary(leaf, leafEntry, OpCode_Multiply, leaf.MakeVariable(two), leaf.MakeConstant(Number(3)));
+			program.Add<ReturnInstr>(leaf, leafEntry, leaf.MakeVariable(six));
+
+			auto& inc = program.AddFunction("inc");
+			size_t incEntry = inc.cfg.AddNode(ControlFlowType_Exit);
+			auto incLeaf = program.Call(inc, incEntry, leaf);
+			auto incResult = program.Binary(inc, incEntry, OpCode_Add, inc.MakeVariable(incLeaf), inc.MakeConstant(Number(1)));
+			program.Add<ReturnInstr>(inc, incEntry, inc.MakeVariable(incResult));
+
+			auto& dbl = program.AddFunction("dbl");
+			size_t dblEntry = dbl.cfg.AddNode(ControlFlowType_Exit);
+			auto dblLeaf = program.Call(dbl, dblEntry, leaf);
+			auto dblResult = program.Binary(dbl, dblEntry, OpCode_Multiply, dbl.MakeVariable(dblLeaf), dbl.MakeConstant(Number(2)));
+			program.Add<ReturnInstr>(dbl, dblEntry, dbl.MakeVariable(dblResult));
+
+			auto& top = program.AddFunction("top");
+			size_t topEntry = top.cfg.AddNode(ControlFlowType_Exit);
+			auto topInc = program.Call(top, topEntry, inc);
+			auto topDbl = program.Call(top, topEntry, dbl);
+			auto topLeaf = program.Call(top, topEntry, leaf);
+			auto topSum = program.Binary(top, topEntry, OpCode_Add, top.MakeVariable(topInc), top.MakeVariable(topDbl));
+			auto topResult = program.Binary(top, topEntry, OpCode_Add, top.MakeVariable(topSum), top.MakeVariable(topLeaf));
+			program.Add<ReturnInstr>(top, topEntry, top.MakeVariable(topResult));
+
+			// sums up the counter of a loop on top of a call, so the unroller runs on a function the inliner changed.
+			auto& loop = program.AddFunction("loop");
+			auto& cfg = loop.cfg;
+			auto x = loop.metadata.RegVar(intType).id;
+			auto sum = loop.metadata.RegVar(intType).id;
+			auto condition = loop.metadata.RegTempVar(intType).id;
+
+			size_t entry = cfg.AddNode(ControlFlowType_Normal);
+			program.Add<MoveInstr>(loop, entry, x, loop.MakeConstant(Number(0)));
+			auto start = program.Call(loop, entry, dbl);
+			program.Add<MoveInstr>(loop, entry, sum, loop.MakeVariable(start));
+			size_t header = cfg.AddNode(ControlFlowType_Conditional);
+			program.Add<BinaryInstr>(loop, header, OpCode_LessThan, condition, loop.MakeVariable(x), loop.MakeConstant(Number(4)));
+			size_t body = cfg.AddNode(ControlFlowType_Unconditional);
+			program.Add<BinaryInstr>(loop, body, OpCode_Add, x, loop.MakeVariable(x), loop.MakeConstant(Number(1)));
+			program.Add<BinaryInstr>(loop, body, OpCode_Add, sum, loop.MakeVariable(sum), loop.MakeVariable(x));
+			program.Add<JumpInstr>(loop, body, OpCode_Jump, loop.allocator.Alloc<Label>(ILLabel(header)));
+			size_t exit = cfg.AddNode(ControlFlowType_Exit);
+			program.Add<ReturnInstr>(loop, exit, loop.MakeVariable(sum));
+			program.Add<JumpInstr>(loop, header, OpCode_JumpZero, loop.allocator.Alloc<Label>(ILLabel(exit)));
+
+			cfg.Link(entry, header);
+			cfg.Link(header, exit);
+			cfg.Link(header, body);
+			cfg.Link(body, header);
+
+			program.Build();
+		};
+
+	Module serialModule;
+	std::vector<uptr<ILContext>> serialContexts;
+	build(serialModule, serialContexts);
+	ILOptimizer(nullptr, &serialModule, OptimizationLevel_Full, 1).Optimize();
+
+	Module parallelModule;
+	std::vector<uptr<ILContext>> parallelContexts;
+	build(parallelModule, parallelContexts);
+	ILOptimizer(nullptr, &parallelModule, OptimizationLevel_Full, 4).Optimize();
+
+	auto& serial = serialModule.GetAllFunctions();
+	auto& parallel = parallelModule.GetAllFunctions();
+	ASSERT_EQ(serial.size(), parallel.size());
+	for (size_t i = 0; i < serial.size(); ++i)
+	{
+		ASSERT_NE(serial[i]->GetCodeBlob(), nullptr);
+		ASSERT_NE(parallel[i]->GetCodeBlob(), nullptr);
+		auto text = PrintCodeBlob(parallel[i]);
+		EXPECT_EQ(text, PrintCodeBlob(serial[i])) << parallel[i]->GetName().str();
+
+		// every callee is cheap enough to be inlined, no level may be left with a call into the one below.
+		EXPECT_EQ(text.find("call"), std::string::npos) << parallel[i]->GetName().str() << "\n" << text;
+	}
+}
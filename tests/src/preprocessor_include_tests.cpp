@@ -0,0 +1,174 @@
+#include "common.hpp"
+#include <filesystem>
+#include <fstream>
+#include "preprocessing/preprocessor.hpp"
+#include "parsers/parallel_parser.hpp"
+
+class PreprocessorIncludeTest : public ASTContextTest
+{
+protected:
+	std::filesystem::path directory;
+
+	void SetUp() override
+	{
+		ASTContextTest::SetUp();
+		directory = std::filesystem::temp_directory_path() / "hxsl_include_tests";
+		std::filesystem::create_directories(directory / "sub");
+	}
+
+	void TearDown() override
+	{
+		ASTContextTest::TearDown();
+		std::filesystem::remove_all(directory);
+	}
+
+	std::string WriteFile(const std::string& name, const std::string& content)
+	{
+		auto path = (directory / name).string();
+		std::ofstream(path, std::ios::binary) << content;
+		return path;
+	}
+
+	std::string Preprocess(const std::string& name)
+	{
+		auto source = context->GetSourceManager().AddSource(MappedSource::Open((directory / name).string().c_str()));
+		Preprocessor preprocessor = Preprocessor(&logger);
+		preprocessor.Process(source);
+		auto& output = source->GetInputStream();
+		return std::string(output->GetBuffer(), output->GetLength());
+	}
+
+	static size_t Count(const std::string& text, const std::string& match)
+	{
+		size_t count = 0;
+		for (size_t pos = text.find(match); pos != std::string::npos; pos = text.find(match, pos + 1))
+		{
+			count++;
+		}
+		return count;
+	}
+};
+
+TEST_F(PreprocessorIncludeTest, DetectsGuardAndPragmaOnce)
+{
+	auto guarded = IncludeCache::Instance().Get(WriteFile("guarded.hxsl", "// header\n#ifndef GUARDED_H\n#define GUARDED_H\nfloat A() { return 1; }\n#endif\n"));
+	auto once = IncludeCache::Instance().Get(WriteFile("once.hxsl", "#pragma once\nfloat B() { return 2; }\n"));
+	auto open = IncludeCache::Instance().Get(WriteFile("open.hxsl", "#ifndef OPEN_H\n#define OPEN_H\n#endif\nfloat C() { return 3; }\n"));
+
+	ASSERT_TRUE(guarded && once && open);
+	ASSERT_NE(guarded->guard, nullptr);
+	EXPECT_EQ(guarded->guard->name.str(), "GUARDED_H");
+	EXPECT_TRUE(once->pragmaOnce);
+	EXPECT_EQ(open->guard, nullptr);
+	EXPECT_EQ(IncludeCache::Instance().Get((directory / "guarded.hxsl").string()), guarded);
+	EXPECT_EQ(IncludeCache::Instance().Get((directory / "missing.hxsl").string()), nullptr);
+}
+
+TEST_F(PreprocessorIncludeTest, SkipsRepeatedIncludes)
+{
+	WriteFile("guarded.hxsl", "#ifndef GUARDED_H\n#define GUARDED_H\n#define VALUE 3\nfloat A() { return VALUE; }\n#endif\n");
+	WriteFile("once.hxsl", "#pragma once\nfloat B() { return 2; }\n");
+	WriteFile("sub/nested.hxsl", "#include \"../guarded.hxsl\"\nfloat C() { return VALUE; }\n");
+	WriteFile("main.hxsl", "#include \"guarded.hxsl\"\n#include \"guarded.hxsl\"\n#include \"once.hxsl\"\n#include \"once.hxsl\"\n#include \"sub/nested.hxsl\"\n");
+
+	auto output = Preprocess("main.hxsl");
+	EXPECT_EQ(Count(output, "float A()"), 1);
+	EXPECT_EQ(Count(output, "float B()"), 1);
+	EXPECT_EQ(Count(output, "float C() { return 3; }"), 1);
+	EXPECT_FALSE(logger.HasErrors());
+}
+
+TEST_F(PreprocessorIncludeTest, ReloadsChangedFiles)
+{
+	auto path = WriteFile("changing.hxsl", "float A() { return 1; }\n");
+	auto first = IncludeCache::Instance().Get(path);
+	WriteFile("changing.hxsl", "float A() { return 2; }\n");
+	auto second = IncludeCache::Instance().Get(path);
+
+	ASSERT_TRUE(first && second);
+	EXPECT_NE(first->hash, second->hash);
+	EXPECT_NE(first, second);
+}
+
+TEST_F(PreprocessorIncludeTest, ReportsMissingInclude)
+{
+	WriteFile("main.hxsl", "#include \"missing.hxsl\"\nfloat A() { return 1; }\n");
+	Preprocess("main.hxsl");
+	EXPECT_TRUE(logger.HasErrors());
+}
+
+TEST_F(PreprocessorIncludeTest, EvictsLeastRecentlyUsedPastCapacity)
+{
+	auto& cache = IncludeCache::Instance();
+	size_t capacity = cache.GetCapacity();
+	cache.Clear();
+	cache.SetCapacity(2);
+
+	auto a = cache.Get(WriteFile("a.hxsl", "float A() { return 1; }\n"));
+	auto b = cache.Get(WriteFile("b.hxsl", "float B() { return 2; }\n"));
+	EXPECT_EQ(cache.Get((directory / "a.hxsl").string()), a);
+	auto c = cache.Get(WriteFile("c.hxsl", "float C() { return 3; }\n"));
+
+	ASSERT_TRUE(a && b && c);
+	EXPECT_EQ(cache.Size(), 2u);
+	EXPECT_EQ(cache.Get((directory / "a.hxsl").string()), a);
+	EXPECT_NE(cache.Get((directory / "b.hxsl").string()), b);
+
+	// the identifiers of a file go with it, a cache of one file holds fewer than one of two.
+	size_t identifiers = cache.GetIdentifierCount();
+	EXPECT_GT(identifiers, 0u);
+	cache.SetCapacity(1);
+	EXPECT_EQ(cache.Size(), 1u);
+	EXPECT_LT(cache.GetIdentifierCount(), identifiers);
+	cache.Clear();
+	EXPECT_EQ(cache.GetIdentifierCount(), 0u);
+
+	cache.SetCapacity(capacity);
+	cache.Clear();
+}
+
+TEST_F(PreprocessorIncludeTest, AssignsIncludeSourceIdsInSourceOrder)
+{
+	constexpr size_t SourceCount = 8;
+	WriteFile("common.hxsl", "#pragma once\nfloat Common() { return 0; }\n");
+	std::vector<std::string> paths;
+	for (size_t i = 0; i < SourceCount; i++)
+	{
+		auto index = std::to_string(i);
+		WriteFile("header" + index + ".hxsl", "#include \"common.hxsl\"\nfloat H" + index + "() { return " + index + "; }\n");
+		paths.push_back(WriteFile("main" + index + ".hxsl", "#include \"header" + index + ".hxsl\"\nfloat M" + index + "() { return H" + index + "(); }\n"));
+	}
+
+	// the path of every registered source by id, workers finish in any order but the ids must not depend on it.
+	auto run = [&](size_t threads)
+		{
+			auto runContext = make_uptr<ASTContext>();
+			ASTContext::SetCurrentContext(runContext.get());
+			ILogger runLogger;
+			auto& sourceManager = runContext->GetSourceManager();
+			std::vector<SourceFile*> sources;
+			for (auto& path : paths)
+			{
+				sources.push_back(sourceManager.AddSource(MappedSource::Open(path.c_str())));
+			}
+
+			CompilationUnitBuilder builder = CompilationUnitBuilder(&runLogger);
+			ParallelParser(&runLogger, runContext.get(), threads).Parse(sources, builder);
+			EXPECT_FALSE(runLogger.HasErrors());
+
+			std::vector<std::string> registered;
+			for (size_t id = 0; id < sourceManager.Size(); id++)
+			{
+				registered.push_back(sourceManager.GetSource(static_cast<SourceFileID>(id))->GetPath());
+			}
+			ASTContext::SetCurrentContext(context.get());
+			return registered;
+		};
+
+	auto serial = run(1);
+	EXPECT_GT(serial.size(), SourceCount);
+	for (size_t i = 0; i < 4; i++)
+	{
+		EXPECT_EQ(run(4), serial);
+	}
+}
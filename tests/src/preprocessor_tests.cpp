@@ -0,0 +1,80 @@
+#include "common.hpp"
+#include "preprocessing/preprocessor.hpp"
+
+class PreprocessorTest : public ASTContextTest
+{
+protected:
+	std::string Preprocess(const std::string& text)
+	{
+		auto* source = context->GetSourceManager().AddSource(nullptr, false);
+		source->GetInputStream()->Write(text.data(), text.size());
+		Preprocessor preprocessor = Preprocessor(&logger);
+		preprocessor.Process(source);
+		auto& output = source->GetInputStream();
+		return std::string(output->GetBuffer(), output->GetLength());
+	}
+};
+
+TEST_F(PreprocessorTest, KeepsFilesWithoutDirectivesIdentical)
+{
+	std::string input =
+		"// line comment with \"quotes\" and 'ticks'\n"
+		"/* block\n"
+		"   comment */\n"
+		"string name = \"a \\\"quoted\\\" 'c' value\";\n"
+		"float f = 1.0; // trailing\n";
+
+	EXPECT_EQ(Preprocess(input), input);
+	EXPECT_FALSE(logger.HasErrors());
+}
+
+TEST_F(PreprocessorTest, EchoesCommentsWhenRewriting)
+{
+	auto output = Preprocess(
+		"#define VALUE 3\n"
+		"// line comment\n"
+		"float A() { return VALUE; } /* block\n"
+		"   comment */\n");
+
+	EXPECT_NE(output.find("// line comment\n"), std::string::npos);
+	EXPECT_NE(output.find("/* block\n   comment */"), std::string::npos);
+	EXPECT_NE(output.find("return 3;"), std::string::npos);
+	EXPECT_EQ(output.find("VALUE"), std::string::npos);
+	EXPECT_FALSE(logger.HasErrors());
+}
+
+TEST_F(PreprocessorTest, KeepsQuotesOnStringLiterals)
+{
+	auto output = Preprocess(
+		"#define NAME \"macro\"\n"
+		"string a = \"plain\";\n"
+		"string b = \"escaped \\\" quote\";\n"
+		"string c = \"\";\n"
+		"string d = NAME;\n");
+
+	EXPECT_NE(output.find("\"plain\""), std::string::npos);
+	EXPECT_NE(output.find("\"escaped \\\" quote\""), std::string::npos);
+	EXPECT_NE(output.find("c = \"\";"), std::string::npos);
+	EXPECT_NE(output.find("d = \"macro\";"), std::string::npos);
+	EXPECT_FALSE(logger.HasErrors());
+}
+
+TEST_F(PreprocessorTest, KeepsCharacterLiteralTextInStringsAndComments)
+{
+	auto output = Preprocess(
+		"#define VALUE 1\n"
+		"string a = \"'x' '\\\\n'\"; // 'y'\n"
+		"float b = VALUE;\n");
+
+	EXPECT_NE(output.find("\"'x' '\\\\n'\""), std::string::npos);
+	EXPECT_NE(output.find("// 'y'"), std::string::npos);
+	EXPECT_NE(output.find("b = 1;"), std::string::npos);
+	EXPECT_FALSE(logger.HasErrors());
+}
+
+TEST_F(PreprocessorTest, ReportsCharacterLiteralsOutsideStrings)
+{
+	// HXSL has no character literals, a bare one is an invalid token rather than silently passed through.
+	Preprocess("float a = 'x';\n");
+	EXPECT_TRUE(logger.HasErrors());
+}
@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "ast_modules/primitive_manager.hpp"
+#include "semantics/symbols/symbol_table.hpp"
+
+using namespace HXSL;
+
+TEST(PrimitiveManagerTest, SharesOneSealedUniverse)
+{
+	PrimitiveManager a;
+	PrimitiveManager b;
+	EXPECT_EQ(a.GetSymbolTable(), b.GetSymbolTable());
+	EXPECT_TRUE(PrimitiveUniverse::Get().GetAssembly()->IsSealed());
+
+	auto float3 = a.Resolve("float3");
+	ASSERT_TRUE(float3.valid());
+	EXPECT_EQ(b.Resolve("float3").GetNode(), float3.GetNode());
+	EXPECT_TRUE(a.Resolve("float5").invalid());
+}
+
+TEST(PrimitiveManagerTest, ConcurrentUse)
+{
+	constexpr size_t ThreadCount = 8;
+	std::vector<const SymbolTable*> tables(ThreadCount);
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < ThreadCount; t++)
+	{
+		threads.emplace_back([&tables, t]()
+			{
+				PrimitiveManager manager;
+				tables[t] = manager.Resolve("float4x4").valid() ? manager.GetSymbolTable() : nullptr;
+			});
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	for (auto table : tables)
+	{
+		EXPECT_NE(table, nullptr);
+		EXPECT_EQ(table, tables[0]);
+	}
+}
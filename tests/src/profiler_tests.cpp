@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <set>
+#include "utils/profiler.hpp"
+
+using namespace HXSL;
+
+static std::string Trace()
+{
+	std::stringstream stream;
+	Profiler::WriteChromeTrace(stream);
+	return stream.str();
+}
+
+// tids of the thread_name metadata events, one per thread that recorded into the session.
+static std::vector<std::string> ThreadIds(const std::string& trace)
+{
+	static const std::string prefix = "\"ph\":\"M\",\"pid\":1,\"tid\":";
+	std::vector<std::string> ids;
+	for (size_t pos = trace.find(prefix); pos != std::string::npos; pos = trace.find(prefix, pos + 1))
+	{
+		size_t start = pos + prefix.size();
+		ids.push_back(trace.substr(start, trace.find(',', start) - start));
+	}
+	return ids;
+}
+
+TEST(ProfilerTest, RecordsNothingOutsideSession)
+{
+	ASSERT_FALSE(Profiler::IsEnabled());
+	ASSERT_TRUE(Profiler::Begin());
+	Profiler::End();
+	{
+		PROFILE_SCOPE_DETAIL("Ignored", std::string("never built"));
+		Profiler::Count("Ignored", 1);
+	}
+	EXPECT_EQ(Trace().find("Ignored"), std::string::npos);
+}
+
+TEST(ProfilerTest, WritesScopesAndCounterTotals)
+{
+	ASSERT_TRUE(Profiler::Begin());
+	EXPECT_FALSE(Profiler::Begin());
+	{
+		PROFILE_SCOPE("Outer");
+		ProfileScope pass = ProfileScope("Pass", []() { return std::string("Fold \"main\""); });
+		pass.AddArg("instructionsRemoved", 3);
+		Profiler::Count("Removed", 3);
+		std::thread([]() { PROFILE_SCOPE("Worker"); Profiler::Count("Removed", 2); }).join();
+	}
+	Profiler::End();
+
+	auto trace = Trace();
+	EXPECT_NE(trace.find("\"name\":\"Outer\""), std::string::npos);
+	EXPECT_NE(trace.find("\"name\":\"Pass: Fold \\\"main\\\"\""), std::string::npos);
+	EXPECT_NE(trace.find("\"args\":{\"instructionsRemoved\":3}"), std::string::npos);
+	EXPECT_NE(trace.find("\"name\":\"Worker\""), std::string::npos);
+	auto ids = ThreadIds(trace);
+	ASSERT_EQ(ids.size(), 2u);
+	EXPECT_NE(ids[0], ids[1]);
+	EXPECT_NE(trace.find("\"args\":{\"value\":5}"), std::string::npos);
+}
+
+TEST(ProfilerTest, ThreadsKeepRecordingAcrossSessions)
+{
+	std::atomic<int> phase = 0;
+	std::thread worker([&]()
+		{
+			// keeps recording while the main thread ends the session and starts the next one.
+			while (phase.load(std::memory_order_acquire) < 2)
+			{
+				PROFILE_SCOPE("Straggler");
+				Profiler::Count("Ticks", 1);
+				if (phase.load(std::memory_order_acquire) == 0)
+				{
+					phase.store(1, std::memory_order_release);
+				}
+			}
+		});
+
+	ASSERT_TRUE(Profiler::Begin());
+	while (phase.load(std::memory_order_acquire) == 0) std::this_thread::yield();
+	for (int i = 0; i < 50; i++)
+	{
+		Profiler::End();
+		EXPECT_TRUE(Profiler::Begin());
+	}
+	{
+		PROFILE_SCOPE("Last");
+	}
+	phase.store(2, std::memory_order_release);
+	worker.join();
+	Profiler::End();
+
+	auto trace = Trace();
+	EXPECT_NE(trace.find("\"name\":\"Last\""), std::string::npos);
+	auto ids = ThreadIds(trace);
+	EXPECT_LE(ids.size(), 2u);
+	EXPECT_EQ(std::set<std::string>(ids.begin(), ids.end()).size(), ids.size());
+}
+
+TEST(ProfilerTest, DropsScopesFromEarlierSession)
+{
+	ASSERT_TRUE(Profiler::Begin());
+	{
+		PROFILE_SCOPE("Old");
+		Profiler::End();
+		ASSERT_TRUE(Profiler::Begin());
+		PROFILE_SCOPE("New");
+	}
+	Profiler::End();
+
+	auto trace = Trace();
+	EXPECT_NE(trace.find("\"name\":\"New\""), std::string::npos);
+	EXPECT_EQ(trace.find("\"name\":\"Old\""), std::string::npos);
+}
+
+// Run under ThreadSanitizer, the trace is written while other threads keep adding to their buffers.
+TEST(ProfilerTest, WritesWhileThreadsRecord)
+{
+	constexpr int WorkerCount = 4;
+	ASSERT_TRUE(Profiler::Begin());
+	std::atomic<int> finished = 0;
+	std::vector<std::thread> workers;
+	for (int t = 0; t < WorkerCount; t++)
+	{
+		workers.emplace_back([&]()
+			{
+				for (int i = 0; i < 2000; i++)
+				{
+					PROFILE_SCOPE_DETAIL("Busy", std::string("worker"));
+					Profiler::Count("Ticks", 1);
+				}
+				finished.fetch_add(1, std::memory_order_release);
+			});
+	}
+
+	do
+	{
+		auto trace = Trace();
+		EXPECT_EQ(trace.substr(trace.size() - 4), "\n]}\n");
+	} while (finished.load(std::memory_order_acquire) < WorkerCount);
+
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+	Profiler::End();
+
+	auto trace = Trace();
+	EXPECT_NE(trace.find("\"name\":\"Busy: worker\""), std::string::npos);
+	EXPECT_NE(trace.find("\"args\":{\"value\":8000}"), std::string::npos);
+}
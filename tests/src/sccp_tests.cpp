@@ -0,0 +1,122 @@
+#include "il_test_fixture.hpp"
+#include "optimizers/sparse_conditional_constant_propagation.hpp"
+
+class SCCPTest : public ILTest
+{
+protected:
+	Operand* ReturnValue(size_t block)
+	{
+		auto& instructions = function->cfg.GetNode(block)->GetInstructions();
+		return cast<ReturnInstr>(&instructions.back())->GetReturnValue();
+	}
+};
+
+TEST_F(SCCPTest, FoldsConstantBranchAndRemovesDeadBlock)
+{
+	auto& cfg = function->cfg;
+	auto condition = Temp();
+	auto a = Temp();
+	auto b = Temp();
+	auto result = Temp();
+
+	size_t entry = cfg.AddNode(ControlFlowType_Conditional);
+	Add<BinaryInstr>(entry, OpCode_LessThan, condition, function->MakeConstant(Number(1)), function->MakeConstant(Number(2)));
+	size_t then = cfg.AddNode(ControlFlowType_Unconditional);
+	Add<MoveInstr>(then, a, function->MakeConstant(Number(10)));
+	size_t other = cfg.AddNode(ControlFlowType_Normal);
+	Add<MoveInstr>(other, b, function->MakeConstant(Number(20)));
+	size_t merge = cfg.AddNode(ControlFlowType_Exit);
+	AddPhi(merge, result, { a, b });
+	Add<ReturnInstr>(merge, function->MakeVariable(result));
+	AddJump(entry, OpCode_JumpZero, other);
+	AddJump(then, OpCode_Jump, merge);
+
+	cfg.Link(entry, other);
+	cfg.Link(entry, then);
+	cfg.Link(then, merge);
+	cfg.Link(other, merge);
+
+	SparseConditionalConstantPropagation sccp = SparseConditionalConstantPropagation(function.get());
+	EXPECT_EQ(sccp.Run(), OptimizerPassResult_Changed);
+
+	// 1 < 2 never jumps, the other side is gone and the phi only sees the taken edge.
+	ASSERT_EQ(cfg.size(), 3u);
+	EXPECT_EQ(cfg.GetNode(entry)->GetType(), ControlFlowType_Normal);
+	EXPECT_EQ(cfg.GetNode(entry)->GetSuccessors(), std::vector<size_t>{ then });
+	EXPECT_TRUE(function->metadata.phiNodes.empty());
+
+	size_t exit = cfg.GetNode(then)->GetSuccessors()[0];
+	auto* value = dyn_cast<Constant>(ReturnValue(exit));
+	ASSERT_NE(value, nullptr);
+	EXPECT_EQ(value->imm().i32, 10);
+
+	EXPECT_EQ(sccp.Run(), OptimizerPassResult_None);
+}
+
+TEST_F(SCCPTest, MeetsEqualConstantsOverUnknownCondition)
+{
+	auto& cfg = function->cfg;
+	auto input = Temp();
+	auto condition = Temp();
+	auto a = Temp();
+	auto b = Temp();
+	auto result = Temp();
+
+	// input has no definition, so the branch can go either way.
+	size_t entry = cfg.AddNode(ControlFlowType_Conditional);
+	Add<MoveInstr>(entry, condition, function->MakeVariable(input));
+	size_t then = cfg.AddNode(ControlFlowType_Unconditional);
+	Add<MoveInstr>(then, a, function->MakeConstant(Number(7)));
+	size_t other = cfg.AddNode(ControlFlowType_Normal);
+	Add<MoveInstr>(other, b, function->MakeConstant(Number(7)));
+	size_t merge = cfg.AddNode(ControlFlowType_Exit);
+	AddPhi(merge, result, { a, b });
+	Add<ReturnInstr>(merge, function->MakeVariable(result));
+	AddJump(entry, OpCode_JumpZero, other);
+	AddJump(then, OpCode_Jump, merge);
+
+	cfg.Link(entry, other);
+	cfg.Link(entry, then);
+	cfg.Link(then, merge);
+	cfg.Link(other, merge);
+
+	SparseConditionalConstantPropagation sccp = SparseConditionalConstantPropagation(function.get());
+	EXPECT_EQ(sccp.Run(), OptimizerPassResult_Changed);
+
+	EXPECT_EQ(cfg.size(), 4u);
+	EXPECT_TRUE(isa<JumpInstr>(&cfg.GetNode(entry)->GetInstructions().back()));
+	auto* value = dyn_cast<Constant>(ReturnValue(merge));
+	ASSERT_NE(value, nullptr);
+	EXPECT_EQ(value->imm().i32, 7);
+}
+
+TEST_F(SCCPTest, LoopCounterStaysOverdefined)
+{
+	auto& cfg = function->cfg;
+	auto i0 = Temp();
+	auto i1 = Temp();
+	auto i2 = Temp();
+	auto condition = Temp();
+
+	size_t entry = cfg.AddNode(ControlFlowType_Normal);
+	Add<MoveInstr>(entry, i0, function->MakeConstant(Number(0)));
+	size_t header = cfg.AddNode(ControlFlowType_Conditional);
+	AddPhi(header, i1, { i0, i2 });
+	Add<BinaryInstr>(header, OpCode_LessThan, condition, function->MakeVariable(i1), function->MakeConstant(Number(4)));
+	size_t body = cfg.AddNode(ControlFlowType_Unconditional);
+	Add<BinaryInstr>(body, OpCode_Add, i2, function->MakeVariable(i1), function->MakeConstant(Number(1)));
+	AddJump(body, OpCode_Jump, header);
+	size_t exit = cfg.AddNode(ControlFlowType_Exit);
+	Add<ReturnInstr>(exit, function->MakeVariable(i1));
+	AddJump(header, OpCode_JumpZero, exit);
+
+	cfg.Link(entry, header);
+	cfg.Link(header, exit);
+	cfg.Link(header, body);
+	cfg.Link(body, header);
+
+	SparseConditionalConstantPropagation sccp = SparseConditionalConstantPropagation(function.get());
+	EXPECT_EQ(sccp.Run(), OptimizerPassResult_None);
+	EXPECT_EQ(cfg.size(), 4u);
+	EXPECT_EQ(function->metadata.phiNodes.size(), 1u);
+}
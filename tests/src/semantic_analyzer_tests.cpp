@@ -0,0 +1,148 @@
+#include "common.hpp"
+#include <filesystem>
+#include <fstream>
+#include "parsers/parallel_parser.hpp"
+#include "semantics/semantic_analyzer.hpp"
+
+static const char* BodiesSource =
+"struct Light\n"
+"{\n"
+"\tfloat3 direction;\n"
+"\tfloat intensity;\n"
+"};\n"
+"\n"
+"float Lambert(float3 normal, Light light)\n"
+"{\n"
+"\tfloat d = dot(normal, light.direction);\n"
+"\treturn max(d, 0.0) * light.intensity;\n"
+"}\n"
+"\n"
+"float3 Scale(float3 v, float s)\n"
+"{\n"
+"\treturn v * s;\n"
+"}\n"
+"\n"
+"int Count(int n)\n"
+"{\n"
+"\tint total = 0;\n"
+"\tfor (int i = 0; i < n; i++)\n"
+"\t{\n"
+"\t\ttotal += i;\n"
+"\t}\n"
+"\treturn total;\n"
+"}\n"
+"\n"
+"float Broken(float x)\n"
+"{\n"
+"\treturn x + missing;\n"
+"}\n"
+"\n"
+"float3 Mix(float3 a, float3 b, float t)\n"
+"{\n"
+"\tfloat3 scaled = Scale(a, 1.0 - t);\n"
+"\treturn scaled + Scale(b, t);\n"
+"}\n"
+"\n"
+"bool Check(float x)\n"
+"{\n"
+"\treturn x > Lambert(float3(0, 1, 0), undefinedLight);\n"
+"}\n";
+
+// Records the inferred type of every expression in pre-order, unresolved ones included.
+class InferredTypeRecorder : public ASTVisitor<InferredTypeRecorder>
+{
+public:
+	std::vector<std::string> types;
+
+	TraversalBehavior Visit(ASTNode*& node, size_t depth, bool deferred, EmptyDeferralContext& context)
+	{
+		// call parameters count as expressions but only wrap one.
+		auto nodeType = node->GetType();
+		if (IsExpressionType(nodeType) && nodeType != NodeType_FunctionCallParameter)
+		{
+			auto type = static_cast<Expression*>(node)->GetInferredType();
+			types.push_back(type ? type->GetFullyQualifiedName().str() : "<none>");
+		}
+		return TraversalBehavior_Keep;
+	}
+};
+
+class SemanticAnalyzerTest : public ASTContextTest
+{
+protected:
+	std::filesystem::path directory;
+
+	struct AnalysisResult
+	{
+		std::vector<std::string> messages;
+		std::vector<std::string> types;
+	};
+
+	void SetUp() override
+	{
+		ASTContextTest::SetUp();
+		directory = std::filesystem::temp_directory_path() / "hxsl_semantic_tests";
+		std::filesystem::create_directories(directory);
+	}
+
+	void TearDown() override
+	{
+		ASTContextTest::TearDown();
+		std::filesystem::remove_all(directory);
+	}
+
+	std::string WriteFile(const std::string& name, const std::string& content)
+	{
+		auto path = (directory / name).string();
+		std::ofstream(path, std::ios::binary) << content;
+		return path;
+	}
+
+	// every run parses into its own context, the units never share nodes.
+	AnalysisResult Analyze(const std::string& path, size_t threads)
+	{
+		auto runContext = make_uptr<ASTContext>();
+		ASTContext::SetCurrentContext(runContext.get());
+		ILogger runLogger;
+		AssemblyCollection references;
+
+		std::vector<SourceFile*> sources = { runContext->GetSourceManager().AddSource(MappedSource::Open(path.c_str())) };
+		CompilationUnitBuilder builder = CompilationUnitBuilder(&runLogger);
+		ParallelParser(&runLogger, runContext.get(), 1).Parse(sources, builder);
+		auto compilation = builder.Build();
+
+		SemanticAnalyzer analyzer = SemanticAnalyzer(&runLogger, compilation, references);
+		analyzer.SetThreadCount(threads);
+		analyzer.Analyze();
+
+		AnalysisResult result;
+		for (auto& message : runLogger.GetMessages())
+		{
+			result.messages.push_back(std::to_string(message.Level) + ": " + message.Message);
+		}
+
+		InferredTypeRecorder recorder;
+		recorder.Traverse(compilation);
+		result.types = std::move(recorder.types);
+
+		ASTContext::SetCurrentContext(context.get());
+		return result;
+	}
+};
+
+TEST_F(SemanticAnalyzerTest, ParallelBodiesMatchSerialRun)
+{
+	auto path = WriteFile("bodies.hxsl", BodiesSource);
+
+	auto serial = Analyze(path, 1);
+	EXPECT_GE(serial.messages.size(), 2u);
+	EXPECT_FALSE(serial.types.empty());
+
+	// bodies finish in any order, diagnostics and types must not depend on it.
+	for (size_t i = 0; i < 4; i++)
+	{
+		auto parallel = Analyze(path, 4);
+		EXPECT_EQ(parallel.messages, serial.messages);
+		EXPECT_EQ(parallel.types, serial.types);
+	}
+}
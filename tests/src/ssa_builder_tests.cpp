@@ -0,0 +1,122 @@
+#include "il_test_fixture.hpp"
+#include "ssa/ssa_builder.hpp"
+
+class SSABuilderTest : public ILTest
+{
+protected:
+	void Build()
+	{
+		function->cfg.EnsureDomTree();
+		SSABuilder builder = SSABuilder(function.get());
+		builder.Build();
+	}
+
+	static ILVarId VarOf(Operand* operand)
+	{
+		return cast<Variable>(operand)->varId;
+	}
+};
+
+TEST_F(SSABuilderTest, PlacesPhisOnlyForLiveVariables)
+{
+	auto& cfg = function->cfg;
+	auto x = Var();
+	auto y = Var();
+	auto condition = Temp();
+
+	size_t entry = cfg.AddNode(ControlFlowType_Conditional);
+	Add<MoveInstr>(entry, x, function->MakeConstant(Number(1)));
+	Add<MoveInstr>(entry, y, function->MakeConstant(Number(1)));
+	Add<BinaryInstr>(entry, OpCode_LessThan, condition, function->MakeVariable(x), function->MakeConstant(Number(2)));
+	size_t then = cfg.AddNode(ControlFlowType_Unconditional);
+	auto* thenX = Add<MoveInstr>(then, x, function->MakeConstant(Number(2)));
+	Add<MoveInstr>(then, y, function->MakeConstant(Number(2)));
+	size_t other = cfg.AddNode(ControlFlowType_Normal);
+	auto* otherX = Add<MoveInstr>(other, x, function->MakeConstant(Number(3)));
+	Add<MoveInstr>(other, y, function->MakeConstant(Number(3)));
+	size_t merge = cfg.AddNode(ControlFlowType_Exit);
+	auto* ret = Add<ReturnInstr>(merge, function->MakeVariable(x));
+	AddJump(entry, OpCode_JumpZero, other);
+	AddJump(then, OpCode_Jump, merge);
+
+	cfg.Link(entry, other);
+	cfg.Link(entry, then);
+	cfg.Link(then, merge);
+	cfg.Link(other, merge);
+
+	Build();
+
+	EXPECT_EQ(cfg.domFront[then], std::vector<size_t>{ merge });
+	EXPECT_EQ(cfg.domFront[other], std::vector<size_t>{ merge });
+
+	// y is redefined on both sides too, but nothing reads it after the merge.
+	ASSERT_EQ(function->metadata.phiNodes.size(), 1u);
+	auto* phi = function->metadata.phiNodes[0];
+	EXPECT_EQ(phi->GetParent(), cfg.GetNode(merge).get());
+	EXPECT_EQ(phi->GetResult().StripVersion(), x);
+
+	auto& predecessors = cfg.GetNode(merge)->GetPredecessors();
+	ASSERT_EQ(predecessors, (std::vector<size_t>{ then, other }));
+	EXPECT_EQ(VarOf(phi->GetOperand(0)), thenX->GetResult());
+	EXPECT_EQ(VarOf(phi->GetOperand(1)), otherX->GetResult());
+	EXPECT_NE(thenX->GetResult(), otherX->GetResult());
+	EXPECT_EQ(VarOf(ret->GetReturnValue()), phi->GetResult());
+}
+
+TEST_F(SSABuilderTest, RestoresVersionsWhenLeavingDominatorSubtree)
+{
+	auto& cfg = function->cfg;
+	auto x = Var();
+	auto condition = Temp();
+
+	size_t entry = cfg.AddNode(ControlFlowType_Normal);
+	auto* init = Add<MoveInstr>(entry, x, function->MakeConstant(Number(0)));
+	size_t header = cfg.AddNode(ControlFlowType_Conditional);
+	auto* compare = Add<BinaryInstr>(header, OpCode_LessThan, condition, function->MakeVariable(x), function->MakeConstant(Number(4)));
+	size_t body = cfg.AddNode(ControlFlowType_Unconditional);
+	auto* step = Add<BinaryInstr>(body, OpCode_Add, x, function->MakeVariable(x), function->MakeConstant(Number(1)));
+	AddJump(body, OpCode_Jump, header);
+	size_t exit = cfg.AddNode(ControlFlowType_Exit);
+	auto* ret = Add<ReturnInstr>(exit, function->MakeVariable(x));
+	AddJump(header, OpCode_JumpZero, exit);
+
+	cfg.Link(entry, header);
+	cfg.Link(header, exit);
+	cfg.Link(header, body);
+	cfg.Link(body, header);
+
+	Build();
+
+	ASSERT_EQ(function->metadata.phiNodes.size(), 1u);
+	auto* phi = function->metadata.phiNodes[0];
+	EXPECT_EQ(phi->GetParent(), cfg.GetNode(header).get());
+	EXPECT_EQ(VarOf(phi->GetOperand(0)), init->GetResult());
+	EXPECT_EQ(VarOf(phi->GetOperand(1)), step->GetResult());
+
+	// body and exit are siblings under the header, the exit must not see the version the body defined.
+	EXPECT_EQ(VarOf(compare->GetLHS()), phi->GetResult());
+	EXPECT_EQ(VarOf(step->GetLHS()), phi->GetResult());
+	EXPECT_EQ(VarOf(ret->GetReturnValue()), phi->GetResult());
+	EXPECT_NE(step->GetResult(), phi->GetResult());
+}
+
+TEST_F(SSABuilderTest, LeavesVoidCallsWithoutResult)
+{
+	auto& cfg = function->cfg;
+	auto x = Var();
+	auto sum = Temp();
+
+	size_t entry = cfg.AddNode(ControlFlowType_Exit);
+	auto* init = Add<MoveInstr>(entry, x, function->MakeConstant(Number(1)));
+	auto* call = AddVoidCall(entry);
+	auto* add = Add<BinaryInstr>(entry, OpCode_Add, sum, function->MakeVariable(x), function->MakeConstant(Number(1)));
+	auto* ret = Add<ReturnInstr>(entry, function->MakeVariable(sum));
+
+	Build();
+
+	EXPECT_EQ(call->GetResult(), INVALID_VARIABLE);
+	EXPECT_EQ(VarOf(add->GetLHS()), init->GetResult());
+	EXPECT_EQ(VarOf(ret->GetReturnValue()), add->GetResult());
+	EXPECT_EQ(add->GetResult().StripVersion(), sum);
+	EXPECT_TRUE(function->metadata.phiNodes.empty());
+}
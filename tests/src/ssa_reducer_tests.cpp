@@ -0,0 +1,244 @@
+#include "il_test_fixture.hpp"
+#include "ssa/ssa_reducer.hpp"
+#include "optimizers/liveness_analyzer.hpp"
+
+class SSAReducerTest : public ILTest
+{
+protected:
+	std::vector<MoveInstr*> Moves(size_t block)
+	{
+		std::vector<MoveInstr*> moves;
+		for (auto& instr : *function->cfg.GetNode(block))
+		{
+			if (auto move = dyn_cast<MoveInstr>(&instr))
+			{
+				moves.push_back(move);
+			}
+		}
+		return moves;
+	}
+
+	static ILVarId SourceVar(const MoveInstr* move)
+	{
+		return cast<Variable>(move->GetSource())->varId;
+	}
+};
+
+TEST_F(SSAReducerTest, LivenessFollowsLoopAndPhiEdges)
+{
+	auto& cfg = function->cfg;
+	auto i0 = Temp();
+	auto i1 = Temp();
+	auto i2 = Temp();
+	auto condition = Temp();
+
+	size_t entry = cfg.AddNode(ControlFlowType_Normal);
+	Add<MoveInstr>(entry, i0, function->MakeConstant(Number(0)));
+	size_t header = cfg.AddNode(ControlFlowType_Conditional);
+	AddPhi(header, i1, { i0, i2 });
+	Add<BinaryInstr>(header, OpCode_LessThan, condition, function->MakeVariable(i1), function->MakeConstant(Number(4)));
+	size_t body = cfg.AddNode(ControlFlowType_Unconditional);
+	Add<BinaryInstr>(body, OpCode_Add, i2, function->MakeVariable(i1), function->MakeConstant(Number(1)));
+	AddJump(body, OpCode_Jump, header);
+	size_t exit = cfg.AddNode(ControlFlowType_Exit);
+	Add<ReturnInstr>(exit, function->MakeVariable(i1));
+	AddJump(header, OpCode_JumpZero, exit);
+
+	cfg.Link(entry, header);
+	cfg.Link(header, exit);
+	cfg.Link(header, body);
+	cfg.Link(body, header);
+
+	LivenessAnalyzer liveness = LivenessAnalyzer(cfg);
+	liveness.Analyze();
+
+	// phi operands are live out of their own predecessor only, the phi result is born in the header.
+	EXPECT_TRUE(liveness.IsLiveOut(entry, i0));
+	EXPECT_FALSE(liveness.IsLiveIn(header, i0));
+	EXPECT_FALSE(liveness.IsLiveIn(header, i1));
+	EXPECT_TRUE(liveness.IsLiveOut(header, i1));
+	EXPECT_TRUE(liveness.IsLiveIn(body, i1));
+	EXPECT_TRUE(liveness.IsLiveOut(body, i2));
+	EXPECT_FALSE(liveness.IsLiveOut(body, i1));
+	EXPECT_TRUE(liveness.IsLiveIn(exit, i1));
+	EXPECT_FALSE(liveness.GetLiveIn(entry).any());
+	EXPECT_LE(liveness.GetIterationCount(), 3u);
+
+	// i0 dies where the loop starts, the condition is never read as a variable.
+	auto& range0 = liveness.GetRange(liveness.GetSlot(i0));
+	auto& range1 = liveness.GetRange(liveness.GetSlot(i1));
+	auto& rangeCondition = liveness.GetRange(liveness.GetSlot(condition));
+	EXPECT_FALSE(range0.Overlaps(range1));
+	EXPECT_EQ(rangeCondition.start, rangeCondition.end);
+}
+
+TEST_F(SSAReducerTest, CoalescesLoopCounterIntoOneVariable)
+{
+	auto& cfg = function->cfg;
+	auto i0 = Temp();
+	auto i1 = Temp();
+	auto i2 = Temp();
+	auto condition = Temp();
+
+	size_t entry = cfg.AddNode(ControlFlowType_Normal);
+	auto* init = Add<MoveInstr>(entry, i0, function->MakeConstant(Number(0)));
+	size_t header = cfg.AddNode(ControlFlowType_Conditional);
+	AddPhi(header, i1, { i0, i2 });
+	Add<BinaryInstr>(header, OpCode_LessThan, condition, function->MakeVariable(i1), function->MakeConstant(Number(4)));
+	size_t body = cfg.AddNode(ControlFlowType_Unconditional);
+	auto* step = Add<BinaryInstr>(body, OpCode_Add, i2, function->MakeVariable(i1), function->MakeConstant(Number(1)));
+	AddJump(body, OpCode_Jump, header);
+	size_t exit = cfg.AddNode(ControlFlowType_Exit);
+	auto* ret = Add<ReturnInstr>(exit, function->MakeVariable(i1));
+	AddJump(header, OpCode_JumpZero, exit);
+
+	cfg.Link(entry, header);
+	cfg.Link(header, exit);
+	cfg.Link(header, body);
+	cfg.Link(body, header);
+
+	SSAReducer reducer = SSAReducer(function->metadata, cfg);
+	reducer.Reduce();
+
+	EXPECT_TRUE(function->metadata.phiNodes.empty());
+	EXPECT_EQ(cfg.size(), 4u);
+	EXPECT_EQ(cfg.CountInstructions(), 6u);
+	EXPECT_EQ(Moves(body).size(), 0u);
+
+	auto counter = init->GetResult();
+	EXPECT_EQ(step->GetResult(), counter);
+	EXPECT_EQ(cast<Variable>(step->GetLHS())->varId, counter);
+	EXPECT_EQ(cast<Variable>(ret->GetReturnValue())->varId, counter);
+}
+
+TEST_F(SSAReducerTest, BreaksSwapCycleWithTemp)
+{
+	auto& cfg = function->cfg;
+	auto a0 = Temp();
+	auto b0 = Temp();
+	auto a1 = Temp();
+	auto b1 = Temp();
+	auto condition = Temp();
+	auto sum = Temp();
+
+	// a1 and b1 swap on every iteration, neither phi can share a variable with its back edge input.
+	size_t entry = cfg.AddNode(ControlFlowType_Normal);
+	Add<MoveInstr>(entry, a0, function->MakeConstant(Number(1)));
+	Add<MoveInstr>(entry, b0, function->MakeConstant(Number(2)));
+	size_t header = cfg.AddNode(ControlFlowType_Conditional);
+	AddPhi(header, a1, { a0, b1 });
+	AddPhi(header, b1, { b0, a1 });
+	Add<BinaryInstr>(header, OpCode_LessThan, condition, function->MakeVariable(a1), function->MakeConstant(Number(4)));
+	size_t body = cfg.AddNode(ControlFlowType_Unconditional);
+	AddJump(body, OpCode_Jump, header);
+	size_t exit = cfg.AddNode(ControlFlowType_Exit);
+	Add<BinaryInstr>(exit, OpCode_Add, sum, function->MakeVariable(a1), function->MakeVariable(b1));
+	Add<ReturnInstr>(exit, function->MakeVariable(sum));
+	AddJump(header, OpCode_JumpZero, exit);
+
+	cfg.Link(entry, header);
+	cfg.Link(header, exit);
+	cfg.Link(header, body);
+	cfg.Link(body, header);
+
+	SSAReducer reducer = SSAReducer(function->metadata, cfg);
+	reducer.Reduce();
+
+	// t = a; a = b; b = t, all in front of the jump back.
+	auto moves = Moves(body);
+	ASSERT_EQ(moves.size(), 3u);
+	EXPECT_TRUE(isa<JumpInstr>(&cfg.GetNode(body)->GetInstructions().back()));
+
+	auto a = SourceVar(moves[0]);
+	auto temp = moves[0]->GetResult();
+	auto b = SourceVar(moves[1]);
+	EXPECT_NE(a, b);
+	EXPECT_EQ(moves[1]->GetResult(), a);
+	EXPECT_EQ(moves[2]->GetResult(), b);
+	EXPECT_EQ(SourceVar(moves[2]), temp);
+	EXPECT_EQ(Moves(entry).size(), 2u);
+}
+
+TEST_F(SSAReducerTest, SplitsCriticalEdgeForInterferingPhi)
+{
+	auto& cfg = function->cfg;
+	auto x0 = Temp();
+	auto x1 = Temp();
+	auto x2 = Temp();
+	auto condition = Temp();
+	auto sum = Temp();
+
+	// x1 is still read after x2 is computed, the back edge needs a copy and leaves a conditional block.
+	size_t entry = cfg.AddNode(ControlFlowType_Normal);
+	Add<MoveInstr>(entry, x0, function->MakeConstant(Number(0)));
+	size_t body = cfg.AddNode(ControlFlowType_Conditional);
+	AddPhi(body, x1, { x0, x2 });
+	Add<BinaryInstr>(body, OpCode_Add, x2, function->MakeVariable(x1), function->MakeConstant(Number(1)));
+	Add<BinaryInstr>(body, OpCode_LessThan, condition, function->MakeVariable(x2), function->MakeConstant(Number(10)));
+	AddJump(body, OpCode_JumpNotZero, body);
+	size_t exit = cfg.AddNode(ControlFlowType_Exit);
+	Add<BinaryInstr>(exit, OpCode_Add, sum, function->MakeVariable(x1), function->MakeVariable(x2));
+	Add<ReturnInstr>(exit, function->MakeVariable(sum));
+
+	cfg.Link(entry, body);
+	cfg.Link(body, body);
+	cfg.Link(body, exit);
+
+	SSAReducer reducer = SSAReducer(function->metadata, cfg);
+	reducer.Reduce();
+
+	ASSERT_EQ(cfg.size(), 4u);
+	auto& split = *cfg.GetNode(3);
+	EXPECT_EQ(split.GetPredecessors(), std::vector<size_t>{ body });
+	EXPECT_EQ(split.GetSuccessors(), std::vector<size_t>{ body });
+	EXPECT_EQ(cfg.GetNode(body)->GetSuccessors(), (std::vector<size_t>{ 3, exit }));
+
+	auto& jump = *cast<JumpInstr>(&cfg.GetNode(body)->GetInstructions().back());
+	EXPECT_EQ(jump.GetLabel()->label.value, 3u);
+
+	ASSERT_EQ(split.GetInstructions().size(), 2u);
+	auto moves = Moves(3);
+	ASSERT_EQ(moves.size(), 1u);
+	EXPECT_NE(moves[0]->GetResult(), SourceVar(moves[0]));
+	EXPECT_EQ(Moves(body).size(), 0u);
+}
+
+TEST_F(SSAReducerTest, LeavesVoidCallsWithoutResult)
+{
+	auto& cfg = function->cfg;
+	auto i0 = Temp();
+	auto i1 = Temp();
+	auto i2 = Temp();
+	auto condition = Temp();
+
+	size_t entry = cfg.AddNode(ControlFlowType_Normal);
+	auto* init = Add<MoveInstr>(entry, i0, function->MakeConstant(Number(0)));
+	size_t header = cfg.AddNode(ControlFlowType_Conditional);
+	AddPhi(header, i1, { i0, i2 });
+	Add<BinaryInstr>(header, OpCode_LessThan, condition, function->MakeVariable(i1), function->MakeConstant(Number(4)));
+	size_t body = cfg.AddNode(ControlFlowType_Unconditional);
+	auto* call = AddVoidCall(body);
+	auto* step = Add<BinaryInstr>(body, OpCode_Add, i2, function->MakeVariable(i1), function->MakeConstant(Number(1)));
+	AddJump(body, OpCode_Jump, header);
+	size_t exit = cfg.AddNode(ControlFlowType_Exit);
+	Add<ReturnInstr>(exit, function->MakeVariable(i1));
+	AddJump(header, OpCode_JumpZero, exit);
+
+	cfg.Link(entry, header);
+	cfg.Link(header, exit);
+	cfg.Link(header, body);
+	cfg.Link(body, header);
+
+	LivenessAnalyzer liveness = LivenessAnalyzer(cfg);
+	liveness.Analyze();
+	EXPECT_EQ(liveness.GetVarCount(), 4u);
+	EXPECT_EQ(liveness.GetSlot(INVALID_VARIABLE), LivenessAnalyzer::InvalidSlot);
+
+	auto tempCount = function->metadata.tempVariables.size();
+	SSAReducer reducer = SSAReducer(function->metadata, cfg);
+	reducer.Reduce();
+
+	EXPECT_EQ(call->GetResult(), INVALID_VARIABLE);
+	EXPECT_EQ(function->metadata.tempVariables.size(), tempCount);
+	EXPECT_EQ(step->GetResult(), init->GetResult());
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "semantics/symbols/symbol_index.hpp"
+
+using namespace HXSL;
+
+static std::vector<uint8_t> WriteIndex(const SymbolTable& table)
+{
+	auto image = SymbolIndexImage::Build(table, [](SymbolDef*) -> const Backend::Layout* { return nullptr; });
+	MemoryStream stream(64);
+	Backend::ModuleWriter writer(&stream);
+	image->Write(stream, writer);
+
+	auto* data = stream.GetBuffer(false);
+	return std::vector<uint8_t>(data, data + stream.Position());
+}
+
+TEST(SymbolIndexTest, RoundTripsTree)
+{
+	SymbolTable table;
+	table.Insert("Engine.Math.Vector", {});
+	table.Insert("Engine.Math.Matrix", {});
+	table.Insert("Engine.Lighting.BRDF", {});
+	table.Insert("Shared", {});
+
+	auto bytes = WriteIndex(table);
+	EXPECT_EQ(SymbolIndexView::GetSectionSize(bytes.data(), bytes.size()), bytes.size());
+
+	SymbolIndexView view;
+	ASSERT_TRUE(view.Open(bytes.data(), bytes.size()));
+	EXPECT_EQ(view.GetNodeCount(), 8u);
+
+	auto engine = view.FindChild(0, "Engine");
+	ASSERT_NE(engine, SymbolIndexNone);
+	auto math = view.FindChild(engine, "Math");
+	ASSERT_NE(math, SymbolIndexNone);
+	auto matrix = view.FindChild(math, "Matrix");
+	ASSERT_NE(matrix, SymbolIndexNone);
+	EXPECT_EQ(view.GetNode(matrix).name, StringSpan("Matrix"));
+	EXPECT_EQ(view.GetNode(matrix).parent, math);
+	EXPECT_NE(view.FindChild(math, "Vector"), SymbolIndexNone);
+	EXPECT_EQ(view.FindChild(math, "BRDF"), SymbolIndexNone);
+	EXPECT_NE(view.FindChild(0, "Shared"), SymbolIndexNone);
+	EXPECT_EQ(view.FindChild(0, "Math"), SymbolIndexNone);
+}
+
+TEST(SymbolIndexTest, RejectsTruncatedSection)
+{
+	SymbolTable table;
+	table.Insert("A.B", {});
+	auto bytes = WriteIndex(table);
+
+	SymbolIndexView view;
+	EXPECT_FALSE(view.Open(bytes.data(), bytes.size() - 1));
+	EXPECT_FALSE(view.Open(bytes.data(), SymbolIndexView::HeaderSize - 1));
+	bytes[0] = 0;
+	EXPECT_FALSE(view.Open(bytes.data(), bytes.size()));
+}
+
+TEST(SymbolIndexTest, MaterializesOnlyTouchedNodes)
+{
+	SymbolTable source;
+	source.Insert("Engine.Math.Vector", {});
+	source.Insert("Engine.Lighting.BRDF", {});
+	auto bytes = WriteIndex(source);
+
+	SymbolIndex index = SymbolIndex({});
+	ASSERT_TRUE(index.Open(bytes.data(), bytes.size()));
+
+	SymbolTable table;
+	table.AttachIndex(make_uptr<SymbolIndexLoader>(nullptr, &table, index));
+
+	EXPECT_TRUE(table.GetRoot()->GetChildren().empty());
+
+	auto vector = table.FindNodeIndexFullPath("Engine.Math.Vector");
+	ASSERT_TRUE(vector.valid());
+	EXPECT_EQ(table.GetFullyQualifiedName(vector.GetNode()), "Engine.Math.Vector");
+
+	auto* engine = table.GetRoot()->GetChild("Engine");
+	ASSERT_NE(engine, nullptr);
+	EXPECT_EQ(engine->GetChildren().size(), 1u);
+	EXPECT_EQ(engine->GetChild("Lighting"), nullptr);
+
+	EXPECT_TRUE(table.FindNodeIndexFullPath("Engine.Math.Matrix").invalid());
+	EXPECT_EQ(table.FindNodeIndexFullPath("Engine.Math.Vector").GetNode(), vector.GetNode());
+
+	auto lighting = table.FindNodeIndexPart("Lighting", engine);
+	ASSERT_TRUE(lighting.valid());
+	EXPECT_EQ(engine->GetChildren().size(), 2u);
+}
+
+TEST(SymbolIndexTest, MaterializesIntoEveryTableSeparately)
+{
+	SymbolTable source;
+	source.Insert("Engine.Math.Vector", {});
+	source.Insert("Engine.Lighting.BRDF", {});
+	auto bytes = WriteIndex(source);
+
+	SymbolIndex index = SymbolIndex({});
+	ASSERT_TRUE(index.Open(bytes.data(), bytes.size()));
+
+	// every compilation gets its own table over the shared index, loading into one leaves the other untouched.
+	SymbolTable first;
+	first.AttachIndex(make_uptr<SymbolIndexLoader>(nullptr, &first, index));
+	SymbolTable second;
+	second.AttachIndex(make_uptr<SymbolIndexLoader>(nullptr, &second, index));
+
+	auto vector = first.FindNodeIndexFullPath("Engine.Math.Vector");
+	ASSERT_TRUE(vector.valid());
+	EXPECT_TRUE(second.GetRoot()->GetChildren().empty());
+
+	auto brdf = second.FindNodeIndexFullPath("Engine.Lighting.BRDF");
+	ASSERT_TRUE(brdf.valid());
+	EXPECT_EQ(second.GetFullyQualifiedName(brdf.GetNode()), "Engine.Lighting.BRDF");
+	EXPECT_EQ(first.GetRoot()->GetChild("Engine")->GetChild("Lighting"), nullptr);
+	EXPECT_EQ(first.FindNodeIndexFullPath("Engine.Math.Vector").GetNode(), vector.GetNode());
+}
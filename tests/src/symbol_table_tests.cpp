@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "semantics/symbols/symbol_table.hpp"
+
+using namespace HXSL;
+
+TEST(SymbolTableTest, FindsDeepPathsThroughIndex)
+{
+	SymbolTable table;
+	auto leaf = table.Insert("HexaEngine.Materials.PBR.BRDF.X", {});
+	auto sibling = table.Insert("HexaEngine.Materials.PBR.BRDF.Y", {});
+	ASSERT_TRUE(leaf.valid());
+	ASSERT_TRUE(sibling.valid());
+
+	EXPECT_EQ(table.FindNodeIndexFullPath("HexaEngine.Materials.PBR.BRDF.X").GetNode(), leaf.GetNode());
+	EXPECT_EQ(table.FindNodeIndexFullPath("HexaEngine.Materials.PBR.BRDF.Y").GetNode(), sibling.GetNode());
+	EXPECT_TRUE(table.FindNodeIndexFullPath("HexaEngine.Materials.PBR.BRDF.Z").invalid());
+	EXPECT_TRUE(table.FindNodeIndexFullPath("Materials.PBR.BRDF.X").invalid());
+
+	auto pbr = table.FindNodeIndexFullPath("HexaEngine.Materials.PBR");
+	ASSERT_TRUE(pbr.valid());
+	EXPECT_EQ(table.FindNodeIndexFullPath("BRDF.X", pbr.GetNode()).GetNode(), leaf.GetNode());
+	EXPECT_TRUE(table.FindNodeIndexFullPath("PBR.BRDF.X", pbr.GetNode()).invalid());
+}
+
+TEST(SymbolTableTest, KeepsIndexInSyncWithRenameAndRemove)
+{
+	SymbolTable table;
+	auto leaf = table.Insert("A.B.C", {});
+	auto b = table.FindNodeIndexFullPath("A.B");
+	ASSERT_TRUE(b.valid());
+
+	ASSERT_TRUE(table.RenameNode("D", b));
+	EXPECT_TRUE(table.FindNodeIndexFullPath("A.B.C").invalid());
+	EXPECT_EQ(table.FindNodeIndexFullPath("A.D.C").GetNode(), leaf.GetNode());
+
+	table.Remove(b);
+	EXPECT_TRUE(table.FindNodeIndexFullPath("A.D.C").invalid());
+	EXPECT_TRUE(table.FindNodeIndexFullPath("A.D").invalid());
+	EXPECT_TRUE(table.FindNodeIndexFullPath("A").valid());
+}
+
+TEST(SymbolTableTest, FrozenIndexMatchesLiveIndex)
+{
+	SymbolTable table;
+	std::vector<SymbolHandle> handles;
+	for (size_t i = 0; i < 256; i++)
+	{
+		handles.push_back(table.Insert("Root.Group" + std::to_string(i % 16) + ".Item" + std::to_string(i), {}));
+	}
+
+	table.Freeze();
+	for (size_t i = 0; i < handles.size(); i++)
+	{
+		auto path = "Root.Group" + std::to_string(i % 16) + ".Item" + std::to_string(i);
+		EXPECT_EQ(table.FindNodeIndexFullPath(path).GetNode(), handles[i].GetNode());
+	}
+	EXPECT_TRUE(table.FindNodeIndexFullPath("Root.Group0.Item1").invalid());
+
+	// inserting into a frozen table keeps it frozen, the new nodes are found through the overlay or a rebuilt table.
+	std::vector<SymbolHandle> late;
+	for (size_t i = 0; i < 512; i++)
+	{
+		late.push_back(table.Insert("Root.Late" + std::to_string(i), {}));
+		EXPECT_TRUE(table.IsFrozen());
+	}
+	for (size_t i = 0; i < late.size(); i++)
+	{
+		EXPECT_EQ(table.FindNodeIndexFullPath("Root.Late" + std::to_string(i)).GetNode(), late[i].GetNode());
+	}
+	for (size_t i = 0; i < handles.size(); i++)
+	{
+		auto path = "Root.Group" + std::to_string(i % 16) + ".Item" + std::to_string(i);
+		EXPECT_EQ(table.FindNodeIndexFullPath(path).GetNode(), handles[i].GetNode());
+	}
+
+	// removing a node thaws it.
+	table.Remove(late[0]);
+	EXPECT_FALSE(table.IsFrozen());
+	EXPECT_TRUE(table.FindNodeIndexFullPath("Root.Late0").invalid());
+}
+
+TEST(SymbolTableTest, VersionChangesWhenChildrenAreReplaced)
+{
+	SymbolTable table;
+	auto first = table.Insert("Lighting.Diffuse.Overload0", {});
+	auto owner = table.FindNodeIndexFullPath("Lighting.Diffuse");
+	ASSERT_TRUE(owner.valid());
+	auto* node = owner.GetNode();
+
+	// swapping one overload for another keeps the child count, caches keyed on the version must still see the change.
+	uint64_t version = node->GetVersion();
+	size_t childCount = node->GetChildren().size();
+	table.Remove(first);
+	table.Insert("Lighting.Diffuse.Overload1", {});
+	EXPECT_EQ(node->GetChildren().size(), childCount);
+	EXPECT_NE(node->GetVersion(), version);
+
+	version = node->GetVersion();
+	ASSERT_TRUE(table.RenameNode("Overload2", table.FindNodeIndexFullPath("Lighting.Diffuse.Overload1")));
+	EXPECT_NE(node->GetVersion(), version);
+
+	version = node->GetVersion();
+	table.FindNodeIndexFullPath("Lighting.Diffuse.Overload2");
+	EXPECT_EQ(node->GetVersion(), version);
+}
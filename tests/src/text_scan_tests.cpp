@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <random>
+#include "utils/text_scan.hpp"
+
+using namespace TextScan;
+
+struct ScanResult
+{
+	size_t offset;
+	size_t counter;
+
+	bool operator==(const ScanResult& other) const { return offset == other.offset && counter == other.counter; }
+};
+
+static std::ostream& operator<<(std::ostream& os, const ScanResult& result)
+{
+	return os << "{ offset: " << result.offset << ", counter: " << result.counter << " }";
+}
+
+class TextScanTest : public ::testing::Test
+{
+protected:
+	ScanLevel previousLevel = ScanLevel_Scalar;
+
+	void SetUp() override
+	{
+		previousLevel = GetScanLevel();
+	}
+
+	void TearDown() override
+	{
+		SetScanLevel(previousLevel);
+	}
+
+	// Runs every kernel at every offset of text with the given level and returns the results in a fixed order.
+	static std::vector<ScanResult> RunAll(ScanLevel level, const std::string& text)
+	{
+		SetScanLevel(level);
+		const char* data = text.data();
+		size_t length = text.size();
+
+		std::vector<ScanResult> results;
+		for (size_t offset = 0; offset <= length; offset++)
+		{
+			results.push_back({ SkipBlanks(data, offset, length), 0 });
+
+			size_t lines = 0;
+			size_t end = SkipWhitespace(data, offset, length, lines);
+			results.push_back({ end, lines });
+
+			results.push_back({ SkipIdentifierChars(data, offset, length), 0 });
+			results.push_back({ FindLineBreak(data, offset, length), 0 });
+
+			size_t lineFeeds = 0;
+			end = FindDelimiterOrEscape(data, offset, length, '"', '"', lineFeeds);
+			results.push_back({ end, lineFeeds });
+
+			lineFeeds = 0;
+			end = FindDelimiterOrEscape(data, offset, length, '*', '/', lineFeeds);
+			results.push_back({ end, lineFeeds });
+		}
+		return results;
+	}
+
+	static void ExpectLevelsAgree(const std::string& text)
+	{
+		auto expected = RunAll(ScanLevel_Scalar, text);
+		for (int level = ScanLevel_SSE2; level <= GetMaxScanLevel(); ++level)
+		{
+			auto actual = RunAll(static_cast<ScanLevel>(level), text);
+			ASSERT_EQ(actual.size(), expected.size());
+			for (size_t i = 0; i < expected.size(); i++)
+			{
+				ASSERT_EQ(actual[i], expected[i])
+					<< ToString(static_cast<ScanLevel>(level)) << " disagrees with Scalar, kernel " << i % 6 << " at offset " << i / 6;
+			}
+		}
+	}
+};
+
+TEST_F(TextScanTest, KernelsAgreeOnRandomInput)
+{
+	// Every byte class the kernels distinguish, plus bytes >= 0x80 that must never be treated as blank or identifier chars.
+	static const char alphabet[] =
+	{
+		' ', '\t', '\v', '\f', '\r', '\n', 'a', 'z', 'A', 'Z', '0', '9', '_', '"', '*', '/', '\\', '@', '`', '{', '[', '\x7F',
+		'\x80', '\x85', '\xA0', '\xC3', '\xE1', '\xFF',
+	};
+
+	std::mt19937 rng(1234);
+	std::uniform_int_distribution<size_t> pick(0, sizeof(alphabet) - 1);
+	std::uniform_int_distribution<size_t> run(1, 40);
+
+	for (size_t iteration = 0; iteration < 64; iteration++)
+	{
+		std::string text;
+		while (text.size() < 160)
+		{
+			// Runs of a single byte reach across chunk boundaries more often than independent bytes.
+			text.append(run(rng), alphabet[pick(rng)]);
+		}
+		ExpectLevelsAgree(text);
+	}
+}
+
+TEST_F(TextScanTest, CRLFSplitAcrossChunkBoundaries)
+{
+	for (size_t split = 1; split < 70; split++)
+	{
+		std::string text(80, ' ');
+		text[split - 1] = '\r';
+		text[split] = '\n';
+		text.push_back('x');
+
+		ExpectLevelsAgree(text);
+
+		for (int level = ScanLevel_Scalar; level <= GetMaxScanLevel(); ++level)
+		{
+			SetScanLevel(static_cast<ScanLevel>(level));
+			size_t lines = 0;
+			size_t end = SkipWhitespace(text.data(), 0, text.size(), lines);
+			EXPECT_EQ(end, text.size() - 1) << ToString(static_cast<ScanLevel>(level)) << " split at " << split;
+			EXPECT_EQ(lines, 1u) << ToString(static_cast<ScanLevel>(level)) << " split at " << split;
+		}
+	}
+}
+
+TEST_F(TextScanTest, HighBytesStopRuns)
+{
+	for (int level = ScanLevel_Scalar; level <= GetMaxScanLevel(); ++level)
+	{
+		SetScanLevel(static_cast<ScanLevel>(level));
+		for (size_t position = 0; position < 70; position++)
+		{
+			std::string blanks(80, ' ');
+			blanks[position] = '\xA0';
+			size_t lines = 0;
+			EXPECT_EQ(SkipBlanks(blanks.data(), 0, blanks.size()), position);
+			EXPECT_EQ(SkipWhitespace(blanks.data(), 0, blanks.size(), lines), position);
+
+			std::string identifier(80, 'a');
+			identifier[position] = '\xC3';
+			EXPECT_EQ(SkipIdentifierChars(identifier.data(), 0, identifier.size()), position);
+		}
+	}
+}
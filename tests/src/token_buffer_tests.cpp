@@ -0,0 +1,192 @@
+#include "common.hpp"
+#include "lexical/token_buffer.hpp"
+
+class TokenBufferTest : public ASTContextTest
+{
+protected:
+	SourceFile* source = nullptr;
+	uptr<LexerContext> lexerContext;
+
+	void Load(const std::string& text)
+	{
+		source = context->GetSourceManager().AddSource(nullptr, false);
+		source->GetInputStream()->Write(text.data(), text.size());
+		lexerContext = make_uptr<LexerContext>(context->GetIdentifierTable(), source, source->GetInputStream().get(), &logger, HXSLLexerConfig::Instance());
+	}
+
+	static void ExpectSameToken(const Token& actual, const Token& expected, size_t index)
+	{
+		EXPECT_EQ(actual.Type, expected.Type) << "token " << index;
+		EXPECT_EQ(actual.Span.source, expected.Span.source) << "token " << index;
+		EXPECT_EQ(actual.Span.start, expected.Span.start) << "token " << index;
+		EXPECT_EQ(actual.Span.length, expected.Span.length) << "token " << index;
+		EXPECT_EQ(actual.Span.line, expected.Span.line) << "token " << index;
+		EXPECT_EQ(actual.Span.column, expected.Span.column) << "token " << index;
+		switch (expected.Type)
+		{
+		case TokenType_Numeric:
+			EXPECT_EQ(actual.Numeric.ToString(), expected.Numeric.ToString()) << "token " << index;
+			break;
+		case TokenType_Identifier:
+			EXPECT_EQ(actual.ii, expected.ii) << "token " << index;
+			break;
+		default:
+			EXPECT_EQ(actual.Value, expected.Value) << "token " << index;
+			break;
+		}
+	}
+};
+
+static const char* TokenBufferSource =
+"// leading comment\r\n"
+"namespace Lighting\r\n"
+"{\n"
+"\tfloat Diffuse(float3 normal, float3 light) /* inline */\n"
+"\t{\n"
+"\t\tstring name = \"diffuse \\\"term\\\"\";\r"
+"\t\treturn saturate(dot(normal, light)) * 0x1F + 2.5f - 1e3;\n"
+"\t}\n"
+"}\n";
+
+TEST_F(TokenBufferTest, RoundTripsStreamingLexer)
+{
+	Load(TokenBufferSource);
+
+	// the reference is the plain lexer loop, including the lexer state directly after every kept token.
+	std::vector<Token> expectedTokens;
+	std::vector<LexerState> expectedStates;
+	LexerState state = lexerContext->MakeState();
+	while (!state.IsEOF())
+	{
+		Token token = Lexer::TokenizeStep(state);
+		state.Advance();
+		if (token.Type == TokenType_Comment || token.Type == TokenType_Unknown)
+		{
+			continue;
+		}
+		expectedTokens.push_back(token);
+		expectedStates.push_back(state);
+	}
+
+	TokenBuffer buffer;
+	ASSERT_TRUE(buffer.Tokenize(lexerContext.get()));
+	ASSERT_EQ(buffer.Size(), expectedTokens.size());
+
+	size_t anchorHint = 0;
+	for (size_t i = 0; i < buffer.Size(); i++)
+	{
+		ExpectSameToken(buffer.GetToken(i, anchorHint), expectedTokens[i], i);
+		ExpectSameToken(buffer.GetToken(i), expectedTokens[i], i);
+
+		LexerState restored = lexerContext->MakeState();
+		buffer.RestoreLexerState(i, restored, anchorHint);
+		EXPECT_EQ(restored.Index, expectedStates[i].Index) << "token " << i;
+		EXPECT_EQ(restored.Line, expectedStates[i].Line) << "token " << i;
+		EXPECT_EQ(restored.Column, expectedStates[i].Column) << "token " << i;
+	}
+
+	LexerState end = lexerContext->MakeState();
+	buffer.RestoreLexerState(buffer.Size(), end, anchorHint);
+	EXPECT_EQ(end.Index, state.Index);
+	EXPECT_EQ(end.Line, state.Line);
+	EXPECT_EQ(end.Column, state.Column);
+	EXPECT_FALSE(logger.HasErrors());
+}
+
+TEST_F(TokenBufferTest, BufferedStreamMatchesStreamingAcrossBacktracking)
+{
+	Load(TokenBufferSource);
+
+	TokenBuffer buffer;
+	ASSERT_TRUE(buffer.Tokenize(lexerContext.get()));
+
+	TokenStream streaming = TokenStream(lexerContext.get());
+	TokenStream buffered = TokenStream(lexerContext.get(), &buffer);
+
+	size_t index = 0;
+	auto step = [&]()
+		{
+			streaming.Advance();
+			buffered.Advance();
+			ExpectSameToken(buffered.Current(), streaming.Current(), index);
+			EXPECT_EQ(buffered.GetLexerState().Index, streaming.GetLexerState().Index) << "token " << index;
+			EXPECT_EQ(buffered.GetLexerState().Line, streaming.GetLexerState().Line) << "token " << index;
+			EXPECT_EQ(buffered.GetLexerState().Column, streaming.GetLexerState().Column) << "token " << index;
+			index++;
+		};
+
+	while (streaming.CanAdvance())
+	{
+		// every few tokens both streams speculate ahead and roll back, the buffered one must land on the same token.
+		if (index % 3 == 0)
+		{
+			streaming.PushState();
+			buffered.PushState();
+			size_t saved = index;
+			for (size_t i = 0; i < 4 && streaming.CanAdvance(); i++)
+			{
+				step();
+			}
+			streaming.PopState();
+			buffered.PopState();
+			index = saved;
+			ExpectSameToken(buffered.Current(), streaming.Current(), index);
+		}
+		step();
+	}
+	EXPECT_EQ(buffered.IsEndOfTokens(), streaming.IsEndOfTokens());
+}
+
+TEST_F(TokenBufferTest, RebindReinternsIdentifiers)
+{
+	Load(TokenBufferSource);
+
+	TokenBuffer buffer;
+	ASSERT_TRUE(buffer.Tokenize(lexerContext.get()));
+
+	IdentifierTable otherTable;
+	TokenBuffer rebound;
+	rebound.Rebind(buffer, source->GetID(), otherTable);
+
+	ASSERT_EQ(rebound.Size(), buffer.Size());
+	for (size_t i = 0; i < buffer.Size(); i++)
+	{
+		Token original = buffer.GetToken(i);
+		Token copy = rebound.GetToken(i);
+		if (original.Type == TokenType_Identifier)
+		{
+			EXPECT_EQ(copy.ii, otherTable.Find(original.ii->name.str())) << "token " << i;
+			EXPECT_EQ(copy.ii->name.str(), original.ii->name.str()) << "token " << i;
+			copy.ii = original.ii;
+		}
+		ExpectSameToken(copy, original, i);
+	}
+}
+
+TEST_F(TokenBufferTest, LexerErrorsPrecedeParserErrors)
+{
+	// the parser error in A comes first in the text, the invalid token at the end is still reported before it
+	// because the whole source is lexed before parsing starts, and only once even though the parser backtracks.
+	Load(
+		"float A() { return 1 }\n"
+		"float B() { return 2; } `\n");
+
+	TokenBuffer buffer;
+	ASSERT_TRUE(buffer.Tokenize(lexerContext.get()));
+	TokenStream stream = TokenStream(lexerContext.get(), &buffer);
+	Parser parser = Parser(&logger, stream);
+	CompilationUnitBuilder builder = CompilationUnitBuilder(&logger);
+	parser.Parse(builder);
+
+	auto& records = logger.GetRecords();
+	ASSERT_GE(records.size(), 2u);
+	EXPECT_EQ(records[0].code, INVALID_TOKEN);
+
+	size_t invalidTokens = 0;
+	for (auto& record : records)
+	{
+		invalidTokens += record.code == INVALID_TOKEN;
+	}
+	EXPECT_EQ(invalidTokens, 1u);
+	EXPECT_NE(records.back().code, INVALID_TOKEN);
+}
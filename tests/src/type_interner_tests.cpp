@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include "ast_modules/swizzle_manager.hpp"
+#include <set>
+
+using namespace HXSL;
+
+static uint8_t LegacySwizzleMask(const std::string& pattern)
+{
+	uint8_t mask = 0;
+	size_t shift = 0;
+	for (char c : pattern)
+	{
+		int i = std::string("xyzw").find(c);
+		mask = (i & 0x3) | (mask << shift);
+		shift += 2;
+	}
+	return mask;
+}
+
+TEST(TypeInternerTest, SwizzleTableCoversEveryPattern)
+{
+	std::set<std::string> names;
+	for (size_t i = 0; i < SwizzlePatternCount; i++)
+	{
+		auto& pattern = SwizzleManager::GetPattern(static_cast<uint16_t>(i));
+		std::string name = pattern.name;
+		ASSERT_EQ(name.size(), pattern.length);
+		EXPECT_EQ(pattern.mask, LegacySwizzleMask(name)) << name;
+
+		uint16_t index;
+		ASSERT_TRUE(SwizzleManager::TryDecodeSwizzle(name, index));
+		EXPECT_EQ(index, i);
+		names.insert(name);
+	}
+	EXPECT_EQ(names.size(), SwizzlePatternCount);
+}
+
+TEST(TypeInternerTest, SwizzleSpellingsShareIndex)
+{
+	uint16_t xyz, rgb, stp;
+	ASSERT_TRUE(SwizzleManager::TryDecodeSwizzle("xyz", xyz));
+	ASSERT_TRUE(SwizzleManager::TryDecodeSwizzle("rgb", rgb));
+	ASSERT_TRUE(SwizzleManager::TryDecodeSwizzle("stp", stp));
+	EXPECT_EQ(xyz, rgb);
+	EXPECT_EQ(xyz, stp);
+	EXPECT_EQ(SwizzleManager::GetPattern(xyz).maxLane, 2);
+
+	uint16_t index;
+	EXPECT_FALSE(SwizzleManager::TryDecodeSwizzle("", index));
+	EXPECT_FALSE(SwizzleManager::TryDecodeSwizzle("xyzwx", index));
+	EXPECT_FALSE(SwizzleManager::TryDecodeSwizzle("xk", index));
+}
+
+TEST(TypeInternerTest, CreatesEachKeyOnce)
+{
+	TypeInterner interner;
+	SymbolDef* element = reinterpret_cast<SymbolDef*>(uintptr_t(0x10));
+	SymbolDef* created = reinterpret_cast<SymbolDef*>(uintptr_t(0x20));
+
+	size_t calls = 0;
+	auto factory = [&]() -> InternedType { calls++; return { created, {} }; };
+	EXPECT_EQ(interner.GetOrCreate(ArrayTypeKey{ element, 4 }, factory).def, created);
+	EXPECT_EQ(interner.GetOrCreate(ArrayTypeKey{ element, 4 }, factory).def, created);
+	EXPECT_EQ(calls, 1u);
+
+	interner.GetOrCreate(ArrayTypeKey{ element, 8 }, factory);
+	interner.GetOrCreate(PointerTypeKey{ element }, factory);
+	EXPECT_EQ(calls, 3u);
+	EXPECT_EQ(interner.GetArrayCount(), 2u);
+	EXPECT_EQ(interner.GetPointerCount(), 1u);
+
+	auto failing = [&]() -> InternedType { calls++; return {}; };
+	EXPECT_EQ(interner.GetOrCreate(PointerTypeKey{ created }, failing).def, nullptr);
+	EXPECT_EQ(interner.GetOrCreate(PointerTypeKey{ created }, failing).def, nullptr);
+	EXPECT_EQ(calls, 5u);
+	EXPECT_EQ(interner.GetPointerCount(), 1u);
+}
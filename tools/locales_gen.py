@@ -140,7 +140,6 @@ def generate_header_file(output_file: str, messages: list[DiagMessage]):
         writer.writeln()
 
         writer.writeln("#include <memory>")
-        writer.writeln("#include <unordered_map>")
         writer.writeln("#include <string>")
         writer.writeln("#include \"logging/diagnostic_code.hpp\"")
         writer.writeln("#include \"logging/logger.hpp\"")
@@ -151,11 +150,8 @@ def generate_header_file(output_file: str, messages: list[DiagMessage]):
 
         writer.beginblock("namespace HXSL")
 
-        writer.writeln(f"extern std::unique_ptr<std::unordered_map<uint64_t, std::string>> current_locale_map;")
-        writer.writeln()
-
         writer.writeln("extern void SetLocale(const std::string& language_code);")
-        writer.writeln("extern std::string GetMessageForCode(uint64_t code);")
+        writer.writeln("extern StringSpan GetMessageForCode(uint64_t code);")
         writer.writeln("extern std::string GetStringForCode(uint64_t code);")
         writer.writeln("extern LogLevel GetLogLevelForCode(uint64_t code);")
         writer.writeln("extern uint64_t EncodeCodeId(LogLevel level, const std::string& input);")
@@ -3,21 +3,45 @@ import struct
 from diag_message import DiagMessage
 
 MAGIC_STRING = "TRANSL" 
-CURRENT_VERSION = 1  
+CURRENT_VERSION = 2
+BLOCK_SIZE = 4096 # uncompressed bytes per block, a lookup only decompresses the block holding its message.
 
+# Layout, must match frontend/src/localization.cpp:
+# magic, uint32 version, uint32 entry count, uint32 block count,
+# entries sorted by code (uint64 code, uint32 block, uint32 offset, uint32 length, uint32 reserved),
+# blocks (uint64 file offset, uint32 compressed size, uint32 size),
+# then every block as an independent zstd frame.
 def write_translations(filename: str, messages: list[DiagMessage]):
+    entries = sorted(((msg.lookup_id.value, (msg.message or "").encode('utf-8')) for msg in messages), key=lambda e: e[0])
+
+    index = list[tuple[int, int, int, int]]()
+    blocks = list[bytearray]()
+    current = bytearray()
+    for code, value_bytes in entries:
+        if current and len(current) + len(value_bytes) > BLOCK_SIZE:
+            blocks.append(current)
+            current = bytearray()
+        index.append((code, len(blocks), len(current), len(value_bytes)))
+        current += value_bytes
+
+    if index and index[-1][1] == len(blocks):
+        blocks.append(current)
+
+    cctx = zstd.ZstdCompressor(level=3)
+    compressed = [cctx.compress(bytes(block)) for block in blocks]
+
+    offset = len(MAGIC_STRING) + 4 * 3 + len(index) * 24 + len(blocks) * 16
+
     with open(filename, 'wb') as f:
         f.write(MAGIC_STRING.encode('utf-8'))
-        f.write(struct.pack('I', CURRENT_VERSION))
-        f.write(struct.pack('Q', len(messages)))
-
-        cctx = zstd.ZstdCompressor(level=3)
-        with cctx.stream_writer(f) as writer:
-            for msg in messages:
-                value_bytes = (msg.message or "").encode('utf-8') 
-                str_length = struct.pack('I', len(value_bytes)) 
-        
-                writer.write(struct.pack('Q', msg.lookup_id.value))
-                writer.write(str_length)
-                writer.write(value_bytes)
-            writer.flush(zstd.FLUSH_FRAME)
\ No newline at end of file
+        f.write(struct.pack('<III', CURRENT_VERSION, len(index), len(blocks)))
+
+        for code, block, start, length in index:
+            f.write(struct.pack('<QIIII', code, block, start, length, 0))
+
+        for block, frame in zip(blocks, compressed):
+            f.write(struct.pack('<QII', offset, len(frame), len(block)))
+            offset += len(frame)
+
+        for frame in compressed:
+            f.write(frame)
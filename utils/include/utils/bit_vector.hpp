@@ -0,0 +1,110 @@
+#ifndef HEXA_UTILS_BIT_VECTOR_HPP
+#define HEXA_UTILS_BIT_VECTOR_HPP
+
+#include "common.hpp"
+#include <bit>
+
+namespace HEXA_UTILS_NAMESPACE
+{
+	// fixed size set of small integers stored as one bit each, the set operations work a word at a time.
+	class bit_vector
+	{
+		using word_type = uint64_t;
+		static constexpr size_t word_bits = sizeof(word_type) * 8;
+
+		std::vector<word_type> words;
+		size_t size_m = 0;
+
+		static size_t word_count(size_t bits) noexcept { return (bits + word_bits - 1) / word_bits; }
+
+	public:
+		bit_vector() = default;
+		explicit bit_vector(size_t size) : words(word_count(size)), size_m(size) {}
+
+		size_t size() const noexcept { return size_m; }
+
+		void resize(size_t size)
+		{
+			words.resize(word_count(size));
+			if (size < size_m && size % word_bits != 0)
+			{
+				words.back() &= (static_cast<word_type>(1) << (size % word_bits)) - 1;
+			}
+			size_m = size;
+		}
+
+		bool test(size_t index) const noexcept { return (words[index / word_bits] >> (index % word_bits)) & 1; }
+
+		void set(size_t index) noexcept { words[index / word_bits] |= static_cast<word_type>(1) << (index % word_bits); }
+
+		void reset(size_t index) noexcept { words[index / word_bits] &= ~(static_cast<word_type>(1) << (index % word_bits)); }
+
+		void clear() noexcept { std::fill(words.begin(), words.end(), 0); }
+
+		bool any() const noexcept
+		{
+			for (auto word : words)
+			{
+				if (word) return true;
+			}
+			return false;
+		}
+
+		size_t count() const noexcept
+		{
+			size_t result = 0;
+			for (auto word : words)
+			{
+				result += std::popcount(word);
+			}
+			return result;
+		}
+
+		// returns true if a bit was added.
+		bool union_with(const bit_vector& other) noexcept
+		{
+			word_type added = 0;
+			for (size_t i = 0; i < words.size(); ++i)
+			{
+				added |= other.words[i] & ~words[i];
+				words[i] |= other.words[i];
+			}
+			return added != 0;
+		}
+
+		void subtract(const bit_vector& other) noexcept
+		{
+			for (size_t i = 0; i < words.size(); ++i)
+			{
+				words[i] &= ~other.words[i];
+			}
+		}
+
+		void intersect(const bit_vector& other) noexcept
+		{
+			for (size_t i = 0; i < words.size(); ++i)
+			{
+				words[i] &= other.words[i];
+			}
+		}
+
+		template<typename Callback>
+		void for_each(Callback&& callback) const
+		{
+			for (size_t i = 0; i < words.size(); ++i)
+			{
+				word_type word = words[i];
+				while (word)
+				{
+					callback(i * word_bits + std::countr_zero(word));
+					word &= word - 1;
+				}
+			}
+		}
+
+		bool operator==(const bit_vector& other) const noexcept { return size_m == other.size_m && words == other.words; }
+		bool operator!=(const bit_vector& other) const noexcept { return !(*this == other); }
+	};
+}
+
+#endif
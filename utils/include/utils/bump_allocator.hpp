@@ -88,6 +88,22 @@ namespace HXSL
 			return CreateBlock(size > MaxDoublingSize ? size : size * 2)->Alloc(size, alignment);
 		}
 
+		// Takes over every block of other, memory allocated from other lives as long as this allocator.
+		void Adopt(BumpAllocator& other) noexcept
+		{
+			if (other.tail == nullptr) return;
+			if (tail == nullptr)
+			{
+				head = other.head;
+			}
+			else
+			{
+				other.head->prev = tail;
+			}
+			tail = other.tail;
+			other.head = other.tail = nullptr;
+		}
+
 		void Reset() noexcept
 		{
 			auto cur = tail;
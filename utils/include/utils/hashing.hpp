@@ -84,6 +84,23 @@ public:
 	void Combine(int8_t value) { Combine(&value, sizeof(int8_t)); }
 };
 
+// Incremental XXH3 for a handful of words, folds every value in with the running hash as seed. Unlike XXHash3_64 it needs no heap allocated state.
+struct XXHash3Chain
+{
+	uint64_t hash = 0;
+
+	void Combine(uint64_t value)
+	{
+		hash = XXH3_64bits_withSeed(&value, sizeof(uint64_t), hash);
+	}
+
+	template<typename T>
+	void Combine(T value)
+	{
+		Combine(static_cast<uint64_t>(value));
+	}
+};
+
 class XXHash3_64 : public HashAlgorithm<XXHash3_64>
 {
 	XXH3_state_t* state;
@@ -34,6 +34,7 @@ namespace HXSL
 
 		static constexpr IndexType INVALID_INDEX = std::numeric_limits<IndexType>::max();
 
+	public:
 		struct Node
 		{
 			IndexType parentIndex;
@@ -50,6 +51,7 @@ namespace HXSL
 			}
 		};
 
+	private:
 		std::vector<Node> nodes;
 		IndexType root = INVALID_INDEX;
 
@@ -300,7 +302,10 @@ namespace HXSL
 				{
 					if (node.left == INVALID_INDEX)
 					{
-						current = node.left = AddNode(current, interval, value);
+						// AddNode may grow nodes, node must not be used past it.
+						auto added = AddNode(current, interval, value);
+						nodes[current].left = added;
+						current = added;
 						break;
 					}
 					else
@@ -312,7 +317,9 @@ namespace HXSL
 				{
 					if (node.right == INVALID_INDEX)
 					{
-						current = node.right = AddNode(current, interval, value);
+						auto added = AddNode(current, interval, value);
+						nodes[current].right = added;
+						current = added;
 						break;
 					}
 					else
@@ -366,6 +373,26 @@ namespace HXSL
 			RemoveAt(current);
 		}
 
+		// Moves every start and end at or after position by delta, used to follow text edits without rebuilding.
+		// A negative delta must not move an endpoint before one that stays, the order of the intervals is kept as is.
+		void Shift(const IntervalT& position, std::make_signed_t<IntervalT> delta)
+		{
+			for (auto& node : nodes)
+			{
+				if (node.interval.start >= position) node.interval.start += delta;
+				if (node.interval.end >= position) node.interval.end += delta;
+				if (node.maxEnd >= position) node.maxEnd += delta;
+			}
+		}
+
+		void Clear()
+		{
+			nodes.clear();
+			root = INVALID_INDEX;
+		}
+
+		size_t Size() const noexcept { return nodes.size(); }
+
 		void SearchOverlapping(const Interval& i, std::vector<const Node*>& result) const
 		{
 			if (root == INVALID_INDEX) return;
@@ -400,6 +427,45 @@ namespace HXSL
 		{
 			SearchOverlapping(Interval(point, point + 1), result);
 		}
+
+		// Stops at the first interval containing point whose value satisfies match, unlike SearchOverlapping it doesn't allocate.
+		template<typename Match>
+		bool AnyContaining(const IntervalT& point, Match&& match) const
+		{
+			if (root == INVALID_INDEX) return false;
+
+			// every popped node pushes at most two children, so the stack never holds more than the tree height plus one.
+			IndexType stack[sizeof(IndexType) * 16];
+			size_t top = 0;
+			stack[top++] = root;
+
+			while (top > 0)
+			{
+				const Node& node = nodes[stack[--top]];
+				if (node.maxEnd <= point)
+				{
+					continue;
+				}
+
+				if (node.interval.start <= point && point < node.interval.end && match(node.value))
+				{
+					return true;
+				}
+
+				if (node.left != INVALID_INDEX)
+				{
+					stack[top++] = node.left;
+				}
+
+				// everything right of a node starts at or after it.
+				if (node.right != INVALID_INDEX && node.interval.start <= point)
+				{
+					stack[top++] = node.right;
+				}
+			}
+
+			return false;
+		}
 	};
 }
 
@@ -0,0 +1,134 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include "pch/std.hpp"
+#include <atomic>
+
+namespace HXSL
+{
+	// Collects nested scopes and counters from every thread while a session runs and exports them as Chrome trace events,
+	// viewable in chrome://tracing or Perfetto. Outside of a session a scope costs a single atomic load.
+	// Only one session can run at a time, events are recorded into per thread buffers whose lock is only contended while a
+	// trace is written. Every event carries the session it was started in, scopes still open when the next session begins
+	// are dropped instead of landing in it with timestamps relative to the wrong origin.
+	class Profiler
+	{
+	public:
+		struct Arg
+		{
+			const char* name;
+			int64_t value;
+		};
+
+		enum EventType : uint8_t
+		{
+			EventType_Scope,
+			EventType_Counter,
+		};
+
+		struct Event
+		{
+			const char* name; // must outlive the session, usually a literal.
+			std::string detail; // appended to the name, attributes the scope to e.g. a pass or a function.
+			uint64_t start; // ns since the session began.
+			uint64_t duration;
+			uint32_t generation; // session the event was started in.
+			EventType type;
+			uint32_t argCount;
+			Arg args[2]; // a counter stores its delta in args[0].
+		};
+
+	private:
+		static std::atomic<bool> enabled;
+		static std::atomic<uint32_t> generation;
+
+	public:
+		static bool IsEnabled() noexcept
+		{
+			return enabled.load(std::memory_order_acquire);
+		}
+
+		// Starts recording and drops the events of the previous session, returns false if a session is already running.
+		static bool Begin();
+
+		// Stops recording, scopes that are still open are recorded once they close.
+		static void End();
+
+		// identifies the current session, read before Now() so a scope never pairs an old session with the new origin.
+		static uint32_t GetGeneration() noexcept
+		{
+			return generation.load(std::memory_order_acquire);
+		}
+
+		static uint64_t Now() noexcept;
+
+		static void Record(Event&& event);
+
+		// Adds delta to the named counter, the trace shows the running total over time.
+		static void Count(const char* name, int64_t delta)
+		{
+			if (!IsEnabled()) return;
+			uint32_t session = GetGeneration();
+			Record({ name, {}, Now(), 0, session, EventType_Counter, 1, { { name, delta } } });
+		}
+
+		// Writes the events of the last session in the JSON object format of the trace event spec, threads may keep recording meanwhile.
+		static void WriteChromeTrace(std::ostream& stream);
+
+		static bool WriteChromeTrace(const std::string& path);
+	};
+
+	class ProfileScope
+	{
+		const char* name;
+		bool active;
+		uint32_t argCount = 0;
+		uint32_t generation = 0;
+		uint64_t start = 0;
+		std::string detail;
+		Profiler::Arg args[2] = {};
+
+	public:
+		ProfileScope(const char* name) : name(name), active(Profiler::IsEnabled())
+		{
+			if (!active) return;
+			generation = Profiler::GetGeneration();
+			start = Profiler::Now();
+		}
+
+		// detailFunc is only called while profiling, building the detail string costs nothing otherwise.
+		template <typename DetailFunc>
+		ProfileScope(const char* name, DetailFunc&& detailFunc) : name(name), active(Profiler::IsEnabled())
+		{
+			if (!active) return;
+			detail = detailFunc();
+			generation = Profiler::GetGeneration();
+			start = Profiler::Now();
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+		~ProfileScope()
+		{
+			if (!active) return;
+			uint64_t end = Profiler::Now();
+			Profiler::Record({ name, std::move(detail), start, end - start, generation, Profiler::EventType_Scope, argCount, { args[0], args[1] } });
+		}
+
+		bool IsActive() const noexcept { return active; }
+
+		void AddArg(const char* argName, int64_t value) noexcept
+		{
+			if (!active || argCount == 2) return;
+			args[argCount++] = { argName, value };
+		}
+	};
+
+#define HXSL_PROFILE_CONCAT_INNER(a, b) a##b
+#define HXSL_PROFILE_CONCAT(a, b) HXSL_PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ::HXSL::ProfileScope HXSL_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_SCOPE_DETAIL(name, detail) ::HXSL::ProfileScope HXSL_PROFILE_CONCAT(profileScope, __LINE__)(name, [&]() -> std::string { return detail; })
+}
+
+#endif
\ No newline at end of file
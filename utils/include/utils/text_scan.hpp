@@ -0,0 +1,43 @@
+#ifndef TEXT_SCAN_HPP
+#define TEXT_SCAN_HPP
+
+#include "pch/std.hpp"
+
+// Vectorized byte-class scanners used by the lexer hot paths.
+// Every kernel has a scalar, SSE2 and AVX2 implementation, the widest one supported by the host is picked at runtime.
+// All kernels return absolute indices into text and never read past text + length.
+namespace TextScan
+{
+	enum ScanLevel
+	{
+		ScanLevel_Scalar,
+		ScanLevel_SSE2,
+		ScanLevel_AVX2,
+	};
+
+	ScanLevel GetMaxScanLevel();
+
+	ScanLevel GetScanLevel();
+
+	// Overrides the active implementation, clamped to GetMaxScanLevel(). Intended for benchmarks and tests.
+	void SetScanLevel(ScanLevel level);
+
+	const char* ToString(ScanLevel level);
+
+	// Skips ' ', '\t', '\v' and '\f'. Line breaks are not skipped.
+	size_t SkipBlanks(const char* text, size_t offset, size_t length);
+
+	// Skips everything std::isspace accepts, lines is incremented once per "\n", "\r\n" or lone "\r".
+	size_t SkipWhitespace(const char* text, size_t offset, size_t length, size_t& lines);
+
+	// Skips [A-Za-z0-9_].
+	size_t SkipIdentifierChars(const char* text, size_t offset, size_t length);
+
+	// Finds the first '\r' or '\n'.
+	size_t FindLineBreak(const char* text, size_t offset, size_t length);
+
+	// Finds the first occurrence of a, b, '\\' or '\r', lineFeeds is incremented by the number of '\n' skipped on the way.
+	size_t FindDelimiterOrEscape(const char* text, size_t offset, size_t length, char a, char b, size_t& lineFeeds);
+}
+
+#endif
\ No newline at end of file
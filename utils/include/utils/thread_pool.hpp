@@ -0,0 +1,42 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include "pch/std.hpp"
+#include <thread>
+#include <condition_variable>
+#include <atomic>
+
+namespace HXSL
+{
+	class ThreadPool
+	{
+		std::vector<std::thread> workers;
+		std::queue<std::function<void()>> jobs;
+		std::mutex mutex;
+		std::condition_variable jobAvailable;
+		bool stopping = false;
+
+		void WorkerMain();
+
+		void Enqueue(std::function<void()>&& job);
+
+	public:
+		// threadCount includes the calling thread, a pool of one runs everything inline.
+		explicit ThreadPool(size_t threadCount = GetDefaultThreadCount());
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		~ThreadPool();
+
+		size_t GetThreadCount() const noexcept { return workers.size() + 1; }
+
+		// Calls func(i) for every i in [0, count) and returns once all calls finished. The calling thread takes part,
+		// indices are handed out in ascending order but may complete in any order.
+		void ParallelFor(size_t count, const std::function<void(size_t)>& func);
+
+		static size_t GetDefaultThreadCount();
+	};
+}
+
+#endif
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "utils/bump_allocator.hpp"
+#include "utils/profiler.hpp"
 
 static constexpr size_t PageSize = 8192;
 
@@ -7,7 +8,7 @@ namespace HXSL
 	BumpAllocator::Block* BumpAllocator::AllocBlock(Block* prev, size_t minSize)
 	{
 		size_t size = AlignUp(minSize + sizeof(Block), PageSize);
-		uint8_t* mem = static_cast<uint8_t*>(aligned_alloc(size, PageSize));
+		uint8_t* mem = static_cast<uint8_t*>(aligned_alloc(PageSize, size));
 		size_t usableSpace = size - sizeof(Block);
 		Block* block = new(mem + usableSpace) Block(prev, usableSpace);
 		return block;
@@ -23,6 +24,8 @@ namespace HXSL
 	BumpAllocator::Block* BumpAllocator::CreateBlock(size_t minSize)
 	{
 		Block* block = AllocBlock(tail, minSize);
+		// single allocations are too hot to count, the block sizes add up to the memory taken by all bump allocators.
+		Profiler::Count("BumpAllocator bytes allocated", static_cast<int64_t>(block->blockSize + sizeof(Block)));
 		tail = block;
 		if (head == nullptr) head = block;
 		return block;
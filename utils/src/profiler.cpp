@@ -0,0 +1,253 @@
+#include "utils/profiler.hpp"
+
+#include <cstring>
+#include <iomanip>
+
+namespace HXSL
+{
+	std::atomic<bool> Profiler::enabled = false;
+	std::atomic<uint32_t> Profiler::generation = 0;
+
+	namespace
+	{
+		// Only the owning thread adds events and it clears them itself once it records into a newer session, the writer reads
+		// them under the same lock. The buffer is freed after its thread exited.
+		struct ThreadBuffer
+		{
+			uint32_t id;
+			uint32_t generation = 0;
+			bool orphaned = false;
+			std::mutex mutex;
+			std::vector<Profiler::Event> events;
+		};
+
+		struct Session
+		{
+			std::mutex mutex;
+			std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+			std::atomic<std::chrono::steady_clock::rep> origin = 0;
+			uint32_t nextThreadId = 1;
+		};
+
+		Session& GetSession()
+		{
+			static Session session;
+			return session;
+		}
+
+		struct ThreadSlot
+		{
+			ThreadBuffer* buffer = nullptr;
+
+			~ThreadSlot()
+			{
+				if (!buffer) return;
+				auto& session = GetSession();
+				std::lock_guard<std::mutex> lock(session.mutex);
+				buffer->orphaned = true;
+			}
+		};
+
+		thread_local ThreadSlot threadSlot;
+
+		// a thread keeps its buffer across sessions, it is reset when the thread first records into a new one.
+		ThreadBuffer* GetThreadBuffer()
+		{
+			if (threadSlot.buffer)
+			{
+				return threadSlot.buffer;
+			}
+
+			auto& session = GetSession();
+			std::lock_guard<std::mutex> lock(session.mutex);
+			auto owned = std::make_unique<ThreadBuffer>();
+			owned->id = session.nextThreadId++;
+			threadSlot.buffer = owned.get();
+			session.buffers.push_back(std::move(owned));
+			return threadSlot.buffer;
+		}
+
+		void WriteEscaped(std::ostream& stream, const char* text, size_t length)
+		{
+			for (size_t i = 0; i < length; ++i)
+			{
+				char c = text[i];
+				switch (c)
+				{
+				case '"':
+					stream << "\\\"";
+					break;
+				case '\\':
+					stream << "\\\\";
+					break;
+				case '\n':
+					stream << "\\n";
+					break;
+				default:
+					if (static_cast<unsigned char>(c) < 0x20)
+					{
+						stream << "\\u00" << "0123456789abcdef"[(c >> 4) & 0xF] << "0123456789abcdef"[c & 0xF];
+					}
+					else
+					{
+						stream << c;
+					}
+					break;
+				}
+			}
+		}
+
+		void WriteTimestamp(std::ostream& stream, uint64_t ns)
+		{
+			// trace timestamps are in microseconds, the fraction keeps the ns resolution.
+			stream << ns / 1000 << "." << std::setw(3) << std::setfill('0') << ns % 1000 << std::setfill(' ');
+		}
+	}
+
+	bool Profiler::Begin()
+	{
+		auto& session = GetSession();
+		std::lock_guard<std::mutex> lock(session.mutex);
+		if (enabled.load(std::memory_order_relaxed))
+		{
+			return false;
+		}
+
+		// buffers of live threads are retired by the generation bump, they may still be written by a straggler of the last session.
+		std::erase_if(session.buffers, [](const std::unique_ptr<ThreadBuffer>& buffer) { return buffer->orphaned; });
+		session.origin.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+		generation.fetch_add(1, std::memory_order_release);
+		enabled.store(true, std::memory_order_release);
+		return true;
+	}
+
+	void Profiler::End()
+	{
+		enabled.store(false, std::memory_order_release);
+	}
+
+	uint64_t Profiler::Now() noexcept
+	{
+		auto origin = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(GetSession().origin.load(std::memory_order_relaxed)));
+		auto elapsed = std::chrono::steady_clock::now() - origin;
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+	}
+
+	void Profiler::Record(Event&& event)
+	{
+		// started before the current session began, its timestamps are relative to an older origin.
+		if (event.generation != GetGeneration())
+		{
+			return;
+		}
+
+		auto buffer = GetThreadBuffer();
+		std::lock_guard<std::mutex> lock(buffer->mutex);
+		if (buffer->generation != event.generation)
+		{
+			// a session began since the check above, the buffer may already belong to it.
+			if (buffer->generation > event.generation)
+			{
+				return;
+			}
+			buffer->events.clear();
+			buffer->generation = event.generation;
+		}
+		buffer->events.push_back(std::move(event));
+	}
+
+	void Profiler::WriteChromeTrace(std::ostream& stream)
+	{
+		auto& session = GetSession();
+		std::lock_guard<std::mutex> lock(session.mutex);
+
+		stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		bool first = true;
+		auto separator = [&]() -> std::ostream&
+			{
+				if (!first) stream << ",";
+				first = false;
+				return stream << "\n";
+			};
+
+		// copied out, the buffer may grow again once it is unlocked.
+		struct CounterSample
+		{
+			const char* name;
+			uint64_t start;
+			int64_t delta;
+			uint32_t thread;
+		};
+		std::vector<CounterSample> counters;
+
+		uint32_t current = GetGeneration();
+		for (auto& buffer : session.buffers)
+		{
+			std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+			if (buffer->generation != current)
+			{
+				continue;
+			}
+
+			separator() << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id << ",\"name\":\"thread_name\",\"args\":{\"name\":\"Thread " << buffer->id << "\"}}";
+
+			for (auto& event : buffer->events)
+			{
+				if (event.type == EventType_Counter)
+				{
+					counters.push_back({ event.name, event.start, event.args[0].value, buffer->id });
+					continue;
+				}
+
+				separator() << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id << ",\"name\":\"";
+				WriteEscaped(stream, event.name, std::strlen(event.name));
+				if (!event.detail.empty())
+				{
+					stream << ": ";
+					WriteEscaped(stream, event.detail.data(), event.detail.size());
+				}
+				stream << "\",\"ts\":";
+				WriteTimestamp(stream, event.start);
+				stream << ",\"dur\":";
+				WriteTimestamp(stream, event.duration);
+				if (event.argCount != 0)
+				{
+					stream << ",\"args\":{";
+					for (uint32_t i = 0; i < event.argCount; ++i)
+					{
+						stream << (i == 0 ? "\"" : ",\"") << event.args[i].name << "\":" << event.args[i].value;
+					}
+					stream << "}";
+				}
+				stream << "}";
+			}
+		}
+
+		// counters are recorded as deltas per thread, the trace wants the process wide total at every sample.
+		std::stable_sort(counters.begin(), counters.end(), [](const CounterSample& a, const CounterSample& b) { return a.start < b.start; });
+		std::unordered_map<std::string_view, int64_t> totals;
+		for (auto& sample : counters)
+		{
+			int64_t& total = totals[sample.name];
+			total += sample.delta;
+			separator() << "{\"ph\":\"C\",\"pid\":1,\"tid\":" << sample.thread << ",\"name\":\"";
+			WriteEscaped(stream, sample.name, std::strlen(sample.name));
+			stream << "\",\"ts\":";
+			WriteTimestamp(stream, sample.start);
+			stream << ",\"args\":{\"value\":" << total << "}}";
+		}
+
+		stream << "\n]}\n";
+	}
+
+	bool Profiler::WriteChromeTrace(const std::string& path)
+	{
+		std::ofstream stream(path, std::ios::binary);
+		if (!stream)
+		{
+			return false;
+		}
+		WriteChromeTrace(stream);
+		return static_cast<bool>(stream);
+	}
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "utils/text_helper.hpp"
+#include "utils/text_scan.hpp"
 #include "utils/endianness.hpp"
 
 namespace TextHelper
@@ -25,44 +26,23 @@ namespace TextHelper
 
 	size_t FindEndOfLine(const char* text, size_t offset, size_t length)
 	{
-		const char* current = text + offset;
-		const char* end = text + length;
-
-		while (current != end)
+		size_t position = TextScan::FindLineBreak(text, offset, length);
+		if (position == length)
 		{
-			char c = *current;
-			bool cr = c == '\r';
-			if (cr || c == '\n')
-			{
-				size_t width = 1;
-				if (cr && current + 1 != end && current[1] == '\n')
-				{
-					width++;
-				}
-				return (size_t)(current + width - text - offset);
-			}
-			current++;
+			return length - offset;
 		}
 
-		return length - offset;
+		size_t width = 1;
+		if (text[position] == '\r' && position + 1 != length && text[position + 1] == '\n')
+		{
+			width++;
+		}
+		return position + width - offset;
 	}
 
 	size_t FindWordBoundary(const char* text, size_t offset, size_t length)
 	{
-		const char* current = text + offset;
-		const char* end = text + length;
-
-		while (current != end)
-		{
-			char c = *current;
-			if (!IsLetterOrDigit(c) && c != '_')
-			{
-				return (size_t)(current - text - offset);
-			}
-			current++;
-		}
-
-		return length - offset;
+		return TextScan::SkipIdentifierChars(text, offset, length) - offset;
 	}
 
 	size_t FindOperatorBoundary(const char* text, size_t offset, size_t length, const std::unordered_set<char>& delimiter)
@@ -91,6 +71,16 @@ namespace TextHelper
 		bool escaped = false;
 		while (current < end)
 		{
+			if (!escaped)
+			{
+				// runs without the target, escapes or '\r' are skipped in bulk, line feeds on the way are counted by the scanner.
+				current = text + TextScan::FindDelimiterOrEscape(text, current - text, length, target, target, lines);
+				if (current == end)
+				{
+					break;
+				}
+			}
+
 			char c = *current;
 			if (c == target && !escaped)
 			{
@@ -129,8 +119,25 @@ namespace TextHelper
 
 		bool escaped = false;
 		size_t ix = 0;
+		bool canScan = target.length() == 1 || target.length() == 2;
+		char first = canScan ? target.front() : '\0';
+		char last = canScan ? target.back() : '\0';
 		while (current < end)
 		{
+			if (canScan && !escaped)
+			{
+				const char* next = text + TextScan::FindDelimiterOrEscape(text, current - text, length, first, last, lines);
+				if (next != current)
+				{
+					ix = 0;
+					current = next;
+				}
+				if (current == end)
+				{
+					break;
+				}
+			}
+
 			char c = *current;
 			if (c == target[ix] && !escaped)
 			{
@@ -233,18 +240,7 @@ namespace TextHelper
 			return false;
 		}
 
-		current++;
-		while (current != end)
-		{
-			char c = *current;
-			if (!IsLetterOrDigit(c) && c != '_')
-			{
-				break;
-			}
-			current++;
-		}
-
-		trackedLength = (size_t)(current - (text + offset));
+		trackedLength = TextScan::SkipIdentifierChars(text, offset + 1, length) - offset;
 		return true;
 	}
 
@@ -0,0 +1,155 @@
+#include "text_scan_kernels.hpp"
+
+#include <atomic>
+
+namespace TextScan
+{
+	namespace Detail
+	{
+		static constexpr ScanKernels ScalarKernels = { Scalar::SkipBlanks, Scalar::SkipWhitespace, Scalar::SkipIdentifierChars, Scalar::FindLineBreak, Scalar::FindDelimiterOrEscape };
+
+#if HXSL_SCAN_X86
+		namespace
+		{
+			struct SSE2Traits
+			{
+				using Vec = __m128i;
+				static constexpr size_t Width = 16;
+				static constexpr uint32_t Full = 0xFFFFu;
+
+				static inline Vec Load(const char* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+				static inline Vec Splat(char c) { return _mm_set1_epi8(c); }
+				static inline Vec Eq(Vec a, Vec b) { return _mm_cmpeq_epi8(a, b); }
+				static inline Vec Gt(Vec a, Vec b) { return _mm_cmpgt_epi8(a, b); }
+				static inline Vec Or(Vec a, Vec b) { return _mm_or_si128(a, b); }
+				static inline Vec And(Vec a, Vec b) { return _mm_and_si128(a, b); }
+				static inline uint32_t Mask(Vec v) { return static_cast<uint32_t>(_mm_movemask_epi8(v)); }
+			};
+		}
+
+		static constexpr ScanKernels SSE2Kernels = Kernels<SSE2Traits>::Table();
+#endif
+	}
+
+	using namespace Detail;
+
+	static ScanLevel DetectScanLevel()
+	{
+#if HXSL_SCAN_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] >= 7)
+		{
+			__cpuid(info, 1);
+			bool osxsave = (info[2] & (1 << 27)) != 0;
+			bool avx = (info[2] & (1 << 28)) != 0;
+			__cpuidex(info, 7, 0);
+			bool avx2 = (info[1] & (1 << 5)) != 0;
+			if (osxsave && avx && avx2 && (_xgetbv(0) & 0x6) == 0x6)
+			{
+				return ScanLevel_AVX2;
+			}
+		}
+#else
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+		{
+			return ScanLevel_AVX2;
+		}
+#endif
+		return ScanLevel_SSE2;
+#else
+		return ScanLevel_Scalar;
+#endif
+	}
+
+	static const ScanKernels* GetKernelsFor(ScanLevel level)
+	{
+		switch (level)
+		{
+#if HXSL_SCAN_X86
+		case ScanLevel_AVX2:
+			return &AVX2Kernels;
+		case ScanLevel_SSE2:
+			return &SSE2Kernels;
+#endif
+		default:
+			return &ScalarKernels;
+		}
+	}
+
+	// Constant initialized, the first call resolves the kernels so that lexing from static initializers is safe.
+	static std::atomic<ScanLevel> activeLevel{ ScanLevel_Scalar };
+	static std::atomic<const ScanKernels*> activeKernels{ nullptr };
+
+	static inline const ScanKernels* Active()
+	{
+		auto kernels = activeKernels.load(std::memory_order_acquire);
+		if (!kernels)
+		{
+			SetScanLevel(GetMaxScanLevel());
+			kernels = activeKernels.load(std::memory_order_acquire);
+		}
+		return kernels;
+	}
+
+	ScanLevel GetMaxScanLevel()
+	{
+		static const ScanLevel maxLevel = DetectScanLevel();
+		return maxLevel;
+	}
+
+	ScanLevel GetScanLevel()
+	{
+		Active();
+		return activeLevel.load(std::memory_order_relaxed);
+	}
+
+	void SetScanLevel(ScanLevel level)
+	{
+		level = std::min(level, GetMaxScanLevel());
+		activeLevel.store(level, std::memory_order_relaxed);
+		activeKernels.store(GetKernelsFor(level), std::memory_order_release);
+	}
+
+	const char* ToString(ScanLevel level)
+	{
+		switch (level)
+		{
+		case ScanLevel_Scalar:
+			return "Scalar";
+		case ScanLevel_SSE2:
+			return "SSE2";
+		case ScanLevel_AVX2:
+			return "AVX2";
+		default:
+			return "Unknown";
+		}
+	}
+
+	size_t SkipBlanks(const char* text, size_t offset, size_t length)
+	{
+		return Active()->skipBlanks(text, offset, length);
+	}
+
+	size_t SkipWhitespace(const char* text, size_t offset, size_t length, size_t& lines)
+	{
+		return Active()->skipWhitespace(text, offset, length, lines);
+	}
+
+	size_t SkipIdentifierChars(const char* text, size_t offset, size_t length)
+	{
+		return Active()->skipIdentifierChars(text, offset, length);
+	}
+
+	size_t FindLineBreak(const char* text, size_t offset, size_t length)
+	{
+		return Active()->findLineBreak(text, offset, length);
+	}
+
+	size_t FindDelimiterOrEscape(const char* text, size_t offset, size_t length, char a, char b, size_t& lineFeeds)
+	{
+		return Active()->findDelimiterOrEscape(text, offset, length, a, b, lineFeeds);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#include "text_scan_kernels.hpp"
+
+// Built with AVX2 code generation enabled (see utils/CMakeLists.txt), only reached after the runtime CPU check in text_scan.cpp.
+namespace TextScan::Detail
+{
+#if HXSL_SCAN_X86
+	namespace
+	{
+		struct AVX2Traits
+		{
+			using Vec = __m256i;
+			static constexpr size_t Width = 32;
+			static constexpr uint32_t Full = 0xFFFFFFFFu;
+
+			static inline Vec Load(const char* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+			static inline Vec Splat(char c) { return _mm256_set1_epi8(c); }
+			static inline Vec Eq(Vec a, Vec b) { return _mm256_cmpeq_epi8(a, b); }
+			static inline Vec Gt(Vec a, Vec b) { return _mm256_cmpgt_epi8(a, b); }
+			static inline Vec Or(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+			static inline Vec And(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+			static inline uint32_t Mask(Vec v) { return static_cast<uint32_t>(_mm256_movemask_epi8(v)); }
+		};
+	}
+
+	const ScanKernels AVX2Kernels = Kernels<AVX2Traits>::Table();
+#endif
+}
\ No newline at end of file
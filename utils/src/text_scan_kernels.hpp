@@ -0,0 +1,261 @@
+#ifndef TEXT_SCAN_KERNELS_HPP
+#define TEXT_SCAN_KERNELS_HPP
+
+#include "utils/text_scan.hpp"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define HXSL_SCAN_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#else
+#define HXSL_SCAN_X86 0
+#endif
+
+// Shared between text_scan.cpp (scalar + SSE2) and text_scan_avx2.cpp, which is compiled with AVX2 enabled.
+// Everything except the ScanKernels table has internal linkage so that no AVX2 encoded inline function can leak
+// into the baseline translation units through the linker, for the same reason no std helpers are used in the kernels.
+namespace TextScan::Detail
+{
+	struct ScanKernels
+	{
+		size_t(*skipBlanks)(const char* text, size_t offset, size_t length);
+		size_t(*skipWhitespace)(const char* text, size_t offset, size_t length, size_t& lines);
+		size_t(*skipIdentifierChars)(const char* text, size_t offset, size_t length);
+		size_t(*findLineBreak)(const char* text, size_t offset, size_t length);
+		size_t(*findDelimiterOrEscape)(const char* text, size_t offset, size_t length, char a, char b, size_t& lineFeeds);
+	};
+
+	namespace
+	{
+		inline uint32_t CountTrailingZeros(uint32_t x)
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			unsigned long index;
+			_BitScanForward(&index, x);
+			return static_cast<uint32_t>(index);
+#else
+			return static_cast<uint32_t>(__builtin_ctz(x));
+#endif
+		}
+
+		inline uint32_t PopCount(uint32_t x)
+		{
+			x = x - ((x >> 1) & 0x55555555u);
+			x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+			x = (x + (x >> 4)) & 0x0F0F0F0Fu;
+			return (x * 0x01010101u) >> 24;
+		}
+
+		inline bool IsBlank(char c)
+		{
+			return c == ' ' || c == '\t' || c == '\v' || c == '\f';
+		}
+
+		inline bool IsIdentifierChar(char c)
+		{
+			return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+		}
+
+		namespace Scalar
+		{
+			inline size_t SkipBlanks(const char* text, size_t offset, size_t length)
+			{
+				while (offset < length && IsBlank(text[offset]))
+				{
+					offset++;
+				}
+				return offset;
+			}
+
+			inline size_t SkipWhitespace(const char* text, size_t offset, size_t length, size_t& lines, bool prevCR)
+			{
+				while (offset < length)
+				{
+					char c = text[offset];
+					if (c == '\n')
+					{
+						if (!prevCR) lines++;
+					}
+					else if (c == '\r')
+					{
+						lines++;
+					}
+					else if (!IsBlank(c))
+					{
+						break;
+					}
+					prevCR = c == '\r';
+					offset++;
+				}
+				return offset;
+			}
+
+			inline size_t SkipWhitespace(const char* text, size_t offset, size_t length, size_t& lines)
+			{
+				return SkipWhitespace(text, offset, length, lines, false);
+			}
+
+			inline size_t SkipIdentifierChars(const char* text, size_t offset, size_t length)
+			{
+				while (offset < length && IsIdentifierChar(text[offset]))
+				{
+					offset++;
+				}
+				return offset;
+			}
+
+			inline size_t FindLineBreak(const char* text, size_t offset, size_t length)
+			{
+				while (offset < length)
+				{
+					char c = text[offset];
+					if (c == '\r' || c == '\n') break;
+					offset++;
+				}
+				return offset;
+			}
+
+			inline size_t FindDelimiterOrEscape(const char* text, size_t offset, size_t length, char a, char b, size_t& lineFeeds)
+			{
+				while (offset < length)
+				{
+					char c = text[offset];
+					if (c == a || c == b || c == '\\' || c == '\r') break;
+					if (c == '\n') lineFeeds++;
+					offset++;
+				}
+				return offset;
+			}
+		}
+
+		// V provides: Vec, Width, Full, Load, Splat, Eq, Gt (signed), Or, And, Mask (movemask).
+		template <typename V>
+		struct Kernels
+		{
+			static inline typename V::Vec InRange(typename V::Vec v, char lo, char hi)
+			{
+				return V::And(V::Gt(v, V::Splat(lo - 1)), V::Gt(V::Splat(hi + 1), v));
+			}
+
+			static inline uint32_t BlankMask(typename V::Vec v)
+			{
+				auto blank = V::Or(V::Eq(v, V::Splat(' ')), V::Eq(v, V::Splat('\t')));
+				return V::Mask(V::Or(blank, InRange(v, '\v', '\f')));
+			}
+
+			static size_t SkipBlanks(const char* text, size_t offset, size_t length)
+			{
+				while (offset + V::Width <= length)
+				{
+					uint32_t stop = ~BlankMask(V::Load(text + offset)) & V::Full;
+					if (stop)
+					{
+						return offset + CountTrailingZeros(stop);
+					}
+					offset += V::Width;
+				}
+				return Scalar::SkipBlanks(text, offset, length);
+			}
+
+			static size_t SkipWhitespace(const char* text, size_t offset, size_t length, size_t& lines)
+			{
+				const auto cr = V::Splat('\r');
+				const auto lf = V::Splat('\n');
+				uint32_t carryCR = 0;
+				while (offset + V::Width <= length)
+				{
+					auto v = V::Load(text + offset);
+					uint32_t crMask = V::Mask(V::Eq(v, cr));
+					uint32_t lfMask = V::Mask(V::Eq(v, lf));
+					uint32_t space = BlankMask(v) | crMask | lfMask;
+					uint32_t stop = ~space & V::Full;
+					uint32_t run = stop ? (1u << CountTrailingZeros(stop)) - 1 : V::Full;
+
+					crMask &= run;
+					lfMask &= run & ~((crMask << 1) | carryCR);
+					lines += PopCount(crMask) + PopCount(lfMask);
+
+					if (stop)
+					{
+						return offset + CountTrailingZeros(stop);
+					}
+
+					carryCR = crMask >> (V::Width - 1);
+					offset += V::Width;
+				}
+				return Scalar::SkipWhitespace(text, offset, length, lines, carryCR != 0);
+			}
+
+			static size_t SkipIdentifierChars(const char* text, size_t offset, size_t length)
+			{
+				const auto underscore = V::Splat('_');
+				const auto caseBit = V::Splat(0x20);
+				while (offset + V::Width <= length)
+				{
+					auto v = V::Load(text + offset);
+					auto letter = InRange(V::Or(v, caseBit), 'a', 'z');
+					auto ident = V::Or(V::Or(letter, InRange(v, '0', '9')), V::Eq(v, underscore));
+					uint32_t stop = ~V::Mask(ident) & V::Full;
+					if (stop)
+					{
+						return offset + CountTrailingZeros(stop);
+					}
+					offset += V::Width;
+				}
+				return Scalar::SkipIdentifierChars(text, offset, length);
+			}
+
+			static size_t FindLineBreak(const char* text, size_t offset, size_t length)
+			{
+				const auto cr = V::Splat('\r');
+				const auto lf = V::Splat('\n');
+				while (offset + V::Width <= length)
+				{
+					auto v = V::Load(text + offset);
+					uint32_t stop = V::Mask(V::Or(V::Eq(v, cr), V::Eq(v, lf)));
+					if (stop)
+					{
+						return offset + CountTrailingZeros(stop);
+					}
+					offset += V::Width;
+				}
+				return Scalar::FindLineBreak(text, offset, length);
+			}
+
+			static size_t FindDelimiterOrEscape(const char* text, size_t offset, size_t length, char a, char b, size_t& lineFeeds)
+			{
+				const auto va = V::Splat(a);
+				const auto vb = V::Splat(b);
+				const auto backslash = V::Splat('\\');
+				const auto cr = V::Splat('\r');
+				const auto lf = V::Splat('\n');
+				while (offset + V::Width <= length)
+				{
+					auto v = V::Load(text + offset);
+					uint32_t stop = V::Mask(V::Or(V::Or(V::Eq(v, va), V::Eq(v, vb)), V::Or(V::Eq(v, backslash), V::Eq(v, cr))));
+					uint32_t lfMask = V::Mask(V::Eq(v, lf));
+					if (stop)
+					{
+						uint32_t index = CountTrailingZeros(stop);
+						lineFeeds += PopCount(lfMask & ((1u << index) - 1));
+						return offset + index;
+					}
+					lineFeeds += PopCount(lfMask);
+					offset += V::Width;
+				}
+				return Scalar::FindDelimiterOrEscape(text, offset, length, a, b, lineFeeds);
+			}
+
+			static constexpr ScanKernels Table()
+			{
+				return { SkipBlanks, SkipWhitespace, SkipIdentifierChars, FindLineBreak, FindDelimiterOrEscape };
+			}
+		};
+	}
+
+	extern const ScanKernels AVX2Kernels;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "utils/thread_pool.hpp"
+
+namespace HXSL
+{
+	ThreadPool::ThreadPool(size_t threadCount)
+	{
+		threadCount = std::max<size_t>(threadCount, 1);
+		workers.reserve(threadCount - 1);
+		for (size_t i = 1; i < threadCount; i++)
+		{
+			workers.emplace_back([this]() { WorkerMain(); });
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		jobAvailable.notify_all();
+
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+	}
+
+	void ThreadPool::WorkerMain()
+	{
+		while (true)
+		{
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				jobAvailable.wait(lock, [this]() { return stopping || !jobs.empty(); });
+				if (jobs.empty())
+				{
+					return;
+				}
+				job = std::move(jobs.front());
+				jobs.pop();
+			}
+			job();
+		}
+	}
+
+	void ThreadPool::Enqueue(std::function<void()>&& job)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			jobs.push(std::move(job));
+		}
+		jobAvailable.notify_one();
+	}
+
+	void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& func)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		size_t helpers = std::min(workers.size(), count - 1);
+		if (helpers == 0)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				func(i);
+			}
+			return;
+		}
+
+		std::atomic<size_t> next = 0;
+		std::mutex doneMutex;
+		std::condition_variable doneSignal;
+		size_t running = helpers;
+
+		auto work = [&]()
+			{
+				size_t i;
+				while ((i = next.fetch_add(1, std::memory_order_relaxed)) < count)
+				{
+					func(i);
+				}
+			};
+
+		for (size_t i = 0; i < helpers; i++)
+		{
+			Enqueue([&]()
+				{
+					work();
+					std::lock_guard<std::mutex> lock(doneMutex);
+					if (--running == 0)
+					{
+						doneSignal.notify_one();
+					}
+				});
+		}
+
+		work();
+
+		std::unique_lock<std::mutex> lock(doneMutex);
+		doneSignal.wait(lock, [&]() { return running == 0; });
+	}
+
+	size_t ThreadPool::GetDefaultThreadCount()
+	{
+		return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	}
+}
\ No newline at end of file